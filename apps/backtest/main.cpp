@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Backtester.hpp"
+
+// Replays captured feeds through the live book and strategy code against the matching simulator:
+//     Backtester [--threads=N] [--md-us=X] [--order-us=X] [--report-us=X] [--jitter-us=X] journal ...
+// Journals are written by the HFT app when HFT_JOURNAL is set. Each journal runs on its own core.
+
+namespace {
+
+	bool option(std::string_view arg, std::string_view name, double& out) {
+		if (!arg.starts_with(name) || arg.size() <= name.size() || arg[name.size()] != '=') return false;
+		out = std::atof(std::string(arg.substr(name.size() + 1)).c_str());
+		return true;
+	}
+
+	std::chrono::nanoseconds micros(double us) {
+		return std::chrono::nanoseconds(static_cast<std::int64_t>(us * 1000.0));
+	}
+
+}
+
+int main(int argc, char** argv) {
+	backtest::BacktestConfig config;
+	double threads = 0.0;
+	double jitter = -1.0;
+	double us = 0.0;
+	std::vector<std::string> journals;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (option(arg, "--threads", threads)) continue;
+		if (option(arg, "--jitter-us", jitter)) continue;
+		if (option(arg, "--md-us", us)) { config.latency.marketData.base = micros(us); continue; }
+		if (option(arg, "--order-us", us)) { config.latency.order.base = micros(us); continue; }
+		if (option(arg, "--report-us", us)) { config.latency.report.base = micros(us); continue; }
+		if (arg.starts_with("--")) {
+			std::cerr << "Unknown option " << arg << "\n";
+			return 2;
+		}
+		journals.emplace_back(arg);
+	}
+	if (journals.empty()) {
+		std::cerr << "Usage: Backtester [--threads=N] [--md-us=X] [--order-us=X] [--report-us=X] [--jitter-us=X] journal ...\n";
+		return 2;
+	}
+	if (jitter >= 0.0) {
+		config.latency.marketData.jitter = config.latency.order.jitter = config.latency.report.jitter = micros(jitter);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto results = backtest::runJournals(journals, config, static_cast<unsigned>(threads));
+	const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::uint64_t frames = 0;
+	bool ok = true;
+	std::cout << std::fixed << std::setprecision(4);
+	for (const auto& r : results) {
+		ok &= r.ok;
+		if (!r.ok) continue;
+		frames += r.frames;
+		std::cout << r.journal << ": " << r.frames << " frames, " << r.quotes << " quotes, "
+		          << r.decisions << " decisions, " << r.orders << " orders, "
+		          << r.riskRejects << " risk rejects, " << r.omsRefusals << " OMS refusals, " << r.venueRejects << " venue rejects, "
+		          << static_cast<double>(r.simulatedNs) * 1e-9 << " s simulated in " << r.wallSeconds << " s\n";
+		for (const auto& m : r.markets) {
+			std::cout << "    " << m.symbol << ": " << m.fills << " fills, volume " << m.volume
+			          << ", position " << m.position << ", pnl " << m.pnl() << "\n";
+		}
+	}
+	std::cout << frames << " frames in " << wall << " s, " << static_cast<double>(frames) / wall << " frames/s\n";
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SimulatorServer.hpp"
+
+// Local venue for the FIX gateway: FixSim [port] [symbol ...]
+// Each symbol gets a seeded book around 100.00 and a random-walk stream of house orders, so
+// subscribers see a live feed and resting client orders eventually trade.
+
+namespace {
+
+	std::atomic<bool> running{true};
+
+	constexpr double kTick = 0.01;
+	constexpr std::size_t kRestingPerSymbol = 200;
+
+	struct HouseFlow {
+		gateway::SymbolId symbol;
+		double mid{100.0};
+		std::deque<std::uint64_t> resting;
+	};
+
+}
+
+int main(int argc, char** argv) {
+	const unsigned short port = argc > 1 ? static_cast<unsigned short>(std::atoi(argv[1])) : 9876;
+	std::vector<std::string> symbols;
+	for (int i = 2; i < argc; ++i) symbols.emplace_back(argv[i]);
+	if (symbols.empty()) symbols = {"EUR/USD", "BTC-EUR"};
+
+	sim::SimulatorServer server;
+	std::vector<HouseFlow> flows;
+	for (const auto& s : symbols) {
+		server.addSymbol(s);
+		flows.push_back(HouseFlow{gateway::internSymbol(s), 100.0, {}});
+	}
+
+	std::mt19937_64 rng(42);
+	std::uint64_t nextId = sim::kHouseIdBase;
+	const auto place = [&](sim::SimulatorServer::Engine& engine, HouseFlow& f, gateway::QuoteSide side, double price, double qty) {
+		sim::OrderRequest req;
+		req.owner = sim::kHouse;
+		req.clOrdId = nextId++;
+		req.symbol = f.symbol;
+		req.side = side;
+		req.price = price;
+		req.qty = qty;
+		engine.newOrder(req);
+		f.resting.push_back(req.clOrdId);
+	};
+	const auto pruneOldest = [&](sim::SimulatorServer::Engine& engine, HouseFlow& f) {
+		while (f.resting.size() > kRestingPerSymbol) {
+			sim::OrderRequest cancel;
+			cancel.msgType = 'F';
+			cancel.owner = sim::kHouse;
+			cancel.clOrdId = nextId++;
+			cancel.origClOrdId = f.resting.front();
+			cancel.symbol = f.symbol;
+			engine.cancel(cancel);   // already filled orders are simply not found
+			f.resting.pop_front();
+		}
+	};
+
+	server.run([&](auto& engine) {
+		for (auto& f : flows) {
+			for (int level = 1; level <= 20; ++level) {
+				place(engine, f, gateway::QuoteSide::Bid, f.mid - level * kTick, 1.0);
+				place(engine, f, gateway::QuoteSide::Ask, f.mid + level * kTick, 1.0);
+			}
+		}
+	});
+
+	server.every(std::chrono::milliseconds(10), [&](auto& engine) {
+		std::normal_distribution<double> step(0.0, 1.0);
+		std::uniform_int_distribution<int> offset(0, 10);
+		std::uniform_real_distribution<double> size(0.1, 2.0);
+		std::bernoulli_distribution buy(0.5);
+		for (auto& f : flows) {
+			f.mid = std::max(kTick, f.mid + std::round(step(rng)) * kTick);
+			const auto side = buy(rng) ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask;
+			const double away = (offset(rng) - 1) * kTick;   // -1 tick crosses the mid and may trade
+			const double price = side == gateway::QuoteSide::Bid ? f.mid - away : f.mid + away;
+			place(engine, f, side, std::round(price / kTick) * kTick, std::round(size(rng) * 100.0) / 100.0);
+			pruneOldest(engine, f);
+		}
+	});
+
+	if (!server.start(port)) return 1;
+	std::cout << "FixSim listening on port " << server.port() << " with " << symbols.size() << " symbols\n";
+
+	std::signal(SIGINT, [](int) { running = false; });
+	std::signal(SIGTERM, [](int) { running = false; });
+	while (running) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	server.stop();
+	std::cout << "FixSim stopped after " << server.messagesIn() << " messages in, " << server.messagesOut() << " out\n";
+	return 0;
+}
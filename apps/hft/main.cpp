@@ -1,6 +1,14 @@
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
 
+#include "BookCheckpoint.hpp"
+#include "FeedJournal.hpp"
+#include "FeedSupervisor.hpp"
+#include "MarketMaker.hpp"
+#include "PreTradeRisk.hpp"
 #include "QuoteConsumer.hpp"
 #include "QuotesObtainer.hpp"
 #include "websocket/BitVavoNetworkClient.hpp"
@@ -12,24 +20,53 @@ int main() {
 
 	const std::string host = "ws.bitvavo.com";
 	const std::string port = "443";
-	const std::string market = "BTC-EUR";
+	const std::vector<std::string> markets = {"BTC-EUR", "ETH-EUR", "SOL-EUR", "XRP-EUR"};
+
+	const std::string checkpointPath = "hft_books.ckpt";
 
 	gateway::BitvavoWebSocketClient wsClient;
-	gateway::QuotesObtainer<gateway::BitvavoWebSocketClient> obt(wsClient, host, port, market);
+	gateway::QuotesObtainer<gateway::BitvavoWebSocketClient> obt(wsClient, host, port, markets);
+	QuoteConsumer consumer{std::tie(obt), markets};
+
+	// Warm start: books from the last checkpoint, reconciled against the feed once it connects.
+	CheckpointFile warm;
+	if (warm.open(checkpointPath)) {
+		std::cout << "Restored " << consumer.restore(warm) << " books from " << checkpointPath << "\n";
+		warm.close();
+	}
+	CheckpointWriter checkpoints(checkpointPath);
+	consumer.enableCheckpoints(&checkpoints, seconds(5));
+
+	// HFT_JOURNAL=path records every feed frame for replay with the Backtester app.
+	JournalWriter feedJournal;
+	if (const char* journalPath = std::getenv("HFT_JOURNAL"); journalPath && feedJournal.open(journalPath, journal::Wire::Bitvavo, markets)) {
+		obt.tapFrames([&feedJournal](std::string_view frame) { feedJournal.append(frame); });
+		std::cout << "Recording feed to " << journalPath << "\n";
+	}
 
+	// Connects, resubscribes after every reconnect and drops a feed that has gone quiet for 30 s.
 	std::cout << "Connecting to " << host << ":" << port << " ...\n";
-	QuoteConsumer consumer{obt, "BTC-EUR"};
-	std::cout << "Connected\n";
+	gateway::FeedSupervisor supervisor;
+	supervisor.watch(obt, "bitvavo", gateway::SupervisorPolicy{.staleAfter = seconds(30)});
+	supervisor.start();
 	OrderBookView view;
+	consumer.setPublishLevels(80);
 	consumer.attachView(&view);
 	std::cout << "Attached view\n";
-	consumer.setPublishLevels(80);
 	consumer.setPublishPeriod(milliseconds(20));
 
-	consumer.start();
+	// Decisions run inline on the consumer thread. Intents pass pre-trade risk and are then discarded
+	// until an order path is attached.
+	PreTradeRisk risk(RiskLimits{});
+	MarketMaker<RiskGate<NullIntentSink>> strategy(MarketMakerParams{}, RiskGate<NullIntentSink>(risk, NullIntentSink{}));
+	consumer.start(strategy);
 	VisualizerImGui visualizer(view);
 	std::cout << "Vizualizer class created\n";
 	visualizer.run();
-	std::cout << "GUI thread running\n";
 
+	// The window was closed: stop the consumer first, which writes the final checkpoint, then the
+	// supervisor, so both threads are joined before their owners go out of scope.
+	std::cout << "Shutting down ...\n";
+	consumer.stop();
+	supervisor.stop();
 }
@@ -0,0 +1,246 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "MarketMaker.hpp"
+#include "OrderSender.hpp"
+#include "QuoteConsumer.hpp"
+#include "QuotesObtainer.hpp"
+#include "SimulatorServer.hpp"
+#include "TscClock.hpp"
+#include "tcp/PixNetworkClient.hpp"
+
+// Tick-to-trade on loopback: TickToTrade [--ticks=N] [--warmup=N] [--gap-us=X] [--spin] [--direct]
+// The matching simulator publishes one market update at a time to a FIX market-data session; it runs
+// through QuotesObtainer, QuoteConsumer, MarketMaker and OrderSender, and the resulting order arrives
+// on a second, order-entry session of the same simulator. Both ends and every stage in between are
+// stamped with the TSC, so each tick is matched to its order and split into stages. The next tick is
+// published gap-us after the order arrived, once the echo of our own quotes has settled.
+//
+// --spin drives the consumer from a busy loop instead of its sleeping thread; --direct writes orders
+// on the consumer thread instead of handing them to the sender thread.
+
+namespace {
+
+	constexpr std::string_view kSymbol = "T2T-SIM";
+	constexpr auto kTickTimeout = std::chrono::milliseconds(200);
+
+	enum Stage : std::size_t { Published, Received, BookUpdated, Decided, Sent, Accepted, kStages };
+
+	// One slot per stage for the tick in flight; each is written once, by the thread that owns the stage,
+	// and only after the stage it follows. Stragglers from earlier ticks find their predecessor empty.
+	struct TickStamps {
+		std::array<std::atomic<std::uint64_t>, kStages> at{};
+
+		void clear() noexcept {
+			for (auto& a : at) a.store(0, std::memory_order_relaxed);
+		}
+		void mark(Stage s, Stage after) noexcept {
+			if (at[after].load(std::memory_order_acquire) == 0 || at[s].load(std::memory_order_relaxed) != 0) return;
+			at[s].store(TscClock::now(), std::memory_order_release);
+		}
+		[[nodiscard]] std::uint64_t get(Stage s) const noexcept { return at[s].load(std::memory_order_acquire); }
+	};
+
+	using Sender = OrderSender<gateway::PixNetworkClient>;
+
+	// Strategy sink: stamps the book and decision stages, then sends.
+	struct StagedSender {
+		Sender* sender;
+		TickStamps* stamps;
+
+		template<class Book>
+		void onBook(const Book&) { stamps->mark(BookUpdated, Received); }
+
+		bool operator()(const OrderIntent& intent) {
+			stamps->mark(Decided, BookUpdated);
+			const bool ok = sender->send(intent);
+			stamps->mark(Sent, Decided);
+			return ok;
+		}
+	};
+
+	struct Report {
+		const char* name;
+		Stage from;
+		Stage to;
+		LatencyHistogram histogram;
+	};
+
+	bool option(std::string_view arg, std::string_view name, double& out) {
+		if (!arg.starts_with(name) || arg.size() <= name.size() || arg[name.size()] != '=') return false;
+		out = std::atof(std::string(arg.substr(name.size() + 1)).c_str());
+		return true;
+	}
+
+	template<class Pred>
+	bool waitFor(Pred pred, std::chrono::milliseconds timeout) {
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+		while (!pred()) {
+			if (std::chrono::steady_clock::now() > deadline) return false;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	double micros(std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+}
+
+int main(int argc, char** argv) {
+	using namespace std::chrono;
+	double ticks = 10000, warmup = 200, gapUs = 1000;
+	bool spin = false, direct = false;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (option(arg, "--ticks", ticks) || option(arg, "--warmup", warmup) || option(arg, "--gap-us", gapUs)) continue;
+		if (arg == "--spin") { spin = true; continue; }
+		if (arg == "--direct") { direct = true; continue; }
+		std::cerr << "Usage: TickToTrade [--ticks=N] [--warmup=N] [--gap-us=X] [--spin] [--direct]\n";
+		return 2;
+	}
+
+	const auto tsc = TscClock::calibrate();
+	TickStamps stamps;
+	const auto symbol = gateway::internSymbol(kSymbol);
+
+	// Venue: a one-lot house touch at 99.90 / 100.10. Each tick adds or pulls nine lots behind the bid,
+	// a single level update that moves the microprice by about 8 bps.
+	sim::SimulatorServer server;
+	server.addSymbol(kSymbol);
+	std::uint64_t nextHouseId = sim::kHouseIdBase;
+	const auto house = [&](sim::SimulatorServer::Engine& engine, char type, gateway::QuoteSide side, double price, double qty, std::uint64_t orig = 0) {
+		sim::OrderRequest req;
+		req.msgType = type;
+		req.owner = sim::kHouse;
+		req.clOrdId = nextHouseId++;
+		req.origClOrdId = orig;
+		req.symbol = symbol;
+		req.side = side;
+		req.price = price;
+		req.qty = qty;
+		if (type == 'F') engine.cancel(req);
+		else engine.newOrder(req);
+		return req.clOrdId;
+	};
+	server.run([&](auto& engine) {
+		house(engine, 'D', gateway::QuoteSide::Bid, 99.90, 1.0);
+		house(engine, 'D', gateway::QuoteSide::Ask, 100.10, 1.0);
+	});
+	server.tapOrders([&stamps](std::string_view) { stamps.mark(Accepted, Decided); });
+	if (!server.start(0, "127.0.0.1")) return 1;
+	const auto port = std::to_string(server.port());
+
+	// Order entry: OrderSender takes MsgSeqNum and CompIDs from this client's session.
+	gateway::PixNetworkClient orderEntry;
+	orderEntry.setSymbols({});
+	orderEntry.setSendOptions(gateway::SendOptions{.queued = !direct});
+	std::atomic<std::uint64_t> reports{0};
+	orderEntry.setMessageHandler([&reports](std::string_view msg) {
+		if (msg.find("\x01" "35=8\x01") != std::string_view::npos) reports.fetch_add(1, std::memory_order_relaxed);
+	});
+	orderEntry.setErrorHandler([](std::string_view err) { std::cerr << "Order entry: " << err << "\n"; });
+	Sender sender(orderEntry, fix::TemplateConfig{});
+	sender.addSymbol(symbol);
+
+	// Quotes stay 50 bps either side of the microprice, behind the house touch, so our own orders never
+	// move the microprice and each tick triggers exactly one round of replaces.
+	MarketMakerParams params;
+	params.halfSpreadBps = 50.0;
+	MarketMaker<StagedSender> strategy(params, StagedSender{&sender, &stamps});
+
+	gateway::PixNetworkClient marketData;
+	gateway::QuotesObtainer<gateway::PixNetworkClient> obt(marketData, "127.0.0.1", port, std::vector<std::string>{std::string(kSymbol)});
+	obt.tapFrames([&stamps](std::string_view) { stamps.mark(Received, Published); });
+	QuoteConsumer consumer{std::tie(obt), std::vector<std::string>{std::string(kSymbol)}};
+
+	if (!orderEntry.connect("127.0.0.1", port) || !waitFor([&] { return orderEntry.session().loggedOn(); }, seconds(5))) {
+		std::cerr << "Order entry session did not log on\n";
+		return 1;
+	}
+	if (!obt.connect()) {
+		std::cerr << "Market data connect failed\n";
+		return 1;
+	}
+	std::atomic<bool> spinning{spin};
+	std::thread spinner;
+	if (spin) {
+		spinner = std::thread([&] {
+			while (spinning.load(std::memory_order_relaxed)) consumer.poll(strategy);
+		});
+	} else {
+		consumer.start(strategy);
+	}
+	const auto shutdown = [&] {
+		if (spinner.joinable()) {
+			spinning = false;
+			spinner.join();
+		}
+		consumer.stop();
+		orderEntry.disconnect();
+		server.stop();
+	};
+	// The first quotes go out on the snapshot; both acknowledged means the whole path is up.
+	if (!waitFor([&] { return reports.load() >= 2; }, seconds(5))) {
+		std::cerr << "No quotes acknowledged by the venue\n";
+		shutdown();
+		return 1;
+	}
+
+	std::array<Report, 6> report{{
+		{"feed -> gateway", Published, Received, {}},
+		{"parse -> book", Received, BookUpdated, {}},
+		{"strategy", BookUpdated, Decided, {}},
+		{"order -> venue", Decided, Accepted, {}},
+		{"  of which send()", Decided, Sent, {}},
+		{"tick-to-trade", Published, Accepted, {}},
+	}};
+	const auto total = static_cast<std::uint64_t>(ticks + warmup);
+	const auto gap = microseconds(static_cast<std::int64_t>(gapUs));
+	std::uint64_t extra = 0, missed = 0;
+	for (std::uint64_t i = 0; i < total; ++i) {
+		stamps.clear();
+		server.run([&](auto& engine) {
+			stamps.at[Published].store(TscClock::now(), std::memory_order_release);
+			if (extra) {
+				house(engine, 'F', gateway::QuoteSide::Bid, 99.90, 9.0, extra);
+				extra = 0;
+			} else {
+				extra = house(engine, 'D', gateway::QuoteSide::Bid, 99.90, 9.0);
+			}
+		});
+		const bool done = waitFor([&] { return stamps.get(Accepted) != 0 && stamps.get(Sent) != 0; }, kTickTimeout);
+		if (!done) ++missed;
+		else if (i >= static_cast<std::uint64_t>(warmup)) {
+			for (auto& r : report) r.histogram.recordNs(tsc.elapsedNs(stamps.get(r.from), stamps.get(r.to)));
+		}
+		std::this_thread::sleep_for(gap);
+	}
+
+	shutdown();
+
+	std::cout << "Tick-to-trade over " << report.back().histogram.count() << " ticks (" << missed << " missed), TSC "
+	          << std::setprecision(3) << tsc.ghz() << " GHz, consumer " << (spin ? "spinning" : "sleeping")
+	          << ", orders " << (direct ? "direct" : "queued") << "\n";
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << std::left << std::setw(20) << "stage (us)" << std::right << std::setw(10) << "mean" << std::setw(10) << "p50"
+	          << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+	for (const auto& r : report) {
+		const auto& h = r.histogram;
+		std::cout << std::left << std::setw(20) << r.name << std::right << std::setw(10) << h.mean() / 1000.0
+		          << std::setw(10) << micros(h.percentile(50)) << std::setw(10) << micros(h.percentile(99))
+		          << std::setw(10) << micros(h.percentile(99.9)) << std::setw(10) << micros(h.max()) << "\n";
+	}
+	const auto& t2t = report.back().histogram;
+	std::cout << "README row: | " << t2t.mean() / 1000.0 << " | " << micros(t2t.percentile(99)) << " |\n";
+	return missed * 100 > total ? 1 : 0;
+}
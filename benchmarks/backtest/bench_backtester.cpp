@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "Backtester.hpp"
+#include "FeedJournal.hpp"
+
+namespace {
+
+	std::string price(int ticks) {
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), "%.2f", ticks * 0.01);
+		return buf;
+	}
+
+	// Random-walk Bitvavo feed around 100.00: a 20-level snapshot, then single-level updates 100 us
+	// apart, each resizing or removing a level within 20 ticks of the moving mid.
+	std::string writeJournal(std::size_t updates) {
+		const auto path = (std::filesystem::temp_directory_path() / "hft_bench_backtest.journal").string();
+		JournalWriter writer;
+		writer.open(path, journal::Wire::Bitvavo, {"BENCH-EUR"});
+		auto t = std::chrono::system_clock::time_point(std::chrono::seconds(1'700'000'000));
+
+		std::string snap = R"({"action":"getBook","response":{"market":"BENCH-EUR","nonce":1,"bids":[)";
+		for (int i = 1; i <= 20; ++i) snap += (i > 1 ? "," : "") + ("[\"" + price(10000 - i) + "\",\"1\"]");
+		snap += R"(],"asks":[)";
+		for (int i = 1; i <= 20; ++i) snap += (i > 1 ? "," : "") + ("[\"" + price(10000 + i) + "\",\"1\"]");
+		snap += "]}}";
+		writer.append(snap, t);
+
+		std::mt19937_64 rng(11);
+		std::uniform_int_distribution<int> away(1, 20);
+		std::uniform_int_distribution<int> size(0, 4);
+		int mid = 10000;
+		for (std::size_t n = 0; n < updates; ++n) {
+			t += std::chrono::microseconds(100);
+			if (rng() % 16 == 0) mid += rng() & 1 ? 1 : -1;
+			const bool bid = rng() & 1;
+			const int ticks = bid ? mid - away(rng) : mid + away(rng);
+			const std::string frame = R"({"event":"book","market":"BENCH-EUR","nonce":)" + std::to_string(n + 2) +
+				(bid ? R"(,"bids":[[")" : R"(,"asks":[[")") + price(ticks) + R"(",")" + std::to_string(size(rng)) + R"("]]})";
+			writer.append(frame, t);
+		}
+		writer.close();
+		return path;
+	}
+
+}
+
+// Frames per second through the whole replay: parsing, book, strategy, risk and simulated venue.
+static void BM_Backtest_Replay(benchmark::State& state) {
+	const auto path = writeJournal(static_cast<std::size_t>(state.range(0)));
+	std::uint64_t frames = 0;
+	for (auto _ : state) {
+		const auto r = backtest::runJournal(path, backtest::BacktestConfig{});
+		frames += r.frames;
+		benchmark::DoNotOptimize(r.orders);
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(frames));
+	std::remove(path.c_str());
+}
+
+BENCHMARK(BM_Backtest_Replay)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "SendQueue.hpp"
+
+namespace {
+
+	// Roughly the size of a rendered NewOrderSingle.
+	const std::string kOrder(180, 'x');
+
+	// Stream socket pair with a thread reading the far end dry.
+	struct DrainedPair {
+		int fd[2]{-1, -1};
+		std::atomic<bool> running{true};
+		std::thread reader;
+
+		DrainedPair() {
+			::socketpair(AF_UNIX, SOCK_STREAM, 0, fd);
+			reader = std::thread([this] {
+				char buf[1 << 16];
+				while (running.load(std::memory_order_relaxed) && ::read(fd[1], buf, sizeof(buf)) > 0) {}
+			});
+		}
+		~DrainedPair() {
+			running = false;
+			::shutdown(fd[0], SHUT_WR);
+			reader.join();
+			::close(fd[0]);
+			::close(fd[1]);
+		}
+	};
+
+	long writeBatch(int fd, const iovec* iov, std::size_t n) {
+		msghdr msg{};
+		msg.msg_iov = const_cast<iovec*>(iov);
+		msg.msg_iovlen = n;
+		const auto r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+		return r >= 0 ? r : 0;
+	}
+
+}
+
+// Caller-side cost of a blocking write per message: what the strategy thread paid before.
+static void BM_Send_BlockingWrite(benchmark::State& state) {
+	DrainedPair pair;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(::send(pair.fd[0], kOrder.data(), kOrder.size(), MSG_NOSIGNAL));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Caller-side cost of handing the message to the sender thread.
+static void BM_Send_QueuedPush(benchmark::State& state) {
+	DrainedPair pair;
+	gateway::SendQueue queue({.ringBytes = 1 << 24});
+	queue.start([fd = pair.fd[0]](const iovec* iov, std::size_t n) { return writeBatch(fd, iov, n); });
+	for (auto _ : state) {
+		while (!queue.push(kOrder)) {}
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.counters["maxBatch"] = static_cast<double>(queue.stats().maxBatch);
+	queue.stop();
+}
+
+// Same thread pushes a burst of arg messages and drains them with one sendmsg().
+static void BM_Send_BurstDrain(benchmark::State& state) {
+	DrainedPair pair;
+	gateway::SendQueue queue({.senderThread = false});
+	queue.start([fd = pair.fd[0]](const iovec* iov, std::size_t n) { return writeBatch(fd, iov, n); });
+	const auto burst = state.range(0);
+	for (auto _ : state) {
+		for (int64_t i = 0; i < burst; ++i) queue.push(kOrder);
+		while (queue.queuedBytes()) queue.drain();
+	}
+	state.SetItemsProcessed(state.iterations() * burst);
+}
+
+BENCHMARK(BM_Send_BlockingWrite);
+BENCHMARK(BM_Send_QueuedPush);
+BENCHMARK(BM_Send_BurstDrain)->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+#include "DepthKernels.hpp"
+
+using gateway::QuoteSide;
+
+namespace {
+
+	// Bid side with n levels one tick apart, best first.
+	std::vector<std::pair<double, double>> bidLevels(std::size_t n) {
+		std::vector<std::pair<double, double>> out;
+		out.reserve(n);
+		for (std::size_t i = 0; i < n; ++i)
+			out.emplace_back(50'000.0 - 0.01 * static_cast<double>(i), 0.05 + 0.01 * static_cast<double>(i % 7));
+		return out;
+	}
+
+	// Arg 0: levels, arg 1: 1 forces the scalar path.
+	template<class Query>
+	void run(benchmark::State& state, Query query) {
+		const auto levels = bidLevels(static_cast<std::size_t>(state.range(0)));
+		const depth::PairLevels side{levels.data(), levels.size()};
+		depth::forceScalar(state.range(1) != 0);
+		for (auto _ : state) benchmark::DoNotOptimize(query(side, levels));
+		depth::forceScalar(false);
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+}
+
+static void BM_DepthKernel_CumulativeDepth(benchmark::State& state) {
+	run(state, [](const depth::PairLevels& side, const auto& levels) {
+		return depth::cumulativeDepth(side, QuoteSide::Bid, levels.back().first);
+	});
+}
+
+static void BM_DepthKernel_CrossingLevel(benchmark::State& state) {
+	run(state, [](const depth::PairLevels& side, const auto&) { return depth::crossingLevel(side, 1e9); });
+}
+
+static void BM_DepthKernel_Sweep(benchmark::State& state) {
+	run(state, [](const depth::PairLevels& side, const auto&) { return depth::sweep(side, 1e9).notional; });
+}
+
+#define HFT_KERNEL_ARGS ->ArgsProduct({{50, 200}, {0, 1}})
+BENCHMARK(BM_DepthKernel_CumulativeDepth) HFT_KERNEL_ARGS;
+BENCHMARK(BM_DepthKernel_CrossingLevel) HFT_KERNEL_ARGS;
+BENCHMARK(BM_DepthKernel_Sweep) HFT_KERNEL_ARGS;
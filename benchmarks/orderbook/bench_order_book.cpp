@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "FlatOrderBook.hpp"
+#include "OrderBook.hpp"
+#include "PoolAllocator.hpp"
+
+using namespace gateway;
+
+namespace {
+
+	// Synthetic Bitvavo-like churn: a drifting mid, ~35% deletes. Deep streams spread updates over ~64 levels
+	// behind the touch, touch streams keep them geometric around it (the common case on Bitvavo).
+	// Streams are generated once and replayed so generation cost stays out of the measurement.
+	std::vector<Quote> makeStream(bool touchHeavy) {
+		constexpr std::size_t kLen = 1 << 20;
+		constexpr double kTick = 0.01;
+		const auto symbol = internSymbol("BTC-EUR");
+		const auto ts = std::chrono::system_clock::time_point{};
+
+		std::vector<Quote> out;
+		out.reserve(kLen);
+		std::uint64_t x = 0x9E3779B97F4A7C15ull;
+		auto next = [&x] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+		std::int64_t mid = 5'000'000;
+		for (std::size_t i = 0; i < kLen; ++i) {
+			const auto r = next();
+			if ((r & 0xff) == 0) mid += (r & 0x100) ? 1 : -1;
+			const bool bid = r & 0x200;
+			// Distance from the touch is roughly geometric: most activity at the first few levels.
+			const std::int64_t depth = std::countr_zero((r >> 10) | (std::uint64_t{1} << 40))
+									   + (touchHeavy ? 0 : static_cast<std::int64_t>((r >> 56) & 0x3f));
+			const std::int64_t ticks = bid ? mid - 1 - depth : mid + 1 + depth;
+			const double size = ((r >> 20) % 100) < 35 ? 0.0 : static_cast<double>((r >> 30) % 1000) / 100.0 + 0.01;
+			out.emplace_back(static_cast<double>(ticks) * kTick, size, ts, symbol,
+							 bid ? QuoteSide::Bid : QuoteSide::Ask);
+		}
+		return out;
+	}
+
+	const std::vector<Quote>& churnStream(bool touchHeavy) {
+		static const std::vector<Quote> deep = makeStream(false);
+		static const std::vector<Quote> touch = makeStream(true);
+		return touchHeavy ? touch : deep;
+	}
+
+	template<class Book>
+	void replay(benchmark::State& state, Book& book) {
+		const auto& stream = churnStream(state.range(1) != 0);
+		const auto updates = static_cast<std::size_t>(state.range(0));
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < updates; ++i) book.update(stream[i & (stream.size() - 1)]);
+			benchmark::DoNotOptimize(book.bestBid());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * updates));
+		state.counters["levels"] = static_cast<double>(book.bids().size() + book.asks().size());
+	}
+
+}
+
+static void BM_OrderBook_Churn_StdAllocator(benchmark::State& state) {
+	OrderBook book("BTC-EUR");
+	replay(state, book);
+}
+
+static void BM_OrderBook_Churn_PoolAllocator(benchmark::State& state) {
+	NodeArena arena(std::size_t{64} << 20);
+	PooledOrderBook book("BTC-EUR", PoolAllocator<PriceLevel>(arena));
+	replay(state, book);
+	state.counters["fallbacks"] = static_cast<double>(arena.fallbacks());
+}
+
+static void BM_OrderBook_Churn_PoolAllocatorHugePages(benchmark::State& state) {
+	NodeArena arena(std::size_t{64} << 20, true);
+	PooledOrderBook book("BTC-EUR", PoolAllocator<PriceLevel>(arena));
+	replay(state, book);
+	state.counters["hugetlb"] = arena.hugePages() ? 1 : 0;
+}
+
+static void BM_FlatOrderBook_Churn(benchmark::State& state) {
+	FlatOrderBook book("BTC-EUR");
+	replay(state, book);
+}
+
+// Top-80 publish cost once the book is warm: map walk vs contiguous copy.
+template<class Book>
+static void BM_Publish(benchmark::State& state) {
+	Book book("BTC-EUR");
+	const auto& stream = churnStream(false);
+	for (const auto& q : stream) book.update(q);
+	OrderBookView view(80);
+	for (auto _ : state) view.publish_from(book, 80);
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Args: {updates, touchHeavy}
+#define HFT_CHURN_ARGS ->Args({10'000'000, 0})->Args({10'000'000, 1})->Unit(benchmark::kMillisecond)
+BENCHMARK(BM_OrderBook_Churn_StdAllocator) HFT_CHURN_ARGS;
+BENCHMARK(BM_OrderBook_Churn_PoolAllocator) HFT_CHURN_ARGS;
+BENCHMARK(BM_OrderBook_Churn_PoolAllocatorHugePages) HFT_CHURN_ARGS;
+BENCHMARK(BM_FlatOrderBook_Churn) HFT_CHURN_ARGS;
+BENCHMARK(BM_Publish<OrderBook>);
+BENCHMARK(BM_Publish<FlatOrderBook>);
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "MatchingEngine.hpp"
+#include "OrderManager.hpp"
+#include "SimulatorWire.hpp"
+
+namespace {
+
+	const gateway::SymbolId kSymbol = gateway::internSymbol("BENCH-EUR");
+
+	OrderIntent newOrder(std::uint64_t id, double price) {
+		OrderIntent i;
+		i.symbol = kSymbol;
+		i.side = gateway::QuoteSide::Bid;
+		i.clientOrderId = id;
+		i.price = price;
+		i.qty = 1.0;
+		return i;
+	}
+
+	oms::ExecReport ack(std::uint64_t id, double price, oms::ExecType type, oms::OrdStatus status, std::uint64_t orig = 0) {
+		oms::ExecReport r;
+		r.execType = type;
+		r.ordStatus = status;
+		r.clOrdId = id;
+		r.origClOrdId = orig;
+		r.symbol = kSymbol;
+		r.price = price;
+		r.orderQty = 1.0;
+		r.leavesQty = type == oms::ExecType::Canceled ? 0.0 : 1.0;
+		return r;
+	}
+
+}
+
+// Full life of one order against a book of 1024 working ones: send, ack, cancel, cancel ack.
+static void BM_OrderManager_Lifecycle(benchmark::State& state) {
+	oms::OrderManager m(4096);
+	std::uint64_t id = 1;
+	for (int i = 0; i < 1024; ++i) m.onIntent(newOrder(id++, 100.0 - (i % 64) * 0.01));
+	for (auto _ : state) {
+		const auto order = id++;
+		const auto cancel = id++;
+		const double price = 100.0 - static_cast<double>(order % 64) * 0.01;
+		m.onIntent(newOrder(order, price));
+		m.apply(ack(order, price, oms::ExecType::New, oms::OrdStatus::New));
+		OrderIntent c = newOrder(cancel, price);
+		c.type = IntentType::Cancel;
+		c.origClientOrderId = order;
+		m.onIntent(c);
+		benchmark::DoNotOptimize(m.apply(ack(cancel, price, oms::ExecType::Canceled, oms::OrdStatus::Canceled, order)));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderManager_Lifecycle);
+
+static void BM_ParseExecReport(benchmark::State& state) {
+	sim::Execution e;
+	e.owner = 1;
+	e.execType = sim::ExecType::Trade;
+	e.ordStatus = sim::OrdStatus::PartiallyFilled;
+	e.orderId = 77;
+	e.execId = 1234;
+	e.clOrdId = 42;
+	e.symbol = kSymbol;
+	e.orderQty = 2.0;
+	e.price = 100.25;
+	e.lastQty = 0.5;
+	e.lastPx = 100.25;
+	e.leavesQty = 1.5;
+	e.cumQty = 0.5;
+	e.avgPx = 100.25;
+	std::string body;
+	const auto type = sim::appendExecution(body, e);
+	sim::FixFramer framer("VENUE", "CLIENT");
+	const std::string wire(framer.frame(type, body));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(oms::parseExecReport(wire));
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(wire.size()));
+}
+
+BENCHMARK(BM_ParseExecReport);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+
+#include "OrderSender.hpp"
+
+namespace {
+
+	struct DiscardTransport {
+		bool send(const std::string_view& msg) {
+			benchmark::DoNotOptimize(msg.data());
+			return true;
+		}
+	};
+
+	OrderIntent makeIntent(IntentType type) {
+		OrderIntent i;
+		i.type = type;
+		i.side = gateway::QuoteSide::Bid;
+		i.symbol = gateway::internSymbol("BTC-EUR");
+		i.clientOrderId = 1;
+		i.origClientOrderId = 1;
+		i.price = 50'000.0;
+		i.qty = 0.01;
+		return i;
+	}
+
+}
+
+// Intent to finished bytes; arg 0 is the IntentType.
+static void BM_OrderSender_Encode(benchmark::State& state) {
+	DiscardTransport wire;
+	OrderSender<DiscardTransport> sender(wire, fix::TemplateConfig{});
+	auto intent = makeIntent(static_cast<IntentType>(state.range(0)));
+	sender.addSymbol(intent.symbol);
+	const auto now = IntentClock::now();
+	for (auto _ : state) {
+		++intent.clientOrderId;
+		intent.price += 0.01;
+		benchmark::DoNotOptimize(sender.encode(intent, now));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_OrderSender_EncodeWithClock(benchmark::State& state) {
+	DiscardTransport wire;
+	OrderSender<DiscardTransport> sender(wire, fix::TemplateConfig{});
+	auto intent = makeIntent(IntentType::New);
+	sender.addSymbol(intent.symbol);
+	for (auto _ : state) {
+		++intent.clientOrderId;
+		benchmark::DoNotOptimize(sender.send(intent));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderSender_Encode)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_OrderSender_EncodeWithClock);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string_view>
+
+#include "OrderSender.hpp"
+#include "PreTradeRisk.hpp"
+
+namespace {
+
+	struct DiscardTransport {
+		bool send(const std::string_view& msg) {
+			benchmark::DoNotOptimize(msg.data());
+			return true;
+		}
+	};
+
+	OrderIntent makeIntent() {
+		OrderIntent i;
+		i.type = IntentType::New;
+		i.side = gateway::QuoteSide::Bid;
+		i.symbol = gateway::internSymbol("BTC-EUR");
+		i.clientOrderId = 1;
+		i.price = 50'000.0;
+		i.qty = 0.01;
+		i.decisionTs = IntentClock::now();
+		return i;
+	}
+
+}
+
+// All checks passing; the decision time advances 1 ms per order so the throttle never engages.
+static void BM_PreTradeRisk_Check(benchmark::State& state) {
+	PreTradeRisk risk({.maxOrdersPerSecond = 2'000.0});
+	auto intent = makeIntent();
+	risk.updateMid(intent.symbol, 50'000.0);
+	for (auto _ : state) {
+		intent.decisionTs += std::chrono::milliseconds(1);
+		const auto result = risk.check(intent);
+		risk.commit(intent, result);
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// Risk plus encoding, as a RiskGate in front of an OrderSender; compare with BM_OrderSender_Encode.
+static void BM_PreTradeRisk_GateAndEncode(benchmark::State& state) {
+	PreTradeRisk risk({.maxOrdersPerSecond = 2'000.0});
+	DiscardTransport wire;
+	OrderSender<DiscardTransport> sender(wire, fix::TemplateConfig{});
+	auto intent = makeIntent();
+	sender.addSymbol(intent.symbol);
+	risk.updateMid(intent.symbol, 50'000.0);
+	const auto now = IntentClock::now();
+	for (auto _ : state) {
+		intent.decisionTs += std::chrono::milliseconds(1);
+		++intent.clientOrderId;
+		const auto result = risk.check(intent);
+		if (!result.accepted()) continue;
+		benchmark::DoNotOptimize(sender.encode(intent, now));
+		risk.commit(intent, result);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PreTradeRisk_Check);
+BENCHMARK(BM_PreTradeRisk_GateAndEncode);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "MatchingEngine.hpp"
+
+namespace {
+
+	struct CountingListener {
+		std::uint64_t executions{0};
+		std::uint64_t levels{0};
+		void onExecution(const sim::Execution&) { ++executions; }
+		void onLevel(const sim::LevelUpdate&) { ++levels; }
+	};
+
+	// Pre-generated flow around 100.00: mostly passive orders within 20 ticks of the mid, about one
+	// in eight marketable, and a cancel for the order placed 64 requests earlier when still live.
+	std::vector<sim::OrderRequest> makeFlow(gateway::SymbolId symbol, std::size_t n) {
+		std::mt19937_64 rng(7);
+		std::uniform_int_distribution<int> ticks(0, 20);
+		std::uniform_int_distribution<int> kind(0, 7);
+		std::vector<sim::OrderRequest> out;
+		std::vector<std::uint64_t> placed;
+		out.reserve(n * 2);
+		placed.reserve(n);
+		std::uint64_t id = 1;
+		for (std::size_t i = 0; i < n; ++i) {
+			sim::OrderRequest r;
+			r.clOrdId = id++;
+			r.symbol = symbol;
+			r.side = rng() & 1 ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask;
+			const int away = kind(rng) == 0 ? -2 : ticks(rng) + 1;
+			r.price = r.side == gateway::QuoteSide::Bid ? 100.0 - away * 0.01 : 100.0 + away * 0.01;
+			r.qty = 1.0;
+			out.push_back(r);
+			placed.push_back(r.clOrdId);
+			if (i >= 64) {
+				sim::OrderRequest c;
+				c.msgType = 'F';
+				c.clOrdId = id++;
+				c.origClOrdId = placed[i - 64];
+				c.symbol = symbol;
+				out.push_back(c);
+			}
+		}
+		return out;
+	}
+
+}
+
+static void BM_MatchingEngine_Flow(benchmark::State& state) {
+	const auto symbol = gateway::internSymbol("BENCH-EUR");
+	const auto flow = makeFlow(symbol, 1 << 16);
+	for (auto _ : state) {
+		state.PauseTiming();
+		sim::MatchingEngine<CountingListener> engine(CountingListener{}, 1 << 17);
+		engine.addSymbol(symbol);
+		state.ResumeTiming();
+		for (const auto& r : flow) engine.submit(r);
+		benchmark::DoNotOptimize(engine.listener().executions);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(flow.size()));
+}
+
+BENCHMARK(BM_MatchingEngine_Flow)->Unit(benchmark::kMillisecond);
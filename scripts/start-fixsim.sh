@@ -1,23 +1,29 @@
 #!/usr/bin/env bash
 # start-fixsim.sh
 
-# Use existing VM_IP or grab it from Multipass
-VM_IP="${VM_IP:-$(multipass list | grep '\bhft-vm\b' | tr -s ' ' | cut -d ' ' -f3)}"
-[ -z "$VM_IP" ] && { echo "❌ VM_IP not set and multipass query failed"; exit 1; }
+# Runs the in-repo FixSim matching engine in the background; no VM or SSH needed.
+# FIXSIM_BIN, FIXSIM_PORT and FIXSIM_SYMBOLS override the defaults.
 
-echo "🚀 Starting FIXSIM servers on VM at $VM_IP"
+set -euo pipefail
 
-ssh -o StrictHostKeyChecking=no ubuntu@"$VM_IP" <<'EOF'
-  echo "🛑 Killing existing FIXSIM servers…"
-  pkill -f fixsim-server.py || true
+BUILD_DIR="${BUILD_DIR:-build}"
+FIXSIM_BIN="${FIXSIM_BIN:-${BUILD_DIR}/FixSim}"
+FIXSIM_PORT="${FIXSIM_PORT:-9876}"
+FIXSIM_SYMBOLS="${FIXSIM_SYMBOLS:-EUR/USD BTC-EUR}"
+PID_FILE="${PID_FILE:-/tmp/fixsim.pid}"
+LOG_FILE="${LOG_FILE:-/tmp/fixsim.log}"
 
-  echo "🧹 Cleaning old config/log dirs…"
-  rm -rf /home/ubuntu/FIX-Simulator/fixsim_instances
+[ -x "$FIXSIM_BIN" ] || { echo "❌ $FIXSIM_BIN not found, build the FixSim target first"; exit 1; }
 
-  echo "🔧 Spawning new FIXSIM servers…"
-  cd /home/ubuntu/FIX-Simulator
-  chmod +x ./spawn_servers.sh
-  ./spawn_servers.sh
+echo "🛑 Stopping existing FixSim…"
+if [ -f "$PID_FILE" ]; then
+  kill "$(cat "$PID_FILE")" 2>/dev/null || true
+  rm -f "$PID_FILE"
+fi
 
-  echo "✅ FIXSIM servers launched."
-EOF
+echo "🚀 Starting FixSim on port ${FIXSIM_PORT}…"
+# shellcheck disable=SC2086
+nohup "$FIXSIM_BIN" "$FIXSIM_PORT" $FIXSIM_SYMBOLS >"$LOG_FILE" 2>&1 &
+echo $! >"$PID_FILE"
+
+echo "✅ FixSim running (pid $(cat "$PID_FILE"), log $LOG_FILE)."
@@ -1,14 +1,13 @@
 #!/usr/bin/env bash
-# stop-fixsim-ssh.sh
+# stop-fixsim.sh
 
-# 1) VM IP from your env or hardcode it
-VM_IP=${VM_IP:-1.2.3.4}
+PID_FILE="${PID_FILE:-/tmp/fixsim.pid}"
 
-# 2) Kill servers and clean up
-ssh ubuntu@"$VM_IP" <<'EOF'
-  echo "🛑 Stopping FIXSIM servers…"
-  pkill -f fixsim-server.py || true
-  echo "🧹 Removing old fixsim_instances directory…"
-  rm -rf /home/ubuntu/FIX-Simulator/fixsim_instances
-  echo "✅ Cleanup complete."
-EOF
+if [ -f "$PID_FILE" ]; then
+  echo "🛑 Stopping FixSim…"
+  kill "$(cat "$PID_FILE")" 2>/dev/null || true
+  rm -f "$PID_FILE"
+  echo "✅ FixSim stopped."
+else
+  echo "ℹ️  No FixSim pid file at $PID_FILE"
+fi
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "BitvavoBookParser.hpp"
+#include "FeedJournal.hpp"
+#include "FixBookParser.hpp"
+#include "LatencyModel.hpp"
+#include "MarketMaker.hpp"
+#include "MatchingEngine.hpp"
+#include "OrderManager.hpp"
+#include "PreTradeRisk.hpp"
+#include "QuoteConsumer.hpp"
+#include "QuotesObtainer.hpp"
+#include "ReplayClient.hpp"
+
+namespace backtest {
+
+	struct BacktestConfig {
+		LatencyModel latency;
+		MarketMakerParams strategy;
+		RiskLimits risk;
+	};
+
+	struct MarketResult {
+		std::string symbol;
+		std::uint64_t fills{0};
+		double volume{0.0};
+		double position{0.0};
+		double cash{0.0};
+		double mark{std::numeric_limits<double>::quiet_NaN()};   // last mid of the strategy's book
+		[[nodiscard]] double pnl() const { return std::isfinite(mark) ? cash + position * mark : cash; }
+	};
+
+	struct BacktestResult {
+		std::string journal;
+		bool ok{false};
+		std::uint64_t frames{0};
+		std::uint64_t quotes{0};          // applied to the strategy's books
+		std::uint64_t decisions{0};
+		std::uint64_t orders{0};          // reached the venue
+		std::uint64_t riskRejects{0};
+		std::uint64_t omsRefusals{0};     // passed risk, refused by the OrderManager
+		std::uint64_t venueRejects{0};
+		std::uint64_t simulatedNs{0};     // first to last journal frame
+		double wallSeconds{0.0};
+		std::vector<MarketResult> markets;
+	};
+
+	// Our session on the simulated venue; everything else in its books is replayed market data.
+	inline constexpr sim::OwnerId kStrategyOwner = 1;
+
+	// Replays one journal on the calling thread. The frames go through the live code path, a
+	// QuotesObtainer over a ReplayClient, a QuoteConsumer and a MarketMaker behind PreTradeRisk and the
+	// OrderManager, while a MatchingEngine plays the venue: each frame's levels become resting house
+	// orders at the frame's receive time, so strategy orders fill against the recorded book, and
+	// recorded levels that cross a resting strategy order trade with it. The LatencyModel delays the
+	// three paths between strategy and venue; all times come from the journal, so a run is
+	// deterministic and as fast as the CPU.
+	template<journal::Wire W>
+	class Backtest {
+	public:
+		using Client = ReplayClient<W>;
+
+		// Strategy sink: the order path to the venue, which is also the strategy's clock.
+		struct OrderPath {
+			Backtest* owner;
+			void operator()(const OrderIntent& intent) { owner->sendOrder(intent); }
+			[[nodiscard]] IntentClock::time_point now() const { return journal::fromNs(owner->nowNs_); }
+		};
+
+		struct VenueListener {
+			Backtest* owner;
+			void onExecution(const sim::Execution& e) { owner->onVenueExecution(e); }
+			void onLevel(const sim::LevelUpdate&) {}
+		};
+
+		using Strategy = MarketMaker<RiskGate<oms::OmsGate<OrderPath>>>;
+
+		Backtest(const JournalFile& file, const BacktestConfig& config)
+			: file_(file)
+			, obtainer_(client_, "replay", "0", file.markets())
+			, consumer_(std::tie(obtainer_), file.markets())
+			, risk_(config.risk)
+			, strategy_(config.strategy, RiskGate<oms::OmsGate<OrderPath>>(risk_, oms::OmsGate<OrderPath>(oms_, OrderPath{this})))
+			, venue_(VenueListener{this})
+			, marketData_(config.latency.marketData, config.latency.seed)
+			, orderLink_(config.latency.order, config.latency.seed + 1)
+			, reportLink_(config.latency.report, config.latency.seed + 2) {
+			for (const auto& m : file.markets()) {
+				const auto id = gateway::internSymbol(m);
+				venue_.addSymbol(id);
+				MarketResult r;
+				r.symbol = m;
+				results_.emplace(id, std::move(r));
+			}
+		}
+
+		Backtest(const Backtest&) = delete;
+		Backtest& operator=(const Backtest&) = delete;
+
+		BacktestResult run() {
+			const auto wallStart = std::chrono::steady_clock::now();
+			BacktestResult result;
+			result.ok = true;
+
+			std::size_t cursor = file_.begin();
+			journal::Frame frame{};
+			bool more = file_.next(cursor, frame);
+			const std::uint64_t firstNs = more ? frame.recvNs : 0;
+			std::uint64_t lastNs = firstNs;
+
+			// Merge the journal with the three links by time. At equal times the venue sees market data
+			// first, then orders, then reports go out, then the strategy sees market data.
+			while (true) {
+				const std::uint64_t next = std::min({head(orders_), head(reports_), head(feed_)});
+				if (more && frame.recvNs <= next) {
+					nowNs_ = frame.recvNs;
+					lastNs = frame.recvNs;
+					mirror(frame.bytes);
+					feed_.push_back({marketData_.arrival(frame.recvNs), frame.bytes});
+					++result.frames;
+					more = file_.next(cursor, frame);
+					continue;
+				}
+				if (next == kNever) break;
+				nowNs_ = next;
+				if (head(orders_) == next) {
+					venue_.submit(orders_.front().request);
+					orders_.pop_front();
+				} else if (head(reports_) == next) {
+					onReport(reports_.front().execution);
+					reports_.pop_front();
+				} else {
+					client_.deliver(journal::Frame{next, feed_.front().bytes});
+					feed_.pop_front();
+					result.quotes += consumer_.poll(strategy_);
+				}
+			}
+
+			result.decisions = strategy_.decisions();
+			result.orders = orderCount_;
+			result.venueRejects = venueRejects_;
+			for (std::size_t r = 1; r < static_cast<std::size_t>(RiskReject::Count); ++r) {
+				result.riskRejects += risk_.rejects(static_cast<RiskReject>(r));
+			}
+			result.omsRefusals = oms_.refusedIntents();
+			result.simulatedNs = lastNs - firstNs;
+			for (std::size_t i = 0; i < consumer_.bookCount(); ++i) {
+				const auto& book = consumer_.getOrderBook(i);
+				auto& m = results_.at(book.symbolId());
+				m.position = strategy_.position(book.symbolId());
+				const double bid = book.bestBid();
+				const double ask = book.bestAsk();
+				if (bid > 0.0 && ask > 0.0) m.mark = 0.5 * (bid + ask);
+				result.markets.push_back(m);
+			}
+			result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+			return result;
+		}
+
+		[[nodiscard]] const Strategy& strategy() const noexcept { return strategy_; }
+		[[nodiscard]] const sim::MatchingEngine<VenueListener>& venue() const noexcept { return venue_; }
+		[[nodiscard]] const oms::OrderManager& orders() const noexcept { return oms_; }
+
+	private:
+		static constexpr std::uint64_t kNever = std::numeric_limits<std::uint64_t>::max();
+
+		struct PendingFrame { std::uint64_t at; std::string_view bytes; };
+		struct PendingOrder { std::uint64_t at; sim::OrderRequest request; };
+		struct PendingReport { std::uint64_t at; sim::Execution execution; };
+
+		struct LevelKey {
+			gateway::SymbolId symbol;
+			gateway::QuoteSide side;
+			double price;
+			bool operator==(const LevelKey&) const = default;
+		};
+		struct LevelKeyHash {
+			std::size_t operator()(const LevelKey& k) const noexcept {
+				return std::hash<double>{}(k.price) ^ (std::size_t{k.symbol} << 1) ^ static_cast<std::size_t>(k.side);
+			}
+		};
+
+		template<class Queue>
+		static std::uint64_t head(const Queue& q) noexcept { return q.empty() ? kNever : q.front().at; }
+
+		void sendOrder(const OrderIntent& intent) {
+			sim::OrderRequest req;
+			req.msgType = intent.type == IntentType::New ? 'D' : intent.type == IntentType::Replace ? 'G' : 'F';
+			req.owner = kStrategyOwner;
+			req.clOrdId = intent.clientOrderId;
+			req.origClOrdId = intent.origClientOrderId;
+			req.symbol = intent.symbol;
+			req.side = intent.side;
+			req.price = intent.price;
+			req.qty = intent.qty;
+			orders_.push_back({orderLink_.arrival(nowNs_), req});
+			++orderCount_;
+		}
+
+		void onVenueExecution(const sim::Execution& e) {
+			if (e.owner != kStrategyOwner) return;
+			reports_.push_back({reportLink_.arrival(nowNs_), e});
+		}
+
+		void onReport(const sim::Execution& e) {
+			oms_.apply(toExecReport(e));
+			if (e.execType == sim::ExecType::Trade) {
+				strategy_.onFill(e.symbol, e.side, e.lastQty);
+				risk_.onFill(e.symbol, e.side, e.lastQty);
+				auto& m = results_.at(e.symbol);
+				++m.fills;
+				m.volume += e.lastQty;
+				m.cash += e.side == gateway::QuoteSide::Bid ? -e.lastQty * e.lastPx : e.lastQty * e.lastPx;
+			} else if (e.execType == sim::ExecType::Rejected) {
+				++venueRejects_;
+			}
+			if (e.ordStatus == sim::OrdStatus::Filled || e.ordStatus == sim::OrdStatus::Canceled ||
+				e.ordStatus == sim::OrdStatus::Rejected) {
+				strategy_.onOrderDone(e.symbol, e.clOrdId);
+				if (e.origClOrdId) strategy_.onOrderDone(e.symbol, e.origClOrdId);
+			}
+		}
+
+		// The venue's execution as the OrderManager sees a decoded 35=8 or 35=9; both use the FIX codes.
+		static oms::ExecReport toExecReport(const sim::Execution& e) noexcept {
+			oms::ExecReport r;
+			r.msgType = e.cancelReject ? '9' : '8';
+			r.execType = static_cast<oms::ExecType>(static_cast<char>(e.execType));
+			r.ordStatus = static_cast<oms::OrdStatus>(static_cast<char>(e.ordStatus));
+			if (e.cancelReject) r.cxlRejResponseTo = e.requestType == 'G' ? '2' : '1';
+			r.clOrdId = e.clOrdId;
+			r.origClOrdId = e.origClOrdId;
+			r.orderId = e.orderId;
+			r.symbol = e.symbol;
+			r.side = e.side;
+			r.orderQty = e.orderQty;
+			r.price = e.price;
+			r.lastQty = e.lastQty;
+			r.lastPx = e.lastPx;
+			r.leavesQty = e.leavesQty;
+			r.cumQty = e.cumQty;
+			r.avgPx = e.avgPx;
+			return r;
+		}
+
+		// Applies one recorded frame to the venue's book as house liquidity: each level's resting house
+		// order is replaced by one of the recorded size. Removals go first so a moving book does not
+		// cross itself; a getBook snapshot clears the symbol's house orders before placing its levels.
+		void mirror(std::string_view bytes) {
+			levels_.clear();
+			if constexpr (W == journal::Wire::Bitvavo) {
+				const bool snapshot = bitvavo::isBookSnapshot(bytes);
+				if (!snapshot && !bitvavo::isBookUpdate(bytes)) return;
+				auto market = bitvavo::extractMarket(bytes);
+				if (market.empty() && file_.markets().size() == 1) market = file_.markets().front();
+				const auto symbol = gateway::SymbolTable::instance().find(market);
+				if (!symbol || !results_.count(*symbol)) return;
+				if (!bitvavo::parseBookLevels(bytes, *symbol, [this](const gateway::Quote& q) { levels_.push_back(q); })) return;
+				if (snapshot) clearHouse(*symbol);
+			} else {
+				const auto quote = fix::parseAndStoreQuote(bytes);
+				if (!quote || !results_.count(quote->getSymbolId())) return;
+				levels_.push_back(*quote);
+			}
+			for (const auto& q : levels_) {
+				if (q.getSize() <= 0.0) setHouseLevel(q);
+			}
+			for (const auto& q : levels_) {
+				if (q.getSize() > 0.0) setHouseLevel(q);
+			}
+		}
+
+		void setHouseLevel(const gateway::Quote& q) {
+			const LevelKey key{q.getSymbolId(), q.getSide(), q.getPrice()};
+			if (const auto it = house_.find(key); it != house_.end()) {
+				sim::OrderRequest cancel;
+				cancel.msgType = 'F';
+				cancel.owner = sim::kHouse;
+				cancel.clOrdId = nextHouseId_++;
+				cancel.origClOrdId = it->second;
+				cancel.symbol = key.symbol;
+				venue_.cancel(cancel);   // a level the strategy traded away is simply not found
+				house_.erase(it);
+			}
+			if (q.getSize() <= 0.0) return;
+			sim::OrderRequest place;
+			place.owner = sim::kHouse;
+			place.clOrdId = nextHouseId_++;
+			place.symbol = key.symbol;
+			place.side = key.side;
+			place.price = key.price;
+			place.qty = q.getSize();
+			venue_.newOrder(place);
+			house_.emplace(key, place.clOrdId);
+		}
+
+		void clearHouse(gateway::SymbolId symbol) {
+			for (auto it = house_.begin(); it != house_.end();) {
+				if (it->first.symbol != symbol) {
+					++it;
+					continue;
+				}
+				sim::OrderRequest cancel;
+				cancel.msgType = 'F';
+				cancel.owner = sim::kHouse;
+				cancel.clOrdId = nextHouseId_++;
+				cancel.origClOrdId = it->second;
+				cancel.symbol = symbol;
+				venue_.cancel(cancel);
+				it = house_.erase(it);
+			}
+		}
+
+		const JournalFile& file_;
+		Client client_;
+		gateway::QuotesObtainer<Client> obtainer_;
+		QuoteConsumer<Client> consumer_;
+		PreTradeRisk risk_;
+		oms::OrderManager oms_;
+		Strategy strategy_;
+		sim::MatchingEngine<VenueListener> venue_;
+
+		Link marketData_;
+		Link orderLink_;
+		Link reportLink_;
+		std::deque<PendingFrame> feed_;
+		std::deque<PendingOrder> orders_;
+		std::deque<PendingReport> reports_;
+		std::uint64_t nowNs_{0};
+
+		std::unordered_map<LevelKey, std::uint64_t, LevelKeyHash> house_;
+		std::vector<gateway::Quote> levels_;
+		std::uint64_t nextHouseId_{sim::kHouseIdBase};
+		std::unordered_map<gateway::SymbolId, MarketResult> results_;
+		std::uint64_t orderCount_{0};
+		std::uint64_t venueRejects_{0};
+	};
+
+	// Opens path and replays it with the Backtest matching its wire format.
+	BacktestResult runJournal(const std::string& path, const BacktestConfig& config);
+
+	// Replays every journal, up to threads at a time (0: one per core). Each run is independent and
+	// single-threaded, so days or instruments captured to separate journals scale across cores.
+	// Results come back in the order of paths.
+	std::vector<BacktestResult> runJournals(const std::vector<std::string>& paths, const BacktestConfig& config,
+	                                        unsigned threads = 0);
+
+}
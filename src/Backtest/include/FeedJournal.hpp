@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Raw market-data capture: every frame a feed connection delivered, with its receive time, in arrival
+// order. Native endianness, every block 8-byte aligned:
+//   FileHeader, the market names joined by '\n' and padded to 8 bytes,
+//   then per frame a RecordHeader and the frame bytes padded to 8.
+// Records are appended as they arrive and never rewritten, so a capture cut short by a crash is still
+// readable up to its last complete record.
+namespace journal {
+
+	inline constexpr char kMagic[8] = {'H', 'F', 'T', 'F', 'E', 'E', 'D', '1'};
+	inline constexpr std::uint32_t kVersion = 1;
+
+	// Decides which parser the frames go through on replay.
+	enum class Wire : std::uint8_t { Bitvavo, Fix };
+
+	struct FileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t wire;
+		std::uint8_t reserved[3];
+		std::uint32_t marketCount;
+		std::uint32_t marketBytes;
+		std::uint64_t createdNs;   // system_clock
+	};
+
+	struct RecordHeader {
+		std::uint64_t recvNs;      // system_clock nanoseconds when the frame was handed to the parser
+		std::uint32_t length;
+		std::uint32_t reserved;
+	};
+
+	struct Frame {
+		std::uint64_t recvNs;
+		std::string_view bytes;
+	};
+
+	inline std::uint64_t toNs(std::chrono::system_clock::time_point t) noexcept {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+	}
+
+	inline std::chrono::system_clock::time_point fromNs(std::uint64_t ns) noexcept {
+		return std::chrono::system_clock::time_point(
+			std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+	}
+
+}
+
+// Appends frames to a journal file through a large stdio buffer. Called from the receive thread;
+// a write only reaches the kernel when the buffer fills.
+class JournalWriter {
+public:
+	JournalWriter() = default;
+	~JournalWriter() { close(); }
+
+	JournalWriter(const JournalWriter&) = delete;
+	JournalWriter& operator=(const JournalWriter&) = delete;
+
+	bool open(const std::string& path, journal::Wire wire, const std::vector<std::string>& markets);
+	void append(std::string_view frame, std::chrono::system_clock::time_point recv = std::chrono::system_clock::now());
+	void flush();
+	void close();
+
+	[[nodiscard]] bool isOpen() const noexcept { return file_ != nullptr; }
+	[[nodiscard]] std::uint64_t frames() const noexcept { return frames_; }
+	[[nodiscard]] std::uint64_t failures() const noexcept { return failures_; }
+
+private:
+	std::FILE* file_{nullptr};
+	std::vector<char> buffer_;
+	std::uint64_t frames_{0};
+	std::uint64_t failures_{0};
+};
+
+// Read-only, memory-mapped journal. open() validates the header; frames are then walked in place
+// with next(), which stops at the end of the file or at a truncated trailing record.
+class JournalFile {
+public:
+	JournalFile() = default;
+	~JournalFile() { close(); }
+
+	JournalFile(const JournalFile&) = delete;
+	JournalFile& operator=(const JournalFile&) = delete;
+
+	bool open(const std::string& path);
+	void close() noexcept;
+
+	[[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr; }
+	[[nodiscard]] journal::Wire wire() const noexcept { return wire_; }
+	[[nodiscard]] const std::vector<std::string>& markets() const noexcept { return markets_; }
+	[[nodiscard]] std::size_t bytes() const noexcept { return size_; }
+
+	// Cursor over the frames; start from begin().
+	[[nodiscard]] std::size_t begin() const noexcept { return firstRecord_; }
+	bool next(std::size_t& cursor, journal::Frame& out) const noexcept;
+
+private:
+	const std::byte* data_{nullptr};
+	std::size_t size_{0};
+	bool mapped_{false};
+	std::vector<std::byte> owned_;   // fallback when the file cannot be mapped
+	journal::Wire wire_{journal::Wire::Bitvavo};
+	std::vector<std::string> markets_;
+	std::size_t firstRecord_{0};
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace backtest {
+
+	// One-way delay of a path: base plus a uniform extra in [0, jitter].
+	struct LatencyPath {
+		std::chrono::nanoseconds base{0};
+		std::chrono::nanoseconds jitter{0};
+	};
+
+	// Simulated delays around the venue. The venue sees each journal frame at its recorded receive
+	// time; the strategy sees it marketData later. Orders reach the venue after order, execution
+	// reports come back after report.
+	struct LatencyModel {
+		LatencyPath marketData{std::chrono::microseconds(20), std::chrono::microseconds(10)};
+		LatencyPath order{std::chrono::microseconds(50), std::chrono::microseconds(20)};
+		LatencyPath report{std::chrono::microseconds(50), std::chrono::microseconds(20)};
+		std::uint64_t seed{1};
+	};
+
+	// Delivery times over one path. Like the TCP connection it stands for, a link never reorders:
+	// a message sent after another arrives no earlier than it, whatever the jitter draws.
+	class Link {
+	public:
+		Link(LatencyPath path, std::uint64_t seed)
+			: base_(path.base.count())
+			, jitter_(0, std::max<std::int64_t>(0, path.jitter.count()))
+			, rng_(seed) {}
+
+		std::uint64_t arrival(std::uint64_t sentNs) {
+			const auto delay = static_cast<std::uint64_t>(std::max<std::int64_t>(0, base_ + jitter_(rng_)));
+			last_ = std::max(last_, sentNs + delay);
+			return last_;
+		}
+
+	private:
+		std::int64_t base_;
+		std::uniform_int_distribution<std::int64_t> jitter_;
+		std::mt19937_64 rng_;
+		std::uint64_t last_{0};
+	};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "FeedJournal.hpp"
+#include "Wire.hpp"
+
+// Stand-in network client for QuotesObtainer that delivers journal frames on the caller's thread.
+// The obtainer picks its parser from kWire, so W must match the journal's wire format.
+// receiveTime() lets the obtainer stamp quotes with the frame's
+// simulated receive time instead of the wall clock.
+template<journal::Wire W>
+class ReplayClient {
+public:
+	using MessageHandler = std::function<void(std::string_view)>;
+	using ErrorHandler = std::function<void(std::string_view)>;
+	static constexpr gateway::Wire kWire = W == journal::Wire::Bitvavo ? gateway::Wire::Bitvavo : gateway::Wire::Fix;
+
+	bool connect(const std::string&, const std::string&) { return true; }
+	void disconnect() {}
+
+	// Requests the obtainer would put on the wire; a recorded feed cannot answer them.
+	void send(const std::string&) requires (W == journal::Wire::Bitvavo) { ++requests_; }
+
+	void setMessageHandler(MessageHandler handler) { onMessage_ = std::move(handler); }
+	void setErrorHandler(ErrorHandler handler) { onError_ = std::move(handler); }
+
+	void deliver(const journal::Frame& frame) {
+		now_ = journal::fromNs(frame.recvNs);
+		if (onMessage_) onMessage_(frame.bytes);
+	}
+
+	[[nodiscard]] std::chrono::system_clock::time_point receiveTime() const noexcept { return now_; }
+	[[nodiscard]] std::uint64_t requests() const noexcept { return requests_; }
+
+private:
+	MessageHandler onMessage_;
+	ErrorHandler onError_;
+	std::chrono::system_clock::time_point now_{};
+	std::uint64_t requests_{0};
+};
@@ -0,0 +1,56 @@
+#include "Backtester.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace backtest {
+
+	namespace {
+
+		template<journal::Wire W>
+		BacktestResult replay(const JournalFile& file, const BacktestConfig& config) {
+			// Books, queues and the venue are too large for a thread's stack.
+			auto run = std::make_unique<Backtest<W>>(file, config);
+			return run->run();
+		}
+
+	}
+
+	BacktestResult runJournal(const std::string& path, const BacktestConfig& config) {
+		JournalFile file;
+		if (!file.open(path)) {
+			std::cerr << "Backtest: cannot open journal " << path << "\n";
+			BacktestResult failed;
+			failed.journal = path;
+			return failed;
+		}
+		auto result = file.wire() == journal::Wire::Fix ? replay<journal::Wire::Fix>(file, config)
+		                                                 : replay<journal::Wire::Bitvavo>(file, config);
+		result.journal = path;
+		return result;
+	}
+
+	std::vector<BacktestResult> runJournals(const std::vector<std::string>& paths, const BacktestConfig& config,
+	                                        unsigned threads) {
+		std::vector<BacktestResult> results(paths.size());
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+		threads = static_cast<unsigned>(std::min<std::size_t>(threads, paths.size()));
+
+		std::atomic<std::size_t> next{0};
+		const auto work = [&] {
+			for (std::size_t i = next.fetch_add(1); i < paths.size(); i = next.fetch_add(1)) {
+				results[i] = runJournal(paths[i], config);
+			}
+		};
+		std::vector<std::thread> workers;
+		workers.reserve(threads);
+		for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work);
+		work();
+		for (auto& w : workers) w.join();
+		return results;
+	}
+
+}
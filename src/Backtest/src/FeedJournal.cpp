@@ -0,0 +1,163 @@
+#include "FeedJournal.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+
+	constexpr std::size_t pad8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+	constexpr char kPadding[8] = {};
+	constexpr std::size_t kWriteBuffer = 1 << 20;
+
+}
+
+bool JournalWriter::open(const std::string& path, journal::Wire wire, const std::vector<std::string>& markets) {
+	using namespace journal;
+	close();
+	file_ = std::fopen(path.c_str(), "wb");
+	if (!file_) {
+		std::cerr << "Journal: cannot open " << path << "\n";
+		return false;
+	}
+	buffer_.resize(kWriteBuffer);
+	std::setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+
+	std::string names;
+	for (const auto& m : markets) {
+		if (!names.empty()) names += '\n';
+		names += m;
+	}
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.wire = static_cast<std::uint8_t>(wire);
+	header.marketCount = static_cast<std::uint32_t>(markets.size());
+	header.marketBytes = static_cast<std::uint32_t>(names.size());
+	header.createdNs = toNs(std::chrono::system_clock::now());
+
+	const bool ok = std::fwrite(&header, sizeof(header), 1, file_) == 1 &&
+					std::fwrite(names.data(), 1, names.size(), file_) == names.size() &&
+					std::fwrite(kPadding, 1, pad8(names.size()) - names.size(), file_) == pad8(names.size()) - names.size();
+	if (!ok) {
+		std::cerr << "Journal: cannot write header to " << path << "\n";
+		close();
+		return false;
+	}
+	frames_ = 0;
+	failures_ = 0;
+	return true;
+}
+
+void JournalWriter::append(std::string_view frame, std::chrono::system_clock::time_point recv) {
+	if (!file_) return;
+	const journal::RecordHeader rh{journal::toNs(recv), static_cast<std::uint32_t>(frame.size()), 0};
+	const std::size_t pad = pad8(frame.size()) - frame.size();
+	const bool ok = std::fwrite(&rh, sizeof(rh), 1, file_) == 1 &&
+					std::fwrite(frame.data(), 1, frame.size(), file_) == frame.size() &&
+					std::fwrite(kPadding, 1, pad, file_) == pad;
+	if (ok) ++frames_;
+	else ++failures_;
+}
+
+void JournalWriter::flush() {
+	if (file_) std::fflush(file_);
+}
+
+void JournalWriter::close() {
+	if (!file_) return;
+	std::fclose(file_);
+	file_ = nullptr;
+	buffer_.clear();
+	buffer_.shrink_to_fit();
+}
+
+bool JournalFile::open(const std::string& path) {
+	using namespace journal;
+	close();
+
+#if defined(__unix__) || defined(__APPLE__)
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st{};
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+			data_ = static_cast<const std::byte*>(p);
+			size_ = static_cast<std::size_t>(st.st_size);
+			mapped_ = true;
+		}
+	}
+	::close(fd);
+#endif
+	if (!data_) {
+		std::ifstream f(path, std::ios::binary);
+		if (!f) return false;
+		std::vector<char> raw((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+		owned_.resize(raw.size());
+		std::memcpy(owned_.data(), raw.data(), raw.size());
+		data_ = owned_.data();
+		size_ = owned_.size();
+	}
+
+	auto fail = [&](const char* why) {
+		std::cerr << "Journal: " << path << " " << why << "\n";
+		close();
+		return false;
+	};
+
+	FileHeader header{};
+	if (size_ < sizeof(header)) return fail("is truncated");
+	std::memcpy(&header, data_, sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return fail("is not a feed journal");
+	if (header.version != kVersion) return fail("has an unsupported version");
+	if (header.wire > static_cast<std::uint8_t>(Wire::Fix)) return fail("has an unknown wire format");
+	if (size_ - sizeof(header) < pad8(header.marketBytes)) return fail("is truncated");
+
+	const std::string_view names(reinterpret_cast<const char*>(data_ + sizeof(header)), header.marketBytes);
+	std::size_t start = 0;
+	while (start < names.size()) {
+		auto end = names.find('\n', start);
+		if (end == std::string_view::npos) end = names.size();
+		markets_.emplace_back(names.substr(start, end - start));
+		start = end + 1;
+	}
+	if (markets_.size() != header.marketCount) return fail("has a corrupt market list");
+
+	wire_ = static_cast<Wire>(header.wire);
+	firstRecord_ = sizeof(header) + pad8(header.marketBytes);
+	return true;
+}
+
+bool JournalFile::next(std::size_t& cursor, journal::Frame& out) const noexcept {
+	journal::RecordHeader rh{};
+	if (cursor >= size_ || size_ - cursor < sizeof(rh)) return false;
+	std::memcpy(&rh, data_ + cursor, sizeof(rh));
+	const std::size_t body = cursor + sizeof(rh);
+	if (size_ - body < rh.length) return false;
+	out.recvNs = rh.recvNs;
+	out.bytes = std::string_view(reinterpret_cast<const char*>(data_ + body), rh.length);
+	cursor = body + pad8(rh.length);
+	return true;
+}
+
+void JournalFile::close() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+	if (mapped_) ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+	mapped_ = false;
+	owned_.clear();
+	markets_.clear();
+	firstRecord_ = 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Quote.hpp"
+
+namespace gateway {
+
+	// Full book as returned by a getBook request; levels carry the snapshot nonce as their sequence.
+	struct BookSnapshot {
+		SymbolId symbol{};
+		std::uint64_t sequence{};
+		std::vector<Quote> levels;
+	};
+
+	// Tracks nonce continuity of one market's book channel. On a gap, updates are buffered until
+	// onSnapshot() hands them back for replay on top of the fresh book. A snapshot that has not come
+	// back within the timeout, e.g. because the request was answered with an error, is asked for again.
+	// Runs on the gateway receive thread only.
+	class BookSync {
+	public:
+		using Clock = std::chrono::steady_clock;
+		enum class Action { Apply, Drop, Buffer, RequestSnapshot };
+
+		explicit BookSync(std::size_t maxPending = 65536, std::chrono::milliseconds snapshotTimeout = std::chrono::seconds(2))
+			: maxPending_(maxPending), snapshotTimeout_(snapshotTimeout) {}
+
+		void setSnapshotTimeout(std::chrono::milliseconds timeout) noexcept { snapshotTimeout_ = timeout; }
+
+		Action onUpdate(std::string_view frame, std::uint64_t nonce) {
+			if (resyncing_) {
+				buffer(frame);
+				return Action::Buffer;
+			}
+			if (nonce == 0 || last_ == 0 || nonce == last_ + 1) {
+				if (nonce != 0) last_ = nonce;
+				return Action::Apply;
+			}
+			if (nonce <= last_) {
+				++dropped_;
+				return Action::Drop;
+			}
+
+			++gaps_;
+			++resyncs_;
+			resyncing_ = true;
+			buffer(frame);
+			return Action::RequestSnapshot;
+		}
+
+		// Returns the frames received while resyncing, oldest first. They must be fed back through
+		// onUpdate() so stale ones are dropped and a gap inside them triggers another resync.
+		std::deque<std::string> onSnapshot(std::uint64_t nonce) {
+			resyncing_ = false;
+			last_ = nonce;
+			std::deque<std::string> replay;
+			replay.swap(pending_);
+			return replay;
+		}
+
+		// Starts a resync asked for from outside, e.g. by a book that failed its integrity checks. Updates are
+		// buffered exactly as after a gap. Returns false if a resync is already in progress.
+		bool beginResync() {
+			if (resyncing_) return false;
+			resyncing_ = true;
+			++resyncs_;
+			return true;
+		}
+
+		// Starts the deadline of the snapshot request just sent.
+		void snapshotRequested(Clock::time_point now) noexcept { deadline_ = now + snapshotTimeout_; }
+
+		// True once a resync has waited past its deadline; the caller sends the request again. Re-arms
+		// the deadline, so a feed that keeps failing is asked once per timeout.
+		bool snapshotOverdue(Clock::time_point now) noexcept {
+			if (!resyncing_ || now < deadline_) return false;
+			deadline_ = now + snapshotTimeout_;
+			++retries_;
+			return true;
+		}
+
+		[[nodiscard]] bool resyncing() const noexcept { return resyncing_; }
+		[[nodiscard]] std::uint64_t lastNonce() const noexcept { return last_; }
+		[[nodiscard]] std::uint64_t gaps() const noexcept { return gaps_; }
+		[[nodiscard]] std::uint64_t resyncs() const noexcept { return resyncs_; }
+		[[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_; }
+		[[nodiscard]] std::uint64_t retries() const noexcept { return retries_; }
+		[[nodiscard]] std::size_t pending() const noexcept { return pending_.size(); }
+
+	private:
+		void buffer(std::string_view frame) {
+			if (pending_.size() >= maxPending_) {
+				pending_.pop_front();
+				++dropped_;
+			}
+			pending_.emplace_back(frame);
+		}
+
+		std::uint64_t last_{0};
+		bool resyncing_{false};
+		std::deque<std::string> pending_;
+		std::size_t maxPending_;
+		std::chrono::milliseconds snapshotTimeout_;
+		Clock::time_point deadline_{};
+
+		std::uint64_t gaps_{0};
+		std::uint64_t resyncs_{0};
+		std::uint64_t dropped_{0};
+		std::uint64_t retries_{0};
+	};
+
+}
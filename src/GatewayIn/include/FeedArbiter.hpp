@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Quote.hpp"
+
+namespace gateway {
+
+	struct FeedStats {
+		std::uint64_t wins{};
+		std::uint64_t duplicates{};
+		std::uint64_t stale{};
+		std::uint64_t unsequenced{};
+		std::chrono::nanoseconds totalLag{};
+		std::chrono::nanoseconds maxLag{};
+
+		[[nodiscard]] double winRate() const noexcept {
+			const auto total = wins + duplicates;
+			return total ? static_cast<double>(wins) / static_cast<double>(total) : 0.0;
+		}
+
+		[[nodiscard]] std::chrono::nanoseconds avgLag() const noexcept {
+			return duplicates ? totalLag / static_cast<std::int64_t>(duplicates) : std::chrono::nanoseconds{0};
+		}
+	};
+
+	// Merges N redundant copies of the same feed: the first copy of every (symbol, exchange sequence) is
+	// forwarded, later copies are dropped and charged as lag to the feed that lost the race. Every book
+	// has its own window of the last Window sequences, so a busy book cannot evict another book's
+	// winner and let its late copy through. accept() must be called from a single thread; stats() may
+	// be read from any thread.
+	template<std::size_t Feeds, std::size_t Window = 64>
+	class FeedArbiter {
+		static_assert(Feeds > 0, "FeedArbiter needs at least one feed");
+		static_assert((Window & (Window - 1)) == 0, "Window must be a power of two");
+
+	public:
+		[[nodiscard]] bool accept(std::size_t feed, const Quote& quote) noexcept {
+			auto& counters = counters_[feed];
+			const std::uint64_t seq = quote.getSequence();
+			if (seq == 0) {
+				bump(counters.unsequenced);
+				return true;
+			}
+
+			const auto book = quote.getSymbolId();
+			auto& slot = window_[std::size_t{book} * Window + (seq & (Window - 1))];
+			if (slot.sequence != seq) {
+				if (slot.sequence > seq) {
+					bump(counters.stale);
+					return false;
+				}
+				slot = Slot{seq, feed, quote.getTimestamp()};
+				bump(counters.wins);
+				return true;
+			}
+
+			// Further levels of a frame we already forwarded from this feed.
+			if (slot.feed == feed) return true;
+
+			// QuoteConsumer offers copies in receive order; a copy can still predate the winner when its
+			// producer enqueued it only after the winner was applied, and then it lost by nothing.
+			const auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(quote.getTimestamp() - slot.arrival);
+			const auto lagNs = static_cast<std::uint64_t>(std::max<std::int64_t>(lag.count(), 0));
+			bump(counters.duplicates);
+			counters.lagNs.store(counters.lagNs.load(std::memory_order_relaxed) + lagNs, std::memory_order_relaxed);
+			if (lagNs > counters.maxLagNs.load(std::memory_order_relaxed)) {
+				counters.maxLagNs.store(lagNs, std::memory_order_relaxed);
+			}
+			return false;
+		}
+
+		[[nodiscard]] FeedStats stats(std::size_t feed) const noexcept {
+			const auto& c = counters_[feed];
+			FeedStats s;
+			s.wins        = c.wins.load(std::memory_order_relaxed);
+			s.duplicates  = c.duplicates.load(std::memory_order_relaxed);
+			s.stale       = c.stale.load(std::memory_order_relaxed);
+			s.unsequenced = c.unsequenced.load(std::memory_order_relaxed);
+			s.totalLag    = std::chrono::nanoseconds(c.lagNs.load(std::memory_order_relaxed));
+			s.maxLag      = std::chrono::nanoseconds(c.maxLagNs.load(std::memory_order_relaxed));
+			return s;
+		}
+
+		[[nodiscard]] static constexpr std::size_t feeds() noexcept { return Feeds; }
+
+	private:
+		struct Slot {
+			std::uint64_t sequence{};
+			std::size_t feed{};
+			std::chrono::system_clock::time_point arrival{};
+		};
+
+		struct alignas(64) Counters {
+			std::atomic<std::uint64_t> wins{0};
+			std::atomic<std::uint64_t> duplicates{0};
+			std::atomic<std::uint64_t> stale{0};
+			std::atomic<std::uint64_t> unsequenced{0};
+			std::atomic<std::uint64_t> lagNs{0};
+			std::atomic<std::uint64_t> maxLagNs{0};
+		};
+
+		// Single writer, so a plain load/store pair is enough and avoids a locked RMW per quote.
+		static void bump(std::atomic<std::uint64_t>& c) noexcept {
+			c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		std::vector<Slot> window_ = std::vector<Slot>(SymbolTable::kMaxSymbols * Window);
+		std::array<Counters, Feeds> counters_{};
+	};
+
+}
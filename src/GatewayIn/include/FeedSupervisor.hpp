@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace gateway {
+
+	struct SupervisorPolicy {
+		std::chrono::milliseconds baseBackoff{100};
+		std::chrono::milliseconds maxBackoff{3000};
+		std::chrono::milliseconds maxJitter{50};
+		// Consecutive failed connects before the feed is given up; 0 keeps trying.
+		std::size_t maxAttempts{0};
+		std::chrono::milliseconds healthInterval{1000};
+		// A connected feed that delivers no frame for this long is reconnected; 0 disables the check.
+		std::chrono::milliseconds staleAfter{0};
+	};
+
+	// How the supervisor drives one feed. connect() opens the connection and subscribes; activity(),
+	// if set, returns a count that grows with every frame received.
+	struct FeedHooks {
+		std::function<bool()> connect;
+		std::function<void()> disconnect;
+		std::function<std::uint64_t()> activity;
+	};
+
+	enum class FeedState : std::uint8_t { Idle, Connecting, Up, Backoff, Failed, Stopped };
+
+	struct SupervisedFeedStats {
+		FeedState state{FeedState::Idle};
+		std::uint64_t connects{0};    // successful connects
+		std::uint64_t attempts{0};    // connect() calls
+		std::uint64_t losses{0};      // connections lost or found stale after coming up
+	};
+
+	// Runs the lifecycle of every registered feed as a coroutine on one control thread: connect,
+	// exponential backoff with jitter, periodic health checks and reconnect once the feed reports its
+	// connection lost or goes quiet. Receive threads only post a notification here, so they never run
+	// or wait for reconnect logic; the control thread runs at lowered priority.
+	//
+	// connect() and disconnect() of the feeds are blocking calls made on the control thread, so feeds
+	// reconnect one after another. stop() cancels every pending wait, lets each coroutine disconnect its
+	// feed and joins the thread.
+	class FeedSupervisor {
+	public:
+		explicit FeedSupervisor(bool lowPriority = true) : lowPriority_(lowPriority) {}
+		~FeedSupervisor() { stop(); }
+
+		FeedSupervisor(const FeedSupervisor&) = delete;
+		FeedSupervisor& operator=(const FeedSupervisor&) = delete;
+
+		// Registers a feed; must precede start(). Returns its index.
+		std::size_t watch(std::string name, FeedHooks hooks, SupervisorPolicy policy = {}) {
+			auto feed = std::make_unique<Feed>(io_);
+			feed->name = std::move(name);
+			feed->hooks = std::move(hooks);
+			feed->policy = policy;
+			feeds_.push_back(std::move(feed));
+			return feeds_.size() - 1;
+		}
+
+		// A QuotesObtainer, or anything with connect(), disconnect(), frames() and onConnectionLost().
+		template<class Obtainer>
+		std::size_t watch(Obtainer& obtainer, std::string name, SupervisorPolicy policy = {}) {
+			const auto id = watch(std::move(name),
+								  FeedHooks{[&obtainer] { return obtainer.connect(); },
+											[&obtainer] { obtainer.disconnect(); },
+											[&obtainer] { return obtainer.frames(); }},
+								  policy);
+			obtainer.onConnectionLost([this, id](std::string_view why) { reportLost(id, why); });
+			return id;
+		}
+
+		// Spawns the control thread, which connects every feed.
+		void start() {
+			if (thread_.joinable()) return;
+			stopping_ = false;
+			for (auto& feed : feeds_) {
+				boost::asio::co_spawn(io_, supervise(*feed), [](std::exception_ptr e) {
+					if (!e) return;
+					try {
+						std::rethrow_exception(e);
+					} catch (const std::exception& ex) {
+						std::cerr << "[Supervisor] feed coroutine failed: " << ex.what() << "\n";
+					}
+				});
+			}
+			thread_ = std::thread([this] {
+				if (lowPriority_) ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), kNice);
+				io_.run();
+			});
+		}
+
+		// Cancels every wait, disconnects the feeds that are up and joins the control thread.
+		void stop() {
+			if (!thread_.joinable()) return;
+			boost::asio::post(io_, [this] {
+				stopping_ = true;
+				for (auto& feed : feeds_) feed->timer.cancel();
+			});
+			thread_.join();
+			io_.restart();
+			io_.poll();   // runs what was posted after the last coroutine finished
+		}
+
+		// Any thread, typically a receive thread from its error handler. Never blocks.
+		void reportLost(std::size_t feed, std::string_view why) {
+			auto& f = *feeds_[feed];
+			const auto generation = f.generation.load(std::memory_order_acquire);
+			boost::asio::post(io_, [this, &f, generation, reason = std::string(why)] {
+				// Late reports from a connection that has since been replaced are stale.
+				if (generation != f.generation.load(std::memory_order_relaxed) || f.state != FeedState::Up) return;
+				std::cerr << "[Supervisor] " << f.name << " lost: " << reason << "\n";
+				f.lost = true;
+				f.timer.cancel();
+			});
+		}
+
+		[[nodiscard]] std::size_t feeds() const noexcept { return feeds_.size(); }
+		[[nodiscard]] const std::string& name(std::size_t feed) const { return feeds_[feed]->name; }
+
+		[[nodiscard]] SupervisedFeedStats stats(std::size_t feed) const noexcept {
+			const auto& f = *feeds_[feed];
+			return SupervisedFeedStats{f.state.load(), f.connects.load(), f.attempts.load(), f.losses.load()};
+		}
+
+	private:
+		static constexpr int kNice = 10;
+
+		struct Feed {
+			explicit Feed(boost::asio::io_context& io) : timer(io) {}
+
+			std::string name;
+			FeedHooks hooks;
+			SupervisorPolicy policy;
+			boost::asio::steady_timer timer;
+			std::atomic<std::uint64_t> generation{0};   // bumped by every connect; read by reportLost()
+			bool lost{false};
+
+			// Written by the control thread only.
+			std::atomic<FeedState> state{FeedState::Idle};
+			std::atomic<std::uint64_t> connects{0};
+			std::atomic<std::uint64_t> attempts{0};
+			std::atomic<std::uint64_t> losses{0};
+		};
+
+		using Clock = std::chrono::steady_clock;
+
+		// Sleeps for d unless reportLost() or stop() cuts it short.
+		static boost::asio::awaitable<void> pause(Feed& f, Clock::duration d) {
+			f.timer.expires_after(d);
+			boost::system::error_code ec;
+			co_await f.timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+		}
+
+		Clock::duration backoff(const SupervisorPolicy& p, std::size_t failures) {
+			const auto shift = std::min<std::size_t>(failures, 20);
+			const auto wait = std::min(p.baseBackoff * (std::int64_t{1} << shift), p.maxBackoff);
+			std::uniform_int_distribution<std::int64_t> jitter(0, p.maxJitter.count());
+			return wait + std::chrono::milliseconds(jitter(rng_));
+		}
+
+		boost::asio::awaitable<void> supervise(Feed& f) {
+			const auto& p = f.policy;
+			std::size_t failures = 0;
+			while (!stopping_) {
+				f.state = FeedState::Connecting;
+				f.lost = false;
+				++f.attempts;
+				f.generation.fetch_add(1, std::memory_order_release);
+				if (!f.hooks.connect()) {
+					++failures;
+					if (p.maxAttempts && failures >= p.maxAttempts) {
+						std::cerr << "[Supervisor] " << f.name << " failed after " << failures << " attempts\n";
+						f.state = FeedState::Failed;
+						co_return;
+					}
+					f.state = FeedState::Backoff;
+					co_await pause(f, backoff(p, failures));
+					continue;
+				}
+
+				failures = 0;
+				++f.connects;
+				f.state = FeedState::Up;
+				auto seen = f.hooks.activity ? f.hooks.activity() : 0;
+				auto lastFrame = Clock::now();
+				while (!stopping_ && !f.lost) {
+					co_await pause(f, p.healthInterval);
+					if (stopping_ || f.lost || p.staleAfter.count() == 0 || !f.hooks.activity) continue;
+					const auto now = Clock::now();
+					if (const auto a = f.hooks.activity(); a != seen) {
+						seen = a;
+						lastFrame = now;
+					} else if (now - lastFrame >= p.staleAfter) {
+						std::cerr << "[Supervisor] " << f.name << " silent for "
+								  << std::chrono::duration_cast<std::chrono::milliseconds>(now - lastFrame).count() << " ms\n";
+						f.lost = true;
+					}
+				}
+				f.hooks.disconnect();
+				if (f.lost) ++f.losses;
+			}
+			f.state = FeedState::Stopped;
+		}
+
+		boost::asio::io_context io_;
+		std::vector<std::unique_ptr<Feed>> feeds_;
+		std::thread thread_;
+		bool stopping_{false};   // control thread only
+		bool lowPriority_;
+		std::mt19937 rng_{std::random_device{}()};
+	};
+
+}
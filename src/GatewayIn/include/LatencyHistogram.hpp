@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Log-linear nanosecond histogram: exact below 16 ns, then 16 buckets per power of two, so any
+// reported percentile is within ~6% of the true value. Recording is a few shifts and one relaxed
+// store; a single thread records, any thread may read.
+class LatencyHistogram {
+public:
+	static constexpr unsigned kSubBits = 4;
+	static constexpr std::size_t kSub = std::size_t{1} << kSubBits;
+	static constexpr std::size_t kBuckets = 64 * kSub;
+
+	void record(std::chrono::nanoseconds d) noexcept {
+		recordNs(d.count() > 0 ? static_cast<std::uint64_t>(d.count()) : 0);
+	}
+
+	void recordNs(std::uint64_t ns) noexcept {
+		bump(buckets_[bucketOf(ns)], 1);
+		bump(count_, 1);
+		bump(sum_, ns);
+		if (ns < min_.load(std::memory_order_relaxed)) min_.store(ns, std::memory_order_relaxed);
+		if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+	[[nodiscard]] std::uint64_t min() const noexcept { return count() ? min_.load(std::memory_order_relaxed) : 0; }
+	[[nodiscard]] std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+	[[nodiscard]] double mean() const noexcept {
+		const auto n = count();
+		return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+	}
+
+	// Upper edge of the bucket holding the p-th percentile (p in [0, 100]), clamped to the observed max.
+	[[nodiscard]] std::uint64_t percentile(double p) const noexcept {
+		const auto n = count();
+		if (n == 0) return 0;
+		auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(n) + 0.5);
+		if (rank == 0) rank = 1;
+		if (rank > n) rank = n;
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < kBuckets; ++i) {
+			seen += buckets_[i].load(std::memory_order_relaxed);
+			if (seen >= rank) {
+				const auto edge = upperEdge(i);
+				return edge < max() ? edge : max();
+			}
+		}
+		return max();
+	}
+
+	// Adds other's samples; both histograms must be quiescent.
+	void merge(const LatencyHistogram& other) noexcept {
+		for (std::size_t i = 0; i < kBuckets; ++i) bump(buckets_[i], other.buckets_[i].load(std::memory_order_relaxed));
+		bump(count_, other.count());
+		bump(sum_, other.sum_.load(std::memory_order_relaxed));
+		if (other.count() && other.min() < min_.load(std::memory_order_relaxed)) min_.store(other.min(), std::memory_order_relaxed);
+		if (other.max() > max()) max_.store(other.max(), std::memory_order_relaxed);
+	}
+
+	void reset() noexcept {
+		for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+		count_.store(0, std::memory_order_relaxed);
+		sum_.store(0, std::memory_order_relaxed);
+		min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+		max_.store(0, std::memory_order_relaxed);
+	}
+
+	static std::size_t bucketOf(std::uint64_t ns) noexcept {
+		if (ns < kSub) return static_cast<std::size_t>(ns);
+		const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - 1 - kSubBits;
+		return ((shift + 1) << kSubBits) + static_cast<std::size_t>((ns >> shift) & (kSub - 1));
+	}
+
+	static std::uint64_t upperEdge(std::size_t bucket) noexcept {
+		if (bucket < kSub) return bucket;
+		const unsigned shift = static_cast<unsigned>(bucket >> kSubBits) - 1;
+		const std::uint64_t lower = (kSub + (bucket & (kSub - 1))) << shift;
+		return lower + ((std::uint64_t{1} << shift) - 1);
+	}
+
+private:
+	static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept {
+		c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+	std::atomic<std::uint64_t> count_{0};
+	std::atomic<std::uint64_t> sum_{0};
+	std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+	std::atomic<std::uint64_t> max_{0};
+};
@@ -1,38 +1,52 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string_view>
 
+#include "SymbolTable.hpp"
+
 namespace gateway {
-	enum class QuoteSide { Bid, Ask };
+	enum class QuoteSide : std::uint8_t { Bid, Ask };
 
+	// 32 bytes: sequence, symbol id and side share one word so two quotes fit in a cache line.
 	class Quote {
 	public:
+		static constexpr unsigned kSequenceBits = 40;
+		static constexpr std::uint64_t kSequenceMask = (std::uint64_t{1} << kSequenceBits) - 1;
+
 		Quote(double price,
 			  double size,
 			  std::chrono::system_clock::time_point timestamp,
-			  std::string_view symbol,
-			  QuoteSide side)
+			  SymbolId symbol,
+			  QuoteSide side,
+			  std::uint64_t sequence = 0)
 				: price_{price}
 				, size_{size}
 				, timestamp_{timestamp}
-				, symbol_{std::move(symbol)}
-				, side_{side} {}
+				, sequence_{sequence & kSequenceMask}
+				, symbol_{symbol}
+				, side_{static_cast<std::uint8_t>(side)} {}
 
 		Quote() = default;
 
 		[[nodiscard]] double getPrice() const noexcept { return price_; }
 		[[nodiscard]] std::chrono::system_clock::time_point getTimestamp() const noexcept { return timestamp_; }
-		[[nodiscard]] std::string_view getSymbol() const noexcept { return symbol_; }
-		[[nodiscard]] QuoteSide getSide() const noexcept { return side_; }
+		[[nodiscard]] SymbolId getSymbolId() const noexcept { return static_cast<SymbolId>(symbol_); }
+		[[nodiscard]] std::string_view getSymbol() const noexcept { return symbolName(getSymbolId()); }
+		[[nodiscard]] QuoteSide getSide() const noexcept { return static_cast<QuoteSide>(side_); }
 		[[nodiscard]] double getSize() const noexcept { return size_; }
+		// Exchange sequence (Bitvavo nonce, low 40 bits) of the frame this quote came from, 0 when the feed has none.
+		[[nodiscard]] std::uint64_t getSequence() const noexcept { return sequence_; }
 
 	private:
 		double price_{};
 		double size_{};
 		std::chrono::system_clock::time_point timestamp_;
-		std::string_view symbol_;
-		QuoteSide side_;
+		std::uint64_t sequence_ : kSequenceBits {};
+		std::uint64_t symbol_ : 16 {};
+		std::uint64_t side_ : 8 {};
 	};
-}
 
+	static_assert(sizeof(Quote) == 32, "Quote must stay half a cache line");
+}
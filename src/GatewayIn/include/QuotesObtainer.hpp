@@ -7,13 +7,18 @@
 #include <utility>
 #include <chrono>
 #include <iostream>
-#include <thread>
 #include <atomic>
 #include <algorithm>
-#include <random>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <vector>
 #include <boost/lockfree/spsc_queue.hpp>
 
 #include "Quote.hpp"
+#include "BookSync.hpp"
+#include "SymbolRouter.hpp"
+#include "Wire.hpp"
 #include "../../Parser/include/BitvavoBookParser.hpp"
 #include "../../Parser/include/FixBookParser.hpp"
 
@@ -24,25 +29,55 @@ namespace gateway {
 	public:
 		using Clock = std::chrono::system_clock;
 
+		// Bitvavo clients take JSON subscribe and getBook requests; FIX clients subscribe through their session.
+		static constexpr bool kBitvavo = Client::kWire == Wire::Bitvavo;
+		// Only Bitvavo answers requestResync() with a book snapshot.
+		static constexpr bool kCanResync = kBitvavo;
+
 		template <typename C>
 		explicit QuotesObtainer(C&& client,
 								std::string host,
 								std::string port,
 								std::string market)
+				: QuotesObtainer(std::forward<C>(client), std::move(host), std::move(port),
+								 std::vector<std::string>{std::move(market)}) {}
+
+		// All markets share this connection; quotes are tagged with the market's global SymbolId.
+		template <typename C>
+		explicit QuotesObtainer(C&& client,
+								std::string host,
+								std::string port,
+								const std::vector<std::string>& markets)
 				: host_(std::move(host)),
-				  port_(std::move(port)),
-				  market_(std::move(market))
+				  port_(std::move(port))
 			{
+				for (const auto& m : markets) router_.add(m);
+				bookSync_.resize(router_.size());
+				pendingSnapshots_.resize(router_.size());
+				resyncWanted_ = std::make_unique<std::atomic<bool>[]>(router_.size());
+
 				client_ = &client;
-				if constexpr (requires(Client* c, const std::string& s) { c->send(s); }) {
-					client_->setMessageHandler([this](std::string_view msg) { parseBitvavo(msg); });
+				if constexpr (requires(Client* c, const std::vector<std::string>& v) { c->setSymbols(v); }) {
+					client_->setSymbols(markets);
+				}
+				if constexpr (kBitvavo) {
+					client_->setMessageHandler([this](std::string_view msg) {
+						countFrame();
+						if (tap_) tap_(msg);
+						parseBitvavo(msg);
+					});
 				} else {
-					client_->setMessageHandler([this](std::string_view msg) { parseFix(msg); });
+					client_->setMessageHandler([this](std::string_view msg) {
+						countFrame();
+						if (tap_) tap_(msg);
+						parseFix(msg);
+					});
 				}
+				// Runs on the receive thread: only report. Tearing down and reconnecting is left to
+				// whoever supervises the connection, e.g. a FeedSupervisor.
 				client_->setErrorHandler([this](std::string_view err) {
 					std::cerr << "Error: " << err << "\n";
-					disconnect();
-					startReconnectLoop();
+					if (connectionLost_) connectionLost_(err);
 				});
 			}
 
@@ -50,10 +85,8 @@ namespace gateway {
 
 		bool connect() {
 			if (!client_->connect(host_, port_)) return false;
-			if constexpr (requires(Client* c, const std::string& s) { c->send(s); }) {
-    std::string sub = std::string(R"({"action":"subscribe","channels":[{"name":"book","markets":[")")
-						  + market_ + R"("]}]})";
-				client_->send(sub);
+			if constexpr (kBitvavo) {
+				client_->send(bitvavo::makeSubscribeRequest(router_.names()));
 			}
 			return true;
 		}
@@ -62,6 +95,16 @@ namespace gateway {
 			client_->disconnect();
 		}
 
+		// Sees every raw frame on the receive thread before it is parsed, e.g. to journal the feed for
+		// replay. Set before connect().
+		void tapFrames(std::function<void(std::string_view)> tap) { tap_ = std::move(tap); }
+
+		// Called on the receive thread when the connection fails. Set before connect().
+		void onConnectionLost(std::function<void(std::string_view)> handler) { connectionLost_ = std::move(handler); }
+
+		// Frames received so far; a supervisor watches it to spot a silent feed.
+		[[nodiscard]] std::uint64_t frames() const noexcept { return frames_.load(std::memory_order_relaxed); }
+
 		boost::lockfree::spsc_queue<gateway::Quote, boost::lockfree::capacity<1024>>& getBidQueue() { return bidQuoteQueue_; }
 		boost::lockfree::spsc_queue<gateway::Quote, boost::lockfree::capacity<1024>>& getAskQueue() { return askQuoteQueue_; }
 
@@ -80,41 +123,143 @@ namespace gateway {
 		}
 		std::chrono::milliseconds updateInterval_{1000};
 
-		void startReconnectLoop() {
-			if (reconnecting_.exchange(true)) return;
-			std::thread([this]() {
-				std::uniform_int_distribution<int> jitterDist(0, 50);
-				size_t attempts = 0;
-				while (attempts < maxReconnectAttempts_) {
-					std::cerr << "[Reconnect] Attempt " << (attempts + 1)
-							  << " for " << host_ << ":" << port_ << "\n";
-					if (connect()) {
-						std::cout << "[Reconnect] Success for " << host_ << ":" << port_ << "\n";
-						reconnecting_ = false;
-						return;
-					}
-					++attempts;
-					auto backoff = std::min(baseBackoff_ * (1 << attempts), maxBackoff_);
-					backoff += std::chrono::milliseconds(jitterDist(rng_));
-					std::this_thread::sleep_for(backoff);
-				}
-				std::cerr << "[Reconnect] Failed after " << attempts << " attempts for "
-						  << host_ << ":" << port_ << "\n";
-				reconnecting_ = false;
-			}).detach();
-		}
-
 		void parseFix(std::string_view fixMessage) {
 			auto quote = fix::parseAndStoreQuote(fixMessage);
-			if (quote) storeQuote(*quote);
+			if (quote && router_.route(quote->getSymbolId())) storeQuote(*quote);
+		}
+
+		// Frames without a "market" field are only accepted on single-market connections.
+		[[nodiscard]] std::optional<SymbolRouter::Route> routeBitvavo(std::string_view frame) const {
+			const auto market = bitvavo::extractMarket(frame);
+			if (market.empty()) {
+				if (router_.size() == 1) return SymbolRouter::Route{0, router_.symbol(0)};
+				return std::nullopt;
+			}
+			return router_.route(market);
 		}
 
 		void parseBitvavo(std::string_view bitVavoMessage) {
-			auto result = bitvavo::parseAndStoreQuote(bitVavoMessage, market_);
-			if (result) storeQuote(*result); else std::cerr << "Error parsing quote: " << bitVavoMessage << "\n";
+			if (resyncRequested_.load(std::memory_order_acquire)) serviceResyncRequests();
+			if (bitvavo::isBookSnapshot(bitVavoMessage)) {
+				onBookSnapshot(bitVavoMessage);
+				return;
+			}
+			if (!bitvavo::isBookUpdate(bitVavoMessage)) return;
+
+			const auto route = routeBitvavo(bitVavoMessage);
+			if (!route) return;
+
+			auto& sync = bookSync_[route->slot];
+			switch (sync.onUpdate(bitVavoMessage, bitvavo::extractNonce(bitVavoMessage))) {
+				case BookSync::Action::Apply:
+					applyBitvavoUpdate(bitVavoMessage, route->symbol);
+					break;
+				case BookSync::Action::RequestSnapshot:
+					std::cerr << "[Resync] Nonce gap after " << sync.lastNonce() << " for " << symbolName(route->symbol)
+							  << ", requesting book snapshot\n";
+					requestSnapshot(route->slot);
+					break;
+				case BookSync::Action::Buffer:
+					if (sync.snapshotOverdue(BookSync::Clock::now())) {
+						std::cerr << "[Resync] No book snapshot for " << symbolName(route->symbol) << " yet, requesting again\n";
+						requestSnapshot(route->slot);
+					}
+					break;
+				case BookSync::Action::Drop:
+					break;
+			}
 		}
 
-		void storeQuote(const Quote& quote) {
+		void applyBitvavoUpdate(std::string_view frame, SymbolId symbol) {
+			if (!bitvavo::parseBookLevels(frame, symbol, [this](const Quote& q) { storeQuote(q); })) {
+				std::cerr << "Error parsing quote: " << frame << "\n";
+			}
+		}
+
+		void onBookSnapshot(std::string_view frame) {
+			const auto route = routeBitvavo(frame);
+			if (!route) return;
+
+			const auto nonce = bitvavo::extractNonce(frame);
+			BookSnapshot snap;
+			snap.symbol = route->symbol;
+			snap.sequence = nonce;
+			// A malformed snapshot is dropped: the book keeps buffering until the request is overdue and resent.
+			const auto collect = [this, &snap](const Quote& q) { snap.levels.push_back(stamped(q)); };
+			if (!bitvavo::parseBookLevels(frame, route->symbol, collect)) {
+				std::cerr << "Error parsing book snapshot: " << frame.substr(0, 200) << "\n";
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(snapshotMutex_);
+				pendingSnapshots_[route->slot] = std::move(snap);
+				snapshotPending_.store(true, std::memory_order_release);
+			}
+			for (const auto& buffered : bookSync_[route->slot].onSnapshot(nonce)) {
+				parseBitvavo(buffered);
+			}
+		}
+
+		// Consumer side of the snapshot handoff. Must be checked after every dequeued quote: updates
+		// replayed behind a snapshot are queued after it was published.
+		[[nodiscard]] bool snapshotPending() const noexcept { return snapshotPending_.load(std::memory_order_acquire); }
+
+		std::optional<BookSnapshot> takeSnapshot() {
+			std::lock_guard<std::mutex> lock(snapshotMutex_);
+			std::optional<BookSnapshot> taken;
+			bool more = false;
+			for (auto& pending : pendingSnapshots_) {
+				if (!pending) continue;
+				if (taken) { more = true; break; }
+				taken = std::exchange(pending, std::nullopt);
+			}
+			snapshotPending_.store(more, std::memory_order_relaxed);
+			return taken;
+		}
+
+		// Seeds nonce tracking from a restored checkpoint: the first live update then either continues from
+		// nonce or, after a gap, requests a snapshot as usual. Call before connect().
+		void resumeFrom(SymbolId symbol, std::uint64_t nonce) {
+			if (const auto route = router_.route(symbol)) bookSync_[route->slot].onSnapshot(nonce);
+		}
+
+		// Asks for a fresh snapshot of symbol from any thread, e.g. when the consumer finds the book crossed.
+		// The receive thread sends the request before handling its next frame (Bitvavo connections only).
+		void requestResync(SymbolId symbol) {
+			const auto route = router_.route(symbol);
+			if (!route) return;
+			resyncWanted_[route->slot].store(true, std::memory_order_relaxed);
+			resyncRequested_.store(true, std::memory_order_release);
+		}
+
+		// How long a resync waits for its book snapshot before asking again. Call before connect().
+		void setSnapshotTimeout(std::chrono::milliseconds timeout) {
+			for (auto& sync : bookSync_) sync.setSnapshotTimeout(timeout);
+		}
+
+		[[nodiscard]] const BookSync& bookSync(std::size_t slot = 0) const noexcept { return bookSync_[slot]; }
+		[[nodiscard]] const SymbolRouter& router() const noexcept { return router_; }
+
+
+		void serviceResyncRequests() {
+			resyncRequested_.store(false, std::memory_order_relaxed);
+			for (std::size_t slot = 0; slot < router_.size(); ++slot) {
+				if (!resyncWanted_[slot].exchange(false, std::memory_order_acquire)) continue;
+				if (!bookSync_[slot].beginResync()) continue;
+				std::cerr << "[Resync] Book check failed for " << router_.name(slot) << ", requesting book snapshot\n";
+				if constexpr (kBitvavo) {
+					requestSnapshot(slot);
+				}
+			}
+		}
+
+		void requestSnapshot(std::size_t slot) {
+			bookSync_[slot].snapshotRequested(BookSync::Clock::now());
+			client_->send(bitvavo::makeGetBookRequest(router_.name(slot)));
+		}
+
+		void storeQuote(const Quote& parsed) {
+			const Quote quote = stamped(parsed);
 			if (quote.getSide() == QuoteSide::Bid) {
 				if (!bidQuoteQueue_.push(quote)) std::cerr << "Bid queue full for host " << host_ << ":" << port_ << "\n";
 				if (!peakBidQuote_ || quote.getPrice() > peakBidQuote_->getPrice()) {
@@ -132,7 +277,7 @@ namespace gateway {
 			}
 		}
 
-		[[nodiscard]] const std::string& getMarket(){return market_;};
+		[[nodiscard]] std::string_view getMarket(){return router_.name(0);};
 		[[nodiscard]] const std::string& getHost(){return host_;};
 		[[nodiscard]] const std::string& getPort(){return port_;};
 		[[nodiscard]] bool bidQueueEmpty() {return bidQuoteQueue_.empty();}
@@ -140,18 +285,35 @@ namespace gateway {
 		size_t sizeAskQueue() const noexcept { return askQuoteQueue_.read_available(); }
 
 	private:
+		// Single writer, the receive thread.
+		void countFrame() noexcept { frames_.store(frames_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+		// Replay clients carry the recorded receive time of the frame being parsed; live quotes keep
+		// the parser's wall-clock stamp.
+		Quote stamped(const Quote& q) const {
+			if constexpr (requires(const Client* c) { c->receiveTime(); }) {
+				return Quote(q.getPrice(), q.getSize(), client_->receiveTime(), q.getSymbolId(), q.getSide(), q.getSequence());
+			} else {
+				return q;
+			}
+		}
+
 		Client* client_ {nullptr};
+		std::function<void(std::string_view)> tap_;
+		std::function<void(std::string_view)> connectionLost_;
+		std::atomic<std::uint64_t> frames_{0};
 		std::string host_;
 		std::string port_;
-		std::string market_;
+		SymbolRouter router_;
 
 		boost::lockfree::spsc_queue<gateway::Quote, boost::lockfree::capacity<1024>> bidQuoteQueue_;
 		boost::lockfree::spsc_queue<gateway::Quote, boost::lockfree::capacity<1024>> askQuoteQueue_;
 
-		std::atomic<bool> reconnecting_{false};
-		const size_t maxReconnectAttempts_ = 10;
-		const std::chrono::milliseconds baseBackoff_{100};
-		const std::chrono::milliseconds maxBackoff_{3000};
-		std::mt19937 rng_{std::random_device{}()};
+		std::vector<BookSync> bookSync_;
+		std::mutex snapshotMutex_;
+		std::vector<std::optional<BookSnapshot>> pendingSnapshots_;
+		std::atomic<bool> snapshotPending_{false};
+		std::unique_ptr<std::atomic<bool>[]> resyncWanted_;
+		std::atomic<bool> resyncRequested_{false};
 	};
 }
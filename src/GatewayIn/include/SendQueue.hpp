@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "LatencyHistogram.hpp"
+
+namespace gateway {
+
+	// Single-producer single-consumer ring of encoded outbound messages. push() copies a message in
+	// behind a 16-byte record header; the consumer hands the queued payloads to writev() straight out
+	// of the ring, so a burst reaches the kernel in one call, and retires them once every byte has
+	// been taken. Records never straddle the end: one that does not fit leaves a skip record behind
+	// and starts again at offset 0.
+	class SendRing {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Capacity is rounded up to a power of two.
+		explicit SendRing(std::size_t capacityBytes = std::size_t{1} << 20)
+			: buffer_(std::bit_ceil(std::max(capacityBytes, std::size_t{4096})))
+			, mask_(buffer_.size() - 1) {}
+
+		SendRing(const SendRing&) = delete;
+		SendRing& operator=(const SendRing&) = delete;
+
+		// Producer. False when the message does not fit in the free space.
+		bool push(std::string_view message) noexcept {
+			const auto need = recordSize(message.size());
+			const auto head = head_.load(std::memory_order_relaxed);
+			const auto offset = head & mask_;
+			const auto skip = offset + need > buffer_.size() ? buffer_.size() - offset : 0;
+			if (need > buffer_.size()) return false;
+			if (head + skip + need - cachedTail_ > buffer_.size()) {
+				cachedTail_ = tail_.load(std::memory_order_acquire);
+				if (head + skip + need - cachedTail_ > buffer_.size()) return false;
+			}
+			if (skip) writeHeader(offset, Header{static_cast<std::uint32_t>(skip), kSkip, 0});
+			const auto at = (head + skip) & mask_;
+			writeHeader(at, Header{static_cast<std::uint32_t>(message.size()), 0, Clock::now().time_since_epoch().count()});
+			std::memcpy(&buffer_[at + kHeaderSize], message.data(), message.size());
+			head_.store(head + skip + need, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer. Fills iov with up to maxIov queued payloads, the first one minus the bytes an
+		// earlier partial write already took. Returns the number of entries.
+		std::size_t gather(iovec* iov, std::size_t maxIov) noexcept {
+			const auto head = head_.load(std::memory_order_acquire);
+			auto pos = tail_.load(std::memory_order_relaxed);
+			std::size_t n = 0;
+			while (pos != head && n < maxIov) {
+				const auto h = readHeader(pos & mask_);
+				if (h.flags == kSkip) {
+					pos += h.length;
+					continue;
+				}
+				const auto skipped = n == 0 ? partial_ : 0;
+				iov[n].iov_base = &buffer_[(pos & mask_) + kHeaderSize + skipped];
+				iov[n].iov_len = h.length - skipped;
+				++n;
+				pos += recordSize(h.length);
+			}
+			return n;
+		}
+
+		// Consumer. Retires bytes taken by the transport, recording enqueue-to-written latency for
+		// every message that is now complete. Returns how many completed.
+		std::size_t consume(std::size_t bytes) noexcept {
+			const auto head = head_.load(std::memory_order_acquire);
+			auto pos = tail_.load(std::memory_order_relaxed);
+			std::size_t done = 0;
+			Clock::rep now = 0;
+			while (pos != head) {
+				const auto h = readHeader(pos & mask_);
+				if (h.flags == kSkip) {
+					pos += h.length;
+					continue;
+				}
+				const auto remaining = h.length - partial_;
+				if (bytes < remaining) {
+					partial_ += bytes;
+					break;
+				}
+				bytes -= remaining;
+				partial_ = 0;
+				if (!now) now = Clock::now().time_since_epoch().count();
+				latency_.recordNs(static_cast<std::uint64_t>(std::max<Clock::rep>(now - h.enqueued, 0)));
+				pos += recordSize(h.length);
+				++done;
+				if (bytes == 0) break;
+			}
+			tail_.store(pos, std::memory_order_release);
+			return done;
+		}
+
+		// Consumer. Drops everything queued, e.g. once the connection it was meant for is gone.
+		std::size_t discard() noexcept {
+			std::size_t dropped = 0;
+			const auto head = head_.load(std::memory_order_acquire);
+			auto pos = tail_.load(std::memory_order_relaxed);
+			while (pos != head) {
+				const auto h = readHeader(pos & mask_);
+				dropped += h.flags != kSkip;
+				pos += h.flags == kSkip ? h.length : recordSize(h.length);
+			}
+			partial_ = 0;
+			tail_.store(pos, std::memory_order_release);
+			return dropped;
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+		}
+		[[nodiscard]] std::size_t queuedBytes() const noexcept {
+			return static_cast<std::size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+		}
+		[[nodiscard]] std::size_t capacity() const noexcept { return buffer_.size(); }
+		[[nodiscard]] const LatencyHistogram& latency() const noexcept { return latency_; }
+
+	private:
+		static constexpr std::size_t kHeaderSize = 16;
+		static constexpr std::uint32_t kSkip = 1;
+
+		struct Header {
+			std::uint32_t length;
+			std::uint32_t flags;
+			Clock::rep enqueued;
+		};
+		static_assert(sizeof(Header) == kHeaderSize);
+
+		static std::size_t recordSize(std::size_t payload) noexcept { return (kHeaderSize + payload + 15) & ~std::size_t{15}; }
+
+		void writeHeader(std::size_t at, const Header& h) noexcept { std::memcpy(&buffer_[at], &h, sizeof(h)); }
+		[[nodiscard]] Header readHeader(std::size_t at) const noexcept {
+			Header h;
+			std::memcpy(&h, &buffer_[at], sizeof(h));
+			return h;
+		}
+
+		std::vector<char> buffer_;
+		std::size_t mask_;
+		alignas(64) std::atomic<std::uint64_t> head_{0};
+		std::uint64_t cachedTail_{0};     // producer's last look at tail_
+		alignas(64) std::atomic<std::uint64_t> tail_{0};
+		std::size_t partial_{0};          // bytes of the oldest record already written
+		LatencyHistogram latency_;
+	};
+
+	struct SendOptions {
+		// Off: send() writes on the caller's thread and blocks until the kernel took everything.
+		bool queued = true;
+		std::size_t ringBytes = std::size_t{1} << 20;
+		// Off: nothing drains the ring on its own; the owner calls drainSends() from its loop.
+		bool senderThread = true;
+		// The sender thread spins when idle instead of sleeping until the next push.
+		bool busyPoll = false;
+	};
+
+	struct SendStats {
+		std::uint64_t enqueued{0};     // messages accepted by the queue
+		std::uint64_t sent{0};         // queued messages fully handed to the transport
+		std::uint64_t bytes{0};
+		std::uint64_t writes{0};       // transport writes that took data
+		std::uint64_t maxBatch{0};     // most messages carried by one write
+		std::uint64_t direct{0};       // critical messages written without queueing
+		std::uint64_t rejected{0};     // messages refused because the ring was full
+		std::uint64_t wouldBlock{0};   // writes the transport pushed back on
+		std::uint64_t dropped{0};      // queued messages discarded on disconnect or write error
+		std::uint64_t depth{0};        // messages queued now
+		std::uint64_t maxDepth{0};
+	};
+
+	// Outbound path of one connection: the hot thread push()es encoded messages into a SendRing and a
+	// sender thread, or the owner in a drain step, writes them out in batches through the transport's
+	// BatchWriter. Pushes come from one thread at a time; callers with several threads serialise them.
+	class SendQueue {
+	public:
+		// Writes as much of iov[0, n) as the transport takes without blocking. Returns the bytes taken,
+		// 0 when the transport is full for now, or -1 on a failed connection.
+		using BatchWriter = std::function<long(const iovec*, std::size_t)>;
+
+		static constexpr std::size_t kMaxBatch = 64;
+
+		explicit SendQueue(SendOptions options = {}) : options_(options), ring_(options.ringBytes) {}
+		~SendQueue() { stop(); }
+
+		SendQueue(const SendQueue&) = delete;
+		SendQueue& operator=(const SendQueue&) = delete;
+
+		[[nodiscard]] const SendOptions& options() const noexcept { return options_; }
+
+		void start(BatchWriter writer) {
+			stop();
+			writer_ = std::move(writer);
+			failed_.store(false, std::memory_order_relaxed);
+			if (!options_.senderThread) return;
+			running_.store(true);
+			sender_ = std::thread([this] { run(); });
+		}
+
+		// Joins the sender and drops whatever was still queued.
+		void stop() {
+			running_.store(false);
+			wake();
+			if (sender_.joinable()) sender_.join();
+			bump(dropped_, ring_.discard());
+		}
+
+		// Producer.
+		bool push(std::string_view message) noexcept {
+			if (message.empty()) return true;
+			if (!ring_.push(message)) {
+				bump(rejected_, 1);
+				return false;
+			}
+			bump(enqueued_, 1);
+			const auto depth = enqueued_.load(std::memory_order_relaxed) - sent_.load(std::memory_order_relaxed);
+			if (depth > maxDepth_.load(std::memory_order_relaxed)) maxDepth_.store(depth, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (sleeping_.load(std::memory_order_relaxed)) wake();
+			return true;
+		}
+
+		// Producer. Writes message with one non-blocking attempt when nothing is queued ahead of it, so it
+		// cannot overtake queued bytes on the stream; whatever the transport does not take is queued.
+		bool pushCritical(std::string_view message) {
+			if (ring_.empty() && writer_ && !failed_.load(std::memory_order_relaxed)) {
+				const iovec iov{const_cast<char*>(message.data()), message.size()};
+				const long n = writer_(&iov, 1);
+				if (n == static_cast<long>(message.size())) {
+					bump(direct_, 1);
+					return true;
+				}
+				if (n > 0) message.remove_prefix(static_cast<std::size_t>(n));
+			}
+			return push(message);
+		}
+
+		// Consumer. One gather-write-retire round; returns the bytes written.
+		std::size_t drain() {
+			std::array<iovec, kMaxBatch> iov;
+			const auto n = ring_.gather(iov.data(), iov.size());
+			if (n == 0) {
+				ring_.consume(0);   // steps over a trailing skip record
+				return 0;
+			}
+			if (failed_.load(std::memory_order_relaxed)) {
+				bump(dropped_, ring_.discard());
+				return 0;
+			}
+			const long written = writer_ ? writer_(iov.data(), n) : -1;
+			if (written < 0) {
+				std::cerr << "SendQueue: write failed, dropping queued messages\n";
+				failed_.store(true, std::memory_order_relaxed);
+				bump(dropped_, ring_.discard());
+				return 0;
+			}
+			if (written == 0) {
+				bump(wouldBlock_, 1);
+				return 0;
+			}
+			const auto done = ring_.consume(static_cast<std::size_t>(written));
+			bump(sent_, done);
+			bump(bytes_, static_cast<std::uint64_t>(written));
+			bump(writes_, 1);
+			if (done > maxBatch_.load(std::memory_order_relaxed)) maxBatch_.store(done, std::memory_order_relaxed);
+			return static_cast<std::size_t>(written);
+		}
+
+		[[nodiscard]] SendStats stats() const noexcept {
+			SendStats s;
+			s.enqueued = enqueued_.load(std::memory_order_relaxed);
+			s.sent = sent_.load(std::memory_order_relaxed);
+			s.bytes = bytes_.load(std::memory_order_relaxed);
+			s.writes = writes_.load(std::memory_order_relaxed);
+			s.maxBatch = maxBatch_.load(std::memory_order_relaxed);
+			s.direct = direct_.load(std::memory_order_relaxed);
+			s.rejected = rejected_.load(std::memory_order_relaxed);
+			s.wouldBlock = wouldBlock_.load(std::memory_order_relaxed);
+			s.dropped = dropped_.load(std::memory_order_relaxed);
+			s.depth = s.enqueued > s.sent + s.dropped ? s.enqueued - s.sent - s.dropped : 0;
+			s.maxDepth = maxDepth_.load(std::memory_order_relaxed);
+			return s;
+		}
+
+		// Enqueue-to-written time of queued messages.
+		[[nodiscard]] const LatencyHistogram& latency() const noexcept { return ring_.latency(); }
+		[[nodiscard]] std::size_t queuedBytes() const noexcept { return ring_.queuedBytes(); }
+
+	private:
+		static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept {
+			c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+		void wake() {
+			{ std::lock_guard lock(mutex_); }
+			wakeUp_.notify_one();
+		}
+
+		void run() {
+			while (running_.load(std::memory_order_relaxed)) {
+				if (drain() > 0) continue;
+				if (!ring_.empty()) {
+					// The transport is full: let the peer catch up before trying again.
+					if (!options_.busyPoll) std::this_thread::sleep_for(std::chrono::microseconds(50));
+					continue;
+				}
+				if (options_.busyPoll) continue;
+				// Announce the nap before the last look at the ring; push() checks the flag after
+				// publishing, so one of the two sees the other. The timeout is only a backstop.
+				sleeping_.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (ring_.empty() && running_.load(std::memory_order_relaxed)) {
+					std::unique_lock lock(mutex_);
+					wakeUp_.wait_for(lock, std::chrono::milliseconds(1));
+				}
+				sleeping_.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		SendOptions options_;
+		SendRing ring_;
+		BatchWriter writer_;
+		std::thread sender_;
+		std::mutex mutex_;
+		std::condition_variable wakeUp_;
+		std::atomic<bool> running_{false};
+		std::atomic<bool> sleeping_{false};
+		std::atomic<bool> failed_{false};
+
+		std::atomic<std::uint64_t> enqueued_{0};
+		std::atomic<std::uint64_t> rejected_{0};
+		std::atomic<std::uint64_t> direct_{0};
+		std::atomic<std::uint64_t> maxDepth_{0};
+		std::atomic<std::uint64_t> sent_{0};
+		std::atomic<std::uint64_t> bytes_{0};
+		std::atomic<std::uint64_t> writes_{0};
+		std::atomic<std::uint64_t> maxBatch_{0};
+		std::atomic<std::uint64_t> wouldBlock_{0};
+		std::atomic<std::uint64_t> dropped_{0};
+	};
+
+} // namespace gateway
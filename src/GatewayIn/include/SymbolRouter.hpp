@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "SymbolTable.hpp"
+
+namespace gateway {
+
+	// Maps the markets subscribed on one connection to their global SymbolId and to a dense per-connection
+	// slot (used to index per-market gateway state). Populate before the feed starts; lookups are then
+	// read-only and allocation-free.
+	class SymbolRouter {
+	public:
+		struct Route {
+			std::size_t slot;
+			SymbolId symbol;
+		};
+
+		std::size_t add(std::string_view symbol) {
+			if (auto existing = route(symbol)) return existing->slot;
+			const auto id = internSymbol(symbol);
+			const std::size_t slot = symbols_.size();
+			symbols_.push_back(id);
+			const std::string_view stored = symbolName(id);
+			auto it = std::lower_bound(index_.begin(), index_.end(), stored,
+									   [](const Entry& e, std::string_view s) { return e.name < s; });
+			index_.insert(it, Entry{stored, Route{slot, id}});
+			return slot;
+		}
+
+		[[nodiscard]] std::optional<Route> route(std::string_view symbol) const noexcept {
+			auto it = std::lower_bound(index_.begin(), index_.end(), symbol,
+									   [](const Entry& e, std::string_view s) { return e.name < s; });
+			if (it == index_.end() || it->name != symbol) return std::nullopt;
+			return it->route;
+		}
+
+		[[nodiscard]] std::optional<Route> route(SymbolId id) const noexcept {
+			auto it = std::find(symbols_.begin(), symbols_.end(), id);
+			if (it == symbols_.end()) return std::nullopt;
+			return Route{static_cast<std::size_t>(it - symbols_.begin()), id};
+		}
+
+		[[nodiscard]] SymbolId symbol(std::size_t slot) const { return symbols_[slot]; }
+		[[nodiscard]] std::string_view name(std::size_t slot) const { return symbolName(symbols_[slot]); }
+		[[nodiscard]] std::size_t size() const noexcept { return symbols_.size(); }
+
+		[[nodiscard]] std::vector<std::string_view> names() const {
+			std::vector<std::string_view> out;
+			out.reserve(symbols_.size());
+			for (auto id : symbols_) out.push_back(symbolName(id));
+			return out;
+		}
+
+	private:
+		struct Entry {
+			std::string_view name;
+			Route route;
+		};
+
+		std::vector<SymbolId> symbols_;
+		std::vector<Entry> index_;
+	};
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace gateway {
+
+	using SymbolId = std::uint16_t;
+
+	// Process-wide, append-only instrument table. Ids are dense, assigned on first intern() (normally at
+	// subscription time) and never reused, so they can index arrays of books directly.
+	// intern() serialises writers; find() and name() are lock-free.
+	class SymbolTable {
+	public:
+		static constexpr std::size_t kMaxSymbols = 4096;
+
+		static SymbolTable& instance() {
+			static SymbolTable table;
+			return table;
+		}
+
+		SymbolId intern(std::string_view symbol) {
+			if (auto id = find(symbol)) return *id;
+
+			std::lock_guard<std::mutex> lock(writeMutex_);
+			if (auto id = find(symbol)) return *id;
+
+			const auto n = size_.load(std::memory_order_relaxed);
+			if (n >= kMaxSymbols) throw std::length_error("SymbolTable full");
+			names_[n] = std::string(symbol);
+			size_.store(n + 1, std::memory_order_release);
+
+			std::size_t slot = hash(symbol);
+			while (slots_[slot].load(std::memory_order_relaxed) != 0) slot = (slot + 1) & (kSlots - 1);
+			slots_[slot].store(static_cast<std::uint32_t>(n + 1), std::memory_order_release);
+			return static_cast<SymbolId>(n);
+		}
+
+		[[nodiscard]] std::optional<SymbolId> find(std::string_view symbol) const noexcept {
+			std::size_t slot = hash(symbol);
+			while (true) {
+				const auto v = slots_[slot].load(std::memory_order_acquire);
+				if (v == 0) return std::nullopt;
+				if (names_[v - 1] == symbol) return static_cast<SymbolId>(v - 1);
+				slot = (slot + 1) & (kSlots - 1);
+			}
+		}
+
+		// Views stay valid for the lifetime of the process.
+		[[nodiscard]] std::string_view name(SymbolId id) const noexcept {
+			return id < size_.load(std::memory_order_acquire) ? std::string_view(names_[id]) : std::string_view{};
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+	private:
+		static constexpr std::size_t kSlots = kMaxSymbols * 2;
+
+		SymbolTable() = default;
+
+		static std::size_t hash(std::string_view s) noexcept {
+			std::uint64_t h = 1469598103934665603ull;
+			for (unsigned char c : s) h = (h ^ c) * 1099511628211ull;
+			return static_cast<std::size_t>(h) & (kSlots - 1);
+		}
+
+		std::array<std::string, kMaxSymbols> names_{};
+		std::array<std::atomic<std::uint32_t>, kSlots> slots_{};
+		std::atomic<std::size_t> size_{0};
+		std::mutex writeMutex_;
+	};
+
+	inline SymbolId internSymbol(std::string_view symbol) { return SymbolTable::instance().intern(symbol); }
+	inline std::string_view symbolName(SymbolId id) { return SymbolTable::instance().name(id); }
+
+}
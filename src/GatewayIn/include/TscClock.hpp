@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Time-stamp counter for cross-thread latency stamps: now() is one unserialised rdtsc, cheap enough to
+// sprinkle through the hot path. Assumes an invariant TSC, synchronised across cores, as on any recent
+// x86. Elsewhere now() falls back to steady_clock nanoseconds and the calibrated rate is 1.
+class TscClock {
+public:
+	static std::uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	// Measures the tick rate against steady_clock over window; blocks for that long.
+	static TscClock calibrate(std::chrono::milliseconds window = std::chrono::milliseconds(50)) {
+		const auto wall0 = std::chrono::steady_clock::now();
+		const auto tsc0 = now();
+		std::this_thread::sleep_for(window);
+		const auto tsc1 = now();
+		const auto wall1 = std::chrono::steady_clock::now();
+		const auto ns = std::chrono::duration<double, std::nano>(wall1 - wall0).count();
+		return TscClock(tsc1 > tsc0 ? ns / static_cast<double>(tsc1 - tsc0) : 1.0);
+	}
+
+	TscClock() = default;
+
+	[[nodiscard]] std::uint64_t toNs(std::uint64_t ticks) const noexcept {
+		return static_cast<std::uint64_t>(static_cast<double>(ticks) * nsPerTick_);
+	}
+	// Nanoseconds from a to b, 0 when b is not after a.
+	[[nodiscard]] std::uint64_t elapsedNs(std::uint64_t a, std::uint64_t b) const noexcept {
+		return b > a ? toNs(b - a) : 0;
+	}
+	[[nodiscard]] double ghz() const noexcept { return 1.0 / nsPerTick_; }
+
+private:
+	explicit TscClock(double nsPerTick) : nsPerTick_(nsPerTick) {}
+
+	double nsPerTick_{1.0};
+};
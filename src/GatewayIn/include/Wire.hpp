@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gateway {
+
+	// Wire format a network client speaks. Every client passed to QuotesObtainer declares it as
+	// `static constexpr Wire kWire`, which picks the parser and whether subscribe and getBook
+	// requests are sent.
+	enum class Wire : std::uint8_t { Bitvavo, Fix };
+
+} // namespace gateway
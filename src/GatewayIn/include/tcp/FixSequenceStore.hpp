@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gateway {
+
+	// Next outgoing and next expected incoming MsgSeqNum (34) of one FIX session. Opened on a path the
+	// pair lives in a shared mapping of a small file, so it survives reconnects and restarts and an
+	// update is a plain store into the page cache; otherwise it is kept in memory only.
+	class FixSequenceStore {
+	public:
+		FixSequenceStore() = default;
+		~FixSequenceStore() { close(); }
+
+		FixSequenceStore(const FixSequenceStore&) = delete;
+		FixSequenceStore& operator=(const FixSequenceStore&) = delete;
+
+		// Maps path, creating it with both numbers at 1 if it does not exist yet.
+		bool open(const std::string& path) {
+			close();
+			const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+			if (fd < 0) {
+				std::cerr << "FixSequenceStore: cannot open " << path << ": " << std::strerror(errno) << '\n';
+				return false;
+			}
+			struct stat st {};
+			const bool fresh = ::fstat(fd, &st) == 0 && st.st_size == 0;
+			if (fresh && ::ftruncate(fd, sizeof(State)) != 0) {
+				std::cerr << "FixSequenceStore: cannot size " << path << ": " << std::strerror(errno) << '\n';
+				::close(fd);
+				return false;
+			}
+			if (!fresh && st.st_size != static_cast<off_t>(sizeof(State))) {
+				std::cerr << "FixSequenceStore: " << path << " is not a sequence store\n";
+				::close(fd);
+				return false;
+			}
+			void* map = ::mmap(nullptr, sizeof(State), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (map == MAP_FAILED) {
+				std::cerr << "FixSequenceStore: cannot map " << path << ": " << std::strerror(errno) << '\n';
+				return false;
+			}
+
+			if (fresh) {
+				auto* s = new (map) State{};
+				std::memcpy(s->magic, kMagic, sizeof(kMagic));
+				s->version = kVersion;
+			}
+			auto* s = std::launder(static_cast<State*>(map));
+			if (std::memcmp(s->magic, kMagic, sizeof(kMagic)) != 0 || s->version != kVersion) {
+				std::cerr << "FixSequenceStore: " << path << " is not a sequence store\n";
+				::munmap(map, sizeof(State));
+				return false;
+			}
+			state_ = s;
+			return true;
+		}
+
+		// Flushes and unmaps; the numbers reached so far carry on in memory.
+		void close() {
+			if (!persistent()) return;
+			local_.outgoing.store(state_->outgoing.load());
+			local_.incoming.store(state_->incoming.load());
+			::msync(state_, sizeof(State), MS_SYNC);
+			::munmap(state_, sizeof(State));
+			state_ = &local_;
+		}
+
+		// Schedules write-back of the mapping; the page cache already holds the current numbers.
+		void sync() {
+			if (persistent()) ::msync(state_, sizeof(State), MS_ASYNC);
+		}
+
+		[[nodiscard]] bool persistent() const noexcept { return state_ != &local_; }
+
+		[[nodiscard]] std::uint64_t nextOutgoing() const noexcept { return state_->outgoing.load(std::memory_order_acquire); }
+		std::uint64_t takeOutgoing() noexcept { return state_->outgoing.fetch_add(1, std::memory_order_acq_rel); }
+		void setNextOutgoing(std::uint64_t seq) noexcept { state_->outgoing.store(seq, std::memory_order_release); }
+
+		[[nodiscard]] std::uint64_t nextIncoming() const noexcept { return state_->incoming.load(std::memory_order_acquire); }
+		void setNextIncoming(std::uint64_t seq) noexcept { state_->incoming.store(seq, std::memory_order_release); }
+
+		void reset() noexcept {
+			setNextOutgoing(1);
+			setNextIncoming(1);
+		}
+
+	private:
+		static constexpr char kMagic[8] = {'H', 'F', 'T', 'S', 'E', 'Q', 'N', 'O'};
+		static constexpr std::uint32_t kVersion = 1;
+
+		struct State {
+			char magic[8]{};
+			std::uint32_t version{0};
+			std::uint32_t reserved{0};
+			std::atomic<std::uint64_t> outgoing{1};
+			std::atomic<std::uint64_t> incoming{1};
+		};
+		static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "sequence numbers are shared through a file mapping");
+
+		State local_;
+		State* state_{&local_};
+	};
+
+} // namespace gateway
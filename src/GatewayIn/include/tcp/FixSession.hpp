@@ -0,0 +1,523 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include "FixSequenceStore.hpp"
+
+namespace gateway {
+
+	struct FixSessionConfig {
+		std::string senderCompId{"FIXSIM-CLIENT-MKD"};
+		std::string targetCompId{"FIXSIM-SERVER-MKD"};
+		std::chrono::seconds heartbeatInterval{30};   // HeartBtInt (108) proposed in our Logon
+		bool resetOnLogon{false};                      // start both directions at 1 and send 141=Y
+		std::string sequenceStorePath;                 // empty: sequence numbers live in memory only
+	};
+
+	// FIX 4.4 session layer of an initiator. The receive thread calls onMessage() for every inbound
+	// message: it checks MsgSeqNum, applies SequenceResets and Logon resets, and hands application
+	// messages straight back. Everything that needs a reply or a timer (Logon, Heartbeat, TestRequest,
+	// ResendRequest, SequenceReset-GapFill, Logout) runs on a separate admin thread fed through a
+	// lock-free queue, so the data path never formats or writes an administrative message.
+	//
+	// Messages behind a sequence gap are dropped rather than queued; the ResendRequest (7=first
+	// missing, 16=0) brings them back as PossDup in order. Peer ResendRequests are answered with a
+	// single SequenceReset-GapFill: nothing this session sends is worth replaying after the fact.
+	class FixSession {
+	public:
+		using Clock = std::chrono::steady_clock;
+		// Puts one complete message on the wire; critical asks to skip any send queue when it can.
+		using Writer = std::function<bool(std::string_view, bool critical)>;
+		using LogonHandler = std::function<void()>;
+		using FatalHandler = std::function<void(std::string_view)>;
+
+		// What the receive thread should do with a message after onMessage().
+		enum class Inbound : std::uint8_t {
+			Deliver,      // in-sequence application message
+			Consumed,     // administrative, duplicate or behind a gap
+			Disconnect    // unrecoverable; the admin thread logs out and calls the fatal handler
+		};
+
+		explicit FixSession(FixSessionConfig config = {}) : config_(std::move(config)) {
+			if (!config_.sequenceStorePath.empty()) store_.open(config_.sequenceStorePath);
+			heartbeatSeconds_.store(config_.heartbeatInterval.count());
+		}
+
+		~FixSession() { stop(); }
+
+		FixSession(const FixSession&) = delete;
+		FixSession& operator=(const FixSession&) = delete;
+
+		// Always called under the session's send lock.
+		void setWriter(Writer writer) { writer_ = std::move(writer); }
+		// Runs on the admin thread once the counterparty has acknowledged our Logon.
+		void setLogonHandler(LogonHandler handler) { onLogon_ = std::move(handler); }
+		// Runs on the admin thread after a Logout went out or came in; the transport should be closed.
+		void setFatalHandler(FatalHandler handler) { onFatal_ = std::move(handler); }
+
+		// Starts the admin thread, which sends our Logon first.
+		void start() {
+			if (running_.exchange(true)) return;
+			admin_ = std::thread([this] { run(); });
+		}
+
+		// Stops the admin thread. Sequence numbers are kept for the next connection.
+		void stop() {
+			running_ = false;
+			wake();
+			if (admin_.joinable()) {
+				if (std::this_thread::get_id() != admin_.get_id()) admin_.join();
+				else admin_.detach();
+			}
+			tasks_.reset();
+			loggedOn_ = false;
+			loggingOut_ = false;
+			gapEnd_ = 0;
+			gapOpen_ = false;
+			lastRxAt_.reset();
+			lastTxAt_.reset();
+			testRequestAt_.reset();
+			store_.sync();
+		}
+
+		// Receive thread. Messages must be complete, from 8= through the 10= trailer.
+		Inbound onMessage(std::string_view message) {
+			received_.fetch_add(1, std::memory_order_relaxed);
+			const Header h = scan(message);
+			if (h.seq == 0) {
+				push({.kind = Task::Kind::Malformed});
+				return Inbound::Disconnect;
+			}
+
+			if (h.type == "A" && h.resetSeqNum) store_.setNextIncoming(h.seq);
+			if (h.type == "4" && !h.gapFill) {
+				// Reset mode ignores MsgSeqNum. Moving backwards is refused; the peer has to log on afresh.
+				if (h.newSeqNo > store_.nextIncoming()) store_.setNextIncoming(h.newSeqNo);
+				else if (h.newSeqNo < store_.nextIncoming()) push({.kind = Task::Kind::Reject, .a = h.seq}, "NewSeqNo lower than expected");
+				closeGapIfFilled();
+				return Inbound::Consumed;
+			}
+
+			const auto expected = store_.nextIncoming();
+			if (h.seq < expected) {
+				// PossDupFlag sits further into the header than the early stop of scan() reaches.
+				if (h.possDup || scan(message, true).possDup) {
+					duplicates_.fetch_add(1, std::memory_order_relaxed);
+					return Inbound::Consumed;
+				}
+				push({.kind = Task::Kind::SeqTooLow, .a = expected, .b = h.seq});
+				return Inbound::Disconnect;
+			}
+			if (h.seq > expected) {
+				if (!gapOpen_.load(std::memory_order_relaxed)) {
+					gapOpen_.store(true, std::memory_order_relaxed);
+					gaps_.fetch_add(1, std::memory_order_relaxed);
+					push({.kind = Task::Kind::Gap, .a = expected, .b = h.seq});
+				}
+				if (h.seq > gapEnd_) gapEnd_ = h.seq;
+				// A Logon or Logout still counts; anything else comes again with the resend.
+				if (h.type == "A") return logonAck(h);
+				if (h.type == "5") return logout(h);
+				return Inbound::Consumed;
+			}
+
+			store_.setNextIncoming(h.type == "4" ? (h.newSeqNo > h.seq ? h.newSeqNo : h.seq + 1) : h.seq + 1);
+			closeGapIfFilled();
+
+			if (h.type.size() != 1) return Inbound::Deliver;
+			switch (h.type.front()) {
+				case '0': return Inbound::Consumed;
+				case '1': push({.kind = Task::Kind::TestRequest}, h.testReqId); return Inbound::Consumed;
+				case '2': push({.kind = Task::Kind::Resend, .a = h.beginSeqNo, .b = h.endSeqNo}); return Inbound::Consumed;
+				case '3': push({.kind = Task::Kind::Reject, .a = h.refSeqNum}, h.text); return Inbound::Consumed;
+				case '4': return Inbound::Consumed;
+				case '5': return logout(h);
+				case 'A': return logonAck(h);
+				default: return Inbound::Deliver;
+			}
+		}
+
+		// Any thread. Frames body as msgType with the next MsgSeqNum and writes it.
+		bool send(std::string_view msgType, std::string_view body) {
+			std::lock_guard lock(sendMutex_);
+			return write(frame(msgType, store_.takeOutgoing(), body, false));
+		}
+
+		// Any thread. Writes a message framed elsewhere, e.g. by OrderSender, under the session's next
+		// MsgSeqNum: patch(seq) fills the number in and returns the finished message. Both run under the
+		// send lock, so the numbers go out in order and are kept in the store with the session's own.
+		// An empty result writes nothing; the number is spent and a later ResendRequest gap-fills it.
+		template<class Patch>
+		bool sendSequenced(Patch&& patch, bool critical = false) {
+			std::lock_guard lock(sendMutex_);
+			const std::string_view message = patch(store_.takeOutgoing());
+			return !message.empty() && write(message, critical);
+		}
+
+		bool logon() {
+			if (config_.resetOnLogon) store_.reset();
+			std::string body = "98=0\x01" "108=";
+			body += std::to_string(config_.heartbeatInterval.count());
+			body += '\x01';
+			if (config_.resetOnLogon) body += "141=Y\x01";
+			return send("A", body);
+		}
+
+		// Drains the admin queue and runs the heartbeat timers as of now. The admin thread calls it
+		// on every wake-up; it is public so tests can drive the timers with their own clock.
+		void poll(Clock::time_point now) {
+			Task task;
+			while (tasks_.pop(task)) handle(task, now);
+
+			const auto rx = received_.load(std::memory_order_relaxed);
+			if (rx != lastReceived_ || !lastRxAt_) {
+				lastReceived_ = rx;
+				lastRxAt_ = now;
+				testRequestAt_.reset();
+			}
+			const auto tx = sent_.load(std::memory_order_relaxed);
+			if (tx != lastSent_ || !lastTxAt_) {
+				lastSent_ = tx;
+				lastTxAt_ = now;
+			}
+			if (!loggedOn_) return;
+
+			const std::chrono::seconds interval{heartbeatSeconds_.load(std::memory_order_relaxed)};
+			if (now - *lastTxAt_ >= interval) {
+				send("0", {});
+				heartbeats_.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (testRequestAt_) {
+				if (now - *testRequestAt_ >= interval) fail("no Heartbeat in answer to TestRequest");
+			} else if (now - *lastRxAt_ >= interval + interval / 5) {
+				std::string body = "112=TEST-";
+				body += std::to_string(++testRequestId_);
+				body += '\x01';
+				send("1", body);
+				testRequestAt_ = now;
+				testRequests_.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (gapOpen_.load(std::memory_order_relaxed) && now - resendAt_ >= interval) requestResend(now);
+			if (now - syncAt_ >= interval) {
+				store_.sync();
+				syncAt_ = now;
+			}
+		}
+
+		[[nodiscard]] bool loggedOn() const noexcept { return loggedOn_; }
+		[[nodiscard]] std::uint64_t nextOutgoing() const noexcept { return store_.nextOutgoing(); }
+		[[nodiscard]] std::uint64_t nextIncoming() const noexcept { return store_.nextIncoming(); }
+		[[nodiscard]] std::chrono::seconds heartbeatInterval() const noexcept { return std::chrono::seconds{heartbeatSeconds_.load()}; }
+		FixSequenceStore& store() noexcept { return store_; }
+		[[nodiscard]] const FixSessionConfig& config() const noexcept { return config_; }
+
+		[[nodiscard]] std::uint64_t gaps() const noexcept { return gaps_.load(); }
+		[[nodiscard]] std::uint64_t resendRequests() const noexcept { return resendRequests_.load(); }
+		[[nodiscard]] std::uint64_t duplicates() const noexcept { return duplicates_.load(); }
+		[[nodiscard]] std::uint64_t heartbeats() const noexcept { return heartbeats_.load(); }
+		[[nodiscard]] std::uint64_t testRequests() const noexcept { return testRequests_.load(); }
+
+	private:
+		static constexpr auto kTick = std::chrono::milliseconds(100);
+		static constexpr std::size_t kTextSize = 64;
+
+		struct Task {
+			enum class Kind : std::uint8_t { LogonAck, TestRequest, Resend, Gap, Reject, Logout, SeqTooLow, Malformed };
+			Kind kind{Kind::LogonAck};
+			std::uint64_t a{0};
+			std::uint64_t b{0};
+			std::uint8_t textSize{0};
+			std::array<char, kTextSize> text{};
+
+			[[nodiscard]] std::string_view textView() const noexcept { return {text.data(), textSize}; }
+		};
+
+		struct Header {
+			std::string_view type;
+			std::uint64_t seq{0};
+			bool possDup{false};
+			bool gapFill{false};
+			bool resetSeqNum{false};
+			std::uint64_t newSeqNo{0};
+			std::uint64_t beginSeqNo{0};
+			std::uint64_t endSeqNo{0};
+			std::uint64_t refSeqNum{0};
+			std::int64_t heartBtInt{0};
+			std::string_view testReqId;
+			std::string_view text;
+		};
+
+		static bool isAdmin(std::string_view type) noexcept {
+			return type.size() == 1 && (type.front() == 'A' || (type.front() >= '0' && type.front() <= '5'));
+		}
+
+		template<class T>
+		static void number(std::string_view s, T& out) noexcept {
+			std::from_chars(s.data(), s.data() + s.size(), out);
+		}
+
+		// One pass over the fields. Unless full, application messages stop as soon as MsgType and
+		// MsgSeqNum are known, which for a well-formed header is within its first few fields.
+		static Header scan(std::string_view m, bool full = false) noexcept {
+			Header h;
+			std::size_t pos = 0;
+			while (pos < m.size()) {
+				const auto eq = m.find('=', pos);
+				if (eq == std::string_view::npos) break;
+				const auto soh = m.find('\x01', eq);
+				if (soh == std::string_view::npos) break;
+				const auto value = m.substr(eq + 1, soh - eq - 1);
+				unsigned tag = 0;
+				for (auto i = pos; i < eq; ++i) tag = tag * 10 + static_cast<unsigned>(m[i] - '0');
+				pos = soh + 1;
+
+				switch (tag) {
+					case 35: h.type = value; break;
+					case 34: number(value, h.seq); break;
+					case 43: h.possDup = value == "Y"; break;
+					case 123: h.gapFill = value == "Y"; break;
+					case 141: h.resetSeqNum = value == "Y"; break;
+					case 36: number(value, h.newSeqNo); break;
+					case 7: number(value, h.beginSeqNo); break;
+					case 16: number(value, h.endSeqNo); break;
+					case 45: number(value, h.refSeqNum); break;
+					case 108: number(value, h.heartBtInt); break;
+					case 112: h.testReqId = value; break;
+					case 58: h.text = value; break;
+					default: break;
+				}
+				if (!full && h.seq && !h.type.empty() && !isAdmin(h.type)) break;
+			}
+			return h;
+		}
+
+		void push(Task task, std::string_view text = {}) {
+			task.textSize = static_cast<std::uint8_t>(text.size() < kTextSize ? text.size() : kTextSize);
+			std::copy_n(text.data(), task.textSize, task.text.data());
+			if (!tasks_.push(task)) {
+				std::cerr << "FixSession: admin queue full, dropping task\n";
+				return;
+			}
+			wake();
+		}
+
+		void wake() {
+			{ std::lock_guard lock(wakeMutex_); }
+			wakeUp_.notify_one();
+		}
+
+		void closeGapIfFilled() noexcept {
+			if (gapOpen_.load(std::memory_order_relaxed) && store_.nextIncoming() > gapEnd_) {
+				gapOpen_.store(false, std::memory_order_relaxed);
+				gapEnd_ = 0;
+			}
+		}
+
+		Inbound logonAck(const Header& h) {
+			if (h.heartBtInt > 0) heartbeatSeconds_.store(h.heartBtInt, std::memory_order_relaxed);
+			push({.kind = Task::Kind::LogonAck});
+			return Inbound::Consumed;
+		}
+
+		Inbound logout(const Header& h) {
+			push({.kind = Task::Kind::Logout}, h.text);
+			return Inbound::Consumed;
+		}
+
+		void run() {
+			logon();
+			while (running_) {
+				{
+					std::unique_lock lock(wakeMutex_);
+					wakeUp_.wait_for(lock, kTick, [this] { return !running_ || tasks_.read_available() > 0; });
+				}
+				if (running_) poll(Clock::now());
+			}
+		}
+
+		void handle(const Task& task, Clock::time_point now) {
+			switch (task.kind) {
+				case Task::Kind::LogonAck:
+					loggedOn_ = true;
+					if (onLogon_) onLogon_();
+					break;
+				case Task::Kind::TestRequest: {
+					std::string body = "112=";
+					body.append(task.textView());
+					body += '\x01';
+					send("0", body);
+					heartbeats_.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+				case Task::Kind::Resend:
+					gapFill(task.a, task.b);
+					break;
+				case Task::Kind::Gap:
+					std::cerr << "FixSession: sequence gap, expected " << task.a << " received " << task.b << '\n';
+					requestResend(now);
+					break;
+				case Task::Kind::Reject:
+					std::cerr << "FixSession: session reject of " << task.a << ": " << task.textView() << '\n';
+					break;
+				case Task::Kind::Logout:
+					if (loggingOut_) {
+						// The answer to our own Logout; the fatal handler has already run.
+						loggingOut_ = false;
+						break;
+					}
+					send("5", {});
+					loggedOn_ = false;
+					if (onFatal_) onFatal_(task.textSize ? task.textView() : std::string_view("logged out by counterparty"));
+					break;
+				case Task::Kind::SeqTooLow:
+					fail("MsgSeqNum too low, expected " + std::to_string(task.a) + " received " + std::to_string(task.b));
+					break;
+				case Task::Kind::Malformed:
+					fail("MsgSeqNum missing");
+					break;
+			}
+		}
+
+		void requestResend(Clock::time_point now) {
+			std::string body = "7=";
+			body += std::to_string(store_.nextIncoming());
+			body += "\x01" "16=0\x01";
+			send("2", body);
+			resendAt_ = now;
+			resendRequests_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Answers a ResendRequest for [begin, end] (end 0: everything) with one SequenceReset-GapFill.
+		void gapFill(std::uint64_t begin, std::uint64_t end) {
+			std::lock_guard lock(sendMutex_);
+			const auto next = store_.nextOutgoing();
+			if (begin == 0 || begin >= next) return;
+			const auto newSeqNo = end == 0 || end + 1 >= next ? next : end + 1;
+			std::string body = "123=Y\x01" "36=";
+			body += std::to_string(newSeqNo);
+			body += '\x01';
+			write(frame("4", begin, body, true));
+		}
+
+		void fail(std::string_view reason) {
+			std::cerr << "FixSession: " << reason << ", logging out\n";
+			if (loggedOn_) {
+				std::string body = "58=";
+				body += reason;
+				body += '\x01';
+				send("5", body);
+			}
+			loggedOn_ = false;
+			loggingOut_ = true;
+			testRequestAt_.reset();
+			if (onFatal_) onFatal_(reason);
+		}
+
+		bool write(std::string_view message, bool critical = false) {
+			sent_.fetch_add(1, std::memory_order_relaxed);
+			return writer_ && writer_(message, critical);
+		}
+
+		// Called under sendMutex_. The returned view stays valid until the next call.
+		std::string_view frame(std::string_view msgType, std::uint64_t seq, std::string_view body, bool possDup) {
+			char stamp[24];
+			const auto wall = std::chrono::system_clock::now();
+			const auto secs = std::chrono::system_clock::to_time_t(wall);
+			const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(wall.time_since_epoch()).count() % 1000;
+			std::tm utc {};
+			gmtime_r(&secs, &utc);
+			const auto n = std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H:%M:%S", &utc);
+			std::snprintf(stamp + n, sizeof(stamp) - n, ".%03d", static_cast<int>(ms));
+
+			body_.clear();
+			body_ += "35=";
+			body_ += msgType;
+			body_ += "\x01" "49=";
+			body_ += config_.senderCompId;
+			body_ += "\x01" "56=";
+			body_ += config_.targetCompId;
+			body_ += "\x01" "34=";
+			body_ += std::to_string(seq);
+			if (possDup) {
+				body_ += "\x01" "43=Y\x01" "122=";
+				body_ += stamp;
+			}
+			body_ += "\x01" "52=";
+			body_ += stamp;
+			body_ += '\x01';
+			body_ += body;
+
+			out_ = "8=FIX.4.4\x01" "9=";
+			out_ += std::to_string(body_.size());
+			out_ += '\x01';
+			out_ += body_;
+			unsigned sum = 0;
+			for (const unsigned char c : out_) sum += c;
+			char trailer[8] = {'1', '0', '=', static_cast<char>('0' + sum % 256 / 100), static_cast<char>('0' + sum % 100 / 10),
+			                   static_cast<char>('0' + sum % 10), '\x01', 0};
+			out_ += trailer;
+			return out_;
+		}
+
+		FixSessionConfig config_;
+		FixSequenceStore store_;
+		Writer writer_;
+		LogonHandler onLogon_;
+		FatalHandler onFatal_;
+
+		std::mutex sendMutex_;
+		std::string body_;
+		std::string out_;
+
+		boost::lockfree::spsc_queue<Task, boost::lockfree::capacity<256>> tasks_;
+		std::thread admin_;
+		std::mutex wakeMutex_;
+		std::condition_variable wakeUp_;
+		std::atomic<bool> running_{false};
+		std::atomic<bool> loggedOn_{false};
+		std::atomic<std::int64_t> heartbeatSeconds_{30};
+
+		// Receive thread only.
+		std::uint64_t gapEnd_{0};
+		std::atomic<bool> gapOpen_{false};
+
+		// Counted on the data path, turned into times by the admin thread.
+		std::atomic<std::uint64_t> received_{0};
+		std::atomic<std::uint64_t> sent_{0};
+
+		// Admin thread only.
+		std::uint64_t lastReceived_{0};
+		std::uint64_t lastSent_{0};
+		std::optional<Clock::time_point> lastRxAt_;
+		std::optional<Clock::time_point> lastTxAt_;
+		std::optional<Clock::time_point> testRequestAt_;
+		Clock::time_point resendAt_{};
+		Clock::time_point syncAt_{};
+		std::uint64_t testRequestId_{0};
+		bool loggingOut_{false};
+
+		std::atomic<std::uint64_t> gaps_{0};
+		std::atomic<std::uint64_t> resendRequests_{0};
+		std::atomic<std::uint64_t> duplicates_{0};
+		std::atomic<std::uint64_t> heartbeats_{0};
+		std::atomic<std::uint64_t> testRequests_{0};
+	};
+
+} // namespace gateway
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <chrono>
 #include <string_view>
 #include <thread>
 #include <atomic>
 #include <array>
+#include <memory>
+
+#include "SendQueue.hpp"
 
 namespace gateway {
 
@@ -22,11 +26,32 @@ public:
 
 	void setConnectTimeout(std::chrono::milliseconds timeout);
 	[[nodiscard]] std::chrono::milliseconds getConnectTimeout() const;
+	// Takes effect on the next connect().
+	void setSendOptions(const SendOptions& options);
+	[[nodiscard]] const SendOptions& getSendOptions() const { return send_queue_->options(); }
+
 	bool connect(std::string_view host, std::string_view port);
     void disconnect();
+    // Queued: returns once the message is in the send ring, false if the ring is full. Otherwise
+    // writes on the caller's thread. Calls from several threads must be serialised by the caller.
     bool send(const std::string_view& message);
+    // As send(), but tries one non-blocking write first when nothing is queued ahead of the message.
+    bool sendCritical(std::string_view message);
+    // Writes out queued messages when SendOptions::senderThread is off; returns the bytes written.
+    std::size_t drainSends() { return send_queue_->drain(); }
+
+    [[nodiscard]] SendStats sendStats() const { return send_queue_->stats(); }
+    [[nodiscard]] const LatencyHistogram& sendLatency() const { return send_queue_->latency(); }
 
 protected:
+    // send() without reporting failures to the derived class.
+    bool write(std::string_view message, bool critical) noexcept;
+    long writeBatch(const iovec* iov, std::size_t count) noexcept;
+
+    template<class Start>
+    boost::system::error_code awaitStep(std::chrono::steady_clock::time_point deadline, Start&& start);
+    // Stops the sender, closes the socket and joins the receive thread, without calling back into Derived.
+    void closeTransport();
     void startReceive();
     void handleReceive(const char* data, std::size_t size);
     void runIoService();
@@ -37,6 +62,7 @@ protected:
     std::thread io_thread_;
     std::atomic<bool> running_{false};
 	std::chrono::milliseconds connect_timeout_{5000};
+	std::unique_ptr<SendQueue> send_queue_ = std::make_unique<SendQueue>();
     
     static constexpr std::size_t max_buffer_size = 8192;
     std::array<char, max_buffer_size> receive_buffer_{};
@@ -1,7 +1,10 @@
 
 #pragma once
+#include <cerrno>
 #include <iostream>
 
+#include <sys/socket.h>
+
 namespace gateway {
 
 	template<typename Derived>
@@ -9,7 +12,8 @@ namespace gateway {
 
 	template<typename Derived>
 	NetworkClientBase<Derived>::~NetworkClientBase() {
-		disconnect();
+		// The derived part is already destroyed, so only the transport is torn down here.
+		closeTransport();
 	}
 
 	template<typename Derived>
@@ -20,6 +24,7 @@ namespace gateway {
 			  io_thread_(),
 			  running_(false),
 			  connect_timeout_(other.connect_timeout_),
+			  send_queue_(std::make_unique<SendQueue>(other.send_queue_->options())),
 			  receive_buffer_(other.receive_buffer_)
 	{
 		bool was_running = other.running_.exchange(false);
@@ -46,11 +51,20 @@ namespace gateway {
 	template<typename Derived>
 	bool NetworkClientBase<Derived>::connect(std::string_view host, std::string_view port) {
 		try {
+			// Resolve and connect share one connect_timeout_ budget.
+			const auto deadline = std::chrono::steady_clock::now() + connect_timeout_;
 			boost::asio::ip::tcp::resolver resolver(io_service_);
-			auto endpoints = resolver.resolve(host, port);
-
-			boost::system::error_code ec;
-			boost::asio::connect(socket_, endpoints, ec);
+			// A resolve that times out still completes later, so its result must outlive this call.
+			auto endpoints = std::make_shared<boost::asio::ip::tcp::resolver::results_type>();
+			auto ec = awaitStep(deadline, [&](auto done) {
+				resolver.async_resolve(host, port, [endpoints, done](boost::system::error_code e, auto results) {
+					*endpoints = std::move(results);
+					done(e);
+				});
+			});
+			if (!ec) {
+				ec = awaitStep(deadline, [&](auto done) { boost::asio::async_connect(socket_, *endpoints, done); });
+			}
 
 			if (ec) {
 				std::cerr << "Connection failed: " << ec.message() << std::endl;
@@ -59,6 +73,9 @@ namespace gateway {
 
 			socket_.non_blocking(true);
 			running_ = true;
+			if (send_queue_->options().queued) {
+				send_queue_->start([this](const iovec* iov, std::size_t count) { return writeBatch(iov, count); });
+			}
 
 			receive_thread_ = std::thread([this]() {
 				static_cast<Derived*>(this)->startReceive();
@@ -72,10 +89,36 @@ namespace gateway {
 		}
 	}
 
+	// Runs one asynchronous connect step on the caller's thread until it completes or deadline passes.
+	// On timeout the socket is closed, which aborts the step, and timed_out is returned. Only connect()
+	// runs io_service_; the connected socket is then used synchronously.
+	template<typename Derived>
+	template<class Start>
+	boost::system::error_code NetworkClientBase<Derived>::awaitStep(std::chrono::steady_clock::time_point deadline, Start&& start) {
+		auto result = std::make_shared<boost::system::error_code>(boost::asio::error::would_block);
+		start([result](boost::system::error_code ec, auto&&...) { *result = ec; });
+		io_service_.restart();
+		while (*result == boost::asio::error::would_block && io_service_.run_one_until(deadline)) {}
+		if (*result != boost::asio::error::would_block) return *result;
+
+		boost::system::error_code ignored;
+		socket_.close(ignored);
+		io_service_.restart();
+		io_service_.poll();
+		return boost::asio::error::timed_out;
+	}
+
 	template<typename Derived>
 	void NetworkClientBase<Derived>::disconnect() {
 		std::cout << "Disconnect called" << std::endl;
+		closeTransport();
+		static_cast<Derived*>(this)->onDisconnect();
+	}
+
+	template<typename Derived>
+	void NetworkClientBase<Derived>::closeTransport() {
 		running_ = false;
+		send_queue_->stop();
 
 		if (socket_.is_open()) {
 			boost::system::error_code ec;
@@ -92,11 +135,16 @@ namespace gateway {
 			}
 			receive_thread_ = std::thread();
 		}
-		static_cast<Derived*>(this)->onDisconnect();
+	}
+
+	template<typename Derived>
+	void NetworkClientBase<Derived>::setSendOptions(const SendOptions& options) {
+		send_queue_ = std::make_unique<SendQueue>(options);
 	}
 
 	template<typename Derived>
 	bool NetworkClientBase<Derived>::send(const std::string_view& message) {
+		if (send_queue_->options().queued) return send_queue_->push(message);
 		try {
 			std::size_t bytes_sent = boost::asio::write(
 					socket_,
@@ -110,6 +158,32 @@ namespace gateway {
 		}
 	}
 
+	template<typename Derived>
+	bool NetworkClientBase<Derived>::sendCritical(std::string_view message) {
+		if (send_queue_->options().queued) return send_queue_->pushCritical(message);
+		return send(message);
+	}
+
+	template<typename Derived>
+	bool NetworkClientBase<Derived>::write(std::string_view message, bool critical) noexcept {
+		if (send_queue_->options().queued) return critical ? send_queue_->pushCritical(message) : send_queue_->push(message);
+		boost::system::error_code ec;
+		boost::asio::write(socket_, boost::asio::buffer(message.data(), message.size()), ec);
+		return !ec;
+	}
+
+	// One sendmsg() for the whole batch. The socket is non-blocking, so a full send buffer comes back
+	// as 0 and the queue retries; MSG_NOSIGNAL keeps a closed peer from raising SIGPIPE.
+	template<typename Derived>
+	long NetworkClientBase<Derived>::writeBatch(const iovec* iov, std::size_t count) noexcept {
+		msghdr msg{};
+		msg.msg_iov = const_cast<iovec*>(iov);
+		msg.msg_iovlen = count;
+		const auto n = ::sendmsg(socket_.native_handle(), &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (n >= 0) return static_cast<long>(n);
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+	}
+
 	template<typename Derived>
 	void NetworkClientBase<Derived>::startReceive() {
 		boost::system::error_code ec;
@@ -1,11 +1,14 @@
 #pragma once
 
+#include "FixSession.hpp"
 #include "NetworkClientBase.hpp"
 #include "QuotesObtainer.hpp"
+#include "Wire.hpp"
 #include <iostream>
-#include <chrono>
-#include <iomanip>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace gateway {
 
@@ -13,8 +16,9 @@ namespace gateway {
 	public:
 		using MessageHandler = std::function<void(std::string_view)>;
 		using ErrorHandler = std::function<void(std::string_view)>;
+		static constexpr Wire kWire = Wire::Fix;
 
-		PixNetworkClient() = default;
+		PixNetworkClient() { bindSession(); }
 		PixNetworkClient(const PixNetworkClient&) = delete;
 		PixNetworkClient& operator=(const PixNetworkClient&) = delete;
 		PixNetworkClient(PixNetworkClient&& other) noexcept
@@ -22,17 +26,20 @@ namespace gateway {
 				, messageHandler_(std::move(other.messageHandler_))
 				, errorHandler_(std::move(other.errorHandler_))
 				, sliding_buffer_(std::move(other.sliding_buffer_))
-				, outgoingSeqNum_(other.outgoingSeqNum_)
-				, loggedOn_(other.loggedOn_.load())
-				, senderCompId_(std::move(other.senderCompId_))
-				, targetCompId_(std::move(other.targetCompId_))
+				, session_(std::move(other.session_))
+				, mdReqId_(other.mdReqId_)
+				, symbols_(std::move(other.symbols_))
 		{
-			other.loggedOn_.store(false);
-			other.outgoingSeqNum_ = 1;
+			other.session_ = std::make_unique<FixSession>(session_->config());
+			other.bindSession();
+			bindSession();
 		}
 
 		PixNetworkClient& operator=(PixNetworkClient&&) noexcept = delete;
 
+		// Joins the receive thread while session_ is still alive; the base destructor only closes the socket.
+		~PixNetworkClient() { disconnect(); }
+
 		void setMessageHandler(MessageHandler handler) {
 			messageHandler_ = std::move(handler);
 		}
@@ -41,59 +48,54 @@ namespace gateway {
 			errorHandler_ = std::move(handler);
 		}
 
+		// Symbols requested in the single MarketDataRequest sent after logon.
+		void setSymbols(const std::vector<std::string>& symbols) {
+			symbols_ = symbols;
+		}
+
+		// CompIDs, heartbeat interval and sequence store of the session. Takes effect on the next connect.
+		void setSessionConfig(FixSessionConfig config) {
+			session_ = std::make_unique<FixSession>(std::move(config));
+			bindSession();
+		}
+
+		FixSession& session() noexcept { return *session_; }
+
 		void handleMessage(std::string_view message) {
 			if (messageHandler_) {
 				messageHandler_(message);
 			}
 		}
 
-		bool isLogonAck(const std::string_view& fix_msg) const {
-			return fix_msg.find("35=A") != std::string::npos &&
-				   fix_msg.find("49=" + targetCompId_) != std::string::npos &&
-				   fix_msg.find("56=" + senderCompId_) != std::string::npos;
-		}
-
 		void handleReceive(const char* data, std::size_t size) {
 			sliding_buffer_.append(data, size);
 
+			std::size_t start = 0;
 			while (true) {
-				std::size_t msg_end = findFixMessageEnd(sliding_buffer_);
+				std::size_t msg_end = findFixMessageEnd(sliding_buffer_, start);
 				if (msg_end == std::string::npos)
 					break;
 
-				std::string_view fix_msg(sliding_buffer_.data(), msg_end);
-
-				if (isLogonAck(fix_msg) && !loggedOn_.exchange(true)) {
-//					std::cout << "Logged in let's go" << std::endl;
-					loggedOn_.store(true);
-					sendMarketDataRequest("EUR/USD");
-				} else {
+				std::string_view fix_msg(sliding_buffer_.data() + start, msg_end - start);
+				if (session_->onMessage(fix_msg) == FixSession::Inbound::Deliver) {
 					handleMessage(fix_msg);
 				}
-				sliding_buffer_.erase(0, msg_end);
+				start = msg_end;
 			}
+			sliding_buffer_.erase(0, start);
 		}
 
-		void loginAndSubscribe(std::string_view symbol) {
-			sendFixLogon();
-		}
-
-		void sendFixLogon() {
-			std::cout << "sending logon" << std::endl;
-			std::ostringstream fields;
-			fields << "98=0" << '\x01';
-			fields << "108=30" << '\x01';
-
-			std::string fix = buildFixMessage("A", fields.str());
-			send(fix);
+		// Writes a message framed elsewhere, e.g. by OrderSender, numbered by the session; see
+		// FixSession::sendSequenced(). Critical messages go straight to the socket when nothing is queued.
+		template<class Patch>
+		bool sendSequenced(Patch&& patch, bool critical = false) {
+			return session_->sendSequenced(std::forward<Patch>(patch), critical);
 		}
 
-		void sendMarketDataRequest(std::string_view symbol) {
-			static int reqCounter = 1;
-
+		void sendMarketDataRequest(const std::vector<std::string>& symbols) {
 			std::ostringstream fixBody;
 
-			fixBody << "262=req-" << reqCounter++ << '\x01';
+			fixBody << "262=req-" << ++mdReqId_ << '\x01';
 			fixBody << "263=1" << '\x01';
 			fixBody << "264=1" << '\x01';
 			fixBody << "265=0" << '\x01';
@@ -102,87 +104,22 @@ namespace gateway {
 			fixBody << "269=1" << '\x01';
 
 
-			fixBody << "146=1" << '\x01';
-			fixBody << "55=" << symbol << '\x01';
-			fixBody << "460=4" << '\x01';
-
-			std::string fix = buildFixMessage("V", fixBody.str());
-
-			for (char c : fix) std::cout << (c == '\x01' ? '|' : c);
-			std::cout << std::endl;
+			fixBody << "146=" << symbols.size() << '\x01';
+			for (const auto& symbol : symbols) {
+				fixBody << "55=" << symbol << '\x01';
+				fixBody << "460=4" << '\x01';
+			}
 
-			send(fix);
+			session_->send("V", fixBody.str());
 		}
 
 		void onConnectionReady() {
-			loggedOn_.store(false);
-			loginAndSubscribe("EUR/USD");
+			sliding_buffer_.clear();
+			session_->start();
 		}
 
 		void onDisconnect() {
-			outgoingSeqNum_ = 1;
-			loggedOn_.store(false);
-		}
-
-		std::string formattedUtcNow() {
-			using namespace std::chrono;
-
-			auto now = system_clock::now();
-			auto now_time_t = system_clock::to_time_t(now);
-			auto now_ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
-
-			std::tm utc_tm;
-
-			gmtime_r(&now_time_t, &utc_tm);
-
-
-			std::ostringstream oss;
-			oss << std::put_time(&utc_tm, "%Y%m%d-%H:%M:%S");
-			oss << '.' << std::setfill('0') << std::setw(3) << now_ms.count();
-
-			return oss.str();
-		}
-
-		std::string computeChecksum(const std::string& message) {
-			unsigned int sum = 0;
-			for (unsigned char c : message) {
-				sum += c;
-			}
-			unsigned int checksum = sum % 256;
-
-			std::ostringstream oss;
-			oss << std::setw(3) << std::setfill('0') << checksum;
-			return oss.str();
-		}
-
-		std::string buildFixMessage(
-				const std::string& msgType,
-				const std::string& bodyFields)
-		{
-			std::ostringstream body;
-
-			body << "35=" << msgType << '\x01';
-			body << "49=" << senderCompId_ << '\x01';
-			body << "56=" << targetCompId_ << '\x01';
-			body << "34=" << outgoingSeqNum_++ << '\x01';
-			body << "52=" << formattedUtcNow() << '\x01';
-
-			body << bodyFields;
-
-			const std::string bodyStr = body.str();
-			const std::size_t bodyLength = bodyStr.size();
-
-			std::ostringstream full;
-			full << "8=FIX.4.4" << '\x01';
-			full << "9=" << bodyLength << '\x01';
-			full << bodyStr;
-
-			const std::string msgWithoutChecksum = full.str();
-			const std::string checksum = computeChecksum(msgWithoutChecksum);
-
-			full << "10=" << checksum << '\x01';
-
-			return full.str();
+			session_->stop();
 		}
 
 		void handleError(std::string_view error) {
@@ -193,8 +130,8 @@ namespace gateway {
 			}
 		}
 
-		std::size_t findFixMessageEnd(const std::string& buffer) {
-			std::size_t pos = buffer.find("10=");
+		std::size_t findFixMessageEnd(const std::string& buffer, std::size_t from = 0) {
+			std::size_t pos = buffer.find("10=", from);
 			while (pos != std::string::npos) {
 				if (pos + 6 < buffer.size() && buffer[pos + 6] == '\x01') {
 					return pos + 7;
@@ -205,14 +142,29 @@ namespace gateway {
 		}
 
 	private:
+		void bindSession() {
+			// Write failures are left to the receive thread to notice, so the admin thread never ends
+			// up in the error handler's reconnect path.
+			session_->setWriter([this](std::string_view message, bool critical) {
+				return write(message, critical);
+			});
+			session_->setLogonHandler([this] { sendMarketDataRequest(symbols_); });
+			// Runs on the session's admin thread: only shut the socket down. The receive thread then
+			// fails its read and reports through the error handler, as for any other lost connection.
+			session_->setFatalHandler([this](std::string_view reason) {
+				std::cerr << "FIX session ended: " << reason << '\n';
+				boost::system::error_code ec;
+				socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+			});
+		}
+
 		MessageHandler messageHandler_;
 		ErrorHandler errorHandler_;
 
 		std::string sliding_buffer_;
-		int outgoingSeqNum_ = 1;
-		std::atomic<bool> loggedOn_{false};
-		std::string senderCompId_ = "FIXSIM-CLIENT-MKD";
-		std::string targetCompId_ = "FIXSIM-SERVER-MKD";
+		std::unique_ptr<FixSession> session_ = std::make_unique<FixSession>();
+		std::uint64_t mdReqId_ = 0;
+		std::vector<std::string> symbols_{"EUR/USD"};
 	};
 
 } // namespace gateway
@@ -1,7 +1,10 @@
 #pragma once
 #include "WebSocketClientBase.hpp"
+#include "../../../Parser/include/BitvavoBookParser.hpp"
+#include "../Wire.hpp"
 #include <iostream>
 #include <unordered_set>
+#include <vector>
 
 namespace gateway
 {
@@ -10,6 +13,7 @@ namespace gateway
 	public:
 		using MessageHandler = std::function<void(std::string_view)>;
 		using ErrorHandler = std::function<void(std::string_view)>;
+		static constexpr Wire kWire = Wire::Bitvavo;
 
 		BitvavoWebSocketClient() = default;
 		BitvavoWebSocketClient(const BitvavoWebSocketClient&) = delete;
@@ -33,10 +37,19 @@ namespace gateway
 
 		void subscribeBook(const std::string &market)
 		{
-			markets_.insert(market);
-			std::string sub = R"({"action":"subscribe","channels":[{"name":"book","markets":[")"
-							  + market + R"("]}]})";
-			send(sub);
+			subscribeBooks({market});
+		}
+
+		// One subscribe frame for all markets; they are remembered so resubscribeAll() can replay them.
+		void subscribeBooks(const std::vector<std::string>& markets)
+		{
+			markets_.insert(markets.begin(), markets.end());
+			send(bitvavo::makeSubscribeRequest(markets));
+		}
+
+		void resubscribeAll()
+		{
+			if (!markets_.empty()) send(bitvavo::makeSubscribeRequest(markets_));
 		}
 
 		bool connect(std::string_view host, std::string_view port)
@@ -6,11 +6,27 @@
 #include <boost/beast/ssl.hpp>
 #include <atomic>
 #include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <iostream>
 
+#include "SendQueue.hpp"
+
+struct WebSocketOptions {
+	// Beast leaves permessage-deflate off for clients; enabling it trades CPU per frame for bandwidth.
+	bool permessageDeflate = false;
+	// SO_RCVBUF in bytes, 0 keeps the kernel default.
+	int tcpReceiveBufferBytes = 0;
+	bool tcpNoDelay = true;
+	// Initial capacity of the read buffer. Frames larger than this grow it once and the capacity is kept.
+	std::size_t readBufferBytes = 64 * 1024;
+	std::size_t maxMessageBytes = 16 * 1024 * 1024;
+};
+
 template<typename Derived>
 class WebSocketClientBase {
 public:
@@ -19,6 +35,7 @@ public:
 			  ws_(ioc_, ssl_ctx_) {
 		ssl_ctx_.set_default_verify_paths();
 		ssl_ctx_.set_verify_mode(boost::asio::ssl::verify_peer);
+		read_buffer_.reserve(options_.readBufferBytes);
 	}
 
 	~WebSocketClientBase() {
@@ -34,6 +51,8 @@ public:
 			  ws_(ioc_, ssl_ctx_),
 			  running_(false),
 			  connect_timeout_(other.connect_timeout_),
+			  send_queue_(std::make_unique<gateway::SendQueue>(other.send_queue_->options())),
+			  options_(other.options_),
 			  host_(std::move(other.host_)),
 			  target_(std::move(other.target_))
 	{
@@ -52,32 +71,66 @@ public:
 			ssl_ctx_.set_verify_mode(boost::asio::ssl::verify_peer);
 		} catch (...) {
 		}
+		read_buffer_.reserve(options_.readBufferBytes);
 	}
 	WebSocketClientBase& operator=(WebSocketClientBase&&) = delete;
 
 	void setConnectTimeout(std::chrono::milliseconds t) { connect_timeout_ = t; }
 	std::chrono::milliseconds getConnectTimeout() const { return connect_timeout_; }
 
+	// Takes effect on the next connect().
+	void setOptions(const WebSocketOptions& options) {
+		options_ = options;
+	}
+	const WebSocketOptions& getOptions() const { return options_; }
+
+	// Takes effect on the next connect().
+	void setSendOptions(const gateway::SendOptions& options) {
+		send_queue_ = std::make_unique<gateway::SendQueue>(options);
+	}
+	const gateway::SendOptions& getSendOptions() const { return send_queue_->options(); }
+
 	// For Bitvavo target must be "/v2/"
 	bool connect(std::string_view host, std::string_view port) {
 		host_ = std::string(host);
 		target_ = "/v2/";
+		// A read cut short by the previous connection may have left part of a frame behind.
+		read_buffer_.clear();
+		read_buffer_.reserve(options_.readBufferBytes);
 
 		try {
+			// Resolve, TCP connect and both handshakes share one connect_timeout_ budget.
+			const auto deadline = std::chrono::steady_clock::now() + connect_timeout_;
 			boost::asio::ip::tcp::resolver resolver(ioc_);
-			auto endpoints = resolver.resolve(host_, std::string(port));
-			boost::asio::connect(ws_.next_layer().next_layer(), endpoints);
+			// A resolve that times out still completes later, so its result must outlive this call.
+			auto endpoints = std::make_shared<boost::asio::ip::tcp::resolver::results_type>();
+			throwIfFailed(awaitStep(deadline, [&](auto done) {
+				resolver.async_resolve(host_, std::string(port), [endpoints, done](boost::system::error_code ec, auto results) {
+					*endpoints = std::move(results);
+					done(ec);
+				});
+			}));
+			connectTcp(*endpoints, deadline);
 
 			if(!SSL_set_tlsext_host_name(ws_.next_layer().native_handle(), host_.c_str())) {
 				std::cerr << "TLS ERROR" << std::endl;
 				static_cast<Derived*>(this)->onError("SSL_set_tlsext_host_name failed");
 			}
-			ws_.next_layer().handshake(boost::asio::ssl::stream_base::client);
+			throwIfFailed(awaitStep(deadline, [&](auto done) {
+				ws_.next_layer().async_handshake(boost::asio::ssl::stream_base::client, done);
+			}));
 
 			ws_.set_option(boost::beast::websocket::stream_base::timeout::suggested(boost::beast::role_type::client));
-			ws_.handshake(host_, target_);
+			boost::beast::websocket::permessage_deflate pmd;
+			pmd.client_enable = options_.permessageDeflate;
+			ws_.set_option(pmd);
+			ws_.read_message_max(options_.maxMessageBytes);
+			throwIfFailed(awaitStep(deadline, [&](auto done) { ws_.async_handshake(host_, target_, done); }));
 
 			running_.store(true);
+			if (send_queue_->options().queued) {
+				send_queue_->start([this](const iovec* iov, std::size_t count) { return writeFrame(iov, count); });
+			}
 			derived().onOpen();
 
 			receive_thread_ = std::thread([this] { this->receiveLoop(); });
@@ -90,13 +143,20 @@ public:
 
 	void disconnect() {
 		if (!running_.exchange(false)) return;
+		send_queue_->stop();
 		try {
 			ws_.close(boost::beast::websocket::close_code::normal);
 		} catch (...) {}
 		if (receive_thread_.joinable()) receive_thread_.join();
 	}
 
+	// Queued: hands the frame to the sender thread and returns, false if the send ring is full.
+	// Otherwise writes on the caller's thread. Safe to call from several threads.
 	bool send(std::string_view text) {
+		if (send_queue_->options().queued) {
+			std::lock_guard lock(send_mutex_);
+			return send_queue_->push(text);
+		}
 		try {
 			ws_.write(boost::asio::buffer(text.data(), text.size()));
 			return true;
@@ -106,22 +166,85 @@ public:
 		}
 	}
 
+	// As send(), but writes on the caller's thread when nothing is queued ahead of the frame. TLS
+	// gives no non-blocking write, so this one can block.
+	bool sendCritical(std::string_view text) {
+		if (!send_queue_->options().queued) return send(text);
+		std::lock_guard lock(send_mutex_);
+		return send_queue_->pushCritical(text);
+	}
+
+	std::size_t drainSends() { return send_queue_->drain(); }
+	gateway::SendStats sendStats() const { return send_queue_->stats(); }
+	const LatencyHistogram& sendLatency() const { return send_queue_->latency(); }
+
 protected:
+	// SO_RCVBUF has to be in place before the SYN so the window scale is negotiated for it.
+	void connectTcp(const boost::asio::ip::tcp::resolver::results_type& endpoints,
+					std::chrono::steady_clock::time_point deadline) {
+		auto& tcp = ws_.next_layer().next_layer();
+		boost::system::error_code ec = boost::asio::error::host_not_found;
+		for (const auto& entry : endpoints) {
+			boost::system::error_code ignored;
+			tcp.close(ignored);
+			tcp.open(entry.endpoint().protocol());
+			if (options_.tcpReceiveBufferBytes > 0) {
+				tcp.set_option(boost::asio::socket_base::receive_buffer_size(options_.tcpReceiveBufferBytes));
+			}
+			ec = awaitStep(deadline, [&](auto done) { tcp.async_connect(entry.endpoint(), done); });
+			if (!ec || ec == boost::asio::error::timed_out) break;
+		}
+		throwIfFailed(ec);
+		tcp.set_option(boost::asio::ip::tcp::no_delay(options_.tcpNoDelay));
+	}
+
+	// Runs one asynchronous connect step on the caller's thread until it completes or deadline passes.
+	// On timeout the socket is closed, which aborts the step, and timed_out is returned. Only connect()
+	// runs ioc_; the connected stream is then used synchronously.
+	template<class Start>
+	boost::system::error_code awaitStep(std::chrono::steady_clock::time_point deadline, Start&& start) {
+		auto result = std::make_shared<boost::system::error_code>(boost::asio::error::would_block);
+		start([result](boost::system::error_code ec, auto&&...) { *result = ec; });
+		ioc_.restart();
+		while (*result == boost::asio::error::would_block && ioc_.run_one_until(deadline)) {}
+		if (*result != boost::asio::error::would_block) return *result;
+
+		boost::system::error_code ignored;
+		ws_.next_layer().next_layer().close(ignored);
+		ioc_.restart();
+		ioc_.poll();
+		return boost::asio::error::timed_out;
+	}
+
+	static void throwIfFailed(const boost::system::error_code& ec) {
+		if (ec) throw boost::system::system_error(ec);
+	}
+
+	// The frame handed to onMessage() views read_buffer_ directly and is only valid until it returns.
 	void receiveLoop() {
 		try {
 			while (running_.load()) {
-				boost::beast::flat_buffer buffer;
-				ws_.read(buffer);
-				auto data = buffer.data();
+				ws_.read(read_buffer_);
+				auto data = read_buffer_.data();
 				std::string_view frame(static_cast<const char*>(data.data()), data.size());
 				derived().onMessage(frame);
+				read_buffer_.consume(read_buffer_.size());
 			}
 		} catch (const std::exception& e) {
+			read_buffer_.clear();
 			if (running_.load()) derived().onError(e.what());
 		}
 		derived().onClosed();
 	}
 
+	// Each queued message is its own WebSocket frame, so a batch goes out one frame per write; errors
+	// are left to the receive loop to report.
+	long writeFrame(const iovec* iov, std::size_t) {
+		boost::system::error_code ec;
+		ws_.write(boost::asio::buffer(iov[0].iov_base, iov[0].iov_len), ec);
+		return ec ? -1 : static_cast<long>(iov[0].iov_len);
+	}
+
 	Derived& derived() { return static_cast<Derived&>(*this); }
 
 protected:
@@ -132,6 +255,10 @@ protected:
 	std::thread receive_thread_;
 	std::atomic<bool> running_{false};
 	std::chrono::milliseconds connect_timeout_{5000};
+	std::unique_ptr<gateway::SendQueue> send_queue_ = std::make_unique<gateway::SendQueue>();
+	std::mutex send_mutex_;
+	WebSocketOptions options_{};
+	boost::beast::flat_buffer read_buffer_;
 
 	std::string host_;
 	std::string target_;
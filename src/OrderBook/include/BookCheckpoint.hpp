@@ -0,0 +1,147 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BookSync.hpp"
+#include "Quote.hpp"
+
+// Immutable copy of one book's levels, taken on the book thread. Images are shared, never modified,
+// so an unchanged book can hand the writer the same image as last time instead of copying again.
+struct BookImage {
+	gateway::SymbolId symbol{};
+	std::uint64_t sequence{0};   // last applied nonce, 0 when the feed has none
+	std::vector<std::pair<double, double>> bids;
+	std::vector<std::pair<double, double>> asks;
+};
+using BookImagePtr = std::shared_ptr<const BookImage>;
+
+template<class BookT>
+BookImagePtr makeBookImage(const BookT& book, std::uint64_t sequence) {
+	auto image = std::make_shared<BookImage>();
+	image->symbol = book.symbolId();
+	image->sequence = sequence;
+	image->bids.reserve(book.bids().size());
+	image->asks.reserve(book.asks().size());
+	for (const auto& [price, level] : book.bids()) image->bids.emplace_back(price, level.size);
+	for (const auto& [price, level] : book.asks()) image->asks.emplace_back(price, level.size);
+	return image;
+}
+
+// Checkpoint file layout, native endianness, every block 8-byte aligned:
+//   FileHeader, then per book a RecordHeader, the symbol name padded to 8 bytes,
+//   bidCount then askCount (price, size) pairs.
+// Symbols are stored by name because SymbolIds are only stable within one process.
+namespace checkpoint {
+
+	inline constexpr char kMagic[8] = {'H', 'F', 'T', 'B', 'O', 'O', 'K', 'S'};
+	inline constexpr std::uint32_t kVersion = 1;
+
+	struct FileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t bookCount;
+		std::uint64_t createdNs;      // system_clock, for staleness checks
+		std::uint64_t payloadBytes;
+		std::uint64_t checksum;       // FNV-1a over the payload
+	};
+
+	struct RecordHeader {
+		std::uint64_t sequence;
+		std::uint32_t bidCount;
+		std::uint32_t askCount;
+		std::uint32_t nameLength;
+		std::uint32_t reserved;
+	};
+
+	// Serialises images into one buffer in the layout above.
+	std::vector<std::byte> encode(const std::vector<BookImagePtr>& images);
+
+	// Writes atomically: the data goes to path + ".tmp", is synced, then renamed over path.
+	bool write(const std::string& path, const std::vector<BookImagePtr>& images);
+
+}
+
+// Read-only, memory-mapped view of a checkpoint file. Levels are read in place from the mapping;
+// the file is validated (magic, version, bounds, checksum) once in open().
+class CheckpointFile {
+public:
+	struct Record {
+		std::string_view symbol;
+		std::uint64_t sequence;
+		const std::pair<double, double>* bids;
+		std::size_t bidCount;
+		const std::pair<double, double>* asks;
+		std::size_t askCount;
+
+		// Levels as snapshot quotes, ready for OrderBook::rebuild().
+		[[nodiscard]] gateway::BookSnapshot toSnapshot() const;
+	};
+
+	CheckpointFile() = default;
+	~CheckpointFile() { close(); }
+
+	CheckpointFile(const CheckpointFile&) = delete;
+	CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+	bool open(const std::string& path);
+	void close() noexcept;
+
+	[[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr; }
+	[[nodiscard]] std::size_t bookCount() const noexcept { return records_.size(); }
+	[[nodiscard]] const std::vector<Record>& records() const noexcept { return records_; }
+	[[nodiscard]] const Record* find(std::string_view symbol) const noexcept;
+	[[nodiscard]] std::uint64_t createdNs() const noexcept { return createdNs_; }
+
+private:
+	const std::byte* data_{nullptr};
+	std::size_t size_{0};
+	bool mapped_{false};
+	std::vector<std::byte> owned_;   // fallback when the file cannot be mapped
+	std::vector<Record> records_;
+	std::uint64_t createdNs_{0};
+};
+
+// Background thread that writes checkpoints handed over by the book thread. Only the newest
+// submission matters: one submitted while a write is in progress replaces any older pending one.
+class CheckpointWriter {
+public:
+	explicit CheckpointWriter(std::string path);
+	~CheckpointWriter();
+
+	CheckpointWriter(const CheckpointWriter&) = delete;
+	CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+	void submit(std::vector<BookImagePtr> images);
+	// Blocks until every submitted checkpoint has been written (or has failed).
+	void flush();
+
+	[[nodiscard]] const std::string& path() const noexcept { return path_; }
+	[[nodiscard]] std::uint64_t written() const;
+	[[nodiscard]] std::uint64_t failures() const;
+	[[nodiscard]] std::uint64_t superseded() const;
+
+private:
+	void run();
+
+	std::string path_;
+	mutable std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	std::vector<BookImagePtr> pending_;
+	bool hasPending_{false};
+	bool busy_{false};
+	bool stopping_{false};
+	std::uint64_t written_{0};
+	std::uint64_t failures_{0};
+	std::uint64_t superseded_{0};
+	std::thread worker_;
+};
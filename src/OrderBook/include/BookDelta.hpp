@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "Quote.hpp"
+
+// One aggregated level after the change; size 0 means the level was removed.
+struct LevelChange {
+	double price{};
+	double size{};
+	gateway::QuoteSide side{};
+};
+
+// Levels touched since the previous delta, each reported once with its latest size.
+// When reset is set the book was replaced wholesale: drop the mirror and apply changes as the full book.
+struct BookDelta {
+	gateway::SymbolId symbolId{};
+	bool reset{false};
+	bool topOfBookChanged{false};
+	double bestBid{std::numeric_limits<double>::quiet_NaN()};
+	double bestAsk{std::numeric_limits<double>::quiet_NaN()};
+	std::vector<LevelChange> changes;
+	std::chrono::steady_clock::time_point mono_ts{};
+
+	[[nodiscard]] bool empty() const noexcept { return !reset && changes.empty(); }
+};
+
+using DeltaHandler = std::function<void(const BookDelta&)>;
+
+// Downstream L2 copy of a book kept current by applying its deltas in order.
+class BookMirror {
+public:
+	void apply(const BookDelta& delta) {
+		if (delta.reset) {
+			bids_.clear();
+			asks_.clear();
+		}
+		for (const auto& c : delta.changes) {
+			if (c.side == gateway::QuoteSide::Bid) set(bids_, c);
+			else set(asks_, c);
+		}
+		symbolId_ = delta.symbolId;
+	}
+
+	[[nodiscard]] double bestBid() const { return bids_.empty() ? std::numeric_limits<double>::quiet_NaN() : bids_.begin()->first; }
+	[[nodiscard]] double bestAsk() const { return asks_.empty() ? std::numeric_limits<double>::quiet_NaN() : asks_.begin()->first; }
+
+	const std::map<double, double, std::greater<double>>& bids() const { return bids_; }
+	const std::map<double, double, std::less<double>>& asks() const { return asks_; }
+	gateway::SymbolId symbolId() const { return symbolId_; }
+
+private:
+	template<class Side>
+	static void set(Side& side, const LevelChange& c) {
+		if (c.size == 0.0) side.erase(c.price);
+		else side[c.price] = c.size;
+	}
+
+	gateway::SymbolId symbolId_{};
+	std::map<double, double, std::greater<double>> bids_;
+	std::map<double, double, std::less<double>> asks_;
+};
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "Quote.hpp"
+
+// What the consumer does when an update leaves a book crossed (best bid > best ask) or locked (equal).
+enum class CrossedBookPolicy : std::uint8_t {
+	// Drop the opposite-side levels the update crossed: the newest quote wins, the old side is stale.
+	Prune,
+	// Keep the book, flag it untrusted until an update uncrosses it.
+	MarkUntrusted,
+	// Flag it untrusted and ask the feed for a snapshot; trusted again once a clean snapshot is applied.
+	// Feeds without snapshots, such as FIX, fall back to Prune.
+	Resync,
+};
+
+struct IntegrityConfig {
+	CrossedBookPolicy policy{CrossedBookPolicy::Prune};
+	// Levels kept per side; deeper ones are trimmed from the far end. 0 disables the bound.
+	std::size_t maxDepth{4096};
+};
+
+struct IntegrityStats {
+	std::uint64_t checks{0};
+	std::uint64_t crossed{0};
+	std::uint64_t locked{0};
+	std::uint64_t invalidQuotes{0};   // rejected before reaching the book: non-finite, non-positive price or negative size
+	std::uint64_t prunedLevels{0};
+	std::uint64_t trimmedLevels{0};
+	std::uint64_t resyncRequests{0};
+	bool trusted{true};
+};
+
+// Invariant checks for one L2 book, run on the consumer thread around every update. Each check is a
+// couple of comparisons against the best levels and the side sizes. Counters are written by the
+// consumer thread only and may be read from any thread through stats().
+class BookGuard {
+public:
+	enum class Verdict : std::uint8_t { Ok, Healed, Untrusted, NeedsResync };
+
+	explicit BookGuard(IntegrityConfig config = {}) : config_(config) {}
+
+	// Copyable so books holding a guard can live in a vector; counters are copied as a snapshot.
+	BookGuard(const BookGuard& other) noexcept
+		: config_(other.config_)
+		, awaitingSnapshot_(other.awaitingSnapshot_) {
+		const auto s = other.stats();
+		checks_.store(s.checks);
+		crossed_.store(s.crossed);
+		locked_.store(s.locked);
+		invalidQuotes_.store(s.invalidQuotes);
+		prunedLevels_.store(s.prunedLevels);
+		trimmedLevels_.store(s.trimmedLevels);
+		resyncRequests_.store(s.resyncRequests);
+		trusted_.store(s.trusted);
+	}
+	BookGuard& operator=(const BookGuard&) = delete;
+
+	void configure(const IntegrityConfig& config) noexcept { config_ = config; }
+
+	[[nodiscard]] static bool valid(const gateway::Quote& q) noexcept {
+		return std::isfinite(q.getPrice()) && q.getPrice() > 0.0 && std::isfinite(q.getSize()) && q.getSize() >= 0.0;
+	}
+
+	// Gate in front of book.update(): false means the quote must not be applied.
+	bool admit(const gateway::Quote& q) noexcept {
+		if (valid(q)) return true;
+		bump(invalidQuotes_);
+		return false;
+	}
+
+	template<class Book>
+	Verdict afterUpdate(Book& book, const gateway::Quote& q) {
+		bump(checks_);
+		if (q.getSide() == gateway::QuoteSide::Bid) trim(book, book.bids(), gateway::QuoteSide::Bid);
+		else trim(book, book.asks(), gateway::QuoteSide::Ask);
+
+		if (!isCrossed(book)) {
+			if (!awaitingSnapshot_) setTrusted(true);
+			return Verdict::Ok;
+		}
+
+		switch (config_.policy) {
+			case CrossedBookPolicy::Prune:
+				pruneCrossed(book, q);
+				if (!awaitingSnapshot_) setTrusted(true);
+				return Verdict::Healed;
+			case CrossedBookPolicy::MarkUntrusted:
+				setTrusted(false);
+				return Verdict::Untrusted;
+			case CrossedBookPolicy::Resync:
+				setTrusted(false);
+				if (awaitingSnapshot_) return Verdict::Untrusted;
+				awaitingSnapshot_ = true;
+				bump(resyncRequests_);
+				return Verdict::NeedsResync;
+		}
+		return Verdict::Ok;
+	}
+
+	// For a NeedsResync verdict on a feed that has no snapshots to offer, e.g. FIX: heals the book as
+	// Prune would, so it is trusted again instead of waiting for a snapshot that never comes.
+	template<class Book>
+	Verdict resyncUnavailable(Book& book, const gateway::Quote& q) {
+		awaitingSnapshot_ = false;
+		pruneCrossed(book, q);
+		setTrusted(true);
+		return Verdict::Healed;
+	}
+
+	// The requested snapshot was dropped as older than the book. The book stays untrusted and the next
+	// crossed update asks for another one.
+	void snapshotSkipped() noexcept { awaitingSnapshot_ = false; }
+
+	// A rebuilt book has no "newest side" to prefer, so a crossed snapshot is only flagged.
+	template<class Book>
+	Verdict afterRebuild(Book& book) {
+		bump(checks_);
+		awaitingSnapshot_ = false;
+		trim(book, book.bids(), gateway::QuoteSide::Bid);
+		trim(book, book.asks(), gateway::QuoteSide::Ask);
+		const bool crossed = isCrossed(book);
+		setTrusted(!crossed);
+		return crossed ? Verdict::Untrusted : Verdict::Ok;
+	}
+
+	[[nodiscard]] bool trusted() const noexcept { return trusted_.load(std::memory_order_relaxed); }
+	[[nodiscard]] const IntegrityConfig& config() const noexcept { return config_; }
+
+	[[nodiscard]] IntegrityStats stats() const noexcept {
+		IntegrityStats s;
+		s.checks = checks_.load(std::memory_order_relaxed);
+		s.crossed = crossed_.load(std::memory_order_relaxed);
+		s.locked = locked_.load(std::memory_order_relaxed);
+		s.invalidQuotes = invalidQuotes_.load(std::memory_order_relaxed);
+		s.prunedLevels = prunedLevels_.load(std::memory_order_relaxed);
+		s.trimmedLevels = trimmedLevels_.load(std::memory_order_relaxed);
+		s.resyncRequests = resyncRequests_.load(std::memory_order_relaxed);
+		s.trusted = trusted();
+		return s;
+	}
+
+private:
+	// Single writer, so a relaxed load/store pair is enough and avoids a locked RMW per update.
+	static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n = 1) noexcept {
+		c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	void setTrusted(bool t) noexcept {
+		if (trusted_.load(std::memory_order_relaxed) != t) trusted_.store(t, std::memory_order_relaxed);
+	}
+
+	template<class Book>
+	bool isCrossed(const Book& book) noexcept {
+		if (book.bids().empty() || book.asks().empty()) return false;
+		const double bb = book.bids().begin()->first;
+		const double ba = book.asks().begin()->first;
+		if (bb < ba) return false;
+		bump(bb == ba ? locked_ : crossed_);
+		return true;
+	}
+
+	static gateway::Quote removal(double price, gateway::QuoteSide side, gateway::SymbolId symbol) {
+		return gateway::Quote(price, 0.0, {}, symbol, side);
+	}
+
+	// Drops the levels of the side q crossed, up to q's side's new best.
+	template<class Book>
+	void pruneCrossed(Book& book, const gateway::Quote& q) {
+		if (q.getSide() == gateway::QuoteSide::Bid) prune(book, book.asks(), gateway::QuoteSide::Ask, book.bids().begin()->first);
+		else prune(book, book.bids(), gateway::QuoteSide::Bid, book.asks().begin()->first);
+	}
+
+	// Removes levels through book.update() so analytics and change tracking see them go.
+	template<class Book, class Side>
+	void prune(Book& book, const Side& side, gateway::QuoteSide which, double through) {
+		std::uint64_t n = 0;
+		while (!side.empty()) {
+			const double px = side.begin()->first;
+			const bool crossing = which == gateway::QuoteSide::Ask ? px <= through : px >= through;
+			if (!crossing) break;
+			book.update(removal(px, which, book.symbolId()));
+			++n;
+		}
+		if (n) bump(prunedLevels_, n);
+	}
+
+	template<class Book, class Side>
+	void trim(Book& book, const Side& side, gateway::QuoteSide which) {
+		if (config_.maxDepth == 0 || side.size() <= config_.maxDepth) return;
+		std::uint64_t n = 0;
+		while (side.size() > config_.maxDepth) {
+			book.update(removal(std::prev(side.end())->first, which, book.symbolId()));
+			++n;
+		}
+		bump(trimmedLevels_, n);
+	}
+
+	IntegrityConfig config_;
+	bool awaitingSnapshot_{false};
+
+	std::atomic<std::uint64_t> checks_{0};
+	std::atomic<std::uint64_t> crossed_{0};
+	std::atomic<std::uint64_t> locked_{0};
+	std::atomic<std::uint64_t> invalidQuotes_{0};
+	std::atomic<std::uint64_t> prunedLevels_{0};
+	std::atomic<std::uint64_t> trimmedLevels_{0};
+	std::atomic<std::uint64_t> resyncRequests_{0};
+	std::atomic<bool> trusted_{true};
+};
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include "BookSync.hpp"
+#include "OrderBook.hpp"
+#include "Quote.hpp"
+#include "SymbolTable.hpp"
+
+// Holds one book per instrument in a dense array indexed by SymbolId and shards the instruments over
+// worker threads. Each shard drains its own SPSC ring and may be pinned to a core. The router thread is
+// the single producer for every ring: add(), route(), routeSnapshot(), pump(), moveSymbol() and
+// rebalance() must all be called from it. Workers count updates per symbol; rebalance() turns those
+// counts into rates and moves hot instruments off the busiest shard.
+//
+// A moved instrument is handed over in-band: the old shard gets a Handoff message behind the updates
+// already queued for it, and the new shard does not touch the book until that message has been
+// processed, so per-instrument update order survives the move.
+template<class Book = OrderBook>
+class BookManager {
+public:
+	static constexpr std::size_t kMaxSymbols = gateway::SymbolTable::kMaxSymbols;
+	static constexpr std::uint16_t kNoShard = 0xffff;
+
+	struct Options {
+		std::size_t shards{1};
+		// cores[i] pins shard i; missing or negative entries leave the shard unpinned.
+		std::vector<int> cores{};
+		std::size_t ringCapacity{std::size_t{1} << 14};
+		// Spin on an empty ring instead of sleeping; only sensible with pinned, isolated cores.
+		bool busyPoll{false};
+	};
+
+	explicit BookManager(Options options)
+		: options_(std::move(options))
+		, slots_(std::make_unique<Slot[]>(kMaxSymbols)) {
+		if (options_.shards == 0) options_.shards = 1;
+		shards_.reserve(options_.shards);
+		for (std::size_t i = 0; i < options_.shards; ++i) {
+			const int core = i < options_.cores.size() ? options_.cores[i] : -1;
+			shards_.push_back(std::make_unique<Shard>(static_cast<std::uint16_t>(i), core, options_.ringCapacity));
+		}
+		owner_.fill(kNoShard);
+	}
+
+	~BookManager() { stop(); }
+
+	BookManager(const BookManager&) = delete;
+	BookManager& operator=(const BookManager&) = delete;
+
+	// Creates the book for symbol on the shard with the fewest instruments, or on the given shard.
+	// Must happen before start().
+	gateway::SymbolId add(std::string_view symbol, std::size_t shard = kNoShard) {
+		const auto id = gateway::internSymbol(symbol);
+		if (owner_[id] != kNoShard) return id;
+		if (shard >= shards_.size()) {
+			shard = static_cast<std::size_t>(std::min_element(shards_.begin(), shards_.end(),
+				[](const auto& a, const auto& b) { return a->symbols < b->symbols; }) - shards_.begin());
+		}
+		auto& slot = slots_[id];
+		slot.book = std::make_unique<Book>(id);
+		slot.holder.store(static_cast<std::uint16_t>(shard), std::memory_order_relaxed);
+		owner_[id] = static_cast<std::uint16_t>(shard);
+		++shards_[shard]->symbols;
+		symbols_.push_back(id);
+		return id;
+	}
+
+	// Publishes the book into v after every batch that touched it. Register before start().
+	void attachView(gateway::SymbolId id, OrderBookView* v) {
+		v->reserve(maxLevels_);
+		slots_[id].view = v;
+	}
+	void setPublishLevels(std::size_t n) { maxLevels_ = n; }
+
+	void start() {
+		running_.store(true);
+		lastRebalance_ = std::chrono::steady_clock::now();
+		for (auto& shard : shards_) shard->worker = std::thread(&BookManager::runShard, this, std::ref(*shard));
+	}
+
+	// Workers finish whatever is already queued before exiting; stop routing first.
+	void stop() {
+		running_.store(false);
+		for (auto& shard : shards_) {
+			if (shard->worker.joinable()) shard->worker.join();
+		}
+	}
+
+	bool route(const gateway::Quote& q) {
+		const auto id = q.getSymbolId();
+		const auto shard = owner_[id];
+		if (shard == kNoShard) {
+			++unrouted_;
+			return false;
+		}
+		return push(*shards_[shard], Message{Message::Kind::Update, id, kNoShard, q, nullptr});
+	}
+
+	bool routeSnapshot(gateway::BookSnapshot snapshot) {
+		const auto id = snapshot.symbol;
+		const auto shard = owner_[id];
+		if (shard == kNoShard) {
+			++unrouted_;
+			return false;
+		}
+		auto* owned = new gateway::BookSnapshot(std::move(snapshot));
+		if (push(*shards_[shard], Message{Message::Kind::Snapshot, id, kNoShard, gateway::Quote{}, owned})) return true;
+		delete owned;
+		return false;
+	}
+
+	// Moves every queued quote and pending snapshot of one gateway feed into the shard rings.
+	template<class Obtainer>
+	std::size_t pump(Obtainer& feed) {
+		std::size_t routed = 0;
+		gateway::Quote q{};
+		pumpSnapshots(feed);
+		while (feed.getBidQueue().pop(q)) {
+			pumpSnapshots(feed);
+			routed += route(q);
+		}
+		while (feed.getAskQueue().pop(q)) {
+			pumpSnapshots(feed);
+			routed += route(q);
+		}
+		return routed;
+	}
+
+	void moveSymbol(gateway::SymbolId id, std::size_t to) {
+		const auto from = owner_[id];
+		if (from == kNoShard || to >= shards_.size() || from == to) return;
+		owner_[id] = static_cast<std::uint16_t>(to);
+		--shards_[from]->symbols;
+		++shards_[to]->symbols;
+		++moves_;
+		pushBlocking(*shards_[from], Message{Message::Kind::Handoff, id, static_cast<std::uint16_t>(to), gateway::Quote{}, nullptr});
+	}
+
+	// Recomputes per-symbol update rates since the previous call and moves up to maxMoves instruments
+	// from the busiest to the idlest shard while their loads differ by more than tolerance times the
+	// mean. Each move picks the instrument whose rate best halves the gap. Returns the number moved.
+	std::size_t rebalance(double tolerance = 0.25, std::size_t maxMoves = 4) {
+		const auto now = std::chrono::steady_clock::now();
+		const double secs = std::chrono::duration<double>(now - lastRebalance_).count();
+		lastRebalance_ = now;
+		if (secs <= 0.0) return 0;
+
+		std::vector<double> load(shards_.size(), 0.0);
+		for (auto id : symbols_) {
+			auto& slot = slots_[id];
+			const auto count = slot.updates.load(std::memory_order_relaxed);
+			slot.rate = static_cast<double>(count - slot.lastCount) / secs;
+			slot.lastCount = count;
+			load[owner_[id]] += slot.rate;
+		}
+
+		std::size_t moved = 0;
+		for (; moved < maxMoves && shards_.size() > 1; ++moved) {
+			const auto hi = static_cast<std::size_t>(std::max_element(load.begin(), load.end()) - load.begin());
+			const auto lo = static_cast<std::size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+			const double gap = load[hi] - load[lo];
+			const double mean = std::accumulate(load.begin(), load.end(), 0.0) / static_cast<double>(load.size());
+			if (gap <= tolerance * mean || gap <= 0.0) break;
+
+			gateway::SymbolId best = 0;
+			double bestResidual = gap;
+			for (auto id : symbols_) {
+				const double r = slots_[id].rate;
+				if (owner_[id] != hi || r <= 0.0) continue;
+				const double residual = std::abs(gap - 2.0 * r);
+				if (residual < bestResidual) {
+					bestResidual = residual;
+					best = id;
+				}
+			}
+			if (bestResidual >= gap) break;
+
+			const double r = slots_[best].rate;
+			moveSymbol(best, lo);
+			load[hi] -= r;
+			load[lo] += r;
+		}
+		for (std::size_t i = 0; i < shards_.size(); ++i) shards_[i]->load = load[i];
+		return moved;
+	}
+
+	// Only safe to read while the book's shard is stopped, or from that shard's thread.
+	const Book* book(gateway::SymbolId id) const { return slots_[id].book.get(); }
+
+	std::size_t shardCount() const { return shards_.size(); }
+	std::size_t bookCount() const { return symbols_.size(); }
+	std::size_t shardOf(gateway::SymbolId id) const { return owner_[id]; }
+	std::size_t symbolsOn(std::size_t shard) const { return shards_[shard]->symbols; }
+
+	// Updates applied to the book so far; safe from any thread.
+	std::uint64_t updateCount(gateway::SymbolId id) const { return slots_[id].updates.load(std::memory_order_relaxed); }
+	// Rates and loads as of the last rebalance(), in updates per second.
+	double updateRate(gateway::SymbolId id) const { return slots_[id].rate; }
+	double shardLoad(std::size_t shard) const { return shards_[shard]->load; }
+
+	std::uint64_t moves() const { return moves_; }
+	std::uint64_t unrouted() const { return unrouted_; }
+	std::uint64_t stalls() const { return stalls_; }
+
+private:
+	struct Message {
+		enum class Kind : std::uint8_t { Update, Snapshot, Handoff };
+
+		Kind kind{Kind::Update};
+		gateway::SymbolId symbol{};
+		std::uint16_t target{kNoShard};
+		gateway::Quote quote{};
+		gateway::BookSnapshot* snapshot{nullptr};   // owned by the message, freed by the shard
+	};
+
+	struct alignas(64) Slot {
+		std::unique_ptr<Book> book;
+		// Shard currently allowed to touch the book; changes hands in processHandoff().
+		std::atomic<std::uint16_t> holder{kNoShard};
+		std::atomic<std::uint64_t> updates{0};
+
+		// Holder only.
+		std::uint64_t snapshotSequence{0};
+		std::uint64_t maxAppliedSequence{0};
+		bool touched{false};
+		OrderBookView* view{nullptr};
+
+		// Router only.
+		std::uint64_t lastCount{0};
+		double rate{0.0};
+	};
+
+	struct alignas(64) Shard {
+		Shard(std::uint16_t index, int core, std::size_t capacity) : index(index), core(core), ring(capacity) {}
+
+		const std::uint16_t index;
+		const int core;
+		boost::lockfree::spsc_queue<Message> ring;
+		std::thread worker;
+		std::vector<gateway::SymbolId> touched;
+
+		// Router only.
+		std::size_t symbols{0};
+		double load{0.0};
+	};
+
+	bool push(Shard& shard, const Message& m) {
+		// A full ring means the shard is behind; wait rather than drop, since a lost level corrupts the book.
+		while (!shard.ring.push(m)) {
+			if (!running_.load(std::memory_order_relaxed)) {
+				std::cerr << "BookManager: shard " << shard.index << " ring full, dropping update\n";
+				return false;
+			}
+			++stalls_;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	// Handoffs cannot be dropped without orphaning the book, so they wait for space even when stopped.
+	void pushBlocking(Shard& shard, const Message& m) {
+		while (!shard.ring.push(m)) {
+			++stalls_;
+			std::this_thread::yield();
+		}
+	}
+
+	template<class Obtainer>
+	void pumpSnapshots(Obtainer& feed) {
+		while (feed.snapshotPending()) {
+			if (auto snap = feed.takeSnapshot()) routeSnapshot(std::move(*snap));
+		}
+	}
+
+	static void pin(Shard& shard) {
+#if defined(__linux__)
+		if (shard.core < 0) return;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(shard.core, &set);
+		if (const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); rc != 0) {
+			std::cerr << "BookManager: could not pin shard " << shard.index << " to core " << shard.core
+					  << " (error " << rc << ")\n";
+		}
+#else
+		(void)shard;
+#endif
+	}
+
+	// A message for a book that is still being handed over waits for the previous holder. The handoff
+	// was queued before this message, so every wait is on an earlier push and waits cannot form a cycle.
+	void acquire(Shard& shard, Slot& slot) {
+		while (slot.holder.load(std::memory_order_acquire) != shard.index) std::this_thread::yield();
+	}
+
+	void process(Shard& shard, Message& m) {
+		auto& slot = slots_[m.symbol];
+		acquire(shard, slot);
+		switch (m.kind) {
+			case Message::Kind::Update: {
+				const auto seq = m.quote.getSequence();
+				if (seq != 0 && seq <= slot.snapshotSequence) return;
+				slot.book->update(m.quote);
+				slot.maxAppliedSequence = std::max(slot.maxAppliedSequence, seq);
+				slot.updates.fetch_add(1, std::memory_order_relaxed);
+				break;
+			}
+			case Message::Kind::Snapshot: {
+				std::unique_ptr<gateway::BookSnapshot> snap(m.snapshot);
+				if (snap->sequence < slot.maxAppliedSequence) return;
+				slot.book->rebuild(snap->levels);
+				slot.snapshotSequence = slot.maxAppliedSequence = snap->sequence;
+				break;
+			}
+			case Message::Kind::Handoff:
+				publishTouched(shard);
+				slot.holder.store(m.target, std::memory_order_release);
+				return;
+		}
+		if (slot.view && !slot.touched) {
+			slot.touched = true;
+			shard.touched.push_back(m.symbol);
+		}
+	}
+
+	void publishTouched(Shard& shard) {
+		for (auto id : shard.touched) {
+			auto& slot = slots_[id];
+			slot.view->publish_from(*slot.book, maxLevels_);
+			slot.touched = false;
+		}
+		shard.touched.clear();
+	}
+
+	std::size_t drain(Shard& shard) {
+		std::size_t n = 0;
+		Message m;
+		while (n < kBatch && shard.ring.pop(m)) {
+			process(shard, m);
+			++n;
+		}
+		publishTouched(shard);
+		return n;
+	}
+
+	void runShard(Shard& shard) {
+		using namespace std::chrono;
+		pin(shard);
+		while (running_.load(std::memory_order_relaxed)) {
+			if (drain(shard) > 0 || options_.busyPoll) continue;
+			std::this_thread::sleep_for(50us);
+		}
+		while (drain(shard) > 0) {}
+	}
+
+	static constexpr std::size_t kBatch = 256;
+
+	Options options_;
+	std::unique_ptr<Slot[]> slots_;
+	std::vector<std::unique_ptr<Shard>> shards_;
+	std::array<std::uint16_t, kMaxSymbols> owner_{};
+	std::vector<gateway::SymbolId> symbols_;
+
+	std::atomic<bool> running_{false};
+	std::size_t maxLevels_{80};
+	std::chrono::steady_clock::time_point lastRebalance_{};
+
+	std::uint64_t moves_{0};
+	std::uint64_t unrouted_{0};
+	std::uint64_t stalls_{0};
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "Quote.hpp"
+
+// Cost of trading a fixed quantity against one side of the book.
+struct SweepCost {
+	double quantity{};   // filled quantity, short of the target when the side is too thin
+	double notional{};
+	bool complete{false};
+
+	[[nodiscard]] double vwap() const { return quantity > 0.0 ? notional / quantity : std::numeric_limits<double>::quiet_NaN(); }
+};
+
+// Depth queries over one contiguous, price-sorted book side. Every query walks levels from the best
+// one. On x86-64 the AVX2 path is chosen at runtime and handles four levels per step; other CPUs and
+// compilers use the scalar loop, which gives the same results up to summation order.
+namespace depth {
+
+	// Best-first (price, size) pairs, as in OrderBookSnapshot.
+	struct PairLevels {
+		const std::pair<double, double>* levels{nullptr};
+		std::size_t count{0};
+	};
+
+	// Parallel price/size arrays with the best level last, as in FlatSide.
+	struct ReversedLevels {
+		const double* prices{nullptr};
+		const double* sizes{nullptr};
+		std::size_t count{0};
+	};
+
+	// Total size at prices at or better than limit.
+	double cumulativeDepth(const PairLevels& side, gateway::QuoteSide which, double limit);
+	double cumulativeDepth(const ReversedLevels& side, gateway::QuoteSide which, double limit);
+
+	// Number of levels at prices at or better than limit.
+	std::size_t levelsWithin(const PairLevels& side, gateway::QuoteSide which, double limit);
+	std::size_t levelsWithin(const ReversedLevels& side, gateway::QuoteSide which, double limit);
+
+	// Total size of the best n levels.
+	double topDepth(const PairLevels& side, std::size_t n);
+	double topDepth(const ReversedLevels& side, std::size_t n);
+
+	// Index of the level at which cumulative size first reaches quantity, or count when it never does.
+	std::size_t crossingLevel(const PairLevels& side, double quantity);
+	std::size_t crossingLevel(const ReversedLevels& side, double quantity);
+
+	SweepCost sweep(const PairLevels& side, double quantity);
+	SweepCost sweep(const ReversedLevels& side, double quantity);
+
+	// True when the vectorised path is in use on this machine.
+	bool simdEnabled();
+	// Forces the scalar path, for tests and benchmarks comparing the two.
+	void forceScalar(bool on);
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "OrderBook.hpp"
+#include "Quote.hpp"
+
+// One side of a FlatOrderBook as two parallel arrays sorted so the best level is at the back
+// (bids ascending, asks descending): edits at the top are push_back/pop_back, deeper ones use a
+// branchless lower bound. Comparisons go through sign * price so one code path serves both sides.
+class FlatSide {
+public:
+	explicit FlatSide(gateway::QuoteSide side) : sign_(side == gateway::QuoteSide::Bid ? 1.0 : -1.0) {}
+
+	void set(double price, double size) {
+		const std::size_t n = prices_.size();
+		if (n == 0 || sign_ * price > sign_ * prices_.back()) {
+			if (size != 0.0) { prices_.push_back(price); sizes_.push_back(size); }
+			return;
+		}
+		if (price == prices_.back()) {
+			if (size != 0.0) sizes_.back() = size;
+			else { prices_.pop_back(); sizes_.pop_back(); }
+			return;
+		}
+		const std::size_t i = lowerBound(price);
+		if (prices_[i] == price) {
+			if (size != 0.0) sizes_[i] = size;
+			else { prices_.erase(prices_.begin() + i); sizes_.erase(sizes_.begin() + i); }
+		} else if (size != 0.0) {
+			prices_.insert(prices_.begin() + i, price);
+			sizes_.insert(sizes_.begin() + i, size);
+		}
+	}
+
+	void clear() noexcept { prices_.clear(); sizes_.clear(); }
+	void reserve(std::size_t n) { prices_.reserve(n); sizes_.reserve(n); }
+
+	// Level i counted from the best one.
+	[[nodiscard]] double price(std::size_t i) const noexcept { return prices_[prices_.size() - 1 - i]; }
+	[[nodiscard]] double size(std::size_t i) const noexcept { return sizes_[sizes_.size() - 1 - i]; }
+	[[nodiscard]] std::size_t depth() const noexcept { return prices_.size(); }
+
+	// Storage index of the first level not worse than price; the side must be non-empty.
+	// The loop body has no data-dependent branch.
+	[[nodiscard]] std::size_t lowerBound(double price) const noexcept {
+		const double key = sign_ * price;
+		const double* base = prices_.data();
+		std::size_t len = prices_.size();
+		while (len > 1) {
+			const std::size_t half = len / 2;
+			base += static_cast<std::size_t>(sign_ * base[half - 1] < key) * half;
+			len -= half;
+		}
+		return static_cast<std::size_t>(base - prices_.data()) + static_cast<std::size_t>(sign_ * *base < key);
+	}
+
+	[[nodiscard]] depth::ReversedLevels levels() const noexcept { return {prices_.data(), sizes_.data(), prices_.size()}; }
+
+	// Copies up to n levels best-first into out; returns how many were written.
+	std::size_t copyTop(std::pair<double, double>* out, std::size_t n) const noexcept {
+		if (n > prices_.size()) n = prices_.size();
+		for (std::size_t i = 0; i < n; ++i) out[i] = {price(i), size(i)};
+		return n;
+	}
+
+	// Map-like, best-first read-only range so FlatOrderBook can stand in for OrderBook in templates
+	// such as OrderBookView::publish_from. Dereferencing materialises a (price, PriceLevel) pair.
+	class const_iterator {
+	public:
+		using value_type = std::pair<double, PriceLevel>;
+
+		const_iterator(const FlatSide* side, std::size_t i) : side_(side), i_(i) {}
+
+		const value_type& operator*() const { load(); return cur_; }
+		const value_type* operator->() const { return &**this; }
+		const_iterator& operator++() { ++i_; return *this; }
+		bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+		bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+
+	private:
+		void load() const {
+			const double p = side_->price(i_);
+			cur_ = {p, PriceLevel{p, side_->size(i_)}};
+		}
+
+		const FlatSide* side_;
+		std::size_t i_;
+		mutable value_type cur_{};
+	};
+
+	[[nodiscard]] const_iterator begin() const { return {this, 0}; }
+	[[nodiscard]] const_iterator end() const { return {this, prices_.size()}; }
+	[[nodiscard]] bool empty() const noexcept { return prices_.empty(); }
+	[[nodiscard]] std::size_t size() const noexcept { return prices_.size(); }
+
+private:
+	double sign_;
+	std::vector<double> prices_;
+	std::vector<double> sizes_;
+};
+
+// Structure-of-arrays L2 book with the same interface as OrderBook for updates and reads.
+class FlatOrderBook {
+public:
+	explicit FlatOrderBook(std::string_view symbol, std::size_t expectedDepth = 256)
+		: FlatOrderBook(gateway::internSymbol(symbol), expectedDepth) {}
+	explicit FlatOrderBook(gateway::SymbolId symbolId, std::size_t expectedDepth = 256)
+		: symbolId_(symbolId) {
+		bids_.reserve(expectedDepth);
+		asks_.reserve(expectedDepth);
+	}
+
+	void update(const gateway::Quote& quote) {
+		(quote.getSide() == gateway::QuoteSide::Bid ? bids_ : asks_).set(quote.getPrice(), quote.getSize());
+	}
+	// Replaces both sides with the given levels in one step; zero-size levels are skipped.
+	void rebuild(const std::vector<gateway::Quote>& levels);
+
+	double bestBid() const { return bids_.empty() ? 0.0 : bids_.price(0); }
+	double bestAsk() const { return asks_.empty() ? 0.0 : asks_.price(0); }
+
+	const FlatSide& bids() const { return bids_; }
+	const FlatSide& asks() const { return asks_; }
+
+	std::string_view symbol() const { return gateway::symbolName(symbolId_); }
+	gateway::SymbolId symbolId() const { return symbolId_; }
+
+	OrderBookSnapshot snapshot(std::size_t maxLevels = 0) const;
+
+	// Same queries as OrderBook, answered by the vectorised depth:: kernels over the side arrays.
+	double cumulativeDepth(gateway::QuoteSide side, double limit) const;
+	std::size_t crossingLevel(gateway::QuoteSide side, double quantity) const;
+	SweepCost sweepCost(gateway::QuoteSide side, double quantity) const;
+
+private:
+	gateway::SymbolId symbolId_;
+	FlatSide bids_{gateway::QuoteSide::Bid};
+	FlatSide asks_{gateway::QuoteSide::Ask};
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "ObjectPool.hpp"
+#include "Quote.hpp"
+
+struct OrderLevel;
+
+// One resting order, linked into its price level in time priority.
+struct OrderNode {
+	std::uint64_t id{};
+	double price{};
+	double qty{};
+	gateway::QuoteSide side{};
+	OrderNode* prev{nullptr};
+	OrderNode* next{nullptr};
+	OrderLevel* level{nullptr};
+};
+
+// Aggregated level with its FIFO queue of orders. price/size mirror PriceLevel so the book's
+// bids()/asks() can be handed to anything that reads an L2 OrderBook (OrderBookView, the visualiser).
+struct OrderLevel {
+	double price{};
+	double size{};
+	std::uint32_t orders{0};
+	OrderNode* head{nullptr};
+	OrderNode* tail{nullptr};
+};
+
+// Order id -> node, open addressing with linear probing and backward-shift deletion.
+class OrderIndex {
+public:
+	explicit OrderIndex(std::size_t capacity = 1024);
+
+	[[nodiscard]] OrderNode* find(std::uint64_t id) const noexcept;
+	bool insert(std::uint64_t id, OrderNode* node);
+	bool erase(std::uint64_t id) noexcept;
+	void clear() noexcept;
+
+	[[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+	struct Slot {
+		std::uint64_t id{};
+		OrderNode* node{nullptr};
+	};
+
+	[[nodiscard]] std::size_t home(std::uint64_t id) const noexcept {
+		return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+	}
+	void rehash(std::size_t capacity);
+
+	std::vector<Slot> slots_;
+	std::size_t mask_{0};
+	unsigned shift_{0};
+	std::size_t size_{0};
+};
+
+// Market-by-order book. add/modify/cancel of an order on an existing level is O(1): the order id
+// resolves through OrderIndex to a pooled node that is unlinked in place. Only creating or emptying
+// a price level touches the level map. The L2 aggregate is maintained on every change.
+class L3OrderBook {
+public:
+	using Bids = std::map<double, OrderLevel, std::greater<double>>;
+	using Asks = std::map<double, OrderLevel, std::less<double>>;
+
+	explicit L3OrderBook(std::string_view symbol, std::size_t expectedOrders = 4096);
+	explicit L3OrderBook(gateway::SymbolId symbolId, std::size_t expectedOrders = 4096);
+
+	L3OrderBook(const L3OrderBook&) = delete;
+	L3OrderBook& operator=(const L3OrderBook&) = delete;
+
+	// Returns false for a duplicate id or a non-positive quantity.
+	bool add(std::uint64_t id, gateway::QuoteSide side, double price, double qty);
+	// Reducing keeps time priority, increasing sends the order to the back of its level; qty <= 0 cancels.
+	bool modify(std::uint64_t id, double qty);
+	// Moves the order to a new price (losing priority) with a new quantity.
+	bool replace(std::uint64_t id, double price, double qty);
+	bool cancel(std::uint64_t id);
+	// FIX MDUpdateAction (279): '0' new, '1' change, '2' delete.
+	bool apply(char updateAction, std::uint64_t id, gateway::QuoteSide side, double price, double qty);
+	void clear();
+
+	[[nodiscard]] const OrderNode* find(std::uint64_t id) const { return index_.find(id); }
+	// Oldest order at the best price of a side, nullptr if the side is empty.
+	[[nodiscard]] const OrderNode* front(gateway::QuoteSide side) const;
+
+	double bestBid() const;
+	double bestAsk() const;
+
+	const Bids& bids() const { return bids_; }
+	const Asks& asks() const { return asks_; }
+
+	std::string_view symbol() const { return gateway::symbolName(symbolId_); }
+	gateway::SymbolId symbolId() const { return symbolId_; }
+	std::size_t orderCount() const { return index_.size(); }
+
+private:
+	OrderLevel& levelFor(gateway::QuoteSide side, double price);
+	void link(OrderLevel& level, OrderNode* node);
+	void unlink(OrderNode* node);
+	void eraseLevel(gateway::QuoteSide side, double price);
+
+	gateway::SymbolId symbolId_;
+	Bids bids_;
+	Asks asks_;
+	OrderIndex index_;
+	ObjectPool<OrderNode> pool_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed-size object pool: storage comes in chunks that are never returned, freed slots are recycled
+// through an intrusive free list, so steady-state create()/destroy() never touch the heap.
+// Not thread-safe; owned by the single thread that mutates the book.
+template<class T>
+class ObjectPool {
+public:
+	explicit ObjectPool(std::size_t chunkSize = 4096) : chunkSize_(chunkSize ? chunkSize : 1) {}
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	template<class... Args>
+	T* create(Args&&... args) {
+		if (!free_) grow();
+		Slot* slot = free_;
+		free_ = slot->next;
+		++live_;
+		return ::new (static_cast<void*>(slot->storage)) T{std::forward<Args>(args)...};
+	}
+
+	void destroy(T* p) noexcept {
+		if constexpr (!std::is_trivially_destructible_v<T>) p->~T();
+		auto* slot = reinterpret_cast<Slot*>(p);
+		slot->next = free_;
+		free_ = slot;
+		--live_;
+	}
+
+	// Preallocates so at least n objects can be live without growing.
+	void reserve(std::size_t n) {
+		while (capacity() < n) grow();
+	}
+
+	[[nodiscard]] std::size_t live() const noexcept { return live_; }
+	[[nodiscard]] std::size_t capacity() const noexcept { return chunks_.size() * chunkSize_; }
+
+private:
+	union Slot {
+		Slot* next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	void grow() {
+		chunks_.push_back(std::make_unique<Slot[]>(chunkSize_));
+		Slot* chunk = chunks_.back().get();
+		for (std::size_t i = chunkSize_; i-- > 0;) {
+			chunk[i].next = free_;
+			free_ = &chunk[i];
+		}
+	}
+
+	std::size_t chunkSize_;
+	std::vector<std::unique_ptr<Slot[]>> chunks_;
+	Slot* free_{nullptr};
+	std::size_t live_{0};
+};
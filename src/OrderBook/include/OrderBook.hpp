@@ -1,9 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include <functional>
 #include "Quote.hpp"
+#include "BookDelta.hpp"
+#include "DepthKernels.hpp"
+#include "PoolAllocator.hpp"
 
 struct PriceLevel {
 	double price{};
@@ -11,7 +20,7 @@ struct PriceLevel {
 };
 
 struct OrderBookSnapshot {
-	std::string symbol;
+	gateway::SymbolId symbolId{};
 	double bestBid{std::numeric_limits<double>::quiet_NaN()};
 	double bestAsk{std::numeric_limits<double>::quiet_NaN()};
 
@@ -19,81 +28,222 @@ struct OrderBookSnapshot {
 	std::vector<std::pair<double,double>> askLevels;
 
 	std::chrono::steady_clock::time_point mono_ts{};
-};
+	// False while the publisher considers the book corrupt (see BookGuard); treat levels as indicative.
+	bool trusted{true};
 
-struct alignas(64) ActiveIndex {
-	std::atomic<int> v{0};
-	char _pad[64 - sizeof(std::atomic<int>)]{};
+	depth::PairLevels bidSide() const { return {bidLevels.data(), bidLevels.size()}; }
+	depth::PairLevels askSide() const { return {askLevels.data(), askLevels.size()}; }
 };
 
+// Single-writer seqlock over fixed-capacity level arrays. The writer never allocates or waits;
+// readers copy into a caller-owned snapshot and retry if a publish overlapped the copy.
+// Every shared field is a relaxed atomic so the torn read a retry discards is still race-free.
 class OrderBookView {
 public:
-    template<class OrderBookT>
-    void publish_from(const OrderBookT& ob, std::size_t maxLevels = 0) {
-        const int cur  = active_.v.load(std::memory_order_relaxed);
-        const int next = 1 - cur;
+    static constexpr std::size_t kDefaultCapacity = 128;
 
-        OrderBookSnapshot s;
-        s.symbol = ob.symbol();
-        s.mono_ts = std::chrono::steady_clock::now();
+    explicit OrderBookView(std::size_t capacity = kDefaultCapacity) { reserve(capacity); }
 
-        if (!ob.bids().empty()) s.bestBid = ob.bids().begin()->second.price;
-        if (!ob.asks().empty()) s.bestAsk = ob.asks().begin()->second.price;
+    OrderBookView(const OrderBookView&) = delete;
+    OrderBookView& operator=(const OrderBookView&) = delete;
 
-        s.bidLevels.reserve(maxLevels ? maxLevels : ob.bids().size());
-        s.askLevels.reserve(maxLevels ? maxLevels : ob.asks().size());
+    // Grows the level storage. Only valid before the first publish_from(), i.e. at attach time.
+    void reserve(std::size_t capacity) {
+        if (capacity <= capacity_) return;
+        bidPx_ = std::make_unique<std::atomic<double>[]>(capacity);
+        bidSz_ = std::make_unique<std::atomic<double>[]>(capacity);
+        askPx_ = std::make_unique<std::atomic<double>[]>(capacity);
+        askSz_ = std::make_unique<std::atomic<double>[]>(capacity);
+        capacity_ = capacity;
+    }
 
-        {
-            std::size_t n = 0;
-            for (auto& [p, lvl] : ob.bids()) {
-                s.bidLevels.emplace_back(p, lvl.size);
-                if (maxLevels && ++n >= maxLevels) break;
-            }
-        }
-        {
-            std::size_t n = 0;
-            for (auto& [p, lvl] : ob.asks()) {
-                s.askLevels.emplace_back(p, lvl.size);
-                if (maxLevels && ++n >= maxLevels) break;
-            }
-        }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
 
-        buffers_[next] = std::move(s);
-        active_.v.store(next, std::memory_order_release);
+    template<class OrderBookT>
+    void publish_from(const OrderBookT& ob, std::size_t maxLevels = 0, bool trusted = true) {
+        const std::size_t limit = (maxLevels && maxLevels < capacity_) ? maxLevels : capacity_;
+        constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+
+        const auto seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        symbolId_.store(ob.symbolId(), std::memory_order_relaxed);
+        monoTs_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        bestBid_.store(ob.bids().empty() ? nan : ob.bids().begin()->second.price, std::memory_order_relaxed);
+        bestAsk_.store(ob.asks().empty() ? nan : ob.asks().begin()->second.price, std::memory_order_relaxed);
+        bidCount_.store(writeSide(ob.bids(), bidPx_.get(), bidSz_.get(), limit), std::memory_order_relaxed);
+        askCount_.store(writeSide(ob.asks(), askPx_.get(), askSz_.get(), limit), std::memory_order_relaxed);
+        trusted_.store(trusted, std::memory_order_relaxed);
+
+        seq_.store(seq + 2, std::memory_order_release);
     }
 
-    OrderBookSnapshot read() const {
-        const int idx = active_.v.load(std::memory_order_acquire);
+    // Copies the latest publish into out. Reuses out's level vectors, so a snapshot that is kept across
+    // calls stops allocating once it has seen the deepest book. Returns false if nothing was published yet.
+    bool read(OrderBookSnapshot& out) const {
+        while (true) {
+            const auto before = seq_.load(std::memory_order_acquire);
+            if (before == 0) return false;
+            if (before & 1) continue;
+
+            out.symbolId = symbolId_.load(std::memory_order_relaxed);
+            out.mono_ts = std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(monoTs_.load(std::memory_order_relaxed)));
+            out.bestBid = bestBid_.load(std::memory_order_relaxed);
+            out.bestAsk = bestAsk_.load(std::memory_order_relaxed);
+            readSide(out.bidLevels, bidPx_.get(), bidSz_.get(), bidCount_.load(std::memory_order_relaxed));
+            readSide(out.askLevels, askPx_.get(), askSz_.get(), askCount_.load(std::memory_order_relaxed));
+            out.trusted = trusted_.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return true;
+        }
+    }
 
-        return buffers_[idx];
+    OrderBookSnapshot read() const {
+        OrderBookSnapshot s;
+        read(s);
+        return s;
     }
 
+    // Number of completed publishes.
+    [[nodiscard]] std::uint64_t version() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
 private:
-    OrderBookSnapshot buffers_[2];
+    template<class Side>
+    static std::size_t writeSide(const Side& side, std::atomic<double>* px, std::atomic<double>* sz, std::size_t limit) {
+        std::size_t n = 0;
+        for (auto it = side.begin(); it != side.end() && n < limit; ++it, ++n) {
+            px[n].store(it->first, std::memory_order_relaxed);
+            sz[n].store(it->second.size, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    void readSide(std::vector<std::pair<double,double>>& out, const std::atomic<double>* px,
+                  const std::atomic<double>* sz, std::size_t n) const {
+        // A torn count may exceed what was written; clamp so the copy stays in bounds and let the retry fix it.
+        if (n > capacity_) n = capacity_;
+        out.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = {px[i].load(std::memory_order_relaxed), sz[i].load(std::memory_order_relaxed)};
+    }
+
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
 
-    ActiveIndex active_{};
+    alignas(64) std::atomic<gateway::SymbolId> symbolId_{};
+    std::atomic<std::chrono::steady_clock::rep> monoTs_{0};
+    std::atomic<double> bestBid_{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<double> bestAsk_{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<std::size_t> bidCount_{0};
+    std::atomic<std::size_t> askCount_{0};
+    std::atomic<bool> trusted_{true};
+
+    std::size_t capacity_{0};
+    std::unique_ptr<std::atomic<double>[]> bidPx_, bidSz_, askPx_, askSz_;
 };
 
-class OrderBook {
+// L2 book keyed by price. Alloc supplies the level map nodes: std::allocator by default, or
+// PoolAllocator to serve level churn from a preallocated NodeArena (see PooledOrderBook).
+template<class Alloc = std::allocator<PriceLevel>>
+class BasicOrderBook {
+	using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const double, PriceLevel>>;
+
 public:
-	explicit OrderBook(std::string symbol)
-		: symbol_(std::move(symbol)) {}
+	using Bids = std::map<double, PriceLevel, std::greater<double>, NodeAlloc>;
+	using Asks = std::map<double, PriceLevel, std::less<double>, NodeAlloc>;
+
+	explicit BasicOrderBook(std::string_view symbol, const Alloc& alloc = Alloc())
+		: BasicOrderBook(gateway::internSymbol(symbol), alloc) {}
+	explicit BasicOrderBook(gateway::SymbolId symbolId, const Alloc& alloc = Alloc())
+		: symbolId_(symbolId), bids_(NodeAlloc(alloc)), asks_(NodeAlloc(alloc)) {}
 
 	void update(const gateway::Quote& quote);
+	// Replaces both sides with the given levels in one step; zero-size levels are skipped.
+	void rebuild(const std::vector<gateway::Quote>& levels);
 
 	double bestBid() const;
 	double bestAsk() const;
 
-	const std::map<double, PriceLevel, std::greater<double>>& bids() const { return bids_; }
-	const std::map<double, PriceLevel, std::less<double>>& asks() const { return asks_; }
+	const Bids& bids() const { return bids_; }
+	const Asks& asks() const { return asks_; }
 
-	const std::string& symbol() const { return symbol_; }
+	std::string_view symbol() const { return gateway::symbolName(symbolId_); }
+	gateway::SymbolId symbolId() const { return symbolId_; }
 
 	OrderBookSnapshot snapshot(std::size_t maxLevels = 0) const;
 
+	// Signals maintained on every update() and readable in O(1). Depth sums cover the best
+	// analyticsDepth() levels per side; sweep costs are for trading sweepQuantity() units.
+	double microprice() const;
+	double bidDepth() const { return bidStats_.depthSize; }
+	double askDepth() const { return askStats_.depthSize; }
+	double bidDepthNotional() const { return bidStats_.depthNotional; }
+	double askDepthNotional() const { return askStats_.depthNotional; }
+	// (bidDepth - askDepth) / (bidDepth + askDepth), 0 for an empty book.
+	double imbalance() const;
+	// Selling sweepQuantity() into the bids / buying it from the asks.
+	const SweepCost& sellSweep() const { return bidStats_.sweep; }
+	const SweepCost& buySweep() const { return askStats_.sweep; }
+
+	// On-demand depth queries for arbitrary limits and quantities (see depth:: for the contiguous versions).
+	double cumulativeDepth(gateway::QuoteSide side, double limit) const;
+	std::size_t crossingLevel(gateway::QuoteSide side, double quantity) const;
+	SweepCost sweepCost(gateway::QuoteSide side, double quantity) const;
+
+	std::size_t analyticsDepth() const { return analyticsDepth_; }
+	double sweepQuantity() const { return sweepQuantity_; }
+	// Both recompute the signals from the current book; 0 switches the respective signal off.
+	void setAnalyticsDepth(std::size_t levels);
+	void setSweepQuantity(double quantity);
+
+	// Records touched levels from now on so takeDelta() can hand out what changed. Off by default;
+	// enabling it starts from a full-book reset so the first delta can seed a mirror.
+	void trackChanges(bool on);
+	bool tracksChanges() const { return tracking_; }
+	// Moves the changes since the previous call into out (reusing its storage) and returns false if there were none.
+	bool takeDelta(BookDelta& out);
+
 private:
-	std::string symbol_;
+	struct SideStats {
+		double edge{0.0};                 // price of the analyticsDepth()-th best level, valid while hasEdge
+		bool hasEdge{false};
+		double depthSize{0.0};
+		double depthNotional{0.0};
+		SweepCost sweep;
+		double sweepLimit{0.0};           // worst price the sweep reached
+	};
+
+	template<class Side>
+	void applyLevel(Side& side, SideStats& stats, double price, double size);
+	template<class Side>
+	void recomputeDepth(Side& side, SideStats& stats);
+	template<class Side>
+	void recomputeSweep(const Side& side, SideStats& stats);
+	void recomputeAnalytics();
+
+	void markDirty(double price, double size, gateway::QuoteSide side);
+
+	gateway::SymbolId symbolId_;
+
+	bool tracking_{false};
+	bool reset_{false};
+	std::vector<LevelChange> dirty_;
+	double publishedBestBid_{std::numeric_limits<double>::quiet_NaN()};
+	double publishedBestAsk_{std::numeric_limits<double>::quiet_NaN()};
+
+	Bids bids_;
+	Asks asks_;
+
+	std::size_t analyticsDepth_{5};
+	double sweepQuantity_{0.0};
+	SideStats bidStats_;
+	SideStats askStats_;
+};
+
+using OrderBook = BasicOrderBook<>;
+using PooledOrderBook = BasicOrderBook<PoolAllocator<PriceLevel>>;
 
-	std::map<double, PriceLevel, std::greater<double>> bids_;
-	std::map<double, PriceLevel, std::less<double>> asks_;
-};
\ No newline at end of file
+extern template class BasicOrderBook<std::allocator<PriceLevel>>;
+extern template class BasicOrderBook<PoolAllocator<PriceLevel>>;
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/mman.h>
+#endif
+
+// Fixed-capacity region carved into size-classed blocks. Freed blocks go onto a per-class free list and
+// are reused before the bump pointer advances, so a book whose level count stays bounded stops calling
+// malloc after warm-up. Requests that are too large, or that arrive once the region is used up, fall
+// back to operator new and are counted. Single-threaded, like the book that owns it.
+class NodeArena {
+public:
+	static constexpr std::size_t kGranule = 16;
+	static constexpr std::size_t kMaxBlock = 256;
+
+	explicit NodeArena(std::size_t capacityBytes = std::size_t{16} << 20, bool hugePages = false) {
+		// hugetlb mappings must be a whole number of 2 MiB pages.
+		const std::size_t unit = hugePages ? std::size_t{2} << 20 : kGranule;
+		capacity_ = (capacityBytes + unit - 1) / unit * unit;
+		base_ = static_cast<std::byte*>(map(capacity_, hugePages));
+	}
+
+	~NodeArena() { unmap(base_, capacity_); }
+
+	NodeArena(const NodeArena&) = delete;
+	NodeArena& operator=(const NodeArena&) = delete;
+
+	void* allocate(std::size_t bytes) {
+		const std::size_t cls = sizeClass(bytes);
+		if (cls < kClasses) {
+			if (FreeBlock* b = free_[cls]) {
+				free_[cls] = b->next;
+				++inUse_;
+				return b;
+			}
+			const std::size_t block = (cls + 1) * kGranule;
+			if (base_ && used_ + block <= capacity_) {
+				void* p = base_ + used_;
+				used_ += block;
+				++inUse_;
+				return p;
+			}
+		}
+		++fallbacks_;
+		return ::operator new(bytes);
+	}
+
+	void deallocate(void* p, std::size_t bytes) noexcept {
+		const std::size_t cls = sizeClass(bytes);
+		if (cls < kClasses && owns(p)) {
+			auto* b = static_cast<FreeBlock*>(p);
+			b->next = free_[cls];
+			free_[cls] = b;
+			--inUse_;
+			return;
+		}
+		::operator delete(p);
+	}
+
+	[[nodiscard]] bool owns(const void* p) const noexcept {
+		auto* b = static_cast<const std::byte*>(p);
+		return base_ && b >= base_ && b < base_ + capacity_;
+	}
+
+	// Blocks currently handed out from the region, bytes of the region ever carved, allocations that missed it.
+	[[nodiscard]] std::size_t inUse() const noexcept { return inUse_; }
+	[[nodiscard]] std::size_t used() const noexcept { return used_; }
+	[[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+	[[nodiscard]] std::size_t fallbacks() const noexcept { return fallbacks_; }
+	[[nodiscard]] bool hugePages() const noexcept { return hugePages_; }
+
+private:
+	struct FreeBlock { FreeBlock* next; };
+	static constexpr std::size_t kClasses = kMaxBlock / kGranule;
+
+	static std::size_t sizeClass(std::size_t bytes) noexcept {
+		return bytes == 0 ? 0 : (bytes - 1) / kGranule;
+	}
+
+	void* map(std::size_t bytes, bool hugePages) {
+#if defined(__unix__) || defined(__APPLE__)
+  #if defined(MAP_HUGETLB)
+		if (hugePages) {
+			void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (p != MAP_FAILED) {
+				hugePages_ = true;
+				mapped_ = true;
+				return p;
+			}
+		}
+  #endif
+		void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p != MAP_FAILED) {
+  #if defined(MADV_HUGEPAGE)
+			// No reserved hugetlb pages: ask for transparent huge pages instead.
+			if (hugePages) ::madvise(p, bytes, MADV_HUGEPAGE);
+  #endif
+			mapped_ = true;
+			return p;
+		}
+		return nullptr;
+#else
+		(void)hugePages;
+		return ::operator new(bytes, std::align_val_t{kGranule}, std::nothrow);
+#endif
+	}
+
+	void unmap(void* p, std::size_t bytes) noexcept {
+		if (!p) return;
+#if defined(__unix__) || defined(__APPLE__)
+		if (mapped_) ::munmap(p, bytes);
+#else
+		(void)bytes;
+		::operator delete(p, std::align_val_t{kGranule});
+#endif
+	}
+
+	std::byte* base_{nullptr};
+	std::size_t capacity_{0};
+	std::size_t used_{0};
+	std::size_t inUse_{0};
+	std::size_t fallbacks_{0};
+	bool hugePages_{false};
+	bool mapped_{false};
+	std::array<FreeBlock*, kClasses> free_{};
+};
+
+// Standard allocator over a NodeArena; rebinding shares the arena, so std::map nodes come from it.
+template<class T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	explicit PoolAllocator(NodeArena& arena) noexcept : arena_(&arena) {}
+	template<class U>
+	PoolAllocator(const PoolAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+	T* allocate(std::size_t n) {
+		static_assert(alignof(T) <= NodeArena::kGranule, "NodeArena blocks are 16-byte aligned");
+		return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+	}
+	void deallocate(T* p, std::size_t n) noexcept { arena_->deallocate(p, n * sizeof(T)); }
+
+	[[nodiscard]] NodeArena* arena() const noexcept { return arena_; }
+
+	template<class U>
+	bool operator==(const PoolAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+
+private:
+	NodeArena* arena_;
+};
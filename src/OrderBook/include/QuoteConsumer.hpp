@@ -1,82 +1,353 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cmath>
 #include <thread>
 #include <chrono>
 #include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "BookCheckpoint.hpp"
+#include "BookIntegrity.hpp"
 #include "OrderBook.hpp"
 #include "QuotesObtainer.hpp"
+#include "FeedArbiter.hpp"
 
-template<class GatewayT>
+// Placeholder strategy for consumers that only maintain and publish books.
+struct NoStrategy {};
+
+// Consumes one or more redundant feeds; duplicates are removed by the FeedArbiter so each book sees
+// whichever copy of an update arrived first. Quotes are routed to books by their SymbolId.
+template<class... GatewayT>
 class QuoteConsumer {
 public:
-    QuoteConsumer(gateway::QuotesObtainer<GatewayT>& obt, std::string symbol)
-        : obt_(obt), symbol_(std::move(symbol)), book_(symbol_) {}
+    using Feeds = std::tuple<gateway::QuotesObtainer<GatewayT>&...>;
+    using Arbiter = gateway::FeedArbiter<sizeof...(GatewayT)>;
+    // Whether any feed can answer a resync with a snapshot; without one the Resync policy heals instead.
+    static constexpr bool kCanResync = (gateway::QuotesObtainer<GatewayT>::kCanResync || ...);
+
+    QuoteConsumer(Feeds feeds, std::string symbol)
+        : QuoteConsumer(feeds, std::vector<std::string>{std::move(symbol)}) {}
+
+    // Book i tracks symbols[i]; quotes for symbols not in the list are ignored.
+    QuoteConsumer(Feeds feeds, const std::vector<std::string>& symbols)
+        : feeds_(feeds) {
+        std::apply([&](auto&... feed) {
+            std::size_t i = 0;
+            ((queues_[i++] = &feed.getBidQueue(), queues_[i++] = &feed.getAskQueue()), ...);
+        }, feeds_);
+        books_.reserve(symbols.size());
+        for (const auto& s : symbols) {
+            const auto id = gateway::internSymbol(s);
+            if (localIndex_[id] != 0) continue;
+            books_.emplace_back(id);
+            localIndex_[id] = static_cast<std::uint16_t>(books_.size());
+        }
+    }
 
     void start() {
         running_.store(true);
-        obt_.connect();
-        worker_ = std::thread(&QuoteConsumer::runLoop, this);
+        worker_ = std::thread([this] { runLoop(noStrategy_); });
+    }
+
+    // Runs strategy on the consumer thread: after each drained batch, strategy.onBook(book, tick, trusted)
+    // is called for every book the batch changed, before views are published. tick is the receive time of
+    // the oldest quote in the batch. The strategy type is fixed here, so the call is direct and inlinable.
+    template<class Strategy>
+    void start(Strategy& strategy) {
+        running_.store(true);
+        worker_ = std::thread([this, &strategy] { runLoop(strategy); });
     }
 
     void stop() {
         running_.store(false);
-        obt_.disconnect();
+        std::apply([](auto&... feed) { (feed.disconnect(), ...); }, feeds_);
         if (worker_.joinable()) worker_.join();
+        if (checkpoints_) checkpoint();
     }
 
-    const OrderBook& orderBook() const { return book_; }
-    const std::string& symbol() const { return symbol_; }
+    // One pass of the consumer loop on the caller's thread: drain every feed, run strategy on the books
+    // that changed, publish and checkpoint. For drivers that feed the obtainers synchronously, such as
+    // a backtest replaying a journal; not to be mixed with start(). Returns the number of quotes applied.
+    template<class Strategy>
+    std::size_t poll(Strategy& strategy) {
+        const std::size_t applied = drainFeeds();
+        decide(strategy);
 
-    void attachView(OrderBookView* v) { view_ = v; }
+        const auto now = std::chrono::steady_clock::now();
+        for (auto id : viewed_) publish(books_[id], now);
+        if (checkpoints_ && now >= nextCheckpoint_) {
+            checkpoint();
+            nextCheckpoint_ = now + checkpointPeriod_;
+        }
+        return applied;
+    }
+
+    std::size_t poll() { return poll(noStrategy_); }
+
+    const OrderBook& getOrderBook(std::size_t i = 0) const { return books_[i].book; }
+    std::string_view symbol(std::size_t i = 0) const { return books_[i].book.symbol(); }
+    std::size_t bookCount() const { return books_.size(); }
+    const Arbiter& arbiter() const { return arbiter_; }
+    // Integrity counters of book i; safe to read from any thread.
+    IntegrityStats integrity(std::size_t i = 0) const { return books_[i].guard.stats(); }
+    bool trusted(std::size_t i = 0) const { return books_[i].guard.trusted(); }
+
+    // Invariant checks and crossed-book policy for every book. Set before start().
+    void setIntegrity(const IntegrityConfig& config) {
+        for (auto& state : books_) state.guard.configure(config);
+    }
+
+    // Sizes the view for the publish depth, so set the depth first; both must happen before start().
+    void attachView(OrderBookView* v, std::size_t i = 0) {
+        v->reserve(maxLevels_);
+        books_[i].view = v;
+        watch(i);
+    }
+    // Delivers book i's change set on the consumer thread after every batch that touched it, unthrottled.
+    // Register before start(); the first delta is a reset carrying the whole book.
+    void subscribeDeltas(DeltaHandler handler, std::size_t i = 0) {
+        books_[i].deltaHandlers.push_back(std::move(handler));
+        books_[i].book.trackChanges(true);
+        watch(i);
+    }
+    // Hands a copy of every book to writer each period, and once more on stop(). Set before start().
+    void enableCheckpoints(CheckpointWriter* writer, std::chrono::milliseconds period) {
+        checkpoints_ = writer;
+        checkpointPeriod_ = period;
+    }
+    // Pre-populates books from a checkpoint and seeds the feeds' nonce tracking with its sequences, so
+    // the live feed either continues the restored book or triggers a snapshot resync on the first gap.
+    // Call before start() and before the feeds connect. Returns the number of books restored.
+    std::size_t restore(const CheckpointFile& file) {
+        std::size_t restored = 0;
+        for (auto& state : books_) {
+            const auto* record = file.find(state.book.symbol());
+            if (!record) continue;
+            const auto snap = record->toSnapshot();
+            state.book.rebuild(snap.levels);
+            state.snapshotSequence = state.maxAppliedSequence = snap.sequence;
+            state.guard.afterRebuild(state.book);
+            ++state.sinceLastPublish;
+            state.imageStale = true;
+            if (snap.sequence != 0) {
+                std::apply([&](auto&... feed) { (feed.resumeFrom(snap.symbol, snap.sequence), ...); }, feeds_);
+            }
+            ++restored;
+        }
+        return restored;
+    }
     void setPublishLevels(std::size_t n) { maxLevels_ = n; }
     void setPublishPeriod(std::chrono::milliseconds p) { publishPeriod_ = p; }
 
 private:
-    void runLoop() {
-        using namespace std::chrono;
-        auto nextPublish = steady_clock::now();
-        std::size_t sinceLastPublish = 0;
+    struct BookState {
+        explicit BookState(gateway::SymbolId symbol) : book(symbol) {}
+
+        OrderBook book;
+        std::uint64_t snapshotSequence{0};
+        std::uint64_t maxAppliedSequence{0};
+
+        BookGuard guard;
+
+        OrderBookView* view{nullptr};
+        bool lastTrusted{true};
+        double lastBestBid{std::numeric_limits<double>::quiet_NaN()};
+        double lastBestAsk{std::numeric_limits<double>::quiet_NaN()};
+        std::chrono::steady_clock::time_point nextPublish{};
+        std::size_t sinceLastPublish{0};
+
+        std::vector<DeltaHandler> deltaHandlers;
+        BookDelta delta;
+
+        // Set while the book is in the current batch; batchTick is its oldest quote's receive time.
+        bool inBatch{false};
+        std::chrono::system_clock::time_point batchTick{};
+
+        // Last checkpoint image; reused while the book has not changed since.
+        BookImagePtr image;
+        bool imageStale{true};
+    };
+
+    void watch(std::size_t i) {
+        if (std::find(viewed_.begin(), viewed_.end(), i) == viewed_.end()) viewed_.push_back(i);
+    }
+
+    void markChanged(BookState& state, std::chrono::system_clock::time_point tick) {
+        if (!state.inBatch) {
+            state.inBatch = true;
+            state.batchTick = tick;
+            batch_.push_back(static_cast<std::size_t>(&state - books_.data()));
+        } else if (tick < state.batchTick) {
+            state.batchTick = tick;
+        }
+    }
 
-        double lastBestBid = std::numeric_limits<double>::quiet_NaN();
-        double lastBestAsk = std::numeric_limits<double>::quiet_NaN();
+    BookState* find(gateway::SymbolId id) {
+        const auto idx = localIndex_[id];
+        return idx ? &books_[idx - 1] : nullptr;
+    }
+
+    template<class Obtainer>
+    void syncSnapshot(Obtainer& feed) {
+        while (feed.snapshotPending()) {
+            auto snap = feed.takeSnapshot();
+            if (!snap) continue;
+            auto* tracked = find(snap->symbol);
+            if (!tracked) continue;
+            auto& state = *tracked;
+            // Another feed may already have carried the book past this snapshot.
+            if (snap->sequence < state.maxAppliedSequence) {
+                state.guard.snapshotSkipped();
+                continue;
+            }
+            state.book.rebuild(snap->levels);
+            state.guard.afterRebuild(state.book);
+            state.snapshotSequence = state.maxAppliedSequence = snap->sequence;
+            ++state.sinceLastPublish;
+            state.imageStale = true;
+            markChanged(state, snap->levels.empty() ? std::chrono::system_clock::now() : snap->levels.front().getTimestamp());
+        }
+    }
+
+    bool apply(std::size_t feedIdx, const gateway::Quote& q) {
+        auto* tracked = find(q.getSymbolId());
+        if (!tracked) return false;
+        auto& state = *tracked;
+        const auto seq = q.getSequence();
+        if (seq != 0 && seq <= state.snapshotSequence) return false;
+        if (!state.guard.admit(q)) return false;
+        if (!arbiter_.accept(feedIdx, q)) return false;
+        state.book.update(q);
+        if (state.guard.afterUpdate(state.book, q) == BookGuard::Verdict::NeedsResync) {
+            if constexpr (kCanResync) {
+                std::apply([&](auto&... feed) { (feed.requestResync(q.getSymbolId()), ...); }, feeds_);
+            } else {
+                state.guard.resyncUnavailable(state.book, q);
+            }
+        }
+        state.maxAppliedSequence = std::max(state.maxAppliedSequence, seq);
+        ++state.sinceLastPublish;
+        state.imageStale = true;
+        markChanged(state, q.getTimestamp());
+        return true;
+    }
 
+    void syncSnapshot(std::size_t feedIdx) {
+        std::apply([&](auto&... feed) {
+            std::size_t i = 0;
+            ((i++ == feedIdx ? syncSnapshot(feed) : void()), ...);
+        }, feeds_);
+    }
+
+    // Applies what every feed has queued, oldest receive time first across all feeds and both sides, so
+    // the arbiter's winner is the copy that arrived first rather than the feed that was drained first.
+    // Equal timestamps go to the lower feed, bids before asks.
+    std::size_t drainFeeds() {
+        std::size_t applied = 0;
+        std::apply([&](auto&... feed) { (syncSnapshot(feed), ...); }, feeds_);
         gateway::Quote q{};
-        while (running_.load(std::memory_order_relaxed)) {
-            bool didWork = false;
-
-            while (obt_.getBidQueue().pop(q)) { book_.update(q); didWork = true; ++sinceLastPublish; }
-            while (obt_.getAskQueue().pop(q)) { book_.update(q); didWork = true; ++sinceLastPublish; }
-
-            const auto now = steady_clock::now();
-            const double bb = book_.bestBid();
-            const double ba = book_.bestAsk();
-            const bool tobChanged =
-                (!std::isnan(bb) && bb != lastBestBid) ||
-                (!std::isnan(ba) && ba != lastBestAsk);
-
-            const bool timeToPublish = now >= nextPublish;
-            const bool haveNewData   = sinceLastPublish > 0;
-
-            if (view_ && ((timeToPublish && haveNewData) || tobChanged)) {
-                view_->publish_from(book_, maxLevels_);
-                sinceLastPublish = 0;
-                nextPublish = now + publishPeriod_;
-                lastBestBid = bb; lastBestAsk = ba;
+        while (true) {
+            std::size_t next = queues_.size();
+            std::chrono::system_clock::time_point oldest{};
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                if (queues_[i]->read_available() == 0) continue;
+                const auto ts = queues_[i]->front().getTimestamp();
+                if (next == queues_.size() || ts < oldest) {
+                    next = i;
+                    oldest = ts;
+                }
             }
+            if (next == queues_.size()) break;
+            queues_[next]->pop(q);
+            const std::size_t feedIdx = next / 2;
+            syncSnapshot(feedIdx);
+            applied += apply(feedIdx, q);
+        }
+        return applied;
+    }
 
-            if (!didWork) std::this_thread::sleep_for(100us);
+    void publish(BookState& state, std::chrono::steady_clock::time_point now) {
+        if (!state.deltaHandlers.empty() && state.book.takeDelta(state.delta)) {
+            for (auto& handler : state.deltaHandlers) handler(state.delta);
+        }
+        if (!state.view) return;
+
+        const double bb = state.book.bestBid();
+        const double ba = state.book.bestAsk();
+        const bool trusted = state.guard.trusted();
+        const bool tobChanged =
+            (!std::isnan(bb) && bb != state.lastBestBid) ||
+            (!std::isnan(ba) && ba != state.lastBestAsk) ||
+            trusted != state.lastTrusted;
+
+        const bool timeToPublish = now >= state.nextPublish;
+        const bool haveNewData   = state.sinceLastPublish > 0;
+
+        if ((timeToPublish && haveNewData) || tobChanged) {
+            state.view->publish_from(state.book, maxLevels_, trusted);
+            state.sinceLastPublish = 0;
+            state.nextPublish = now + publishPeriod_;
+            state.lastBestBid = bb; state.lastBestAsk = ba;
+            state.lastTrusted = trusted;
+        }
+    }
+
+    void checkpoint() {
+        std::vector<BookImagePtr> images;
+        images.reserve(books_.size());
+        for (auto& state : books_) {
+            if (state.imageStale || !state.image) {
+                state.image = makeBookImage(state.book, state.maxAppliedSequence);
+                state.imageStale = false;
+            }
+            images.push_back(state.image);
+        }
+        checkpoints_->submit(std::move(images));
+    }
+
+    template<class Strategy>
+    void decide(Strategy& strategy) {
+        for (auto i : batch_) {
+            auto& state = books_[i];
+            if constexpr (!std::is_same_v<Strategy, NoStrategy>) {
+                strategy.onBook(state.book, state.batchTick, state.guard.trusted());
+            }
+            state.inBatch = false;
+        }
+        batch_.clear();
+    }
+
+    template<class Strategy>
+    void runLoop(Strategy& strategy) {
+        using namespace std::chrono;
+        while (running_.load(std::memory_order_relaxed)) {
+            if (poll(strategy) == 0) std::this_thread::sleep_for(100us);
         }
     }
 
 private:
-    gateway::QuotesObtainer<GatewayT>& obt_;
-    std::string symbol_;
-    OrderBook book_;
+    using QuoteQueue = boost::lockfree::spsc_queue<gateway::Quote, boost::lockfree::capacity<1024>>;
+
+    Feeds feeds_;
+    // Feed i's bid queue at 2i, its ask queue at 2i + 1.
+    std::array<QuoteQueue*, 2 * sizeof...(GatewayT)> queues_{};
+    std::vector<BookState> books_;
+    std::array<std::uint16_t, gateway::SymbolTable::kMaxSymbols> localIndex_{};
+    std::vector<std::size_t> viewed_;
+    std::vector<std::size_t> batch_;
+    Arbiter arbiter_;
+    NoStrategy noStrategy_;
 
     std::atomic<bool> running_{false};
     std::thread worker_;
 
-    OrderBookView* view_{nullptr};
     std::size_t maxLevels_{80};
     std::chrono::milliseconds publishPeriod_{20};
-};
\ No newline at end of file
+
+    CheckpointWriter* checkpoints_{nullptr};
+    std::chrono::milliseconds checkpointPeriod_{5000};
+    std::chrono::steady_clock::time_point nextCheckpoint_{};
+};
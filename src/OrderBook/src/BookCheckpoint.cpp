@@ -0,0 +1,268 @@
+#include "BookCheckpoint.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace checkpoint {
+
+	namespace {
+
+		constexpr std::size_t pad8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+		std::uint64_t fnv1a(const std::byte* p, std::size_t n) {
+			std::uint64_t h = 1469598103934665603ull;
+			for (std::size_t i = 0; i < n; ++i) h = (h ^ static_cast<std::uint64_t>(p[i])) * 1099511628211ull;
+			return h;
+		}
+
+		template<class T>
+		void put(std::vector<std::byte>& out, const T& value) {
+			const auto* p = reinterpret_cast<const std::byte*>(&value);
+			out.insert(out.end(), p, p + sizeof(T));
+		}
+
+		void putLevels(std::vector<std::byte>& out, const std::vector<std::pair<double, double>>& levels) {
+			for (const auto& [price, size] : levels) {
+				put(out, price);
+				put(out, size);
+			}
+		}
+
+	}
+
+	std::vector<std::byte> encode(const std::vector<BookImagePtr>& images) {
+		std::vector<std::byte> out(sizeof(FileHeader));
+		std::uint32_t books = 0;
+		for (const auto& image : images) {
+			if (!image) continue;
+			const auto name = gateway::symbolName(image->symbol);
+			put(out, RecordHeader{image->sequence, static_cast<std::uint32_t>(image->bids.size()),
+								  static_cast<std::uint32_t>(image->asks.size()),
+								  static_cast<std::uint32_t>(name.size()), 0});
+			const auto* chars = reinterpret_cast<const std::byte*>(name.data());
+			out.insert(out.end(), chars, chars + name.size());
+			out.resize(pad8(out.size()));
+			putLevels(out, image->bids);
+			putLevels(out, image->asks);
+			++books;
+		}
+
+		FileHeader header{};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.bookCount = books;
+		header.createdNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+		header.payloadBytes = out.size() - sizeof(FileHeader);
+		header.checksum = fnv1a(out.data() + sizeof(FileHeader), header.payloadBytes);
+		std::memcpy(out.data(), &header, sizeof(header));
+		return out;
+	}
+
+	bool write(const std::string& path, const std::vector<BookImagePtr>& images) {
+		const auto bytes = encode(images);
+		const std::string tmp = path + ".tmp";
+#if defined(__unix__) || defined(__APPLE__)
+		const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			std::cerr << "Checkpoint: cannot open " << tmp << "\n";
+			return false;
+		}
+		std::size_t done = 0;
+		while (done < bytes.size()) {
+			const auto n = ::write(fd, bytes.data() + done, bytes.size() - done);
+			if (n <= 0) break;
+			done += static_cast<std::size_t>(n);
+		}
+		const bool ok = done == bytes.size() && ::fsync(fd) == 0;
+		::close(fd);
+#else
+		std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+		f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		f.close();
+		const bool ok = static_cast<bool>(f);
+#endif
+		if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+			std::cerr << "Checkpoint: failed to write " << path << "\n";
+			std::remove(tmp.c_str());
+			return false;
+		}
+		return true;
+	}
+
+}
+
+gateway::BookSnapshot CheckpointFile::Record::toSnapshot() const {
+	gateway::BookSnapshot snap;
+	snap.symbol = gateway::internSymbol(symbol);
+	snap.sequence = sequence;
+	snap.levels.reserve(bidCount + askCount);
+	const auto ts = std::chrono::system_clock::now();
+	for (std::size_t i = 0; i < bidCount; ++i)
+		snap.levels.emplace_back(bids[i].first, bids[i].second, ts, snap.symbol, gateway::QuoteSide::Bid, sequence);
+	for (std::size_t i = 0; i < askCount; ++i)
+		snap.levels.emplace_back(asks[i].first, asks[i].second, ts, snap.symbol, gateway::QuoteSide::Ask, sequence);
+	return snap;
+}
+
+bool CheckpointFile::open(const std::string& path) {
+	using namespace checkpoint;
+	close();
+
+#if defined(__unix__) || defined(__APPLE__)
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st{};
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			data_ = static_cast<const std::byte*>(p);
+			size_ = static_cast<std::size_t>(st.st_size);
+			mapped_ = true;
+		}
+	}
+	::close(fd);
+#endif
+	if (!data_) {
+		std::ifstream f(path, std::ios::binary);
+		if (!f) return false;
+		std::vector<char> raw((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+		// Heap storage keeps the 8-byte alignment the in-place level reads rely on.
+		owned_.resize(raw.size());
+		std::memcpy(owned_.data(), raw.data(), raw.size());
+		data_ = owned_.data();
+		size_ = owned_.size();
+	}
+
+	auto fail = [&](const char* why) {
+		std::cerr << "Checkpoint: " << path << " " << why << ", ignoring it\n";
+		close();
+		return false;
+	};
+
+	FileHeader header{};
+	if (size_ < sizeof(header)) return fail("is truncated");
+	std::memcpy(&header, data_, sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return fail("is not a checkpoint");
+	if (header.version != kVersion) return fail("has an unsupported version");
+	if (header.payloadBytes != size_ - sizeof(header)) return fail("is truncated");
+	if (header.checksum != checkpoint::fnv1a(data_ + sizeof(header), header.payloadBytes)) return fail("fails its checksum");
+
+	std::size_t off = sizeof(header);
+	records_.reserve(header.bookCount);
+	for (std::uint32_t i = 0; i < header.bookCount; ++i) {
+		RecordHeader rh{};
+		if (size_ - off < sizeof(rh)) return fail("has a truncated record");
+		std::memcpy(&rh, data_ + off, sizeof(rh));
+		off += sizeof(rh);
+
+		const std::size_t levelBytes = (std::size_t{rh.bidCount} + rh.askCount) * sizeof(std::pair<double, double>);
+		if (size_ - off < pad8(rh.nameLength) + levelBytes) return fail("has a truncated record");
+
+		Record r{};
+		r.symbol = std::string_view(reinterpret_cast<const char*>(data_ + off), rh.nameLength);
+		off += pad8(rh.nameLength);
+		r.sequence = rh.sequence;
+		r.bids = reinterpret_cast<const std::pair<double, double>*>(data_ + off);
+		r.bidCount = rh.bidCount;
+		r.asks = r.bids + rh.bidCount;
+		r.askCount = rh.askCount;
+		off += levelBytes;
+		records_.push_back(r);
+	}
+	createdNs_ = header.createdNs;
+	return true;
+}
+
+void CheckpointFile::close() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+	if (mapped_) ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+	mapped_ = false;
+	owned_.clear();
+	records_.clear();
+	createdNs_ = 0;
+}
+
+const CheckpointFile::Record* CheckpointFile::find(std::string_view symbol) const noexcept {
+	for (const auto& r : records_)
+		if (r.symbol == symbol) return &r;
+	return nullptr;
+}
+
+CheckpointWriter::CheckpointWriter(std::string path)
+	: path_(std::move(path))
+	, worker_(&CheckpointWriter::run, this) {}
+
+CheckpointWriter::~CheckpointWriter() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	wake_.notify_one();
+	worker_.join();
+}
+
+void CheckpointWriter::submit(std::vector<BookImagePtr> images) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (hasPending_) ++superseded_;
+		pending_ = std::move(images);
+		hasPending_ = true;
+	}
+	wake_.notify_one();
+}
+
+void CheckpointWriter::flush() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_.wait(lock, [this] { return !hasPending_ && !busy_; });
+}
+
+std::uint64_t CheckpointWriter::written() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return written_;
+}
+
+std::uint64_t CheckpointWriter::failures() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return failures_;
+}
+
+std::uint64_t CheckpointWriter::superseded() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return superseded_;
+}
+
+void CheckpointWriter::run() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		wake_.wait(lock, [this] { return hasPending_ || stopping_; });
+		// A pending checkpoint is still written on shutdown so the newest state survives.
+		if (!hasPending_) return;
+
+		auto images = std::move(pending_);
+		pending_.clear();
+		hasPending_ = false;
+		busy_ = true;
+		lock.unlock();
+		const bool ok = checkpoint::write(path_, images);
+		images.clear();
+		lock.lock();
+		busy_ = false;
+		ok ? ++written_ : ++failures_;
+		idle_.notify_all();
+	}
+}
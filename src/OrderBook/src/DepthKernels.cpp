@@ -0,0 +1,279 @@
+#include "DepthKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  #define HFT_DEPTH_AVX2 1
+  #include <immintrin.h>
+  #define HFT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+  #define HFT_DEPTH_AVX2 0
+#endif
+
+namespace depth {
+
+	namespace {
+
+		// Level i counted from the best one, plus (for AVX2) four levels i..i+3 as lane-matched
+		// price and size vectors. Lane order inside a block is not level order; only sums use it.
+		struct PairAccess {
+			const PairLevels& s;
+			std::size_t count() const { return s.count; }
+			double price(std::size_t i) const { return s.levels[i].first; }
+			double size(std::size_t i) const { return s.levels[i].second; }
+#if HFT_DEPTH_AVX2
+			HFT_TARGET_AVX2 void load4(std::size_t i, __m256d& px, __m256d& sz) const {
+				const __m256d a = _mm256_loadu_pd(&s.levels[i].first);
+				const __m256d b = _mm256_loadu_pd(&s.levels[i + 2].first);
+				px = _mm256_unpacklo_pd(a, b);
+				sz = _mm256_unpackhi_pd(a, b);
+			}
+#endif
+		};
+
+		struct ReversedAccess {
+			const ReversedLevels& s;
+			std::size_t count() const { return s.count; }
+			double price(std::size_t i) const { return s.prices[s.count - 1 - i]; }
+			double size(std::size_t i) const { return s.sizes[s.count - 1 - i]; }
+#if HFT_DEPTH_AVX2
+			HFT_TARGET_AVX2 void load4(std::size_t i, __m256d& px, __m256d& sz) const {
+				px = _mm256_loadu_pd(s.prices + (s.count - 4 - i));
+				sz = _mm256_loadu_pd(s.sizes + (s.count - 4 - i));
+			}
+#endif
+		};
+
+		bool atOrBetter(gateway::QuoteSide which, double price, double limit) {
+			return which == gateway::QuoteSide::Bid ? price >= limit : price <= limit;
+		}
+
+		template<class A>
+		double cumulativeDepthScalar(const A& a, std::size_t i, gateway::QuoteSide which, double limit, double acc) {
+			for (; i < a.count() && atOrBetter(which, a.price(i), limit); ++i) acc += a.size(i);
+			return acc;
+		}
+
+		template<class A>
+		std::size_t levelsWithinScalar(const A& a, std::size_t i, gateway::QuoteSide which, double limit) {
+			while (i < a.count() && atOrBetter(which, a.price(i), limit)) ++i;
+			return i;
+		}
+
+		template<class A>
+		double topDepthScalar(const A& a, std::size_t i, std::size_t n, double acc) {
+			for (; i < n; ++i) acc += a.size(i);
+			return acc;
+		}
+
+		template<class A>
+		std::size_t crossingLevelScalar(const A& a, std::size_t i, double quantity, double acc) {
+			for (; i < a.count(); ++i) {
+				acc += a.size(i);
+				if (acc >= quantity) return i;
+			}
+			return a.count();
+		}
+
+		template<class A>
+		SweepCost sweepScalar(const A& a, std::size_t i, double quantity, SweepCost c) {
+			for (; i < a.count(); ++i) {
+				const double take = std::min(quantity - c.quantity, a.size(i));
+				c.quantity += take;
+				c.notional += take * a.price(i);
+				if (c.quantity >= quantity) {
+					c.complete = true;
+					break;
+				}
+			}
+			return c;
+		}
+
+#if HFT_DEPTH_AVX2
+		// The scalar tails are compiled without VEX, so every AVX2 kernel clears the upper lanes before
+		// handing over; otherwise each SSE instruction in the tail pays the AVX-SSE transition penalty.
+		HFT_TARGET_AVX2 double hsum(__m256d v) {
+			__m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+			s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+			return _mm_cvtsd_f64(s);
+		}
+
+		// Bids compare price >= limit, asks -price >= -limit, so one GE compare serves both sides.
+		template<class A>
+		HFT_TARGET_AVX2 double cumulativeDepthAvx2(const A& a, gateway::QuoteSide which, double limit) {
+			const double sign = which == gateway::QuoteSide::Bid ? 1.0 : -1.0;
+			const __m256d vsign = _mm256_set1_pd(sign);
+			const __m256d vlimit = _mm256_set1_pd(sign * limit);
+			__m256d acc = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= a.count(); i += 4) {
+				__m256d px, sz;
+				a.load4(i, px, sz);
+				const __m256d in = _mm256_cmp_pd(_mm256_mul_pd(px, vsign), vlimit, _CMP_GE_OQ);
+				acc = _mm256_add_pd(acc, _mm256_and_pd(in, sz));
+				// Sorted levels: a block that is not fully inside ends the walk.
+				if (_mm256_movemask_pd(in) != 0xF) {
+					const double total = hsum(acc);
+					_mm256_zeroupper();
+					return total;
+				}
+			}
+			const double total = hsum(acc);
+			_mm256_zeroupper();
+			return cumulativeDepthScalar(a, i, which, limit, total);
+		}
+
+		template<class A>
+		HFT_TARGET_AVX2 std::size_t levelsWithinAvx2(const A& a, gateway::QuoteSide which, double limit) {
+			const double sign = which == gateway::QuoteSide::Bid ? 1.0 : -1.0;
+			const __m256d vsign = _mm256_set1_pd(sign);
+			const __m256d vlimit = _mm256_set1_pd(sign * limit);
+			std::size_t i = 0;
+			for (; i + 4 <= a.count(); i += 4) {
+				__m256d px, sz;
+				a.load4(i, px, sz);
+				const int in = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_mul_pd(px, vsign), vlimit, _CMP_GE_OQ));
+				if (in != 0xF) {
+					_mm256_zeroupper();
+					return i + static_cast<std::size_t>(std::popcount(static_cast<unsigned>(in)));
+				}
+			}
+			_mm256_zeroupper();
+			return levelsWithinScalar(a, i, which, limit);
+		}
+
+		template<class A>
+		HFT_TARGET_AVX2 double topDepthAvx2(const A& a, std::size_t n) {
+			__m256d acc = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m256d px, sz;
+				a.load4(i, px, sz);
+				acc = _mm256_add_pd(acc, sz);
+			}
+			const double total = hsum(acc);
+			_mm256_zeroupper();
+			return topDepthScalar(a, i, n, total);
+		}
+
+		template<class A>
+		HFT_TARGET_AVX2 std::size_t crossingLevelAvx2(const A& a, double quantity) {
+			double acc = 0.0;
+			std::size_t i = 0;
+			for (; i + 4 <= a.count(); i += 4) {
+				__m256d px, sz;
+				a.load4(i, px, sz);
+				const double block = hsum(sz);
+				if (acc + block >= quantity) break;
+				acc += block;
+			}
+			_mm256_zeroupper();
+			return crossingLevelScalar(a, i, quantity, acc);
+		}
+
+		template<class A>
+		HFT_TARGET_AVX2 SweepCost sweepAvx2(const A& a, double quantity) {
+			SweepCost c;
+			std::size_t i = 0;
+			for (; i + 4 <= a.count(); i += 4) {
+				__m256d px, sz;
+				a.load4(i, px, sz);
+				const double block = hsum(sz);
+				if (c.quantity + block >= quantity) break;
+				c.quantity += block;
+				c.notional += hsum(_mm256_mul_pd(px, sz));
+			}
+			_mm256_zeroupper();
+			return sweepScalar(a, i, quantity, c);
+		}
+
+		bool detectAvx2() {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+		}
+		const bool kHasAvx2 = detectAvx2();
+#else
+		constexpr bool kHasAvx2 = false;
+#endif
+
+		std::atomic<bool> scalarOnly{false};
+
+		bool useAvx2() { return kHasAvx2 && !scalarOnly.load(std::memory_order_relaxed); }
+
+		template<class A>
+		double cumulativeDepthImpl(const A& a, gateway::QuoteSide which, double limit) {
+#if HFT_DEPTH_AVX2
+			if (useAvx2()) return cumulativeDepthAvx2(a, which, limit);
+#endif
+			return cumulativeDepthScalar(a, 0, which, limit, 0.0);
+		}
+
+		template<class A>
+		std::size_t levelsWithinImpl(const A& a, gateway::QuoteSide which, double limit) {
+#if HFT_DEPTH_AVX2
+			if (useAvx2()) return levelsWithinAvx2(a, which, limit);
+#endif
+			return levelsWithinScalar(a, 0, which, limit);
+		}
+
+		template<class A>
+		double topDepthImpl(const A& a, std::size_t n) {
+			if (n > a.count()) n = a.count();
+#if HFT_DEPTH_AVX2
+			if (useAvx2()) return topDepthAvx2(a, n);
+#endif
+			return topDepthScalar(a, 0, n, 0.0);
+		}
+
+		template<class A>
+		std::size_t crossingLevelImpl(const A& a, double quantity) {
+#if HFT_DEPTH_AVX2
+			if (useAvx2()) return crossingLevelAvx2(a, quantity);
+#endif
+			return crossingLevelScalar(a, 0, quantity, 0.0);
+		}
+
+		template<class A>
+		SweepCost sweepImpl(const A& a, double quantity) {
+			if (quantity <= 0.0) return SweepCost{};
+#if HFT_DEPTH_AVX2
+			if (useAvx2()) return sweepAvx2(a, quantity);
+#endif
+			return sweepScalar(a, 0, quantity, SweepCost{});
+		}
+
+	}
+
+	double cumulativeDepth(const PairLevels& side, gateway::QuoteSide which, double limit) {
+		return cumulativeDepthImpl(PairAccess{side}, which, limit);
+	}
+	double cumulativeDepth(const ReversedLevels& side, gateway::QuoteSide which, double limit) {
+		return cumulativeDepthImpl(ReversedAccess{side}, which, limit);
+	}
+
+	std::size_t levelsWithin(const PairLevels& side, gateway::QuoteSide which, double limit) {
+		return levelsWithinImpl(PairAccess{side}, which, limit);
+	}
+	std::size_t levelsWithin(const ReversedLevels& side, gateway::QuoteSide which, double limit) {
+		return levelsWithinImpl(ReversedAccess{side}, which, limit);
+	}
+
+	double topDepth(const PairLevels& side, std::size_t n) { return topDepthImpl(PairAccess{side}, n); }
+	double topDepth(const ReversedLevels& side, std::size_t n) { return topDepthImpl(ReversedAccess{side}, n); }
+
+	std::size_t crossingLevel(const PairLevels& side, double quantity) {
+		return crossingLevelImpl(PairAccess{side}, quantity);
+	}
+	std::size_t crossingLevel(const ReversedLevels& side, double quantity) {
+		return crossingLevelImpl(ReversedAccess{side}, quantity);
+	}
+
+	SweepCost sweep(const PairLevels& side, double quantity) { return sweepImpl(PairAccess{side}, quantity); }
+	SweepCost sweep(const ReversedLevels& side, double quantity) { return sweepImpl(ReversedAccess{side}, quantity); }
+
+	bool simdEnabled() { return useAvx2(); }
+	void forceScalar(bool on) { scalarOnly.store(on, std::memory_order_relaxed); }
+
+}
@@ -0,0 +1,38 @@
+#include "FlatOrderBook.hpp"
+
+#include <algorithm>
+
+void FlatOrderBook::rebuild(const std::vector<gateway::Quote>& levels) {
+	bids_.clear();
+	asks_.clear();
+	for (const auto& q : levels) update(q);
+}
+
+OrderBookSnapshot FlatOrderBook::snapshot(std::size_t maxLevels) const {
+	OrderBookSnapshot s;
+	s.symbolId = symbolId_;
+	s.mono_ts = std::chrono::steady_clock::now();
+
+	if (!bids_.empty()) s.bestBid = bids_.price(0);
+	if (!asks_.empty()) s.bestAsk = asks_.price(0);
+
+	const std::size_t nb = maxLevels ? std::min(maxLevels, bids_.depth()) : bids_.depth();
+	const std::size_t na = maxLevels ? std::min(maxLevels, asks_.depth()) : asks_.depth();
+	s.bidLevels.resize(nb);
+	s.askLevels.resize(na);
+	bids_.copyTop(s.bidLevels.data(), nb);
+	asks_.copyTop(s.askLevels.data(), na);
+	return s;
+}
+
+double FlatOrderBook::cumulativeDepth(gateway::QuoteSide side, double limit) const {
+	return depth::cumulativeDepth((side == gateway::QuoteSide::Bid ? bids_ : asks_).levels(), side, limit);
+}
+
+std::size_t FlatOrderBook::crossingLevel(gateway::QuoteSide side, double quantity) const {
+	return depth::crossingLevel((side == gateway::QuoteSide::Bid ? bids_ : asks_).levels(), quantity);
+}
+
+SweepCost FlatOrderBook::sweepCost(gateway::QuoteSide side, double quantity) const {
+	return depth::sweep((side == gateway::QuoteSide::Bid ? bids_ : asks_).levels(), quantity);
+}
@@ -0,0 +1,193 @@
+#include "L3OrderBook.hpp"
+
+#include <bit>
+
+OrderIndex::OrderIndex(std::size_t capacity) {
+	rehash(std::bit_ceil(capacity < 8 ? std::size_t{16} : capacity * 2));
+}
+
+OrderNode* OrderIndex::find(std::uint64_t id) const noexcept {
+	for (std::size_t i = home(id);; i = (i + 1) & mask_) {
+		const Slot& s = slots_[i];
+		if (!s.node) return nullptr;
+		if (s.id == id) return s.node;
+	}
+}
+
+bool OrderIndex::insert(std::uint64_t id, OrderNode* node) {
+	if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.size() * 2);
+	std::size_t i = home(id);
+	for (; slots_[i].node; i = (i + 1) & mask_)
+		if (slots_[i].id == id) return false;
+	slots_[i] = Slot{id, node};
+	++size_;
+	return true;
+}
+
+bool OrderIndex::erase(std::uint64_t id) noexcept {
+	std::size_t i = home(id);
+	for (;; i = (i + 1) & mask_) {
+		if (!slots_[i].node) return false;
+		if (slots_[i].id == id) break;
+	}
+	slots_[i].node = nullptr;
+	--size_;
+
+	// Pull later entries of the probe run back so lookups never stop early at the hole.
+	for (std::size_t j = (i + 1) & mask_; slots_[j].node; j = (j + 1) & mask_) {
+		const std::size_t k = home(slots_[j].id);
+		const bool movable = (j > i) ? (k <= i || k > j) : (k <= i && k > j);
+		if (movable) {
+			slots_[i] = slots_[j];
+			slots_[j].node = nullptr;
+			i = j;
+		}
+	}
+	return true;
+}
+
+void OrderIndex::clear() noexcept {
+	for (auto& s : slots_) s.node = nullptr;
+	size_ = 0;
+}
+
+void OrderIndex::rehash(std::size_t capacity) {
+	std::vector<Slot> old;
+	old.swap(slots_);
+	slots_.assign(capacity, Slot{});
+	mask_ = capacity - 1;
+	shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+	size_ = 0;
+	for (const auto& s : old)
+		if (s.node) insert(s.id, s.node);
+}
+
+L3OrderBook::L3OrderBook(std::string_view symbol, std::size_t expectedOrders)
+	: L3OrderBook(gateway::internSymbol(symbol), expectedOrders) {}
+
+L3OrderBook::L3OrderBook(gateway::SymbolId symbolId, std::size_t expectedOrders)
+	: symbolId_(symbolId), index_(expectedOrders) {
+	pool_.reserve(expectedOrders);
+}
+
+bool L3OrderBook::add(std::uint64_t id, gateway::QuoteSide side, double price, double qty) {
+	if (qty <= 0.0 || index_.find(id)) return false;
+	OrderNode* node = pool_.create(OrderNode{id, price, qty, side});
+	index_.insert(id, node);
+	link(levelFor(side, price), node);
+	return true;
+}
+
+bool L3OrderBook::modify(std::uint64_t id, double qty) {
+	OrderNode* node = index_.find(id);
+	if (!node) return false;
+	if (qty <= 0.0) return cancel(id);
+
+	OrderLevel& level = *node->level;
+	if (qty > node->qty && node != level.tail) {
+		unlink(node);
+		node->qty = qty;
+		link(level, node);
+		return true;
+	}
+	level.size += qty - node->qty;
+	node->qty = qty;
+	return true;
+}
+
+bool L3OrderBook::replace(std::uint64_t id, double price, double qty) {
+	OrderNode* node = index_.find(id);
+	if (!node) return false;
+	if (price == node->price) return modify(id, qty);
+	if (qty <= 0.0) return cancel(id);
+
+	const auto side = node->side;
+	const double oldPrice = node->price;
+	unlink(node);
+	if (node->level->orders == 0) eraseLevel(side, oldPrice);
+	node->price = price;
+	node->qty = qty;
+	link(levelFor(side, price), node);
+	return true;
+}
+
+bool L3OrderBook::cancel(std::uint64_t id) {
+	OrderNode* node = index_.find(id);
+	if (!node) return false;
+	unlink(node);
+	if (node->level->orders == 0) eraseLevel(node->side, node->price);
+	index_.erase(id);
+	pool_.destroy(node);
+	return true;
+}
+
+bool L3OrderBook::apply(char updateAction, std::uint64_t id, gateway::QuoteSide side, double price, double qty) {
+	switch (updateAction) {
+		case '0': return add(id, side, price, qty);
+		case '1': return replace(id, price, qty);
+		case '2': return cancel(id);
+		default:  return false;
+	}
+}
+
+void L3OrderBook::clear() {
+	auto release = [this](auto& levels) {
+		for (auto& [price, level] : levels) {
+			for (OrderNode* n = level.head; n;) {
+				OrderNode* next = n->next;
+				pool_.destroy(n);
+				n = next;
+			}
+		}
+		levels.clear();
+	};
+	release(bids_);
+	release(asks_);
+	index_.clear();
+}
+
+const OrderNode* L3OrderBook::front(gateway::QuoteSide side) const {
+	if (side == gateway::QuoteSide::Bid) return bids_.empty() ? nullptr : bids_.begin()->second.head;
+	return asks_.empty() ? nullptr : asks_.begin()->second.head;
+}
+
+double L3OrderBook::bestBid() const {
+	return bids_.empty() ? 0.0 : bids_.begin()->first;
+}
+
+double L3OrderBook::bestAsk() const {
+	return asks_.empty() ? 0.0 : asks_.begin()->first;
+}
+
+OrderLevel& L3OrderBook::levelFor(gateway::QuoteSide side, double price) {
+	auto& level = side == gateway::QuoteSide::Bid ? bids_[price] : asks_[price];
+	level.price = price;
+	return level;
+}
+
+void L3OrderBook::link(OrderLevel& level, OrderNode* node) {
+	node->level = &level;
+	node->next = nullptr;
+	node->prev = level.tail;
+	if (level.tail) level.tail->next = node;
+	else level.head = node;
+	level.tail = node;
+	level.size += node->qty;
+	++level.orders;
+}
+
+void L3OrderBook::unlink(OrderNode* node) {
+	OrderLevel& level = *node->level;
+	if (node->prev) node->prev->next = node->next;
+	else level.head = node->next;
+	if (node->next) node->next->prev = node->prev;
+	else level.tail = node->prev;
+	node->prev = node->next = nullptr;
+	level.size -= node->qty;
+	--level.orders;
+}
+
+void L3OrderBook::eraseLevel(gateway::QuoteSide side, double price) {
+	if (side == gateway::QuoteSide::Bid) bids_.erase(price);
+	else asks_.erase(price);
+}
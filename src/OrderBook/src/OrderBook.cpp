@@ -1,30 +1,286 @@
 #include "OrderBook.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace std;
 
 
-void OrderBook::update(const gateway::Quote& quote) {
+template<class Alloc>
+void BasicOrderBook<Alloc>::update(const gateway::Quote& quote) {
 	const double price = quote.getPrice();
 	const double size  = quote.getSize();
 
-	if (quote.getSide() == gateway::QuoteSide::Bid) {
-		if (size == 0.0)
-			bids_.erase(price);
-		else
-			bids_[price] = PriceLevel{price, size};
+	if (tracking_) markDirty(price, size, quote.getSide());
+
+	if (quote.getSide() == gateway::QuoteSide::Bid)
+		applyLevel(bids_, bidStats_, price, size);
+	else
+		applyLevel(asks_, askStats_, price, size);
+}
+
+// Updates one level and keeps the top-N sums current by tracking the N-th level (the edge): a change
+// behind the edge is free, an insert or delete in front of it shifts the edge by one level.
+template<class Alloc>
+template<class Side>
+void BasicOrderBook<Alloc>::applyLevel(Side& side, SideStats& stats, double price, double size) {
+	auto it = side.lower_bound(price);
+	const bool exists = it != side.end() && it->first == price;
+	const auto better = side.key_comp();
+	const bool tracked = analyticsDepth_ > 0;
+	const bool inTop = tracked && (!stats.hasEdge || !better(stats.edge, price));
+
+	if (size == 0.0) {
+		if (!exists) return;
+		if (inTop) {
+			stats.depthSize -= it->second.size;
+			stats.depthNotional -= price * it->second.size;
+			if (stats.hasEdge) {
+				const auto next = std::next(it->first == stats.edge ? it : side.find(stats.edge));
+				if (next == side.end()) {
+					stats.hasEdge = false;
+				} else {
+					stats.edge = next->first;
+					stats.depthSize += next->second.size;
+					stats.depthNotional += next->first * next->second.size;
+				}
+			}
+		}
+		side.erase(it);
+		if (side.empty()) stats.depthSize = stats.depthNotional = 0.0;
+	} else if (exists) {
+		if (inTop) {
+			stats.depthSize += size - it->second.size;
+			stats.depthNotional += price * (size - it->second.size);
+		}
+		it->second.size = size;
+	} else {
+		it = side.emplace_hint(it, price, PriceLevel{price, size});
+		if (inTop) {
+			stats.depthSize += size;
+			stats.depthNotional += price * size;
+			if (stats.hasEdge) {
+				const auto old = side.find(stats.edge);
+				stats.depthSize -= old->second.size;
+				stats.depthNotional -= old->first * old->second.size;
+				stats.edge = std::prev(old)->first;
+			} else if (side.size() == analyticsDepth_) {
+				stats.edge = std::prev(side.end())->first;
+				stats.hasEdge = true;
+			}
+		}
+	}
+
+	if (sweepQuantity_ > 0.0 && (!stats.sweep.complete || !better(stats.sweepLimit, price)))
+		recomputeSweep(side, stats);
+}
+
+template<class Alloc>
+template<class Side>
+void BasicOrderBook<Alloc>::recomputeDepth(Side& side, SideStats& stats) {
+	stats.depthSize = stats.depthNotional = 0.0;
+	stats.hasEdge = false;
+	if (analyticsDepth_ == 0) return;
+	std::size_t n = 0;
+	for (auto it = side.begin(); it != side.end(); ++it) {
+		stats.depthSize += it->second.size;
+		stats.depthNotional += it->first * it->second.size;
+		if (++n == analyticsDepth_) {
+			stats.edge = it->first;
+			stats.hasEdge = true;
+			break;
+		}
+	}
+}
+
+template<class Alloc>
+template<class Side>
+void BasicOrderBook<Alloc>::recomputeSweep(const Side& side, SideStats& stats) {
+	stats.sweep = SweepCost{};
+	stats.sweepLimit = 0.0;
+	if (sweepQuantity_ <= 0.0) return;
+	double remaining = sweepQuantity_;
+	for (const auto& [price, lvl] : side) {
+		const double take = std::min(remaining, lvl.size);
+		stats.sweep.quantity += take;
+		stats.sweep.notional += take * price;
+		stats.sweepLimit = price;
+		remaining -= take;
+		if (remaining <= 0.0) {
+			stats.sweep.complete = true;
+			break;
+		}
+	}
+}
+
+template<class Alloc>
+void BasicOrderBook<Alloc>::recomputeAnalytics() {
+	recomputeDepth(bids_, bidStats_);
+	recomputeDepth(asks_, askStats_);
+	recomputeSweep(bids_, bidStats_);
+	recomputeSweep(asks_, askStats_);
+}
+
+template<class Alloc>
+void BasicOrderBook<Alloc>::setAnalyticsDepth(std::size_t levels) {
+	analyticsDepth_ = levels;
+	recomputeAnalytics();
+}
+
+template<class Alloc>
+void BasicOrderBook<Alloc>::setSweepQuantity(double quantity) {
+	sweepQuantity_ = quantity > 0.0 ? quantity : 0.0;
+	recomputeAnalytics();
+}
+
+template<class Alloc>
+double BasicOrderBook<Alloc>::microprice() const {
+	if (bids_.empty() || asks_.empty()) return std::numeric_limits<double>::quiet_NaN();
+	const auto& [bidPx, bid] = *bids_.begin();
+	const auto& [askPx, ask] = *asks_.begin();
+	const double denom = bid.size + ask.size;
+	return denom > 0.0 ? (bidPx * ask.size + askPx * bid.size) / denom : 0.5 * (bidPx + askPx);
+}
+
+template<class Alloc>
+double BasicOrderBook<Alloc>::cumulativeDepth(gateway::QuoteSide side, double limit) const {
+	double total = 0.0;
+	if (side == gateway::QuoteSide::Bid) {
+		for (auto it = bids_.begin(); it != bids_.end() && it->first >= limit; ++it) total += it->second.size;
 	} else {
-		if (size == 0.0)
-			asks_.erase(price);
+		for (auto it = asks_.begin(); it != asks_.end() && it->first <= limit; ++it) total += it->second.size;
+	}
+	return total;
+}
+
+template<class Alloc>
+std::size_t BasicOrderBook<Alloc>::crossingLevel(gateway::QuoteSide side, double quantity) const {
+	auto walk = [quantity](const auto& levels) {
+		double total = 0.0;
+		std::size_t i = 0;
+		for (const auto& [price, lvl] : levels) {
+			total += lvl.size;
+			if (total >= quantity) return i;
+			++i;
+		}
+		return levels.size();
+	};
+	return side == gateway::QuoteSide::Bid ? walk(bids_) : walk(asks_);
+}
+
+template<class Alloc>
+SweepCost BasicOrderBook<Alloc>::sweepCost(gateway::QuoteSide side, double quantity) const {
+	auto walk = [quantity](const auto& levels) {
+		SweepCost c;
+		if (quantity <= 0.0) return c;
+		for (const auto& [price, lvl] : levels) {
+			const double take = std::min(quantity - c.quantity, lvl.size);
+			c.quantity += take;
+			c.notional += take * price;
+			if (c.quantity >= quantity) {
+				c.complete = true;
+				break;
+			}
+		}
+		return c;
+	};
+	return side == gateway::QuoteSide::Bid ? walk(bids_) : walk(asks_);
+}
+
+template<class Alloc>
+double BasicOrderBook<Alloc>::imbalance() const {
+	const double total = bidStats_.depthSize + askStats_.depthSize;
+	return total > 0.0 ? (bidStats_.depthSize - askStats_.depthSize) / total : 0.0;
+}
+
+template<class Alloc>
+void BasicOrderBook<Alloc>::rebuild(const std::vector<gateway::Quote>& levels) {
+	Bids bids(bids_.get_allocator());
+	Asks asks(asks_.get_allocator());
+
+	for (const auto& q : levels) {
+		if (q.getSize() == 0.0) continue;
+		if (q.getSide() == gateway::QuoteSide::Bid)
+			bids[q.getPrice()] = PriceLevel{q.getPrice(), q.getSize()};
 		else
-			asks_[price] = PriceLevel{price, size};
+			asks[q.getPrice()] = PriceLevel{q.getPrice(), q.getSize()};
+	}
+
+	bids_.swap(bids);
+	asks_.swap(asks);
+	recomputeAnalytics();
+
+	if (tracking_) {
+		reset_ = true;
+		dirty_.clear();
 	}
 }
-double OrderBook::bestBid() const {
+
+template<class Alloc>
+void BasicOrderBook<Alloc>::trackChanges(bool on) {
+	tracking_ = on;
+	reset_ = on;
+	dirty_.clear();
+}
+
+// A batch touches a handful of levels, so a backwards scan of dirty_ beats hashing the price; the most
+// recently changed levels, the likeliest to change again, are found first.
+template<class Alloc>
+void BasicOrderBook<Alloc>::markDirty(double price, double size, gateway::QuoteSide side) {
+	if (reset_) return; // the next delta carries the whole book anyway
+	for (auto it = dirty_.rbegin(); it != dirty_.rend(); ++it) {
+		if (it->price == price && it->side == side) {
+			it->size = size;
+			return;
+		}
+	}
+	dirty_.push_back(LevelChange{price, size, side});
+}
+
+static inline bool samePrice(double a, double b) {
+	return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+template<class Alloc>
+bool BasicOrderBook<Alloc>::takeDelta(BookDelta& out) {
+	out.symbolId = symbolId_;
+	out.reset = reset_;
+	out.changes.clear();
+	out.mono_ts = std::chrono::steady_clock::now();
+
+	if (reset_) {
+		out.changes.reserve(bids_.size() + asks_.size());
+		for (const auto& [price, lvl] : bids_) out.changes.push_back(LevelChange{price, lvl.size, gateway::QuoteSide::Bid});
+		for (const auto& [price, lvl] : asks_) out.changes.push_back(LevelChange{price, lvl.size, gateway::QuoteSide::Ask});
+	} else {
+		out.changes.swap(dirty_);
+	}
+
+	out.bestBid = bids_.empty() ? std::numeric_limits<double>::quiet_NaN() : bids_.begin()->first;
+	out.bestAsk = asks_.empty() ? std::numeric_limits<double>::quiet_NaN() : asks_.begin()->first;
+
+	bool touchedTop = out.reset;
+	for (const auto& c : out.changes) {
+		const double best = c.side == gateway::QuoteSide::Bid ? out.bestBid : out.bestAsk;
+		if (c.price == best) { touchedTop = true; break; }
+	}
+	out.topOfBookChanged = touchedTop ||
+		!samePrice(out.bestBid, publishedBestBid_) || !samePrice(out.bestAsk, publishedBestAsk_);
+
+	publishedBestBid_ = out.bestBid;
+	publishedBestAsk_ = out.bestAsk;
+	reset_ = false;
+	dirty_.clear();
+	return !out.empty();
+}
+
+template<class Alloc>
+double BasicOrderBook<Alloc>::bestBid() const {
 	return bids_.empty() ? 0.0 : bids_.begin()->first;
 }
 
-double OrderBook::bestAsk() const {
+template<class Alloc>
+double BasicOrderBook<Alloc>::bestAsk() const {
 	return asks_.empty() ? 0.0 : asks_.begin()->first;
 }
 
@@ -33,10 +289,11 @@ static inline double nanq() {
 }
 
 
-OrderBookSnapshot OrderBook::snapshot(std::size_t maxLevels) const {
+template<class Alloc>
+OrderBookSnapshot BasicOrderBook<Alloc>::snapshot(std::size_t maxLevels) const {
 
 	OrderBookSnapshot s;
-	s.symbol = symbol_;
+	s.symbolId = symbolId_;
 	s.mono_ts = std::chrono::steady_clock::now();
 
 	if (!bids_.empty()) s.bestBid = bids_.begin()->second.price; else s.bestBid = nanq();
@@ -63,3 +320,6 @@ OrderBookSnapshot OrderBook::snapshot(std::size_t maxLevels) const {
 
 	return s;
 }
+
+template class BasicOrderBook<std::allocator<PriceLevel>>;
+template class BasicOrderBook<PoolAllocator<PriceLevel>>;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "Quote.hpp"
+
+namespace oms {
+
+	// FIX 4.4 ExecType (150). The pre-4.3 PartialFill/Fill values are accepted and treated as Trade.
+	enum class ExecType : char {
+		New = '0', PartialFill = '1', Fill = '2', DoneForDay = '3', Canceled = '4', Replaced = '5',
+		PendingCancel = '6', Rejected = '8', PendingNew = 'A', Expired = 'C', Restated = 'D',
+		PendingReplace = 'E', Trade = 'F'
+	};
+
+	// FIX 4.4 OrdStatus (39).
+	enum class OrdStatus : char {
+		New = '0', PartiallyFilled = '1', Filled = '2', DoneForDay = '3', Canceled = '4', PendingCancel = '6',
+		Rejected = '8', PendingNew = 'A', Expired = 'C', PendingReplace = 'E'
+	};
+
+	// The fields of an ExecutionReport (35=8) or OrderCancelReject (35=9) the order manager uses.
+	// ClOrdIDs are numeric, as OrderSender emits them.
+	struct ExecReport {
+		char msgType{'8'};
+		ExecType execType{ExecType::New};
+		OrdStatus ordStatus{OrdStatus::New};
+		char cxlRejResponseTo{0};   // 434 on a 35=9: '1' cancel, '2' cancel/replace
+		std::uint64_t clOrdId{0};
+		std::uint64_t origClOrdId{0};
+		std::uint64_t orderId{0};   // 37 when numeric, else 0
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		double orderQty{0.0};
+		double price{0.0};
+		double lastQty{0.0};
+		double lastPx{0.0};
+		double leavesQty{0.0};
+		double cumQty{0.0};
+		double avgPx{0.0};
+	};
+
+	// Decodes one complete 35=8 or 35=9 message in a single pass over its fields, without allocating.
+	// Returns nullopt for other message types, a missing or non-numeric ClOrdID, or an unknown symbol.
+	std::optional<ExecReport> parseExecReport(std::string_view message);
+
+}
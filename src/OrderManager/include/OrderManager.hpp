@@ -0,0 +1,252 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ExecutionReport.hpp"
+#include "OrderIntent.hpp"
+#include "SymbolTable.hpp"
+
+namespace oms {
+
+	// What is in flight for an order besides its last acknowledged state.
+	enum class Pending : std::uint8_t { None, New, Cancel, Replace };
+
+	// One working order. Slots are reused, so pointers are only valid until the next apply().
+	struct Order {
+		std::uint64_t clOrdId{0};          // current ClOrdID; a confirmed replace moves the order to the new one
+		std::uint64_t pendingClOrdId{0};   // latest unacknowledged cancel or replace; also resolves to this order
+		std::uint64_t orderId{0};          // venue OrderID (37)
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		OrdStatus status{OrdStatus::PendingNew};
+		Pending pending{Pending::New};
+		double price{0.0};
+		double qty{0.0};
+		double cumQty{0.0};
+		double leavesQty{0.0};
+		double avgPx{0.0};
+
+		std::uint32_t prev;    // neighbours in the level's queue, oldest first
+		std::uint32_t next;
+		std::uint32_t level;
+	};
+
+	// Working orders of one instrument, side and price, linked in the order they were sent.
+	struct OpenLevel {
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		double price{0.0};
+		double leavesQty{0.0};
+		std::uint32_t orders{0};
+
+		std::uint32_t head;
+		std::uint32_t tail;
+		std::uint32_t prev;    // neighbours among the levels of symbol and side, unsorted
+		std::uint32_t next;
+	};
+
+	struct Position {
+		double qty{0.0};
+		double cash{0.0};      // sells minus buys, in quote currency
+		double volume{0.0};
+		std::uint64_t fills{0};
+		[[nodiscard]] double pnl(double mark) const noexcept { return cash + qty * mark; }
+	};
+
+	// Outcome of one report, copied out because the order's slot is recycled once it closes.
+	struct Applied {
+		bool known{false};     // matched a tracked order
+		bool closed{false};    // the order is done: filled, cancelled, expired or rejected
+		Order order{};
+		double lastQty{0.0};
+		double lastPx{0.0};
+	};
+
+	// Order state for the trading core. Orders live in a slab fixed at construction; ClOrdIDs resolve
+	// through an open-addressing table of slab indices, and working orders are threaded onto intrusive
+	// per-price-level lists so the strategy can walk its exposure by level. Nothing allocates after the
+	// constructor. Single-threaded: intents and reports must be fed from the same thread.
+	class OrderManager {
+	public:
+		static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+		explicit OrderManager(std::size_t capacity = 4096);
+
+		OrderManager(const OrderManager&) = delete;
+		OrderManager& operator=(const OrderManager&) = delete;
+
+		// Records an intent that is about to go out. Returns false, and the intent must not be sent,
+		// when the slab is full, a new ClOrdID is already in use, or the order a cancel or replace
+		// refers to is unknown or closed. A cancel or replace may name the order by its current ClOrdID
+		// or by that of a request still in flight, so requests can be chained without waiting for acks.
+		bool onIntent(const OrderIntent& intent);
+
+		// Undoes onIntent() for an intent that was recorded but then not sent: a new order gives its
+		// slot back, a cancel or replace stops being pending. A request it had superseded is not restored.
+		void withdraw(const OrderIntent& intent) noexcept;
+
+		// Applies an ExecutionReport or OrderCancelReject.
+		Applied apply(const ExecReport& report);
+
+		// As apply(), then tells strategy: onFill(symbol, side, qty) for a trade and, if it has one,
+		// onOrderDone(symbol, clOrdId) once the order is closed.
+		template<class Strategy>
+		Applied apply(const ExecReport& report, Strategy& strategy) {
+			const Applied a = apply(report);
+			if (a.lastQty > 0.0) strategy.onFill(a.order.symbol, a.order.side, a.lastQty);
+			if constexpr (requires { strategy.onOrderDone(a.order.symbol, a.order.clOrdId); }) {
+				if (a.closed) strategy.onOrderDone(a.order.symbol, a.order.clOrdId);
+			}
+			return a;
+		}
+
+		[[nodiscard]] const Order* find(std::uint64_t clOrdId) const noexcept;
+		[[nodiscard]] const OpenLevel* level(gateway::SymbolId symbol, gateway::QuoteSide side, double price) const noexcept;
+
+		// fn(const OpenLevel&) for each level with working orders on symbol and side, in no particular order.
+		template<class Fn>
+		void forEachLevel(gateway::SymbolId symbol, gateway::QuoteSide side, Fn&& fn) const {
+			for (auto i = levelHeads_[headSlot(symbol, side)]; i != kNone; i = levels_[i].next) fn(levels_[i]);
+		}
+
+		// fn(const Order&) for each order of level, oldest first.
+		template<class Fn>
+		void forEachOrder(const OpenLevel& level, Fn&& fn) const {
+			for (auto i = level.head; i != kNone; i = orders_[i].next) fn(orders_[i]);
+		}
+
+		[[nodiscard]] const Position& position(gateway::SymbolId symbol) const noexcept { return positions_[symbol]; }
+		// Unfilled quantity of the working orders on symbol and side.
+		[[nodiscard]] double openQty(gateway::SymbolId symbol, gateway::QuoteSide side) const noexcept {
+			return openQty_[headSlot(symbol, side)];
+		}
+
+		[[nodiscard]] std::size_t openOrders() const noexcept { return live_; }
+		[[nodiscard]] std::size_t capacity() const noexcept { return orders_.size(); }
+		// Reports that matched no tracked order, e.g. for orders sent before a restart.
+		[[nodiscard]] std::uint64_t unknownReports() const noexcept { return unknown_; }
+		[[nodiscard]] std::uint64_t refusedIntents() const noexcept { return refused_; }
+
+	private:
+		// Open addressing over slab indices with linear probing and backward-shift deletion. A slot keeps
+		// the 64-bit hash next to the index, so probing rarely touches the slab and entries can be
+		// shifted without rehashing; match() settles the rest. Sized at construction to at most half full.
+		class SlabIndex {
+		public:
+			explicit SlabIndex(std::size_t capacity)
+				: slots_(std::bit_ceil(capacity < 8 ? std::size_t{16} : capacity * 2))
+				, mask_(slots_.size() - 1) {}
+
+			template<class Match>
+			[[nodiscard]] std::uint32_t find(std::uint64_t hash, Match&& match) const noexcept {
+				for (auto i = static_cast<std::size_t>(hash) & mask_;; i = (i + 1) & mask_) {
+					const auto& s = slots_[i];
+					if (s.value == kNone || (s.hash == hash && match(s.value))) return s.value;
+				}
+			}
+
+			void insert(std::uint64_t hash, std::uint32_t value) noexcept {
+				auto i = static_cast<std::size_t>(hash) & mask_;
+				while (slots_[i].value != kNone) i = (i + 1) & mask_;
+				slots_[i] = Slot{hash, value};
+			}
+
+			void erase(std::uint64_t hash, std::uint32_t value) noexcept {
+				auto i = static_cast<std::size_t>(hash) & mask_;
+				while (slots_[i].value != value || slots_[i].hash != hash) {
+					if (slots_[i].value == kNone) return;
+					i = (i + 1) & mask_;
+				}
+				for (auto j = (i + 1) & mask_; slots_[j].value != kNone; j = (j + 1) & mask_) {
+					const auto home = static_cast<std::size_t>(slots_[j].hash) & mask_;
+					// The entry at j may fill the hole at i only if i lies on its probe path home..j.
+					if (((j - home) & mask_) >= ((j - i) & mask_)) {
+						slots_[i] = slots_[j];
+						i = j;
+					}
+				}
+				slots_[i] = Slot{};
+			}
+
+		private:
+			struct Slot {
+				std::uint64_t hash{0};
+				std::uint32_t value{kNone};
+			};
+
+			std::vector<Slot> slots_;
+			std::size_t mask_;
+		};
+
+		// Bijective, so distinct ClOrdIDs never share a hash.
+		static std::uint64_t mix(std::uint64_t x) noexcept {
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ull;
+			return x ^ (x >> 33);
+		}
+		static std::uint64_t levelHash(gateway::SymbolId symbol, gateway::QuoteSide side, double price) noexcept {
+			return mix(std::bit_cast<std::uint64_t>(price) ^ (std::uint64_t{symbol} << 1 | static_cast<std::uint64_t>(side)) * 0x9E3779B97F4A7C15ull);
+		}
+		static std::size_t headSlot(gateway::SymbolId symbol, gateway::QuoteSide side) noexcept {
+			return std::size_t{symbol} * 2 + static_cast<std::size_t>(side);
+		}
+
+		std::uint32_t lookup(std::uint64_t clOrdId) const noexcept;
+		void setPending(Order& o, std::uint32_t i, Pending what, std::uint64_t clOrdId) noexcept;
+		void clearPending(Order& o, std::uint32_t i) noexcept;
+		void link(std::uint32_t i);
+		void unlink(std::uint32_t i) noexcept;
+		void setLeaves(Order& o, double leaves) noexcept;
+		void close(std::uint32_t i) noexcept;
+
+		std::vector<Order> orders_;
+		std::vector<OpenLevel> levels_;
+		std::uint32_t freeOrder_{kNone};   // free lists threaded through next
+		std::uint32_t freeLevel_{kNone};
+		SlabIndex byClOrdId_;
+		SlabIndex byLevel_;
+		std::vector<std::uint32_t> levelHeads_;
+		std::vector<double> openQty_;
+		std::vector<Position> positions_;
+		std::size_t live_{0};
+		std::uint64_t unknown_{0};
+		std::uint64_t refused_{0};
+	};
+
+	// Strategy sink that books every intent in the OrderManager before passing it on. Returns false when
+	// the OrderManager refuses the intent or the downstream sink does not take it; in the latter case the
+	// booking is withdrawn again. Forwards onBook() and now() so it can sit anywhere in a sink chain.
+	template<class Sink>
+	class OmsGate {
+	public:
+		OmsGate(OrderManager& oms, Sink sink) : oms_(oms), sink_(std::move(sink)) {}
+
+		template<class Book>
+		void onBook(const Book& book) {
+			if constexpr (requires { sink_.onBook(book); }) sink_.onBook(book);
+		}
+
+		bool operator()(const OrderIntent& intent) {
+			if (!oms_.onIntent(intent)) return false;
+			if (deliverIntent(sink_, intent)) return true;
+			oms_.withdraw(intent);
+			return false;
+		}
+
+		IntentClock::time_point now() requires requires(Sink& s) { s.now(); } { return sink_.now(); }
+
+		OrderManager& oms() noexcept { return oms_; }
+		Sink& sink() noexcept { return sink_; }
+
+	private:
+		OrderManager& oms_;
+		Sink sink_;
+	};
+
+}
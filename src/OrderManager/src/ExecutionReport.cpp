@@ -0,0 +1,77 @@
+#include "ExecutionReport.hpp"
+
+#include <charconv>
+
+#include "FixOrderTemplate.hpp"
+
+namespace oms {
+
+	namespace {
+
+		template<class T>
+		bool parse(std::string_view s, T& out) {
+			const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+			return ec == std::errc{} && ptr == s.data() + s.size();
+		}
+
+		// Tags are compared as integers: no substring compares on the common path.
+		unsigned tagNumber(std::string_view tag) {
+			unsigned n = 0;
+			for (const char c : tag) {
+				if (c < '0' || c > '9') return 0;
+				n = n * 10 + static_cast<unsigned>(c - '0');
+			}
+			return n;
+		}
+
+	}
+
+	std::optional<ExecReport> parseExecReport(std::string_view message) {
+		ExecReport r;
+		std::string_view symbol;
+		bool haveClOrdId = false;
+		char side = 0;
+
+		std::size_t pos = 0;
+		while (pos < message.size()) {
+			const auto eq = message.find('=', pos);
+			if (eq == std::string_view::npos) break;
+			const auto soh = message.find(fix::SOH, eq);
+			if (soh == std::string_view::npos) break;
+			const auto value = message.substr(eq + 1, soh - eq - 1);
+			const char first = value.empty() ? 0 : value.front();
+
+			switch (tagNumber(message.substr(pos, eq - pos))) {
+				case 35: r.msgType = value.size() == 1 ? first : '?'; break;
+				case 150: r.execType = static_cast<ExecType>(first); break;
+				case 39: r.ordStatus = static_cast<OrdStatus>(first); break;
+				case 434: r.cxlRejResponseTo = first; break;
+				case 11: haveClOrdId = parse(value, r.clOrdId); break;
+				case 41: parse(value, r.origClOrdId); break;
+				case 37: parse(value, r.orderId); break;
+				case 55: symbol = value; break;
+				case 54: side = first; break;
+				case 38: parse(value, r.orderQty); break;
+				case 44: parse(value, r.price); break;
+				case 32: parse(value, r.lastQty); break;
+				case 31: parse(value, r.lastPx); break;
+				case 151: parse(value, r.leavesQty); break;
+				case 14: parse(value, r.cumQty); break;
+				case 6: parse(value, r.avgPx); break;
+				default: break;
+			}
+			pos = soh + 1;
+		}
+
+		if ((r.msgType != '8' && r.msgType != '9') || !haveClOrdId) return std::nullopt;
+		r.side = side == '2' ? gateway::QuoteSide::Ask : gateway::QuoteSide::Bid;
+		// OrderCancelReject carries no symbol; the order manager resolves it from ClOrdID.
+		if (r.msgType == '8') {
+			const auto id = gateway::SymbolTable::instance().find(symbol);
+			if (!id) return std::nullopt;
+			r.symbol = *id;
+		}
+		return r;
+	}
+
+}
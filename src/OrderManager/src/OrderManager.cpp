@@ -0,0 +1,259 @@
+#include "OrderManager.hpp"
+
+namespace oms {
+
+	namespace {
+
+		constexpr double kQtyEpsilon = 1e-12;
+
+		bool terminal(OrdStatus s) noexcept {
+			return s == OrdStatus::Filled || s == OrdStatus::Canceled || s == OrdStatus::Rejected ||
+				   s == OrdStatus::Expired || s == OrdStatus::DoneForDay;
+		}
+
+	}
+
+	OrderManager::OrderManager(std::size_t capacity)
+		: orders_(capacity ? capacity : 1)
+		, levels_(orders_.size())
+		, byClOrdId_(orders_.size() * 2)   // current ClOrdID plus at most one pending per order
+		, byLevel_(orders_.size())
+		, levelHeads_(std::size_t{gateway::SymbolTable::kMaxSymbols} * 2, kNone)
+		, openQty_(std::size_t{gateway::SymbolTable::kMaxSymbols} * 2, 0.0)
+		, positions_(gateway::SymbolTable::kMaxSymbols) {
+		for (std::size_t i = orders_.size(); i-- > 0;) {
+			orders_[i].next = freeOrder_;
+			freeOrder_ = static_cast<std::uint32_t>(i);
+		}
+		for (std::size_t i = levels_.size(); i-- > 0;) {
+			levels_[i].next = freeLevel_;
+			freeLevel_ = static_cast<std::uint32_t>(i);
+		}
+	}
+
+	bool OrderManager::onIntent(const OrderIntent& intent) {
+		if (lookup(intent.clientOrderId) != kNone) {
+			++refused_;
+			return false;
+		}
+
+		if (intent.type == IntentType::New) {
+			if (freeOrder_ == kNone || !(intent.qty > 0.0)) {
+				++refused_;
+				return false;
+			}
+			const auto i = freeOrder_;
+			freeOrder_ = orders_[i].next;
+			Order& o = orders_[i];
+			o = Order{};
+			o.clOrdId = intent.clientOrderId;
+			o.symbol = intent.symbol;
+			o.side = intent.side;
+			o.price = intent.price;
+			o.qty = intent.qty;
+			o.leavesQty = intent.qty;
+			byClOrdId_.insert(mix(o.clOrdId), i);
+			link(i);
+			++live_;
+			return true;
+		}
+
+		const auto i = lookup(intent.origClientOrderId);
+		if (i == kNone) {
+			++refused_;
+			return false;
+		}
+		setPending(orders_[i], i, intent.type == IntentType::Cancel ? Pending::Cancel : Pending::Replace, intent.clientOrderId);
+		return true;
+	}
+
+	void OrderManager::withdraw(const OrderIntent& intent) noexcept {
+		const auto i = lookup(intent.clientOrderId);
+		if (i == kNone) return;
+		Order& o = orders_[i];
+		if (intent.type == IntentType::New) {
+			if (o.clOrdId == intent.clientOrderId && o.status == OrdStatus::PendingNew) close(i);
+		} else if (o.pendingClOrdId == intent.clientOrderId) {
+			clearPending(o, i);
+		}
+	}
+
+	Applied OrderManager::apply(const ExecReport& r) {
+		Applied out;
+		auto i = lookup(r.clOrdId);
+		if (i == kNone && r.origClOrdId) i = lookup(r.origClOrdId);
+		if (i == kNone) {
+			++unknown_;
+			return out;
+		}
+		Order& o = orders_[i];
+		out.known = true;
+
+		// A rejected cancel or replace leaves the order as it was. Rejects of a request that has since
+		// been superseded by a newer one change nothing.
+		const bool requestRejected = r.msgType == '9' ||
+			(r.execType == ExecType::Rejected && o.status != OrdStatus::PendingNew);
+		if (requestRejected) {
+			if (o.pendingClOrdId == r.clOrdId) clearPending(o, i);
+			out.order = o;
+			return out;
+		}
+
+		if (r.orderId) o.orderId = r.orderId;
+		switch (r.execType) {
+			case ExecType::Replaced:
+				if (o.clOrdId != r.clOrdId) {
+					byClOrdId_.erase(mix(o.clOrdId), i);
+					if (o.pendingClOrdId == r.clOrdId) {
+						// Already indexed as the pending request; it simply becomes the current ClOrdID.
+						o.pendingClOrdId = 0;
+						o.pending = Pending::None;
+					} else {
+						byClOrdId_.insert(mix(r.clOrdId), i);
+					}
+					o.clOrdId = r.clOrdId;
+				}
+				if (r.price != o.price) {
+					unlink(i);
+					o.price = r.price;
+					link(i);
+				}
+				o.qty = r.orderQty;
+				break;
+			case ExecType::Trade:
+			case ExecType::PartialFill:
+			case ExecType::Fill: {
+				auto& p = positions_[o.symbol];
+				const double signedQty = o.side == gateway::QuoteSide::Bid ? r.lastQty : -r.lastQty;
+				p.qty += signedQty;
+				p.cash -= signedQty * r.lastPx;
+				p.volume += r.lastQty;
+				++p.fills;
+				out.lastQty = r.lastQty;
+				out.lastPx = r.lastPx;
+				break;
+			}
+			case ExecType::New:
+				if (o.pending == Pending::New) o.pending = Pending::None;
+				break;
+			default:
+				break;
+		}
+
+		o.status = r.ordStatus;
+		o.cumQty = r.cumQty;
+		o.avgPx = r.avgPx;
+		setLeaves(o, r.leavesQty);
+
+		out.order = o;
+		if (terminal(o.status) || (out.lastQty > 0.0 && o.leavesQty <= kQtyEpsilon)) {
+			out.closed = true;
+			close(i);
+		}
+		return out;
+	}
+
+	const Order* OrderManager::find(std::uint64_t clOrdId) const noexcept {
+		const auto i = lookup(clOrdId);
+		return i == kNone ? nullptr : &orders_[i];
+	}
+
+	const OpenLevel* OrderManager::level(gateway::SymbolId symbol, gateway::QuoteSide side, double price) const noexcept {
+		const auto li = byLevel_.find(levelHash(symbol, side, price), [&](std::uint32_t l) {
+			const auto& lv = levels_[l];
+			return lv.price == price && lv.symbol == symbol && lv.side == side;
+		});
+		return li == kNone ? nullptr : &levels_[li];
+	}
+
+	std::uint32_t OrderManager::lookup(std::uint64_t clOrdId) const noexcept {
+		if (clOrdId == 0) return kNone;
+		return byClOrdId_.find(mix(clOrdId), [&](std::uint32_t i) {
+			return orders_[i].clOrdId == clOrdId || orders_[i].pendingClOrdId == clOrdId;
+		});
+	}
+
+	void OrderManager::setPending(Order& o, std::uint32_t i, Pending what, std::uint64_t clOrdId) noexcept {
+		if (o.pendingClOrdId) byClOrdId_.erase(mix(o.pendingClOrdId), i);
+		o.pendingClOrdId = clOrdId;
+		o.pending = what;
+		byClOrdId_.insert(mix(clOrdId), i);
+	}
+
+	void OrderManager::clearPending(Order& o, std::uint32_t i) noexcept {
+		if (o.pendingClOrdId) byClOrdId_.erase(mix(o.pendingClOrdId), i);
+		o.pendingClOrdId = 0;
+		o.pending = Pending::None;
+	}
+
+	void OrderManager::link(std::uint32_t i) {
+		Order& o = orders_[i];
+		const auto hash = levelHash(o.symbol, o.side, o.price);
+		auto li = byLevel_.find(hash, [&](std::uint32_t l) {
+			const auto& lv = levels_[l];
+			return lv.price == o.price && lv.symbol == o.symbol && lv.side == o.side;
+		});
+		const auto slot = headSlot(o.symbol, o.side);
+		if (li == kNone) {
+			// Never runs dry: there are as many level slots as order slots.
+			li = freeLevel_;
+			freeLevel_ = levels_[li].next;
+			auto& lv = levels_[li];
+			lv = OpenLevel{o.symbol, o.side, o.price, 0.0, 0, kNone, kNone, kNone, levelHeads_[slot]};
+			if (lv.next != kNone) levels_[lv.next].prev = li;
+			levelHeads_[slot] = li;
+			byLevel_.insert(hash, li);
+		}
+		auto& lv = levels_[li];
+		o.level = li;
+		o.prev = lv.tail;
+		o.next = kNone;
+		if (lv.tail != kNone) orders_[lv.tail].next = i;
+		else lv.head = i;
+		lv.tail = i;
+		++lv.orders;
+		lv.leavesQty += o.leavesQty;
+		openQty_[slot] += o.leavesQty;
+	}
+
+	void OrderManager::unlink(std::uint32_t i) noexcept {
+		Order& o = orders_[i];
+		const auto li = o.level;
+		auto& lv = levels_[li];
+		if (o.prev != kNone) orders_[o.prev].next = o.next;
+		else lv.head = o.next;
+		if (o.next != kNone) orders_[o.next].prev = o.prev;
+		else lv.tail = o.prev;
+		lv.leavesQty -= o.leavesQty;
+		const auto slot = headSlot(o.symbol, o.side);
+		openQty_[slot] -= o.leavesQty;
+		o.level = kNone;
+		if (--lv.orders != 0) return;
+
+		if (lv.prev != kNone) levels_[lv.prev].next = lv.next;
+		else levelHeads_[slot] = lv.next;
+		if (lv.next != kNone) levels_[lv.next].prev = lv.prev;
+		byLevel_.erase(levelHash(lv.symbol, lv.side, lv.price), li);
+		lv.next = freeLevel_;
+		freeLevel_ = li;
+		if (levelHeads_[slot] == kNone) openQty_[slot] = 0.0;   // drop accumulated rounding
+	}
+
+	void OrderManager::setLeaves(Order& o, double leaves) noexcept {
+		const double delta = leaves - o.leavesQty;
+		levels_[o.level].leavesQty += delta;
+		openQty_[headSlot(o.symbol, o.side)] += delta;
+		o.leavesQty = leaves;
+	}
+
+	void OrderManager::close(std::uint32_t i) noexcept {
+		Order& o = orders_[i];
+		unlink(i);
+		byClOrdId_.erase(mix(o.clOrdId), i);
+		if (o.pendingClOrdId) byClOrdId_.erase(mix(o.pendingClOrdId), i);
+		o.next = freeOrder_;
+		freeOrder_ = i;
+		--live_;
+	}
+
+}
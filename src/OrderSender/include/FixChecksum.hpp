@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+namespace fix {
+
+	// Sum of the bytes in [p, p + n), the basis of the FIX CheckSum (10). SSE2 and NEON are part of
+	// the x86-64 and AArch64 baselines, so there is no runtime dispatch here.
+	inline std::uint32_t byteSum(const char* p, std::size_t n) noexcept {
+		std::uint32_t sum = 0;
+		std::size_t i = 0;
+#if defined(__SSE2__)
+		__m128i acc = _mm_setzero_si128();
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= n; i += 16)
+			acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), zero));
+		sum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc)));
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+		for (; i + 16 <= n; i += 16)
+			sum += vaddlvq_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(p + i)));
+#endif
+		for (; i < n; ++i) sum += static_cast<unsigned char>(p[i]);
+		return sum;
+	}
+
+	inline std::uint8_t checksum(std::string_view bytes) noexcept {
+		return static_cast<std::uint8_t>(byteSum(bytes.data(), bytes.size()));
+	}
+
+	// Writes the three-digit CheckSum value.
+	inline void writeChecksum(char* out, std::uint32_t sum) noexcept {
+		const unsigned v = sum & 0xffu;
+		out[0] = static_cast<char>('0' + v / 100);
+		out[1] = static_cast<char>('0' + v / 10 % 10);
+		out[2] = static_cast<char>('0' + v % 10);
+	}
+
+}
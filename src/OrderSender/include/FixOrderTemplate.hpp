@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "FixChecksum.hpp"
+
+namespace fix {
+
+	inline constexpr char SOH = '\x01';
+
+	// Widths of the patched fields. FIX allows leading zeros in int and float values, so every
+	// message rendered from a template has the same length and BodyLength (9) is fixed at build time.
+	inline constexpr std::size_t kSeqNumWidth = 9;
+	inline constexpr std::size_t kTimestampWidth = 21;   // YYYYMMDD-HH:MM:SS.sss
+	inline constexpr std::size_t kClOrdIdWidth = 20;     // any uint64
+	inline constexpr std::size_t kIntegerDigits = 10;    // integer part of price and quantity
+	inline constexpr unsigned kMaxDecimals = 8;
+
+	enum class Field : std::uint8_t { SeqNum, SendingTime, ClOrdID, OrigClOrdID, Side, TransactTime, OrderQty, Price, Count };
+
+	struct TemplateConfig {
+		std::string senderCompId{"FIXSIM-CLIENT"};
+		std::string targetCompId{"FIXSIM-SERVER"};
+		unsigned priceDecimals{8};
+		unsigned qtyDecimals{8};
+		char ordType{'2'};       // limit
+		char timeInForce{'1'};   // good till cancel
+	};
+
+	// One pre-rendered FIX 4.4 order message (35=D, F or G) for a single instrument. Sending it means
+	// patching the variable slots in place and calling finish(), which refreshes only the CheckSum:
+	// the byte sum of the static part is kept from build time and each slot's sum is updated as it is
+	// written. Setters return false, leaving the slot unchanged, when a value does not fit its width.
+	class OrderTemplate {
+	public:
+		OrderTemplate() = default;
+		OrderTemplate(char msgType, std::string_view symbol, const TemplateConfig& config);
+
+		[[nodiscard]] bool has(Field f) const noexcept { return slot(f).width != 0; }
+
+		bool setUnsigned(Field f, std::uint64_t value) noexcept;
+		bool setDecimal(Field f, double value) noexcept;
+		void setChar(Field f, char c) noexcept;
+		// Copies kTimestampWidth bytes, as produced by TimestampFormatter.
+		void setTimestamp(Field f, const char* timestamp) noexcept;
+
+		// Writes the CheckSum and returns the complete message.
+		std::string_view finish() noexcept {
+			std::uint32_t sum = staticSum_;
+			for (const auto& s : slots_) sum += s.sum;
+			writeChecksum(buf_.data() + checksumOffset_, sum);
+			return buf_;
+		}
+
+		[[nodiscard]] char msgType() const noexcept { return msgType_; }
+		[[nodiscard]] std::size_t bodyLength() const noexcept { return bodyLength_; }
+		[[nodiscard]] std::string_view bytes() const noexcept { return buf_; }
+
+	private:
+		struct Slot {
+			std::uint16_t offset{0};
+			std::uint8_t width{0};
+			std::uint8_t decimals{0};
+			std::uint32_t sum{0};
+		};
+
+		Slot& slot(Field f) noexcept { return slots_[static_cast<std::size_t>(f)]; }
+		const Slot& slot(Field f) const noexcept { return slots_[static_cast<std::size_t>(f)]; }
+
+		std::string buf_;
+		std::array<Slot, static_cast<std::size_t>(Field::Count)> slots_{};
+		std::uint32_t staticSum_{0};
+		std::uint16_t checksumOffset_{0};
+		std::uint16_t bodyLength_{0};
+		char msgType_{0};
+	};
+
+	// UTCTimestamp with millisecond precision. The date is re-rendered only when the day changes.
+	class TimestampFormatter {
+	public:
+		// Returns kTimestampWidth bytes, valid until the next call.
+		const char* format(std::chrono::system_clock::time_point tp) noexcept;
+
+	private:
+		std::array<char, kTimestampWidth> buf_{};
+		std::int64_t day_{std::numeric_limits<std::int64_t>::min()};
+	};
+
+}
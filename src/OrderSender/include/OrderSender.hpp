@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "FixOrderTemplate.hpp"
+#include "OrderIntent.hpp"
+#include "SymbolTable.hpp"
+
+// Turns OrderIntents into FIX 4.4 NewOrderSingle (D), OrderCancelReplaceRequest (G) and
+// OrderCancelRequest (F) messages and writes each with a single Transport::send(std::string_view).
+// Messages come from per-instrument templates built up front by addSymbol(), so the hot path only
+// formats digits into fixed-width slots and refreshes the CheckSum; it never allocates.
+//
+// Usable directly as a Strategy sink: MarketMaker<std::reference_wrapper<OrderSender<T>>>.
+//
+// Over a FIX session (PixNetworkClient) the session owns MsgSeqNum: the SeqNum slot is patched from
+// the session's store under its send lock, and the CompIDs come from the session's config, so orders
+// share one numbering with Logon, Heartbeats and the rest. Other transports get numbers from
+// nextSeqNum(). The counters are written on the order thread and may be read from any thread.
+template<class Transport>
+class OrderSender {
+public:
+	static constexpr bool kSessionSequenced = requires(Transport& t) {
+		t.session().config();
+		t.sendSequenced([](std::uint64_t) { return std::string_view{}; }, true);
+	};
+
+	// Over a FIX session, construct after the session's config is final: its CompIDs are copied here.
+	OrderSender(Transport& transport, fix::TemplateConfig config)
+		: transport_(transport)
+		, config_(std::move(config))
+		, templates_(gateway::SymbolTable::kMaxSymbols)
+	{
+		if constexpr (kSessionSequenced) {
+			config_.senderCompId = transport_.session().config().senderCompId;
+			config_.targetCompId = transport_.session().config().targetCompId;
+		}
+	}
+
+	// Renders the D, G and F templates for symbol. Must run before the first intent for it.
+	void addSymbol(gateway::SymbolId symbol) {
+		if (templates_[symbol]) return;
+		const auto name = gateway::symbolName(symbol);
+		auto t = std::make_unique<SymbolTemplates>();
+		t->byType[index(IntentType::New)] = fix::OrderTemplate('D', name, config_);
+		t->byType[index(IntentType::Replace)] = fix::OrderTemplate('G', name, config_);
+		t->byType[index(IntentType::Cancel)] = fix::OrderTemplate('F', name, config_);
+		templates_[symbol] = std::move(t);
+	}
+
+	// Patches the matching template and returns the finished message, or nullopt when the symbol has
+	// no templates or a value does not fit its slot. Consumes a sequence number only on success. The
+	// view stays valid until the next intent of the same type for the same symbol.
+	std::optional<std::string_view> encode(const OrderIntent& intent, IntentClock::time_point now) {
+		auto* t = prepare(intent, now);
+		if (!t) return std::nullopt;
+		if (!t->setUnsigned(fix::Field::SeqNum, nextSeqNum_)) {
+			bump(rejected_);
+			return std::nullopt;
+		}
+		++nextSeqNum_;
+		return t->finish();
+	}
+
+	// Cancels are critical: with nothing queued ahead they go out on this thread instead of waiting
+	// for the sender, when the transport offers that.
+	bool send(const OrderIntent& intent) {
+		const bool critical = intent.type == IntentType::Cancel;
+		bool ok;
+		if constexpr (kSessionSequenced) {
+			auto* t = prepare(intent, IntentClock::now());
+			if (!t) return false;
+			ok = transport_.sendSequenced([t](std::uint64_t seq) {
+				return t->setUnsigned(fix::Field::SeqNum, seq) ? t->finish() : std::string_view{};
+			}, critical);
+		} else {
+			const auto msg = encode(intent, IntentClock::now());
+			if (!msg) return false;
+			if constexpr (requires { transport_.sendCritical(*msg); }) {
+				ok = critical ? transport_.sendCritical(*msg) : transport_.send(*msg);
+			} else {
+				ok = transport_.send(*msg);
+			}
+		}
+		if (!ok) {
+			bump(sendFailures_);
+			return false;
+		}
+		bump(sent_);
+		return true;
+	}
+
+	bool operator()(const OrderIntent& intent) { return send(intent); }
+
+	[[nodiscard]] std::uint64_t nextSeqNum() const noexcept { return nextSeqNum_; }
+	void setNextSeqNum(std::uint64_t seq) noexcept { nextSeqNum_ = seq; }
+
+	[[nodiscard]] std::uint64_t sent() const noexcept { return sent_.load(std::memory_order_relaxed); }
+	[[nodiscard]] std::uint64_t rejected() const noexcept { return rejected_.load(std::memory_order_relaxed); }
+	// Intents for a symbol addSymbol() never saw; included in rejected().
+	[[nodiscard]] std::uint64_t unknownSymbols() const noexcept { return unknownSymbols_.load(std::memory_order_relaxed); }
+	[[nodiscard]] std::uint64_t sendFailures() const noexcept { return sendFailures_.load(std::memory_order_relaxed); }
+	[[nodiscard]] const fix::TemplateConfig& config() const noexcept { return config_; }
+
+private:
+	struct SymbolTemplates {
+		std::array<fix::OrderTemplate, 3> byType;
+	};
+
+	static constexpr std::size_t index(IntentType type) noexcept { return static_cast<std::size_t>(type); }
+
+	// Single writer, so a relaxed load/store pair is enough and avoids a locked RMW per intent.
+	static void bump(std::atomic<std::uint64_t>& c) noexcept {
+		c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	// Patches everything but the SeqNum, or returns nullptr when the symbol has no templates or a value
+	// does not fit its slot.
+	fix::OrderTemplate* prepare(const OrderIntent& intent, IntentClock::time_point now) {
+		auto& symbolTemplates = templates_[intent.symbol];
+		if (!symbolTemplates) {
+			bump(rejected_);
+			bump(unknownSymbols_);
+			return nullptr;
+		}
+		auto& t = symbolTemplates->byType[index(intent.type)];
+
+		bool ok = t.setUnsigned(fix::Field::ClOrdID, intent.clientOrderId)
+			&& t.setDecimal(fix::Field::OrderQty, intent.qty);
+		if (intent.type != IntentType::New) ok = ok && t.setUnsigned(fix::Field::OrigClOrdID, intent.origClientOrderId);
+		if (intent.type != IntentType::Cancel) ok = ok && t.setDecimal(fix::Field::Price, intent.price);
+		if (!ok) {
+			bump(rejected_);
+			return nullptr;
+		}
+		t.setChar(fix::Field::Side, intent.side == gateway::QuoteSide::Bid ? '1' : '2');
+		const char* ts = clock_.format(now);
+		t.setTimestamp(fix::Field::SendingTime, ts);
+		t.setTimestamp(fix::Field::TransactTime, ts);
+		return &t;
+	}
+
+	Transport& transport_;
+	fix::TemplateConfig config_;
+	std::vector<std::unique_ptr<SymbolTemplates>> templates_;
+	fix::TimestampFormatter clock_;
+	std::uint64_t nextSeqNum_{1};
+	std::atomic<std::uint64_t> sent_{0};
+	std::atomic<std::uint64_t> rejected_{0};
+	std::atomic<std::uint64_t> unknownSymbols_{0};
+	std::atomic<std::uint64_t> sendFailures_{0};
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "OrderIntent.hpp"
+#include "SymbolTable.hpp"
+
+// Why an intent was refused. Order is priority: when several checks fail the lowest one is reported.
+enum class RiskReject : std::uint8_t { None, KillSwitch, MaxQty, MaxNotional, NoReference, PriceBand, Position, Throttle, Count };
+
+struct RiskLimits {
+	double maxOrderQty{1.0};
+	double maxNotional{100'000.0};
+	// Furthest a limit price may sit from the book mid.
+	double priceBandBps{200.0};
+	// Bound on |filled position| after this order fills completely. Resting orders are not reserved.
+	double maxPosition{1.0};
+	// Message rate for the instrument, cancels included; burst messages may go back to back.
+	double maxOrdersPerSecond{50.0};
+	double burst{10.0};
+};
+
+// Result of PreTradeRisk::check(). An accepted intent takes its throttle slot only when it is passed
+// to commit(), so an intent that never goes out does not use up the instrument's message rate.
+struct RiskCheck {
+	RiskReject reason{RiskReject::None};
+	// The instrument's throttle TAT once this intent is sent.
+	std::int64_t throttleTatNs{0};
+
+	[[nodiscard]] bool accepted() const noexcept { return reason == RiskReject::None; }
+};
+
+// Pre-trade checks for every intent before it is encoded: order size, notional, price band around the
+// last book mid, position limit and a per-instrument message throttle. Each check is a handful of
+// arithmetic on the instrument's own cache-aligned state; all of them are evaluated and the result is a
+// bitmask, so there is one data-dependent branch per intent. Cancels only face the throttle, since
+// refusing them would only ever add risk.
+//
+// check() has no effect on the limits; commit() charges the throttle once the intent has been sent.
+// Limits are set at startup. check(), commit(), updateMid() and onFill() run on the order thread; the
+// kill switch and the counters may be used from any thread.
+class PreTradeRisk {
+public:
+	explicit PreTradeRisk(RiskLimits defaults = {})
+		: state_(gateway::SymbolTable::kMaxSymbols) {
+		for (auto& s : state_) configure(s, defaults);
+	}
+
+	void setLimits(gateway::SymbolId symbol, const RiskLimits& limits) { configure(state_[symbol], limits); }
+
+	RiskCheck check(const OrderIntent& intent) noexcept {
+		const auto& s = state_[intent.symbol];
+		const bool cancel = intent.type == IntentType::Cancel;
+		const double signedQty = intent.side == gateway::QuoteSide::Bid ? intent.qty : -intent.qty;
+
+		const auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(intent.decisionTs.time_since_epoch()).count();
+
+		std::uint32_t failed = 0;
+		failed |= bit(RiskReject::KillSwitch, !cancel && killed_.load(std::memory_order_relaxed));
+		failed |= bit(RiskReject::MaxQty, !cancel && !(intent.qty > 0.0 && intent.qty <= s.maxOrderQty));
+		failed |= bit(RiskReject::MaxNotional, !cancel && !(intent.qty * intent.price <= s.maxNotional));
+		failed |= bit(RiskReject::NoReference, !cancel && !(s.mid > 0.0));
+		failed |= bit(RiskReject::PriceBand, !cancel && !(std::abs(intent.price - s.mid) <= s.mid * s.bandFraction));
+		failed |= bit(RiskReject::Position, !cancel && !(std::abs(s.position + signedQty) <= s.maxPosition));
+		failed |= bit(RiskReject::Throttle, nowNs < s.throttleTatNs - s.throttleToleranceNs);
+
+		if (failed == 0) [[likely]] {
+			bump(passed_);
+			return {RiskReject::None, std::max(s.throttleTatNs, nowNs) + s.throttleIntervalNs};
+		}
+		const auto reason = static_cast<RiskReject>(std::countr_zero(failed));
+		bump(rejects_[static_cast<std::size_t>(reason)]);
+		return {reason, s.throttleTatNs};
+	}
+
+	// Charges the throttle for an intent check() accepted and that has now been sent.
+	void commit(const OrderIntent& intent, const RiskCheck& result) noexcept {
+		if (result.accepted()) state_[intent.symbol].throttleTatNs = result.throttleTatNs;
+	}
+
+	// Reference price for the band check; a non-positive mid blocks new orders for the instrument.
+	void updateMid(gateway::SymbolId symbol, double mid) noexcept { state_[symbol].mid = mid; }
+
+	void onFill(gateway::SymbolId symbol, gateway::QuoteSide side, double qty) noexcept {
+		state_[symbol].position += side == gateway::QuoteSide::Bid ? qty : -qty;
+	}
+
+	// Refuses every new and replacing order until resume(); cancels still pass.
+	void kill() noexcept { killed_.store(true, std::memory_order_relaxed); }
+	void resume() noexcept { killed_.store(false, std::memory_order_relaxed); }
+	[[nodiscard]] bool killed() const noexcept { return killed_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] double position(gateway::SymbolId symbol) const noexcept { return state_[symbol].position; }
+	[[nodiscard]] std::uint64_t passed() const noexcept { return passed_.load(std::memory_order_relaxed); }
+	[[nodiscard]] std::uint64_t rejects(RiskReject reason) const noexcept {
+		return rejects_[static_cast<std::size_t>(reason)].load(std::memory_order_relaxed);
+	}
+
+private:
+	struct alignas(64) InstrumentState {
+		double maxOrderQty{0.0};
+		double maxNotional{0.0};
+		double bandFraction{0.0};
+		double maxPosition{0.0};
+		// Throttle as a generic cell rate algorithm: one message per interval, up to burst early.
+		std::int64_t throttleIntervalNs{0};
+		std::int64_t throttleToleranceNs{0};
+		std::int64_t throttleTatNs{0};
+		double mid{0.0};
+		double position{0.0};
+	};
+
+	static void configure(InstrumentState& s, const RiskLimits& limits) noexcept {
+		s.maxOrderQty = limits.maxOrderQty;
+		s.maxNotional = limits.maxNotional;
+		s.bandFraction = limits.priceBandBps * 1e-4;
+		s.maxPosition = limits.maxPosition;
+		const double interval = limits.maxOrdersPerSecond > 0.0 ? 1e9 / limits.maxOrdersPerSecond : 1e18;
+		s.throttleIntervalNs = static_cast<std::int64_t>(interval);
+		s.throttleToleranceNs = static_cast<std::int64_t>(interval * std::max(limits.burst - 1.0, 0.0));
+	}
+
+	static constexpr std::uint32_t bit(RiskReject reason, bool on) noexcept {
+		return static_cast<std::uint32_t>(on) << static_cast<unsigned>(reason);
+	}
+
+	static void bump(std::atomic<std::uint64_t>& c) noexcept {
+		c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	std::vector<InstrumentState> state_;
+	std::atomic<bool> killed_{false};
+	std::atomic<std::uint64_t> passed_{0};
+	std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(RiskReject::Count)> rejects_{};
+};
+
+// Strategy sink that runs every intent through PreTradeRisk and forwards only the accepted ones.
+// Strategy::onBook() hands it each book first, which keeps the band reference current. Returns false
+// when risk refused the intent or the downstream sink did not take it, so the strategy keeps its order
+// state as it was; only intents the sink took are charged to the throttle.
+template<class Sink>
+class RiskGate {
+public:
+	RiskGate(PreTradeRisk& risk, Sink sink) : risk_(risk), sink_(std::move(sink)) {}
+
+	template<class Book>
+	void onBook(const Book& book) noexcept {
+		const double bid = book.bestBid();
+		const double ask = book.bestAsk();
+		risk_.updateMid(book.symbolId(), bid > 0.0 && ask > 0.0 ? 0.5 * (bid + ask) : 0.0);
+	}
+
+	bool operator()(const OrderIntent& intent) {
+		const auto result = risk_.check(intent);
+		if (!result.accepted() || !deliverIntent(sink_, intent)) return false;
+		risk_.commit(intent, result);
+		return true;
+	}
+
+	// Passes a simulated clock through to the strategy (see Strategy).
+	IntentClock::time_point now() requires requires(Sink& s) { s.now(); } { return sink_.now(); }
+
+	PreTradeRisk& risk() noexcept { return risk_; }
+	Sink& sink() noexcept { return sink_; }
+
+private:
+	PreTradeRisk& risk_;
+	Sink sink_;
+};
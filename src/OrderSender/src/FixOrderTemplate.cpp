@@ -0,0 +1,178 @@
+#include "FixOrderTemplate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace fix {
+
+	namespace {
+
+		constexpr std::array<std::uint64_t, 20> kPow10 = [] {
+			std::array<std::uint64_t, 20> p{};
+			p[0] = 1;
+			for (std::size_t i = 1; i < p.size(); ++i) p[i] = p[i - 1] * 10;
+			return p;
+		}();
+
+		constexpr char kDigitPairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+
+		// Right-aligned, zero-padded; v must fit in width digits.
+		void writeDigits(char* out, std::size_t width, std::uint64_t v) noexcept {
+			char* p = out + width;
+			while (p - out >= 2) {
+				const auto r = static_cast<std::size_t>(v % 100) * 2;
+				v /= 100;
+				*--p = kDigitPairs[r + 1];
+				*--p = kDigitPairs[r];
+			}
+			if (p != out) *--p = static_cast<char>('0' + v % 10);
+		}
+
+		void write2(char* out, unsigned v) noexcept {
+			out[0] = kDigitPairs[v * 2];
+			out[1] = kDigitPairs[v * 2 + 1];
+		}
+
+		// Appends tag=value<SOH> to msg.
+		void appendField(std::string& msg, int tag, std::string_view value) {
+			msg += std::to_string(tag);
+			msg += '=';
+			msg += value;
+			msg += SOH;
+		}
+
+	}
+
+	OrderTemplate::OrderTemplate(char msgType, std::string_view symbol, const TemplateConfig& config)
+		: msgType_(msgType) {
+		const unsigned priceDecimals = std::min(config.priceDecimals, kMaxDecimals);
+		const unsigned qtyDecimals = std::min(config.qtyDecimals, kMaxDecimals);
+		const auto decimalWidth = [](unsigned decimals) { return kIntegerDigits + (decimals ? decimals + 1 : 0); };
+
+		std::string body;
+		const auto slotField = [&](int tag, Field f, std::size_t width, unsigned decimals = 0) {
+			body += std::to_string(tag);
+			body += '=';
+			auto& s = slot(f);
+			s.offset = static_cast<std::uint16_t>(body.size());   // relative to the body for now
+			s.width = static_cast<std::uint8_t>(width);
+			s.decimals = static_cast<std::uint8_t>(decimals);
+			body.append(width, '0');
+			if (decimals) body[body.size() - decimals - 1] = '.';
+			body += SOH;
+		};
+
+		appendField(body, 35, std::string_view(&msgType, 1));
+		appendField(body, 49, config.senderCompId);
+		appendField(body, 56, config.targetCompId);
+		slotField(34, Field::SeqNum, kSeqNumWidth);
+		slotField(52, Field::SendingTime, kTimestampWidth);
+		if (msgType != 'D') slotField(41, Field::OrigClOrdID, kClOrdIdWidth);
+		slotField(11, Field::ClOrdID, kClOrdIdWidth);
+		appendField(body, 55, symbol);
+		slotField(54, Field::Side, 1);
+		slotField(60, Field::TransactTime, kTimestampWidth);
+		slotField(38, Field::OrderQty, decimalWidth(qtyDecimals), qtyDecimals);
+		if (msgType != 'F') {
+			appendField(body, 40, std::string_view(&config.ordType, 1));
+			slotField(44, Field::Price, decimalWidth(priceDecimals), priceDecimals);
+			appendField(body, 59, std::string_view(&config.timeInForce, 1));
+		}
+		body[slot(Field::Side).offset] = '1';
+
+		bodyLength_ = static_cast<std::uint16_t>(body.size());
+		buf_ = "8=FIX.4.4";
+		buf_ += SOH;
+		appendField(buf_, 9, std::to_string(body.size()));
+		const auto bodyStart = static_cast<std::uint16_t>(buf_.size());
+		buf_ += body;
+		checksumOffset_ = static_cast<std::uint16_t>(buf_.size() + 3);
+		buf_ += "10=000";
+		buf_ += SOH;
+
+		staticSum_ = byteSum(buf_.data(), checksumOffset_ - 3);
+		for (auto& s : slots_) {
+			if (!s.width) continue;
+			s.offset = static_cast<std::uint16_t>(s.offset + bodyStart);
+			s.sum = byteSum(buf_.data() + s.offset, s.width);
+			staticSum_ -= s.sum;
+		}
+		finish();
+	}
+
+	bool OrderTemplate::setUnsigned(Field f, std::uint64_t value) noexcept {
+		auto& s = slot(f);
+		if (!s.width || (s.width < kPow10.size() && value >= kPow10[s.width])) return false;
+		char* out = buf_.data() + s.offset;
+		writeDigits(out, s.width, value);
+		s.sum = byteSum(out, s.width);
+		return true;
+	}
+
+	bool OrderTemplate::setDecimal(Field f, double value) noexcept {
+		auto& s = slot(f);
+		if (!s.width || !std::isfinite(value) || value < 0.0) return false;
+		const double scaled = std::round(value * static_cast<double>(kPow10[s.decimals]));
+		if (scaled >= static_cast<double>(kPow10[kIntegerDigits + s.decimals])) return false;
+		const auto units = static_cast<std::uint64_t>(scaled);
+
+		char* out = buf_.data() + s.offset;
+		writeDigits(out, kIntegerDigits, units / kPow10[s.decimals]);
+		if (s.decimals) writeDigits(out + kIntegerDigits + 1, s.decimals, units % kPow10[s.decimals]);
+		s.sum = byteSum(out, s.width);
+		return true;
+	}
+
+	void OrderTemplate::setChar(Field f, char c) noexcept {
+		auto& s = slot(f);
+		if (!s.width) return;
+		buf_[s.offset] = c;
+		s.sum = static_cast<unsigned char>(c);
+	}
+
+	void OrderTemplate::setTimestamp(Field f, const char* timestamp) noexcept {
+		auto& s = slot(f);
+		if (s.width != kTimestampWidth) return;
+		std::memcpy(buf_.data() + s.offset, timestamp, kTimestampWidth);
+		s.sum = byteSum(timestamp, kTimestampWidth);
+	}
+
+	const char* TimestampFormatter::format(std::chrono::system_clock::time_point tp) noexcept {
+		using namespace std::chrono;
+		const auto ms = duration_cast<milliseconds>(tp.time_since_epoch()).count();
+		auto day = ms / 86'400'000;
+		auto msOfDay = ms % 86'400'000;
+		if (msOfDay < 0) {
+			--day;
+			msOfDay += 86'400'000;
+		}
+
+		char* out = buf_.data();
+		if (day != day_) {
+			day_ = day;
+			const year_month_day ymd{sys_days{days{day}}};
+			const int year = static_cast<int>(ymd.year());
+			write2(out, static_cast<unsigned>(year / 100));
+			write2(out + 2, static_cast<unsigned>(year % 100));
+			write2(out + 4, static_cast<unsigned>(ymd.month()));
+			write2(out + 6, static_cast<unsigned>(ymd.day()));
+			out[8] = '-';
+			out[11] = ':';
+			out[14] = ':';
+			out[17] = '.';
+		}
+		const auto secOfDay = static_cast<unsigned>(msOfDay / 1000);
+		write2(out + 9, secOfDay / 3600);
+		write2(out + 12, secOfDay / 60 % 60);
+		write2(out + 15, secOfDay % 60);
+		const auto millis = static_cast<unsigned>(msOfDay % 1000);
+		out[18] = static_cast<char>('0' + millis / 100);
+		write2(out + 19, millis % 100);
+		return out;
+	}
+
+}
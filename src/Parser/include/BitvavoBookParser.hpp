@@ -3,11 +3,16 @@
 #include <string>
 #include <optional>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "Quote.hpp"
 
 namespace bitvavo {
 
+	// Kept to the low Quote::kSequenceBits, the width quotes carry, so BookSync, snapshots, checkpoints
+	// and quotes all compare the same values.
 	inline uint64_t extractNonce(std::string_view js) {
 		auto p = js.find("\"nonce\":");
 		if (p == std::string_view::npos) return 0;
@@ -17,59 +22,144 @@ namespace bitvavo {
 			v = v * 10 + (js[p] - '0');
 			++p;
 		}
-		return v;
+		return v & gateway::Quote::kSequenceMask;
 	}
 
-	inline bool parseFirstLevel(std::string_view frame,
-							std::string_view key,
-							double& px,
-							double& qty)
-	{
-		auto keyPos = frame.find(key);
-		if (keyPos == std::string_view::npos)
-			return false;
+	inline std::string_view extractMarket(std::string_view js) {
+		auto p = js.find("\"market\":\"");
+		if (p == std::string_view::npos) return {};
+		p += 10;
+		auto end = js.find('"', p);
+		if (end == std::string_view::npos) return {};
+		return js.substr(p, end - p);
+	}
 
-		auto start = frame.find('[', keyPos);
-		if (start == std::string_view::npos)
-			return false;
+	template<typename Markets>
+	inline std::string makeSubscribeRequest(const Markets& markets) {
+		std::string sub = R"({"action":"subscribe","channels":[{"name":"book","markets":[)";
+		bool first = true;
+		for (const auto& m : markets) {
+			if (!first) sub += ',';
+			sub += '"';
+			sub += m;
+			sub += '"';
+			first = false;
+		}
+		sub += "]}]}";
+		return sub;
+	}
 
-		auto nextChar = frame.find_first_not_of(" []", start + 1);
-		if (nextChar == std::string_view::npos || frame[nextChar] == ']')
-			return false;
+	inline bool parseNumber(std::string_view token, double& out) {
+		if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
+			token = token.substr(1, token.size() - 2);
+		}
+		char buf[64];
+		if (token.empty() || token.size() >= sizeof(buf)) return false;
+		std::memcpy(buf, token.data(), token.size());
+		buf[token.size()] = '\0';
 
-		auto end = frame.find(']', start);
-		if (end == std::string_view::npos)
-			return false;
+		char* endp = nullptr;
+		out = std::strtod(buf, &endp);
+		return endp != buf && *endp == '\0';
+	}
+
+	// Offset of the value stored under "key", or npos when the frame has no such key.
+	inline std::size_t findValue(std::string_view frame, std::string_view key) {
+		std::size_t p = 0;
+		while (true) {
+			p = frame.find(key, p);
+			if (p == std::string_view::npos) return p;
+			const std::size_t after = p + key.size();
+			if (p > 0 && frame[p - 1] == '"' && after + 1 < frame.size() && frame[after] == '"' && frame[after + 1] == ':') {
+				return after + 2;
+			}
+			p = after;
+		}
+	}
 
-		std::string inner(frame.substr(start + 1, end - start - 1));
+	// Walks every [price, size] pair of the array stored under "key" without allocating.
+	// fn returns false to stop early. Returns false when the key is missing or the array is malformed.
+	template<typename Fn>
+	inline bool forEachLevel(std::string_view frame, std::string_view key, Fn&& fn) {
+		std::size_t p = findValue(frame, key);
+		if (p >= frame.size() || frame[p] != '[') return false;
+		++p;
+		if (p < frame.size() && frame[p] == ']') return true;
+
+		while (p < frame.size()) {
+			if (frame[p] != '[') return false;
+			const auto comma = frame.find(',', p + 1);
+			if (comma == std::string_view::npos) return false;
+			const auto close = frame.find(']', comma + 1);
+			if (close == std::string_view::npos) return false;
 
-		inner.erase(std::remove_if(inner.begin(), inner.end(), [](unsigned char c) {
-			return c == '"' || c == '[' || c == ']' || std::isspace(c);
-		}), inner.end());
+			double px = 0.0, qty = 0.0;
+			if (!parseNumber(frame.substr(p + 1, comma - p - 1), px)) return false;
+			if (!parseNumber(frame.substr(comma + 1, close - comma - 1), qty)) return false;
+			if (!fn(px, qty)) return true;
 
-		if (inner.empty()) return false;
+			p = close + 1;
+			if (p < frame.size() && frame[p] == ',') { ++p; continue; }
+			return p < frame.size() && frame[p] == ']';
+		}
+		return false;
+	}
 
-		auto comma = inner.find(',');
-		if (comma == std::string::npos)
+	inline bool parseFirstLevel(std::string_view frame,
+							std::string_view key,
+							double& px,
+							double& qty)
+	{
+		bool found = false;
+		forEachLevel(frame, key, [&](double p, double q) {
+			px = p;
+			qty = q;
+			found = true;
 			return false;
+		});
+		return found;
+	}
 
-		std::string priceStr = inner.substr(0, comma);
-		std::string qtyStr   = inner.substr(comma + 1);
+	inline bool isBookUpdate(std::string_view frame) {
+		return frame.find(R"("event":"book")") != std::string_view::npos;
+	}
 
-		char* endp = nullptr;
-		px  = std::strtod(priceStr.c_str(), &endp);
-		if (endp == priceStr.c_str() || *endp != '\0')
-			return false;
+	// A getBook reply carrying a book; error replies to the same action have no response object.
+	inline bool isBookSnapshot(std::string_view frame) {
+		return frame.find(R"("action":"getBook")") != std::string_view::npos &&
+			   frame.find(R"("response":)") != std::string_view::npos &&
+			   frame.find(R"("nonce":)") != std::string_view::npos;
+	}
 
-		endp = nullptr;
-		qty = std::strtod(qtyStr.c_str(), &endp);
-		if (endp == qtyStr.c_str() || *endp != '\0')
-			return false;
+	inline std::string makeGetBookRequest(std::string_view market) {
+		return std::string(R"({"action":"getBook","market":")") + std::string(market) + R"("})";
+	}
 
+	// Emits one Quote per level in both arrays of a book update or getBook response. A frame is applied
+	// whole or not at all: both arrays are checked before the first level is emitted, so nothing is
+	// emitted and false is returned when either array is malformed or the frame carries neither.
+	template<typename Emit>
+	inline bool parseBookLevels(std::string_view frame, gateway::SymbolId symbol, Emit&& emit) {
+		const bool hasBids = findValue(frame, "bids") != std::string_view::npos;
+		const bool hasAsks = findValue(frame, "asks") != std::string_view::npos;
+		const auto wellFormed = [](double, double) { return true; };
+		if (!hasBids && !hasAsks) return false;
+		if (hasBids && !forEachLevel(frame, "bids", wellFormed)) return false;
+		if (hasAsks && !forEachLevel(frame, "asks", wellFormed)) return false;
+
+		const auto now = std::chrono::system_clock::now();
+		const auto nonce = extractNonce(frame);
+		forEachLevel(frame, "bids", [&](double px, double qty) {
+			emit(gateway::Quote(px, qty, now, symbol, gateway::QuoteSide::Bid, nonce));
+			return true;
+		});
+		forEachLevel(frame, "asks", [&](double px, double qty) {
+			emit(gateway::Quote(px, qty, now, symbol, gateway::QuoteSide::Ask, nonce));
+			return true;
+		});
 		return true;
 	}
 
-
 	inline std::optional<gateway::Quote>
 	parseAndStoreQuote(std::string_view frame, std::string_view market)
 	{
@@ -77,15 +167,20 @@ namespace bitvavo {
 			if (frame.find(R"("event":"book")") == std::string_view::npos)
 				return std::nullopt;
 
+			// Only markets someone subscribed to are in the table; anything else is dropped.
+			const auto symbol = gateway::SymbolTable::instance().find(market);
+			if (!symbol) return std::nullopt;
+
 			const auto now = std::chrono::system_clock::now();
+			const auto nonce = extractNonce(frame);
 			double px = 0.0, qty = 0.0;
 
 			if (parseFirstLevel(frame, "bids", px, qty)) {
-				return gateway::Quote(px, qty, now, market, gateway::QuoteSide::Bid);
+				return gateway::Quote(px, qty, now, *symbol, gateway::QuoteSide::Bid, nonce);
 			}
 
 			if (parseFirstLevel(frame, "asks", px, qty)) {
-				return gateway::Quote(px, qty, now, market, gateway::QuoteSide::Ask);
+				return gateway::Quote(px, qty, now, *symbol, gateway::QuoteSide::Ask, nonce);
 			}
 
 			std::cerr << "[Bitvavo parser] No bid/ask found in frame: " << frame.substr(0, 200) << "\n";
@@ -4,6 +4,8 @@
 
 #ifndef HFT_FIXBOOKPARSER_HPP
 #define HFT_FIXBOOKPARSER_HPP
+#include <charconv>
+#include <cstdint>
 #include <iostream>
 #include "../../GatewayIn/include/Quote.hpp"
 
@@ -31,7 +33,9 @@ namespace fix {
 			std::string_view msgType = fields["35"];
 			if (msgType != "X" && msgType != "W") return std::nullopt;
 
-			std::string_view symbol = fields["55"];
+			// Only instruments someone subscribed to are in the table; anything else is dropped.
+			const auto symbol = gateway::SymbolTable::instance().find(fields["55"]);
+			if (!symbol) return std::nullopt;
 			int numEntries = std::stoi(std::string(fields["268"]));
 			size_t current = fixMessage.find("268=");
 
@@ -49,7 +53,7 @@ namespace fix {
 				size_t szEnd = fixMessage.find('\x01', szPos);
 				double size = std::stod(std::string(fixMessage.substr(szPos + 4, szEnd - szPos - 4)));
 
-				return (gateway::Quote(price, size, std::chrono::system_clock::now(), symbol, side == "0" ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask));
+				return (gateway::Quote(price, size, std::chrono::system_clock::now(), *symbol, side == "0" ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask));
 
 
 				current = pxEnd;
@@ -60,5 +64,68 @@ namespace fix {
 		}
 		return std::nullopt;
 	}
+
+	// One market-by-order entry of a 35=X/W repeating group. Snapshot (W) entries carry no 279 and count as new.
+	struct OrderEntry {
+		char updateAction{'0'};
+		gateway::QuoteSide side{};
+		std::uint64_t orderId{};
+		double price{};
+		double size{};
+	};
+
+	// Walks every bid/offer entry that has an MDEntryID (278) and calls emit(const OrderEntry&).
+	// An entry starts at 279, or at 269 when the current entry already has a type. Returns the number emitted.
+	template<class Emit>
+	std::size_t forEachOrderEntry(std::string_view fixMessage, Emit&& emit) {
+		OrderEntry entry;
+		char type = 0;
+		bool haveId = false;
+		std::size_t emitted = 0;
+
+		auto flush = [&] {
+			if (haveId && (type == '0' || type == '1')) {
+				entry.side = type == '0' ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask;
+				emit(static_cast<const OrderEntry&>(entry));
+				++emitted;
+			}
+			entry = OrderEntry{};
+			type = 0;
+			haveId = false;
+		};
+
+		bool inGroup = false;
+		std::size_t pos = 0;
+		while (pos < fixMessage.size()) {
+			const size_t eq = fixMessage.find('=', pos);
+			if (eq == std::string_view::npos) break;
+			const size_t soh = fixMessage.find('\x01', eq);
+			if (soh == std::string_view::npos) break;
+			const auto tag = fixMessage.substr(pos, eq - pos);
+			const auto value = fixMessage.substr(eq + 1, soh - eq - 1);
+			pos = soh + 1;
+
+			if (tag == "268") { inGroup = true; continue; }
+			if (!inGroup) continue;
+
+			if (tag == "279") {
+				flush();
+				entry.updateAction = value.empty() ? '0' : value.front();
+			} else if (tag == "269") {
+				if (type) flush();
+				type = value.empty() ? '?' : value.front();
+			} else if (tag == "278") {
+				haveId = std::from_chars(value.data(), value.data() + value.size(), entry.orderId).ec == std::errc{};
+			} else if (tag == "270") {
+				std::from_chars(value.data(), value.data() + value.size(), entry.price);
+			} else if (tag == "271") {
+				std::from_chars(value.data(), value.data() + value.size(), entry.size);
+			} else if (tag == "10") {
+				break;
+			}
+		}
+		flush();
+		return emitted;
+	}
 }
 #endif //HFT_FIXBOOKPARSER_HPP
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "L3OrderBook.hpp"
+#include "SymbolTable.hpp"
+
+namespace sim {
+
+	// Who placed an order; executions are routed back to it. kHouse orders (seeded liquidity,
+	// background flow) produce no execution reports.
+	using OwnerId = std::uint32_t;
+	inline constexpr OwnerId kHouse = ~OwnerId{0};
+
+	// First ClOrdID for house orders. Client and strategy ids count up from 1, so the two ranges can
+	// share one engine without colliding.
+	inline constexpr std::uint64_t kHouseIdBase = std::uint64_t{1} << 62;
+
+	// FIX 4.4 ExecType (150) and OrdStatus (39) values used by the simulator.
+	enum class ExecType : char { New = '0', Canceled = '4', Replaced = '5', Rejected = '8', Trade = 'F' };
+	enum class OrdStatus : char { New = '0', PartiallyFilled = '1', Filled = '2', Canceled = '4', Rejected = '8' };
+
+	// A decoded D (new), F (cancel) or G (cancel/replace). ClOrdIDs are numeric, as OrderSender emits them.
+	struct OrderRequest {
+		char msgType{'D'};
+		OwnerId owner{0};
+		std::uint64_t clOrdId{0};
+		std::uint64_t origClOrdId{0};
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		double price{0.0};
+		double qty{0.0};
+	};
+
+	// One ExecutionReport, or an OrderCancelReject (35=9) when cancelReject is set.
+	struct Execution {
+		OwnerId owner{0};
+		bool cancelReject{false};
+		char requestType{'D'};   // message that was rejected, for CxlRejResponseTo (434)
+		ExecType execType{ExecType::New};
+		OrdStatus ordStatus{OrdStatus::New};
+		std::uint64_t orderId{0};
+		std::uint64_t execId{0};
+		std::uint64_t clOrdId{0};
+		std::uint64_t origClOrdId{0};
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		double orderQty{0.0};
+		double price{0.0};
+		double lastQty{0.0};
+		double lastPx{0.0};
+		double leavesQty{0.0};
+		double cumQty{0.0};
+		double avgPx{0.0};
+	};
+
+	// New aggregate size of one price level after a change; 0 means the level is gone.
+	struct LevelUpdate {
+		gateway::SymbolId symbol{0};
+		gateway::QuoteSide side{gateway::QuoteSide::Bid};
+		double price{0.0};
+		double size{0.0};
+	};
+
+	// Price-time priority matching over one L3OrderBook per instrument. Listener receives
+	//     void onExecution(const Execution&);
+	//     void onLevel(const LevelUpdate&);
+	// synchronously, in the order events happen. An incoming order first trades against the opposite
+	// side at resting prices, oldest order first, and any remainder rests. Cancel/replace requeues the
+	// order at the back of its new level. ClOrdIDs are scoped to their owner: each session may start
+	// numbering at 1, a ClOrdID still live for the same owner is rejected, and F/G only reach the
+	// sender's own orders. The book is keyed by the venue's OrderID. Single-threaded.
+	template<class Listener>
+	class MatchingEngine {
+	public:
+		explicit MatchingEngine(Listener listener = Listener{}, std::size_t expectedOrders = 1 << 16)
+			: listener_(std::move(listener))
+			, books_(gateway::SymbolTable::kMaxSymbols)
+			, expectedOrders_(expectedOrders) {
+			orders_.reserve(expectedOrders);
+			byClOrdId_.reserve(expectedOrders);
+		}
+
+		void addSymbol(gateway::SymbolId symbol) {
+			if (!books_[symbol]) books_[symbol] = std::make_unique<L3OrderBook>(symbol, expectedOrders_);
+		}
+
+		void submit(const OrderRequest& req) {
+			switch (req.msgType) {
+				case 'D': newOrder(req); break;
+				case 'F': cancel(req); break;
+				case 'G': replace(req); break;
+				default: reject(req, false); break;
+			}
+		}
+
+		void newOrder(const OrderRequest& req) {
+			L3OrderBook* book = books_[req.symbol].get();
+			if (!book || !(req.qty > 0.0) || !(req.price > 0.0) || live(req.owner, req.clOrdId)) {
+				reject(req, false);
+				return;
+			}
+			++accepted_;
+			OrderState state{req.owner, req.clOrdId, nextOrderId_++, req.symbol, req.side, req.price, req.qty, 0.0, 0.0};
+			report(state, 0, ExecType::New, 0.0, 0.0, req.qty);
+			work(*book, state, req.qty);
+		}
+
+		void cancel(const OrderRequest& req) {
+			const auto it = find(req.owner, req.origClOrdId);
+			if (it == orders_.end() || it->second.symbol != req.symbol) {
+				reject(req, true);
+				return;
+			}
+			OrderState state = it->second;
+			L3OrderBook& book = *books_[state.symbol];
+			erase(book, it);
+			level(book, state.side, state.price);
+			state.clOrdId = req.clOrdId;
+			report(state, req.origClOrdId, ExecType::Canceled, 0.0, 0.0, 0.0);
+		}
+
+		void replace(const OrderRequest& req) {
+			const auto it = find(req.owner, req.origClOrdId);
+			if (it == orders_.end() || it->second.symbol != req.symbol || !(req.qty > 0.0) || !(req.price > 0.0)
+				|| req.qty <= it->second.cumQty || live(req.owner, req.clOrdId)) {
+				reject(req, true);
+				return;
+			}
+			OrderState state = it->second;
+			L3OrderBook& book = *books_[state.symbol];
+			erase(book, it);
+			level(book, state.side, state.price);
+
+			state.clOrdId = req.clOrdId;
+			state.price = req.price;
+			state.orderQty = req.qty;
+			const double leaves = req.qty - state.cumQty;
+			report(state, req.origClOrdId, ExecType::Replaced, 0.0, 0.0, leaves);
+			work(book, state, leaves);
+		}
+
+		[[nodiscard]] const L3OrderBook* book(gateway::SymbolId symbol) const { return books_[symbol].get(); }
+		[[nodiscard]] std::size_t liveOrders() const noexcept { return orders_.size(); }
+		[[nodiscard]] std::uint64_t accepted() const noexcept { return accepted_; }
+		[[nodiscard]] std::uint64_t rejected() const noexcept { return rejected_; }
+		[[nodiscard]] std::uint64_t trades() const noexcept { return trades_; }
+		Listener& listener() noexcept { return listener_; }
+
+	private:
+		static constexpr double kQtyEpsilon = 1e-12;
+
+		struct OrderState {
+			OwnerId owner;
+			std::uint64_t clOrdId;
+			std::uint64_t orderId;
+			gateway::SymbolId symbol;
+			gateway::QuoteSide side;
+			double price;
+			double orderQty;
+			double cumQty;
+			double notional;
+		};
+
+		// ClOrdIDs are unique per owner only.
+		struct ClOrdKey {
+			OwnerId owner;
+			std::uint64_t clOrdId;
+			bool operator==(const ClOrdKey&) const = default;
+		};
+		struct ClOrdKeyHash {
+			std::size_t operator()(const ClOrdKey& k) const noexcept {
+				return static_cast<std::size_t>((k.clOrdId ^ (std::uint64_t{k.owner} << 40)) * 0x9E3779B97F4A7C15ull);
+			}
+		};
+		using Orders = std::unordered_map<std::uint64_t, OrderState>;
+
+		[[nodiscard]] bool live(OwnerId owner, std::uint64_t clOrdId) const { return byClOrdId_.count({owner, clOrdId}) != 0; }
+
+		Orders::iterator find(OwnerId owner, std::uint64_t clOrdId) {
+			const auto key = byClOrdId_.find({owner, clOrdId});
+			return key == byClOrdId_.end() ? orders_.end() : orders_.find(key->second);
+		}
+
+		void erase(L3OrderBook& book, Orders::iterator it) {
+			book.cancel(it->first);
+			byClOrdId_.erase({it->second.owner, it->second.clOrdId});
+			orders_.erase(it);
+		}
+
+		// Matches qty of an accepted order against the opposite side, then rests what is left.
+		void work(L3OrderBook& book, OrderState& state, double qty) {
+			const auto opposite = state.side == gateway::QuoteSide::Bid ? gateway::QuoteSide::Ask : gateway::QuoteSide::Bid;
+			const auto crosses = [&](double resting) {
+				return state.side == gateway::QuoteSide::Bid ? resting <= state.price : resting >= state.price;
+			};
+
+			bool touched = false;
+			double touchedPrice = 0.0;
+			while (qty > kQtyEpsilon) {
+				const OrderNode* passive = book.front(opposite);
+				if (!passive || !crosses(passive->price)) break;
+				if (touched && passive->price != touchedPrice) level(book, opposite, touchedPrice);
+				touched = true;
+				touchedPrice = passive->price;
+
+				const double px = passive->price;
+				const double fill = std::min(qty, passive->qty);
+				const double passiveLeaves = passive->qty - fill;
+				const std::uint64_t passiveId = passive->id;
+				qty -= fill;
+				++trades_;
+
+				const auto maker = orders_.find(passiveId);
+				fillState(maker->second, fill, px);
+				report(maker->second, 0, ExecType::Trade, fill, px, passiveLeaves > kQtyEpsilon ? passiveLeaves : 0.0);
+				if (passiveLeaves > kQtyEpsilon) book.modify(passiveId, passiveLeaves);
+				else erase(book, maker);
+
+				fillState(state, fill, px);
+				report(state, 0, ExecType::Trade, fill, px, qty > kQtyEpsilon ? qty : 0.0);
+			}
+			if (touched) level(book, opposite, touchedPrice);
+
+			if (qty > kQtyEpsilon) {
+				book.add(state.orderId, state.side, state.price, qty);
+				orders_.emplace(state.orderId, state);
+				byClOrdId_.emplace(ClOrdKey{state.owner, state.clOrdId}, state.orderId);
+				level(book, state.side, state.price);
+			}
+		}
+
+		static void fillState(OrderState& s, double qty, double px) noexcept {
+			s.cumQty += qty;
+			s.notional += qty * px;
+		}
+
+		void level(const L3OrderBook& book, gateway::QuoteSide side, double price) {
+			double size = 0.0;
+			if (side == gateway::QuoteSide::Bid) {
+				if (auto it = book.bids().find(price); it != book.bids().end()) size = it->second.size;
+			} else {
+				if (auto it = book.asks().find(price); it != book.asks().end()) size = it->second.size;
+			}
+			listener_.onLevel(LevelUpdate{book.symbolId(), side, price, size});
+		}
+
+		// leavesQty is the order's open quantity after the event.
+		void report(const OrderState& s, std::uint64_t origClOrdId, ExecType type,
+		            double lastQty, double lastPx, double leavesQty) {
+			if (s.owner == kHouse) {
+				++execId_;
+				return;
+			}
+			Execution e;
+			e.owner = s.owner;
+			e.execType = type;
+			e.orderId = s.orderId;
+			e.execId = ++execId_;
+			e.clOrdId = s.clOrdId;
+			e.origClOrdId = origClOrdId;
+			e.symbol = s.symbol;
+			e.side = s.side;
+			e.orderQty = s.orderQty;
+			e.price = s.price;
+			e.lastQty = lastQty;
+			e.lastPx = lastPx;
+			e.leavesQty = leavesQty;
+			e.cumQty = s.cumQty;
+			e.avgPx = s.cumQty > 0.0 ? s.notional / s.cumQty : 0.0;
+			if (type == ExecType::Canceled) e.ordStatus = OrdStatus::Canceled;
+			else if (leavesQty <= kQtyEpsilon && s.cumQty > 0.0) e.ordStatus = OrdStatus::Filled;
+			else if (s.cumQty > 0.0) e.ordStatus = OrdStatus::PartiallyFilled;
+			else e.ordStatus = OrdStatus::New;
+			listener_.onExecution(e);
+		}
+
+		void reject(const OrderRequest& req, bool cancelReject) {
+			++rejected_;
+			if (req.owner == kHouse) return;
+			Execution e;
+			e.owner = req.owner;
+			e.cancelReject = cancelReject;
+			e.requestType = req.msgType;
+			e.execType = ExecType::Rejected;
+			e.ordStatus = OrdStatus::Rejected;
+			e.execId = ++execId_;
+			e.clOrdId = req.clOrdId;
+			e.origClOrdId = req.origClOrdId;
+			e.symbol = req.symbol;
+			e.side = req.side;
+			e.orderQty = req.qty;
+			e.price = req.price;
+			listener_.onExecution(e);
+		}
+
+		Listener listener_;
+		std::vector<std::unique_ptr<L3OrderBook>> books_;
+		Orders orders_;   // by OrderID, which is also the book's order id
+		std::unordered_map<ClOrdKey, std::uint64_t, ClOrdKeyHash> byClOrdId_;
+		std::size_t expectedOrders_;
+		std::uint64_t nextOrderId_{1};
+		std::uint64_t execId_{0};
+		std::uint64_t accepted_{0};
+		std::uint64_t rejected_{0};
+		std::uint64_t trades_{0};
+	};
+
+}
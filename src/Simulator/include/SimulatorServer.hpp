@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "MatchingEngine.hpp"
+#include "SimulatorWire.hpp"
+
+namespace sim {
+
+	class SimulatorServer;
+
+	// Engine listener that hands events to the server's sessions.
+	struct SessionRouter {
+		SimulatorServer* server{nullptr};
+		void onExecution(const Execution& e);
+		void onLevel(const LevelUpdate& u);
+	};
+
+	// FIX 4.4 acceptor in front of a MatchingEngine, standing in for a venue. Each TCP connection is
+	// a session: Logon (A) is answered with the CompIDs swapped, MarketDataRequest (V) subscribes to
+	// the listed symbols and replays their books as 35=X entries, D/F/G go to the engine and come
+	// back as ExecutionReports, TestRequest (1) gets a Heartbeat and Logout (5) closes. All sessions
+	// and the engine live on one io thread; run() and every() are the ways in from outside it.
+	class SimulatorServer {
+	public:
+		using Engine = MatchingEngine<SessionRouter>;
+
+		SimulatorServer();
+		~SimulatorServer();
+
+		SimulatorServer(const SimulatorServer&) = delete;
+		SimulatorServer& operator=(const SimulatorServer&) = delete;
+
+		// Instruments to list; only before start().
+		void addSymbol(std::string_view symbol);
+
+		// Listens on address:port (port 0 picks a free one) and starts the io thread.
+		bool start(unsigned short port, std::string_view address = "0.0.0.0");
+		void stop();
+		[[nodiscard]] unsigned short port() const noexcept { return port_; }
+
+		// Runs fn on the io thread and waits for it. Not to be called from the io thread.
+		void run(const std::function<void(Engine&)>& fn);
+		// Runs fn on the io thread every period until stop(), e.g. to generate background flow.
+		// Register from one thread only.
+		void every(std::chrono::milliseconds period, std::function<void(Engine&)> fn);
+		// Sees every inbound D, F and G on the io thread before the engine does, e.g. to timestamp
+		// order arrival. Set before start().
+		void tapOrders(std::function<void(std::string_view)> tap) { orderTap_ = std::move(tap); }
+
+		[[nodiscard]] std::size_t sessions() const noexcept { return sessionCount_.load(std::memory_order_relaxed); }
+		[[nodiscard]] std::uint64_t messagesIn() const noexcept { return messagesIn_.load(std::memory_order_relaxed); }
+		[[nodiscard]] std::uint64_t messagesOut() const noexcept { return messagesOut_.load(std::memory_order_relaxed); }
+
+	private:
+		friend struct SessionRouter;
+
+		struct Session {
+			explicit Session(boost::asio::io_context& io) : socket(io) {}
+			boost::asio::ip::tcp::socket socket;
+			std::array<char, 8192> readBuffer{};
+			std::string inbound;
+			std::string body;
+			FixFramer framer;
+			OwnerId id{0};
+			bool loggedOn{false};
+			bool open{true};
+			std::vector<bool> subscribed = std::vector<bool>(gateway::SymbolTable::kMaxSymbols, false);
+		};
+
+		struct Ticker {
+			Ticker(boost::asio::io_context& io, std::chrono::milliseconds p, std::function<void(Engine&)> f)
+				: timer(io), period(p), fn(std::move(f)) {}
+			boost::asio::steady_timer timer;
+			std::chrono::milliseconds period;
+			std::function<void(Engine&)> fn;
+		};
+
+		void arm(Ticker& t);
+		void accept();
+		void read(Session& s);
+		void handle(Session& s, std::string_view message);
+		void subscribe(Session& s, std::string_view request);
+		void sendFrame(Session& s, std::string_view msgType);
+		void close(Session& s);
+		void onExecution(const Execution& e);
+		void onLevel(const LevelUpdate& u);
+
+		boost::asio::io_context io_;
+		boost::asio::ip::tcp::acceptor acceptor_;
+		std::thread thread_;
+		Engine engine_;
+		std::unordered_map<OwnerId, std::unique_ptr<Session>> sessions_;
+		std::vector<std::unique_ptr<Ticker>> tickers_;
+		std::function<void(std::string_view)> orderTap_;
+		OwnerId nextSession_{1};
+		unsigned short port_{0};
+		std::atomic<std::size_t> sessionCount_{0};
+		std::atomic<std::uint64_t> messagesIn_{0};
+		std::atomic<std::uint64_t> messagesOut_{0};
+	};
+
+}
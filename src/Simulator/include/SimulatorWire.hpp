@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "FixOrderTemplate.hpp"
+#include "L3OrderBook.hpp"
+#include "MatchingEngine.hpp"
+
+// Wire formats spoken by the simulator: inbound FIX orders, outbound ExecutionReports and market
+// data as FIX 35=X entries or Bitvavo "book" frames, each in the shape our parsers consume.
+namespace sim {
+
+	// Value of tag in a FIX message, empty when absent.
+	std::string_view fixField(std::string_view message, std::string_view tag);
+
+	// Decodes a NewOrderSingle (D), OrderCancelRequest (F) or OrderCancelReplaceRequest (G).
+	// nullopt for other message types, unknown symbols or unparsable fields.
+	std::optional<OrderRequest> decodeOrder(std::string_view message, OwnerId owner);
+
+	// Plain decimal without exponent or trailing zeros, at most 8 fractional digits.
+	void appendDecimal(std::string& out, double value);
+	void appendUnsigned(std::string& out, std::uint64_t value);
+
+	// Body of an ExecutionReport (35=8), or of an OrderCancelReject (35=9) when e.cancelReject is set.
+	// Returns the message type to frame it with.
+	std::string_view appendExecution(std::string& body, const Execution& e);
+	// Body of a one-entry MarketDataIncrementalRefresh (35=X). action is MDUpdateAction (279).
+	void appendIncrementalRefresh(std::string& body, const LevelUpdate& u, char action);
+
+	// Bitvavo websocket "book" event carrying one level change.
+	std::string bitvavoBookUpdate(const LevelUpdate& u, std::uint64_t nonce);
+	// Bitvavo getBook response with up to depth levels per side (0 = all).
+	std::string bitvavoBookSnapshot(const L3OrderBook& book, std::uint64_t nonce, std::size_t depth = 0);
+
+	// Wraps bodies in the standard header and trailer for one side of a session, numbering them
+	// from 1. The returned view is valid until the next frame().
+	class FixFramer {
+	public:
+		FixFramer() = default;
+		FixFramer(std::string senderCompId, std::string targetCompId);
+
+		std::string_view frame(std::string_view msgType, std::string_view body,
+		                       std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+		[[nodiscard]] std::uint64_t nextSeqNum() const noexcept { return nextSeqNum_; }
+
+	private:
+		std::string senderCompId_;
+		std::string targetCompId_;
+		std::string body_;
+		std::string out_;
+		fix::TimestampFormatter clock_;
+		std::uint64_t nextSeqNum_{1};
+	};
+
+}
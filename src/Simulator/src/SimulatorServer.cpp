@@ -0,0 +1,235 @@
+#include "SimulatorServer.hpp"
+
+#include <future>
+#include <iostream>
+
+namespace sim {
+
+	void SessionRouter::onExecution(const Execution& e) { server->onExecution(e); }
+	void SessionRouter::onLevel(const LevelUpdate& u) { server->onLevel(u); }
+
+	SimulatorServer::SimulatorServer()
+		: acceptor_(io_)
+		, engine_(SessionRouter{this}) {}
+
+	SimulatorServer::~SimulatorServer() {
+		stop();
+	}
+
+	void SimulatorServer::addSymbol(std::string_view symbol) {
+		engine_.addSymbol(gateway::internSymbol(symbol));
+	}
+
+	bool SimulatorServer::start(unsigned short port, std::string_view address) {
+		boost::system::error_code ec;
+		const auto ip = boost::asio::ip::make_address(std::string(address), ec);
+		if (ec) {
+			std::cerr << "SimulatorServer: bad address " << address << ": " << ec.message() << std::endl;
+			return false;
+		}
+		const boost::asio::ip::tcp::endpoint endpoint(ip, port);
+		acceptor_.open(endpoint.protocol(), ec);
+		if (!ec) acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+		if (!ec) acceptor_.bind(endpoint, ec);
+		if (!ec) acceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+		if (ec) {
+			std::cerr << "SimulatorServer: cannot listen on " << address << ":" << port << ": " << ec.message() << std::endl;
+			acceptor_.close(ec);
+			return false;
+		}
+		port_ = acceptor_.local_endpoint().port();
+		accept();
+		thread_ = std::thread([this] { io_.run(); });
+		return true;
+	}
+
+	void SimulatorServer::stop() {
+		if (!thread_.joinable()) return;
+		io_.stop();
+		thread_.join();
+		boost::system::error_code ec;
+		acceptor_.close(ec);
+		for (auto& t : tickers_) t->timer.cancel();
+		for (auto& [id, s] : sessions_) s->socket.close(ec);
+		sessions_.clear();
+		sessionCount_.store(0, std::memory_order_relaxed);
+	}
+
+	void SimulatorServer::run(const std::function<void(Engine&)>& fn) {
+		if (!thread_.joinable()) {
+			fn(engine_);
+			return;
+		}
+		std::promise<void> done;
+		boost::asio::post(io_, [&] {
+			fn(engine_);
+			done.set_value();
+		});
+		done.get_future().wait();
+	}
+
+	void SimulatorServer::every(std::chrono::milliseconds period, std::function<void(Engine&)> fn) {
+		auto& ticker = *tickers_.emplace_back(std::make_unique<Ticker>(io_, period, std::move(fn)));
+		boost::asio::post(io_, [this, &ticker] { arm(ticker); });
+	}
+
+	void SimulatorServer::arm(Ticker& t) {
+		t.timer.expires_after(t.period);
+		t.timer.async_wait([this, &t](const boost::system::error_code& ec) {
+			if (ec) return;
+			t.fn(engine_);
+			arm(t);
+		});
+	}
+
+	void SimulatorServer::accept() {
+		auto session = std::make_unique<Session>(io_);
+		auto& socket = session->socket;
+		acceptor_.async_accept(socket, [this, session = std::move(session)](const boost::system::error_code& ec) mutable {
+			if (ec) return;
+			boost::system::error_code opt;
+			session->socket.set_option(boost::asio::ip::tcp::no_delay(true), opt);
+			session->id = nextSession_++;
+			Session& s = *session;
+			sessions_.emplace(s.id, std::move(session));
+			sessionCount_.store(sessions_.size(), std::memory_order_relaxed);
+			read(s);
+			accept();
+		});
+	}
+
+	void SimulatorServer::read(Session& s) {
+		s.socket.async_read_some(boost::asio::buffer(s.readBuffer), [this, &s](const boost::system::error_code& ec, std::size_t n) {
+			if (ec || !s.open) {
+				close(s);
+				return;
+			}
+			s.inbound.append(s.readBuffer.data(), n);
+			std::size_t start = 0;
+			while (s.open) {
+				const auto trailer = s.inbound.find("\x01" "10=", start);
+				if (trailer == std::string::npos || trailer + 8 > s.inbound.size()) break;
+				const auto end = trailer + 8;
+				messagesIn_.fetch_add(1, std::memory_order_relaxed);
+				handle(s, std::string_view(s.inbound).substr(start, end - start));
+				start = end;
+			}
+			if (!s.open) {
+				close(s);
+				return;
+			}
+			s.inbound.erase(0, start);
+			read(s);
+		});
+	}
+
+	void SimulatorServer::handle(Session& s, std::string_view message) {
+		const auto type = fixField(message, "35");
+		if (type == "A") {
+			s.framer = FixFramer(std::string(fixField(message, "56")), std::string(fixField(message, "49")));
+			s.loggedOn = true;
+			s.body = "98=0\x01" "108=";
+			const auto hb = fixField(message, "108");
+			s.body += hb.empty() ? std::string_view("30") : hb;
+			// Sequence numbers start over with every connection.
+			s.body += "\x01" "141=Y\x01";
+			sendFrame(s, "A");
+			return;
+		}
+		if (!s.loggedOn) {
+			s.open = false;
+			return;
+		}
+
+		if (type == "D" || type == "F" || type == "G") {
+			if (orderTap_) orderTap_(message);
+			if (const auto req = decodeOrder(message, s.id)) {
+				engine_.submit(*req);
+				return;
+			}
+			s.body = "45=";
+			s.body += fixField(message, "34");
+			s.body += "\x01" "58=Unparsable order or unknown symbol\x01";
+			sendFrame(s, "3");
+		} else if (type == "V") {
+			subscribe(s, message);
+		} else if (type == "1") {
+			s.body = "112=";
+			s.body += fixField(message, "112");
+			s.body += '\x01';
+			sendFrame(s, "0");
+		} else if (type == "2") {
+			// Nothing is kept for replay: skip the client past everything sent so far.
+			s.body = "123=N\x01" "36=";
+			s.body += std::to_string(s.framer.nextSeqNum() + 1);
+			s.body += '\x01';
+			sendFrame(s, "4");
+		} else if (type == "5") {
+			s.body.clear();
+			sendFrame(s, "5");
+			s.open = false;
+		}
+	}
+
+	void SimulatorServer::subscribe(Session& s, std::string_view request) {
+		std::size_t pos = 0;
+		while ((pos = request.find("\x01" "55=", pos)) != std::string_view::npos) {
+			pos += 4;
+			const auto end = request.find('\x01', pos);
+			const auto id = gateway::SymbolTable::instance().find(request.substr(pos, end - pos));
+			if (!id || !engine_.book(*id)) continue;
+			s.subscribed[*id] = true;
+
+			const auto* book = engine_.book(*id);
+			const auto replay = [&](const auto& side, gateway::QuoteSide which) {
+				for (const auto& [price, level] : side) {
+					s.body.clear();
+					appendIncrementalRefresh(s.body, LevelUpdate{*id, which, price, level.size}, '0');
+					sendFrame(s, "X");
+				}
+			};
+			replay(book->bids(), gateway::QuoteSide::Bid);
+			replay(book->asks(), gateway::QuoteSide::Ask);
+		}
+	}
+
+	void SimulatorServer::sendFrame(Session& s, std::string_view msgType) {
+		if (!s.open) return;
+		const auto frame = s.framer.frame(msgType, s.body);
+		boost::system::error_code ec;
+		boost::asio::write(s.socket, boost::asio::buffer(frame.data(), frame.size()), ec);
+		if (ec) {
+			// The pending read fails with the socket closed and drops the session.
+			s.open = false;
+			s.socket.close(ec);
+			return;
+		}
+		messagesOut_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void SimulatorServer::close(Session& s) {
+		boost::system::error_code ec;
+		s.socket.close(ec);
+		sessions_.erase(s.id);
+		sessionCount_.store(sessions_.size(), std::memory_order_relaxed);
+	}
+
+	void SimulatorServer::onExecution(const Execution& e) {
+		const auto it = sessions_.find(e.owner);
+		if (it == sessions_.end()) return;
+		Session& s = *it->second;
+		s.body.clear();
+		const auto type = appendExecution(s.body, e);
+		sendFrame(s, type);
+	}
+
+	void SimulatorServer::onLevel(const LevelUpdate& u) {
+		for (auto& [id, s] : sessions_) {
+			if (!s->loggedOn || !s->subscribed[u.symbol]) continue;
+			s->body.clear();
+			appendIncrementalRefresh(s->body, u, u.size > 0.0 ? '1' : '2');
+			sendFrame(*s, "X");
+		}
+	}
+
+}
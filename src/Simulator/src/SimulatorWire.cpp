@@ -0,0 +1,227 @@
+#include "SimulatorWire.hpp"
+
+#include <charconv>
+
+#include "FixChecksum.hpp"
+
+namespace sim {
+
+	namespace {
+
+		void appendTag(std::string& out, std::string_view tag) {
+			out += tag;
+			out += '=';
+		}
+
+		void appendField(std::string& out, std::string_view tag, std::string_view value) {
+			appendTag(out, tag);
+			out += value;
+			out += fix::SOH;
+		}
+
+		void appendField(std::string& out, std::string_view tag, char value) {
+			appendTag(out, tag);
+			out += value;
+			out += fix::SOH;
+		}
+
+		void appendUnsignedField(std::string& out, std::string_view tag, std::uint64_t value) {
+			appendTag(out, tag);
+			appendUnsigned(out, value);
+			out += fix::SOH;
+		}
+
+		void appendDecimalField(std::string& out, std::string_view tag, double value) {
+			appendTag(out, tag);
+			appendDecimal(out, value);
+			out += fix::SOH;
+		}
+
+		template<class T>
+		bool parse(std::string_view s, T& out) {
+			return !s.empty() && std::from_chars(s.data(), s.data() + s.size(), out).ec == std::errc{};
+		}
+
+		void appendJsonLevel(std::string& out, double price, double size) {
+			out += "[\"";
+			appendDecimal(out, price);
+			out += "\",\"";
+			appendDecimal(out, size);
+			out += "\"]";
+		}
+
+		template<class Side>
+		void appendJsonSide(std::string& out, const Side& side, std::size_t depth) {
+			out += '[';
+			std::size_t n = 0;
+			for (const auto& [price, level] : side) {
+				if (depth && n == depth) break;
+				if (n++) out += ',';
+				appendJsonLevel(out, price, level.size);
+			}
+			out += ']';
+		}
+
+	}
+
+	std::string_view fixField(std::string_view message, std::string_view tag) {
+		std::size_t pos = 0;
+		while (pos < message.size()) {
+			const auto eq = message.find('=', pos);
+			if (eq == std::string_view::npos) break;
+			const auto soh = message.find(fix::SOH, eq);
+			if (soh == std::string_view::npos) break;
+			if (message.substr(pos, eq - pos) == tag) return message.substr(eq + 1, soh - eq - 1);
+			pos = soh + 1;
+		}
+		return {};
+	}
+
+	std::optional<OrderRequest> decodeOrder(std::string_view message, OwnerId owner) {
+		OrderRequest req;
+		req.owner = owner;
+		std::string_view symbol;
+		bool haveClOrdId = false, haveOrig = false, havePrice = false, haveQty = false;
+		char side = 0;
+
+		std::size_t pos = 0;
+		while (pos < message.size()) {
+			const auto eq = message.find('=', pos);
+			if (eq == std::string_view::npos) break;
+			const auto soh = message.find(fix::SOH, eq);
+			if (soh == std::string_view::npos) break;
+			const auto tag = message.substr(pos, eq - pos);
+			const auto value = message.substr(eq + 1, soh - eq - 1);
+			pos = soh + 1;
+
+			if (tag == "35") req.msgType = value.size() == 1 ? value.front() : '?';
+			else if (tag == "11") haveClOrdId = parse(value, req.clOrdId);
+			else if (tag == "41") haveOrig = parse(value, req.origClOrdId);
+			else if (tag == "55") symbol = value;
+			else if (tag == "54") side = value.empty() ? 0 : value.front();
+			else if (tag == "38") haveQty = parse(value, req.qty);
+			else if (tag == "44") havePrice = parse(value, req.price);
+		}
+
+		if (req.msgType != 'D' && req.msgType != 'F' && req.msgType != 'G') return std::nullopt;
+		if (!haveClOrdId || (side != '1' && side != '2')) return std::nullopt;
+		if (req.msgType != 'D' && !haveOrig) return std::nullopt;
+		if (req.msgType != 'F' && (!havePrice || !haveQty)) return std::nullopt;
+		const auto id = gateway::SymbolTable::instance().find(symbol);
+		if (!id) return std::nullopt;
+		req.symbol = *id;
+		req.side = side == '1' ? gateway::QuoteSide::Bid : gateway::QuoteSide::Ask;
+		return req;
+	}
+
+	void appendDecimal(std::string& out, double value) {
+		char buf[64];
+		auto [end, ec] = std::to_chars(buf, buf + sizeof buf, value, std::chars_format::fixed, 8);
+		if (ec != std::errc{}) {
+			out += '0';
+			return;
+		}
+		while (end[-1] == '0') --end;
+		if (end[-1] == '.') --end;
+		out.append(buf, end);
+	}
+
+	void appendUnsigned(std::string& out, std::uint64_t value) {
+		char buf[24];
+		const auto end = std::to_chars(buf, buf + sizeof buf, value).ptr;
+		out.append(buf, end);
+	}
+
+	std::string_view appendExecution(std::string& body, const Execution& e) {
+		const char side = e.side == gateway::QuoteSide::Bid ? '1' : '2';
+		if (e.cancelReject) {
+			if (e.orderId) appendUnsignedField(body, "37", e.orderId);
+			else appendField(body, "37", "NONE");
+			appendUnsignedField(body, "11", e.clOrdId);
+			appendUnsignedField(body, "41", e.origClOrdId);
+			appendField(body, "39", static_cast<char>(OrdStatus::Rejected));
+			appendField(body, "434", e.requestType == 'G' ? '2' : '1');
+			appendField(body, "102", '1');
+			return "9";
+		}
+
+		appendUnsignedField(body, "37", e.orderId);
+		appendUnsignedField(body, "11", e.clOrdId);
+		if (e.origClOrdId) appendUnsignedField(body, "41", e.origClOrdId);
+		appendUnsignedField(body, "17", e.execId);
+		appendField(body, "150", static_cast<char>(e.execType));
+		appendField(body, "39", static_cast<char>(e.ordStatus));
+		appendField(body, "55", gateway::symbolName(e.symbol));
+		appendField(body, "54", side);
+		appendDecimalField(body, "38", e.orderQty);
+		appendDecimalField(body, "44", e.price);
+		if (e.execType == ExecType::Trade) {
+			appendDecimalField(body, "32", e.lastQty);
+			appendDecimalField(body, "31", e.lastPx);
+		}
+		appendDecimalField(body, "151", e.leavesQty);
+		appendDecimalField(body, "14", e.cumQty);
+		appendDecimalField(body, "6", e.avgPx);
+		return "8";
+	}
+
+	void appendIncrementalRefresh(std::string& body, const LevelUpdate& u, char action) {
+		appendField(body, "55", gateway::symbolName(u.symbol));
+		appendField(body, "268", '1');
+		appendField(body, "279", action);
+		appendField(body, "269", u.side == gateway::QuoteSide::Bid ? '0' : '1');
+		appendDecimalField(body, "270", u.price);
+		appendDecimalField(body, "271", u.size);
+	}
+
+	std::string bitvavoBookUpdate(const LevelUpdate& u, std::uint64_t nonce) {
+		std::string out;
+		out.reserve(128);
+		out += R"({"event":"book","market":")";
+		out += gateway::symbolName(u.symbol);
+		out += R"(","nonce":)";
+		appendUnsigned(out, nonce);
+		out += u.side == gateway::QuoteSide::Bid ? R"(,"bids":[)" : R"(,"asks":[)";
+		appendJsonLevel(out, u.price, u.size);
+		out += u.side == gateway::QuoteSide::Bid ? R"(],"asks":[]})" : R"(],"bids":[]})";
+		return out;
+	}
+
+	std::string bitvavoBookSnapshot(const L3OrderBook& book, std::uint64_t nonce, std::size_t depth) {
+		std::string out;
+		out += R"({"action":"getBook","response":{"market":")";
+		out += book.symbol();
+		out += R"(","nonce":)";
+		appendUnsigned(out, nonce);
+		out += R"(,"bids":)";
+		appendJsonSide(out, book.bids(), depth);
+		out += R"(,"asks":)";
+		appendJsonSide(out, book.asks(), depth);
+		out += "}}";
+		return out;
+	}
+
+	FixFramer::FixFramer(std::string senderCompId, std::string targetCompId)
+		: senderCompId_(std::move(senderCompId))
+		, targetCompId_(std::move(targetCompId)) {}
+
+	std::string_view FixFramer::frame(std::string_view msgType, std::string_view body, std::chrono::system_clock::time_point now) {
+		body_.clear();
+		appendField(body_, "35", msgType);
+		appendField(body_, "49", senderCompId_);
+		appendField(body_, "56", targetCompId_);
+		appendUnsignedField(body_, "34", nextSeqNum_++);
+		appendField(body_, "52", std::string_view(clock_.format(now), fix::kTimestampWidth));
+		body_ += body;
+
+		out_.clear();
+		appendField(out_, "8", "FIX.4.4");
+		appendUnsignedField(out_, "9", body_.size());
+		out_ += body_;
+		char checksum[3];
+		fix::writeChecksum(checksum, fix::byteSum(out_.data(), out_.size()));
+		appendField(out_, "10", std::string_view(checksum, 3));
+		return out_;
+	}
+
+}
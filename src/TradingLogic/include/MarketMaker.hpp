@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Strategy.hpp"
+#include "SymbolTable.hpp"
+
+struct MarketMakerParams {
+	double halfSpreadBps{5.0};
+	double quoteSize{0.01};
+	// A side stops quoting once a fill there would take |position| past this.
+	double maxPosition{0.1};
+	// Shift of the quoted mid per unit of position, against the position.
+	double skewBpsPerUnit{10.0};
+	// Resting quotes are left alone until their target price moves further than this.
+	double requoteBps{1.0};
+	double tickSize{0.01};
+};
+
+// Sample two-sided quoter: centres a bid and an ask on the book's microprice, skews them against the
+// current position and only re-quotes when the target moves by more than requoteBps. Never quotes
+// through the opposite touch. Position is per instrument and updated through onFill(). A side's resting
+// order only changes once the sink accepts the intent (onAccepted()): a refused Replace still points at
+// the order that rests, and a refused Cancel leaves the side live.
+template<class Sink = NullIntentSink>
+class MarketMaker : public Strategy<MarketMaker<Sink>, Sink> {
+	using Base = Strategy<MarketMaker<Sink>, Sink>;
+
+public:
+	using Intents = typename Base::Intents;
+
+	explicit MarketMaker(MarketMakerParams params, Sink sink = Sink{})
+		: Base(std::move(sink))
+		, params_(params)
+		, state_(gateway::SymbolTable::kMaxSymbols) {}
+
+	template<class Book>
+	void decide(const Book& book, Intents& out) {
+		const double fair = book.microprice();
+		if (!std::isfinite(fair)) return;
+		auto& s = state_[book.symbolId()];
+
+		const double mid = fair * (1.0 - params_.skewBpsPerUnit * 1e-4 * s.position);
+		const double half = fair * params_.halfSpreadBps * 1e-4;
+		const double tick = params_.tickSize;
+		const double bid = std::min(std::floor((mid - half) / tick) * tick, book.bestAsk() - tick);
+		const double ask = std::max(std::ceil((mid + half) / tick) * tick, book.bestBid() + tick);
+
+		const bool canBuy = s.position + params_.quoteSize <= params_.maxPosition + 1e-12;
+		const bool canSell = s.position - params_.quoteSize >= -params_.maxPosition - 1e-12;
+		quote(s.bid, book.symbolId(), gateway::QuoteSide::Bid, canBuy, bid, out);
+		quote(s.ask, book.symbolId(), gateway::QuoteSide::Ask, canSell, ask, out);
+	}
+
+	// Pulls both quotes: prices derived from a corrupt book are not worth resting.
+	template<class Book>
+	void onUntrusted(const Book& book, Intents& out) {
+		auto& s = state_[book.symbolId()];
+		cancel(s.bid, book.symbolId(), gateway::QuoteSide::Bid, out);
+		cancel(s.ask, book.symbolId(), gateway::QuoteSide::Ask, out);
+	}
+
+	void onFill(gateway::SymbolId symbol, gateway::QuoteSide side, double qty) {
+		state_[symbol].position += side == gateway::QuoteSide::Bid ? qty : -qty;
+	}
+
+	// The sink took intent on: the side now rests under its ClOrdID, or is no longer live after a Cancel.
+	void onAccepted(const OrderIntent& intent) {
+		auto& s = state_[intent.symbol];
+		auto& r = intent.side == gateway::QuoteSide::Bid ? s.bid : s.ask;
+		if (intent.type == IntentType::Cancel) {
+			if (r.id == intent.origClientOrderId) r.live = false;
+		} else {
+			r = Resting{true, intent.clientOrderId, intent.price};
+		}
+	}
+
+	// The order is no longer on the venue (filled, cancelled or rejected); the next decision on that
+	// side places a fresh quote instead of replacing a dead one.
+	void onOrderDone(gateway::SymbolId symbol, std::uint64_t clientOrderId) {
+		auto& s = state_[symbol];
+		if (s.bid.live && s.bid.id == clientOrderId) s.bid.live = false;
+		if (s.ask.live && s.ask.id == clientOrderId) s.ask.live = false;
+	}
+
+	[[nodiscard]] double position(gateway::SymbolId symbol) const { return state_[symbol].position; }
+	[[nodiscard]] const MarketMakerParams& params() const noexcept { return params_; }
+
+private:
+	struct Resting {
+		bool live{false};
+		std::uint64_t id{0};
+		double price{0.0};
+	};
+
+	struct SymbolState {
+		double position{0.0};
+		Resting bid;
+		Resting ask;
+	};
+
+	void quote(Resting& r, gateway::SymbolId symbol, gateway::QuoteSide side, bool allowed, double target, Intents& out) {
+		if (!allowed) {
+			cancel(r, symbol, side, out);
+			return;
+		}
+		if (r.live && std::abs(target - r.price) <= r.price * params_.requoteBps * 1e-4) return;
+
+		OrderIntent intent;
+		intent.type = r.live ? IntentType::Replace : IntentType::New;
+		intent.side = side;
+		intent.symbol = symbol;
+		intent.clientOrderId = nextId_++;
+		intent.origClientOrderId = r.live ? r.id : 0;
+		intent.price = target;
+		intent.qty = params_.quoteSize;
+		out.push(intent);
+	}
+
+	void cancel(Resting& r, gateway::SymbolId symbol, gateway::QuoteSide side, Intents& out) {
+		if (!r.live) return;
+		OrderIntent intent;
+		intent.type = IntentType::Cancel;
+		intent.side = side;
+		intent.symbol = symbol;
+		intent.clientOrderId = nextId_++;
+		intent.origClientOrderId = r.id;
+		intent.price = r.price;
+		intent.qty = params_.quoteSize;
+		out.push(intent);
+	}
+
+	MarketMakerParams params_;
+	std::vector<SymbolState> state_;
+	std::uint64_t nextId_{1};
+};
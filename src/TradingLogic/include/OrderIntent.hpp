@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Quote.hpp"
+
+// Same clock as Quote timestamps, so an intent can be aged against the tick that caused it.
+using IntentClock = std::chrono::system_clock;
+
+enum class IntentType : std::uint8_t { New, Replace, Cancel };
+
+// What a strategy wants done; turning it into a wire message is the OrderSender's job.
+struct OrderIntent {
+	IntentType type{IntentType::New};
+	gateway::QuoteSide side{};
+	gateway::SymbolId symbol{};
+	std::uint64_t clientOrderId{0};
+	std::uint64_t origClientOrderId{0};   // order being replaced or cancelled
+	double price{0.0};
+	double qty{0.0};
+	IntentClock::time_point tickTs{};     // receive time of the market data that triggered the decision
+	IntentClock::time_point decisionTs{};
+};
+
+// Hands intent to sink and reports whether it was taken on. Sinks that can refuse an intent (risk,
+// a full send ring) return bool; sinks returning void accept everything.
+template<class Sink>
+bool deliverIntent(Sink& sink, const OrderIntent& intent) {
+	if constexpr (std::is_void_v<std::invoke_result_t<Sink&, const OrderIntent&>>) {
+		sink(intent);
+		return true;
+	} else {
+		return static_cast<bool>(sink(intent));
+	}
+}
+
+// Fixed-capacity intent list filled by a strategy for one book update; never allocates.
+template<std::size_t N = 8>
+class IntentBuffer {
+public:
+	bool push(const OrderIntent& intent) noexcept {
+		if (size_ == N) {
+			++dropped_;
+			return false;
+		}
+		items_[size_++] = intent;
+		return true;
+	}
+
+	void clear() noexcept { size_ = 0; }
+
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+	[[nodiscard]] std::size_t size() const noexcept { return size_; }
+	[[nodiscard]] static constexpr std::size_t capacity() noexcept { return N; }
+	// Intents refused because the buffer was full, over the buffer's lifetime.
+	[[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_; }
+
+	OrderIntent& operator[](std::size_t i) noexcept { return items_[i]; }
+	const OrderIntent& operator[](std::size_t i) const noexcept { return items_[i]; }
+	OrderIntent* begin() noexcept { return items_.data(); }
+	OrderIntent* end() noexcept { return items_.data() + size_; }
+	const OrderIntent* begin() const noexcept { return items_.data(); }
+	const OrderIntent* end() const noexcept { return items_.data() + size_; }
+
+private:
+	std::array<OrderIntent, N> items_{};
+	std::size_t size_{0};
+	std::uint64_t dropped_{0};
+};
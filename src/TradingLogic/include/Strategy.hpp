@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "LatencyHistogram.hpp"
+#include "OrderIntent.hpp"
+
+// Discards intents; the default until an order path is attached.
+struct NullIntentSink {
+	void operator()(const OrderIntent&) const noexcept {}
+};
+
+// CRTP base for strategies driven synchronously by the book thread (see QuoteConsumer::start(Strategy&)).
+// Derived implements
+//     template<class Book> void decide(const Book& book, Intents& out);
+// and may override onUntrusted() to react to a book that failed its integrity checks. Intents are
+// stamped and handed to Sink, any callable taking const OrderIntent&, on the same thread; a sink that
+// returns false refused the intent. Derived may implement onAccepted(intent), called for each intent
+// the sink took on, to commit its order state only once the order is on its way. A sink with
+// an onBook(book) member sees every book before the strategy does; one with now() supplies the
+// decision time, e.g. a backtest's simulated clock.
+template<class Derived, class Sink = NullIntentSink>
+class Strategy {
+public:
+	static constexpr std::size_t kMaxIntentsPerBook = 8;
+	using Intents = IntentBuffer<kMaxIntentsPerBook>;
+
+	explicit Strategy(Sink sink = Sink{}) : sink_(std::move(sink)) {}
+
+	// Called after every batch that changed book; tick is the receive time of the oldest quote in it.
+	template<class Book>
+	void onBook(const Book& book, IntentClock::time_point tick, bool trusted = true) {
+		if constexpr (requires { sink_.onBook(book); }) sink_.onBook(book);
+		++decisions_;
+		intents_.clear();
+		if (trusted) derived().decide(book, intents_);
+		else derived().onUntrusted(book, intents_);
+		if (intents_.empty()) return;
+
+		const auto now = decisionTime();
+		tickToIntent_.record(now - tick);
+		for (auto& intent : intents_) {
+			intent.tickTs = tick;
+			intent.decisionTs = now;
+			if (deliverIntent(sink_, intent)) derived().onAccepted(intent);
+			else ++refused_;
+		}
+	}
+
+	// Default: leave resting orders alone while the book is untrusted.
+	template<class Book>
+	void onUntrusted(const Book&, Intents&) {}
+
+	void onAccepted(const OrderIntent&) {}
+
+	[[nodiscard]] const LatencyHistogram& tickToIntent() const noexcept { return tickToIntent_; }
+	[[nodiscard]] std::uint64_t decisions() const noexcept { return decisions_; }
+	[[nodiscard]] std::uint64_t droppedIntents() const noexcept { return intents_.dropped(); }
+	// Intents the sink refused, e.g. on a risk reject or a full send ring.
+	[[nodiscard]] std::uint64_t refusedIntents() const noexcept { return refused_; }
+	Sink& sink() noexcept { return sink_; }
+
+private:
+	Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+
+	IntentClock::time_point decisionTime() {
+		if constexpr (requires { sink_.now(); }) return sink_.now();
+		else return IntentClock::now();
+	}
+
+	Sink sink_;
+	Intents intents_;
+	LatencyHistogram tickToIntent_;
+	std::uint64_t decisions_{0};
+	std::uint64_t refused_{0};
+};
@@ -1,4 +1,5 @@
 #include "OrderBook.hpp"
+#include "DepthKernels.hpp"
 
 #include <algorithm>
 #include <chrono>
@@ -43,11 +44,6 @@ struct Metrics {
     int    N      = 5;
 };
 
-static double sum_top_n(const std::vector<std::pair<double,double>>& v, int n) {
-    double s = 0.0; n = std::min<int>(n, (int)v.size());
-    for (int i=0;i<n;++i) s += v[i].second; return s;
-}
-
 static Metrics compute_metrics(const OrderBookSnapshot& s, int nForImb) {
     Metrics m; m.N = nForImb;
     if (!isnan_d(s.bestBid) && !isnan_d(s.bestAsk)) {
@@ -59,8 +55,8 @@ static Metrics compute_metrics(const OrderBookSnapshot& s, int nForImb) {
         const auto [Ba,Sa] = s.askLevels.front();
         const double denom = Sb + Sa; if (denom > 0) m.micro = (Bb*Sa + Ba*Sb)/denom;
     }
-    const double b = sum_top_n(s.bidLevels, nForImb);
-    const double a = sum_top_n(s.askLevels, nForImb);
+    const double b = depth::topDepth(s.bidSide(), (std::size_t)nForImb);
+    const double a = depth::topDepth(s.askSide(), (std::size_t)nForImb);
     const double tot = b + a; m.imbn = (tot > 0) ? (b - a)/tot : 0.0;
     return m;
 }
@@ -125,7 +121,11 @@ struct DepthHeatmap {
         const int N = 10;
         for (int side=0; side<2; ++side) {
             const auto& lvls = side==0 ? s.bidLevels : s.askLevels;
-            int n = std::min((int)lvls.size(), N);
+            // Only levels that land inside the plotted price range.
+            const std::size_t visible = side==0
+                ? depth::levelsWithin(s.bidSide(), gateway::QuoteSide::Bid, px_min)
+                : depth::levelsWithin(s.askSide(), gateway::QuoteSide::Ask, px_max);
+            int n = std::min((int)visible, N);
             for (int i=0;i<n;++i) {
                 int row = price_to_row(lvls[i].first);
                 if (row<0) continue;
@@ -192,7 +192,8 @@ static void draw_metrics_and_charts(const OrderBookSnapshot& s, const Metrics& m
                                     HistF& hLat, double tsec)
 {
     ImGui::SeparatorText("Metrics");
-    ImGui::Text("Symbol: %s", s.symbol.c_str());
+    const std::string_view symbol = gateway::symbolName(s.symbolId);
+    ImGui::Text("Symbol: %.*s", (int)symbol.size(), symbol.data());
     ImGui::Text("BestBid: %s%.2f%s   BestAsk: %s%.2f%s",
         isnan_d(s.bestBid)?"(na)":"", isnan_d(s.bestBid)?0.0:s.bestBid, isnan_d(s.bestBid)?"":"",
         isnan_d(s.bestAsk)?"(na)":"", isnan_d(s.bestAsk)?0.0:s.bestAsk, isnan_d(s.bestAsk)?"":"");
@@ -378,7 +379,7 @@ void VisualizerImGui::run() {
         if (ImGui::IsKeyPressed(ImGuiKey_5, false)) setImbalanceLevels(5);
 
         if (!paused) {
-            snap = view_.read();
+            view_.read(snap);
         }
 
         if (!heat_range_set && !std::isnan(snap.bestBid) && !std::isnan(snap.bestAsk)) {
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../../Backtest/include/Backtester.hpp"
+#include "../../Backtest/include/FeedJournal.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    const std::string kMarket = "BT-EUR";
+
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("hft_test_" + name)).string();
+    }
+
+    std::chrono::system_clock::time_point at(std::chrono::nanoseconds offset) {
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(1'700'000'000) + offset));
+    }
+
+    // A book of 99.90 / 100.10; one millisecond later the bid is pulled and an ask appears at 99.90,
+    // through the bid the strategy quotes around the 100.00 mid.
+    void writeCrossingJournal(const std::string& path) {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(path, journal::Wire::Bitvavo, {kMarket}));
+        writer.append(R"({"action":"getBook","response":{"market":"BT-EUR","nonce":1,"bids":[["99.90","1"]],"asks":[["100.10","1"]]}})", at(0ns));
+        writer.append(R"({"event":"book","market":"BT-EUR","nonce":2,"bids":[["99.90","0"]],"asks":[["99.90","1"]]})", at(1ms));
+        writer.close();
+    }
+
+    backtest::BacktestConfig noJitter(std::chrono::nanoseconds order) {
+        backtest::BacktestConfig config;
+        config.latency.marketData = {20us, 0ns};
+        config.latency.order = {order, 0ns};
+        config.latency.report = {50us, 0ns};
+        return config;
+    }
+
+}
+
+TEST(FeedJournal, RoundTripsFramesAndStopsAtATruncatedTail) {
+    const auto path = tempPath("roundtrip.journal");
+    JournalWriter writer;
+    ASSERT_TRUE(writer.open(path, journal::Wire::Fix, {"AAA", "BBB-EUR"}));
+    writer.append("first", at(5ns));
+    writer.append("", at(6ns));
+    writer.append("third frame", at(7ns));
+    writer.close();
+    EXPECT_EQ(writer.frames(), 3u);
+
+    // Chop off the last record's padding and two bytes of its body.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 7);
+
+    JournalFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.wire(), journal::Wire::Fix);
+    EXPECT_EQ(file.markets(), (std::vector<std::string>{"AAA", "BBB-EUR"}));
+
+    std::vector<journal::Frame> frames;
+    journal::Frame f{};
+    for (auto cursor = file.begin(); file.next(cursor, f);) frames.push_back(f);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].bytes, "first");
+    EXPECT_EQ(frames[0].recvNs, journal::toNs(at(5ns)));
+    EXPECT_TRUE(frames[1].bytes.empty());
+    file.close();
+    std::remove(path.c_str());
+}
+
+TEST(Backtester, RestingQuoteIsFilledByTheReplayedBook) {
+    const auto path = tempPath("passive.journal");
+    writeCrossingJournal(path);
+
+    const auto r = backtest::runJournal(path, noJitter(50us));
+    ASSERT_TRUE(r.ok);
+    EXPECT_EQ(r.frames, 2u);
+    EXPECT_EQ(r.simulatedNs, 1'000'000u);
+    EXPECT_GE(r.orders, 2u);
+    EXPECT_EQ(r.omsRefusals, 0u);
+    ASSERT_EQ(r.markets.size(), 1u);
+    const auto& m = r.markets[0];
+    EXPECT_EQ(m.fills, 1u);
+    EXPECT_DOUBLE_EQ(m.position, 0.01);
+    // Our bid was resting, so it traded at its own price, above the 99.90 the ask came in at.
+    EXPECT_GT(-m.cash / 0.01, 99.90 + 1e-9);
+    std::remove(path.c_str());
+}
+
+TEST(Backtester, OrderLatencyDecidesWhoProvidesLiquidity) {
+    const auto path = tempPath("latency.journal");
+    writeCrossingJournal(path);
+
+    // The bid reaches the venue only after the 99.90 ask has arrived and lifts it instead.
+    const auto slow = backtest::runJournal(path, noJitter(5ms));
+    ASSERT_TRUE(slow.ok);
+    ASSERT_EQ(slow.markets.size(), 1u);
+    EXPECT_EQ(slow.markets[0].fills, 1u);
+    EXPECT_NEAR(-slow.markets[0].cash, 0.01 * 99.90, 1e-12);
+
+    // Runs are deterministic, also side by side on separate threads.
+    const auto both = backtest::runJournals({path, path}, noJitter(5ms), 2);
+    ASSERT_EQ(both.size(), 2u);
+    for (const auto& r : both) {
+        ASSERT_TRUE(r.ok);
+        EXPECT_EQ(r.orders, slow.orders);
+        EXPECT_DOUBLE_EQ(r.markets[0].cash, slow.markets[0].cash);
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "Quote.hpp"
+
+// Quote factories shared by the book and strategy tests.
+namespace testutil {
+
+    // One L2 level stamped with the current time; a size of 0 removes the level.
+    inline gateway::Quote level(gateway::SymbolId symbol, double price, double size, gateway::QuoteSide side,
+                                std::uint64_t seq = 0) {
+        return gateway::Quote(price, size, std::chrono::system_clock::now(), symbol, side, seq);
+    }
+
+    inline gateway::Quote level(std::string_view symbol, double price, double size, gateway::QuoteSide side,
+                                std::uint64_t seq = 0) {
+        return level(gateway::internSymbol(symbol), price, size, side, seq);
+    }
+
+    // A level of the BTC-EUR book most tests run on.
+    inline gateway::Quote level(double price, double size, gateway::QuoteSide side) {
+        return level("BTC-EUR", price, size, side);
+    }
+
+} // namespace testutil
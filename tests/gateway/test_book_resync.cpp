@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../GatewayIn/include/BookSync.hpp"
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderBook/include/QuoteConsumer.hpp"
+#include "websocket/MockBitVavoClient.hpp"
+
+using namespace testing;
+using namespace std::chrono_literals;
+using gateway::BookSync;
+using gateway::MockBitvavoClient;
+using gateway::Quote;
+using gateway::QuotesObtainer;
+
+namespace {
+
+    std::string bookUpdate(std::uint64_t nonce, const std::string& side, const std::string& px, const std::string& sz) {
+        return R"({"event":"book","market":"BTC-EUR","nonce":)" + std::to_string(nonce) +
+               R"(,")" + side + R"(":[[")" + px + R"(",")" + sz + R"("]]})";
+    }
+
+    // Stand-in for the Bitvavo endpoint: records getBook requests and answers them on demand.
+    struct FakeBitvavoServer {
+        MockBitvavoClient::MessageHandler onMsg;
+        int getBookRequests = 0;
+
+        void install(MockBitvavoClient& mock) {
+            EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+            EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+            ON_CALL(mock, send(_)).WillByDefault([this](const std::string& payload) {
+                if (payload == R"({"action":"getBook","market":"BTC-EUR"})") ++getBookRequests;
+            });
+        }
+
+        void respondWithBook(std::uint64_t nonce, const std::string& bids, const std::string& asks) {
+            onMsg(R"({"action":"getBook","response":{"market":"BTC-EUR","nonce":)" + std::to_string(nonce) +
+                  R"(,"bids":)" + bids + R"(,"asks":)" + asks + "}}");
+        }
+    };
+
+    template <typename Q>
+    std::vector<Quote> drain(Q& q) {
+        std::vector<Quote> out; Quote tmp;
+        while (q.pop(tmp)) out.push_back(tmp);
+        return out;
+    }
+
+} // namespace
+
+TEST(BookSync, AppliesContiguousNonces) {
+    BookSync sync;
+    EXPECT_EQ(sync.onUpdate("a", 10), BookSync::Action::Apply);
+    EXPECT_EQ(sync.onUpdate("b", 11), BookSync::Action::Apply);
+    EXPECT_EQ(sync.onUpdate("b", 11), BookSync::Action::Drop);
+    EXPECT_EQ(sync.lastNonce(), 11u);
+    EXPECT_EQ(sync.gaps(), 0u);
+}
+
+TEST(BookSync, GapBuffersUntilSnapshotAndReplaysInOrder) {
+    BookSync sync;
+    EXPECT_EQ(sync.onUpdate("n1", 1), BookSync::Action::Apply);
+    EXPECT_EQ(sync.onUpdate("n3", 3), BookSync::Action::RequestSnapshot);
+    EXPECT_EQ(sync.onUpdate("n4", 4), BookSync::Action::Buffer);
+    EXPECT_TRUE(sync.resyncing());
+    EXPECT_EQ(sync.pending(), 2u);
+
+    auto replay = sync.onSnapshot(3);
+    EXPECT_FALSE(sync.resyncing());
+    ASSERT_EQ(replay.size(), 2u);
+    EXPECT_EQ(replay[0], "n3");
+    EXPECT_EQ(replay[1], "n4");
+    EXPECT_EQ(sync.onUpdate(replay[0], 3), BookSync::Action::Drop);
+    EXPECT_EQ(sync.onUpdate(replay[1], 4), BookSync::Action::Apply);
+}
+
+TEST(BookSync, BoundsPendingBuffer) {
+    BookSync sync(2);
+    sync.onUpdate("n1", 1);
+    sync.onUpdate("n5", 5);
+    sync.onUpdate("n6", 6);
+    sync.onUpdate("n7", 7);
+    EXPECT_EQ(sync.pending(), 2u);
+}
+
+TEST(BookSync, OverdueSnapshotIsRequestedOncePerTimeout) {
+    BookSync sync(16, 100ms);
+    const auto t0 = BookSync::Clock::now();
+    EXPECT_FALSE(sync.snapshotOverdue(t0 + 1s));
+
+    sync.onUpdate("n1", 1);
+    EXPECT_EQ(sync.onUpdate("n3", 3), BookSync::Action::RequestSnapshot);
+    sync.snapshotRequested(t0);
+    EXPECT_FALSE(sync.snapshotOverdue(t0 + 50ms));
+    EXPECT_TRUE(sync.snapshotOverdue(t0 + 100ms));
+    EXPECT_FALSE(sync.snapshotOverdue(t0 + 150ms));
+    EXPECT_TRUE(sync.snapshotOverdue(t0 + 200ms));
+    EXPECT_EQ(sync.retries(), 2u);
+
+    sync.onSnapshot(3);
+    EXPECT_FALSE(sync.snapshotOverdue(t0 + 1s));
+}
+
+TEST(BookResync, ErrorReplyIsIgnoredAndSnapshotRequestedAgain) {
+    MockBitvavoClient mock;
+    FakeBitvavoServer server;
+    server.install(mock);
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "BTC-EUR");
+    obt.setSnapshotTimeout(1ms);
+    ASSERT_TRUE(obt.connect());
+
+    server.onMsg(bookUpdate(1, "bids", "100.0", "1.0"));
+    server.onMsg(bookUpdate(3, "bids", "99.5", "1.0"));
+    EXPECT_EQ(server.getBookRequests, 1);
+
+    server.onMsg(R"({"action":"getBook","errorCode":105,"error":"Rate limit exceeded."})");
+    EXPECT_FALSE(obt.snapshotPending());
+    EXPECT_TRUE(obt.bookSync().resyncing());
+
+    std::this_thread::sleep_for(2ms);
+    server.onMsg(bookUpdate(4, "bids", "99.0", "1.0"));
+    EXPECT_EQ(server.getBookRequests, 2);
+    EXPECT_EQ(obt.bookSync().retries(), 1u);
+
+    server.respondWithBook(4, R"([["99.0","1.0"]])", R"([["101.0","1.0"]])");
+    EXPECT_FALSE(obt.bookSync().resyncing());
+    EXPECT_TRUE(obt.snapshotPending());
+}
+
+TEST(BookResync, GapRequestsSnapshotAndReplaysBufferedDeltas) {
+    MockBitvavoClient mock;
+    FakeBitvavoServer server;
+    server.install(mock);
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "BTC-EUR");
+    ASSERT_TRUE(obt.connect());
+
+    server.onMsg(bookUpdate(1, "bids", "100.0", "1.0"));
+    server.onMsg(bookUpdate(4, "bids", "100.0", "0"));
+    server.onMsg(bookUpdate(5, "bids", "99.5", "3.0"));
+    EXPECT_EQ(server.getBookRequests, 1);
+    EXPECT_TRUE(obt.bookSync().resyncing());
+    EXPECT_EQ(drain(obt.getBidQueue()).size(), 1u);
+
+    server.respondWithBook(4, R"([["99.0","2.0"]])", R"([["101.0","1.0"]])");
+    EXPECT_FALSE(obt.bookSync().resyncing());
+
+    ASSERT_TRUE(obt.snapshotPending());
+    auto snap = obt.takeSnapshot();
+    ASSERT_TRUE(snap.has_value());
+    EXPECT_EQ(snap->sequence, 4u);
+    EXPECT_EQ(snap->levels.size(), 2u);
+    EXPECT_FALSE(obt.snapshotPending());
+
+    auto replayed = drain(obt.getBidQueue());
+    ASSERT_EQ(replayed.size(), 1u);
+    EXPECT_EQ(replayed[0].getSequence(), 5u);
+    EXPECT_DOUBLE_EQ(replayed[0].getPrice(), 99.5);
+}
+
+TEST(BookResync, ConsumerRebuildsBookFromSnapshot) {
+    MockBitvavoClient mock;
+    FakeBitvavoServer server;
+    server.install(mock);
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "BTC-EUR");
+    ASSERT_TRUE(obt.connect());
+
+    QuoteConsumer consumer{ std::tie(obt), "BTC-EUR" };
+    consumer.start();
+
+    server.onMsg(bookUpdate(1, "bids", "100.0", "1.0"));
+    server.onMsg(bookUpdate(2, "asks", "102.0", "1.0"));
+    std::this_thread::sleep_for(2ms);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook().bestBid(), 100.0);
+
+    server.onMsg(bookUpdate(6, "bids", "99.5", "3.0"));
+    server.onMsg(bookUpdate(7, "asks", "101.5", "0.5"));
+    server.respondWithBook(5, R"([["99.0","2.0"],["98.0","1.0"]])", R"([["101.0","1.0"]])");
+    std::this_thread::sleep_for(3ms);
+    consumer.stop();
+
+    const auto& book = consumer.getOrderBook();
+    EXPECT_DOUBLE_EQ(book.bestBid(), 99.5);
+    EXPECT_DOUBLE_EQ(book.bestAsk(), 101.0);
+    EXPECT_EQ(book.bids().size(), 3u);
+    EXPECT_EQ(book.asks().size(), 2u);
+    EXPECT_EQ(book.bids().count(100.0), 0u);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string_view>
+
+#include "../../GatewayIn/include/FeedArbiter.hpp"
+#include "../../GatewayIn/include/Quote.hpp"
+
+using gateway::FeedArbiter;
+using gateway::Quote;
+using gateway::QuoteSide;
+using namespace std::chrono_literals;
+
+namespace {
+
+    const auto T0 = std::chrono::system_clock::time_point{} + 1h;
+
+    Quote bid(std::uint64_t seq, std::chrono::system_clock::time_point ts, double px = 100.0,
+              std::string_view symbol = "BTC-EUR") {
+        return Quote(px, 1.0, ts, gateway::internSymbol(symbol), QuoteSide::Bid, seq);
+    }
+
+} // namespace
+
+TEST(FeedArbiter, ForwardsFirstCopyAndDropsLaterOne) {
+    FeedArbiter<2> arb;
+    EXPECT_TRUE(arb.accept(0, bid(10, T0)));
+    EXPECT_FALSE(arb.accept(1, bid(10, T0 + 5us)));
+
+    EXPECT_EQ(arb.stats(0).wins, 1u);
+    EXPECT_EQ(arb.stats(1).wins, 0u);
+    EXPECT_EQ(arb.stats(1).duplicates, 1u);
+    EXPECT_EQ(arb.stats(1).maxLag, 5us);
+}
+
+TEST(FeedArbiter, FastestFeedWinsPerSequence) {
+    FeedArbiter<2> arb;
+    EXPECT_TRUE(arb.accept(1, bid(1, T0)));
+    EXPECT_FALSE(arb.accept(0, bid(1, T0 + 2us)));
+    EXPECT_TRUE(arb.accept(0, bid(2, T0 + 3us)));
+    EXPECT_FALSE(arb.accept(1, bid(2, T0 + 7us)));
+
+    EXPECT_DOUBLE_EQ(arb.stats(0).winRate(), 0.5);
+    EXPECT_DOUBLE_EQ(arb.stats(1).winRate(), 0.5);
+    EXPECT_EQ(arb.stats(1).avgLag(), 4us);
+}
+
+TEST(FeedArbiter, ForwardsEveryLevelOfTheWinningFrame) {
+    FeedArbiter<2> arb;
+    EXPECT_TRUE(arb.accept(0, bid(5, T0, 100.0)));
+    EXPECT_TRUE(arb.accept(0, bid(5, T0, 99.5)));
+    EXPECT_FALSE(arb.accept(1, bid(5, T0 + 1us, 100.0)));
+    EXPECT_FALSE(arb.accept(1, bid(5, T0 + 1us, 99.5)));
+}
+
+TEST(FeedArbiter, ToleratesReorderingWithinWindow) {
+    FeedArbiter<1> arb;
+    EXPECT_TRUE(arb.accept(0, bid(3, T0)));
+    EXPECT_TRUE(arb.accept(0, bid(2, T0)));
+    EXPECT_TRUE(arb.accept(0, bid(4, T0)));
+}
+
+TEST(FeedArbiter, DropsSequencesOlderThanWindow) {
+    FeedArbiter<2, 8> arb;
+    EXPECT_TRUE(arb.accept(0, bid(9, T0)));
+    EXPECT_FALSE(arb.accept(1, bid(1, T0)));
+    EXPECT_EQ(arb.stats(1).stale, 1u);
+}
+
+TEST(FeedArbiter, BusyBookDoesNotEvictAnotherBooksWinner) {
+    FeedArbiter<2, 8> arb;
+    EXPECT_TRUE(arb.accept(0, bid(1, T0, 100.0, "BTC-EUR")));
+    for (std::uint64_t seq = 1; seq <= 8; ++seq) {
+        EXPECT_TRUE(arb.accept(0, bid(seq, T0, 2000.0, "ETH-EUR")));
+    }
+    EXPECT_FALSE(arb.accept(1, bid(1, T0 + 3us, 100.0, "BTC-EUR")));
+    for (std::uint64_t seq = 1; seq <= 8; ++seq) {
+        EXPECT_FALSE(arb.accept(1, bid(seq, T0 + 3us, 2000.0, "ETH-EUR")));
+    }
+    EXPECT_EQ(arb.stats(0).wins, 9u);
+    EXPECT_EQ(arb.stats(1).duplicates, 9u);
+}
+
+TEST(FeedArbiter, UnsequencedQuotesAlwaysPass) {
+    FeedArbiter<2> arb;
+    EXPECT_TRUE(arb.accept(0, bid(0, T0)));
+    EXPECT_TRUE(arb.accept(1, bid(0, T0)));
+    EXPECT_EQ(arb.stats(0).unsequenced, 1u);
+    EXPECT_EQ(arb.stats(1).unsequenced, 1u);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../../GatewayIn/include/FeedSupervisor.hpp"
+
+using namespace std::chrono_literals;
+using gateway::FeedHooks;
+using gateway::FeedState;
+using gateway::FeedSupervisor;
+using gateway::SupervisorPolicy;
+
+namespace {
+
+    // Stands in for a feed: refuses the first few connects and counts calls.
+    struct FakeFeed {
+        std::atomic<int> failFirst{0};
+        std::atomic<int> connects{0};
+        std::atomic<int> disconnects{0};
+        std::atomic<bool> up{false};
+        std::atomic<std::uint64_t> frames{0};
+
+        FeedHooks hooks() {
+            return FeedHooks{
+                [this] {
+                    if (connects.fetch_add(1) < failFirst) return false;
+                    up = true;
+                    return true;
+                },
+                [this] { up = false; ++disconnects; },
+                [this] { return frames.load(); }};
+        }
+    };
+
+    SupervisorPolicy fast() {
+        SupervisorPolicy p;
+        p.baseBackoff = 5ms;
+        p.maxBackoff = 20ms;
+        p.maxJitter = 0ms;
+        p.healthInterval = 5ms;
+        return p;
+    }
+
+    template<class Pred>
+    bool waitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+}
+
+TEST(FeedSupervisor, BacksOffUntilTheFeedConnects) {
+    FakeFeed feed;
+    feed.failFirst = 3;
+    FeedSupervisor supervisor(false);
+    const auto id = supervisor.watch("fake", feed.hooks(), fast());
+    supervisor.start();
+
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).state == FeedState::Up; }));
+    const auto s = supervisor.stats(id);
+    EXPECT_EQ(s.attempts, 4u);
+    EXPECT_EQ(s.connects, 1u);
+    EXPECT_EQ(s.losses, 0u);
+    EXPECT_TRUE(feed.up);
+
+    supervisor.stop();
+    EXPECT_FALSE(feed.up);
+    EXPECT_EQ(supervisor.stats(id).state, FeedState::Stopped);
+}
+
+TEST(FeedSupervisor, ReconnectsWhenTheFeedReportsItsConnectionLost) {
+    FakeFeed feed;
+    FeedSupervisor supervisor(false);
+    auto policy = fast();
+    policy.healthInterval = 10s;   // the report alone has to wake the coroutine
+    const auto id = supervisor.watch("fake", feed.hooks(), policy);
+    supervisor.start();
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).state == FeedState::Up; }));
+
+    supervisor.reportLost(id, "socket closed");
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).connects == 2; }));
+    EXPECT_EQ(supervisor.stats(id).losses, 1u);
+    EXPECT_EQ(feed.disconnects, 1);
+    supervisor.stop();
+}
+
+TEST(FeedSupervisor, ReconnectsASilentFeed) {
+    FakeFeed feed;
+    FeedSupervisor supervisor(false);
+    auto policy = fast();
+    policy.staleAfter = 30ms;
+    const auto id = supervisor.watch("fake", feed.hooks(), policy);
+    supervisor.start();
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).state == FeedState::Up; }));
+
+    // Frames keep arriving: no reconnect.
+    for (int i = 0; i < 20; ++i) {
+        ++feed.frames;
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_EQ(supervisor.stats(id).connects, 1u);
+
+    // Then nothing.
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).connects >= 2; }));
+    EXPECT_GE(supervisor.stats(id).losses, 1u);
+    supervisor.stop();
+}
+
+TEST(FeedSupervisor, GivesUpAfterMaxAttempts) {
+    FakeFeed feed;
+    feed.failFirst = 1000;
+    FeedSupervisor supervisor(false);
+    auto policy = fast();
+    policy.maxAttempts = 3;
+    const auto id = supervisor.watch("fake", feed.hooks(), policy);
+    supervisor.start();
+
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(id).state == FeedState::Failed; }));
+    EXPECT_EQ(supervisor.stats(id).attempts, 3u);
+    EXPECT_EQ(feed.connects, 3);
+    supervisor.stop();
+}
+
+TEST(FeedSupervisor, StopCancelsPendingBackoffPromptly) {
+    FakeFeed down, live;
+    down.failFirst = 1000;
+    FeedSupervisor supervisor(false);
+    auto slow = fast();
+    slow.baseBackoff = 60s;
+    slow.maxBackoff = 60s;
+    const auto a = supervisor.watch("down", down.hooks(), slow);
+    const auto b = supervisor.watch("live", live.hooks(), slow);
+    supervisor.start();
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(a).state == FeedState::Backoff; }));
+    ASSERT_TRUE(waitFor([&] { return supervisor.stats(b).state == FeedState::Up; }));
+
+    const auto begin = std::chrono::steady_clock::now();
+    supervisor.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 1s);
+    EXPECT_EQ(supervisor.stats(a).state, FeedState::Stopped);
+    EXPECT_EQ(supervisor.stats(b).state, FeedState::Stopped);
+    EXPECT_EQ(down.disconnects, 0);
+    EXPECT_EQ(live.disconnects, 1);
+    EXPECT_FALSE(live.up);
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "../../GatewayIn/include/tcp/FixSession.hpp"
+
+using namespace std::chrono_literals;
+using gateway::FixSequenceStore;
+using gateway::FixSession;
+using gateway::FixSessionConfig;
+using Inbound = gateway::FixSession::Inbound;
+
+namespace {
+
+    std::string tempPath(const char* name) {
+        return "/tmp/" + std::string(name) + "-" + std::to_string(::getpid()) + ".seq";
+    }
+
+    // Inbound message from the counterparty; the session does not check BodyLength or CheckSum.
+    std::string inbound(std::string_view type, std::uint64_t seq, std::string_view fields = {}) {
+        std::string m = "8=FIX.4.4\x01" "9=0\x01" "35=";
+        m += type;
+        m += "\x01" "49=FIXSIM-SERVER-MKD\x01" "56=FIXSIM-CLIENT-MKD\x01" "34=";
+        m += std::to_string(seq);
+        m += "\x01" "52=20260101-00:00:00.000\x01";
+        m += fields;
+        m += "10=000\x01";
+        return m;
+    }
+
+    std::string field(std::string_view m, std::string_view tag) {
+        const std::string key = "\x01" + std::string(tag) + "=";
+        const auto pos = m.find(key);
+        if (pos == std::string_view::npos) return {};
+        const auto start = pos + key.size();
+        return std::string(m.substr(start, m.find('\x01', start) - start));
+    }
+
+    struct Wire {
+        std::vector<std::string> sent;
+        std::vector<std::string> fatal;
+        int logons = 0;
+
+        void attach(FixSession& s) {
+            s.setWriter([this](std::string_view m, bool) { sent.emplace_back(m); return true; });
+            s.setLogonHandler([this] { ++logons; });
+            s.setFatalHandler([this](std::string_view r) { fatal.emplace_back(r); });
+        }
+        std::size_t count(std::string_view type) const {
+            std::size_t n = 0;
+            for (const auto& m : sent) n += field(m, "35") == type;
+            return n;
+        }
+    };
+
+    void logOn(FixSession& s, Wire& w, FixSession::Clock::time_point now) {
+        s.logon();
+        ASSERT_EQ(s.onMessage(inbound("A", 1, "98=0\x01" "108=30\x01")), Inbound::Consumed);
+        s.poll(now);
+        ASSERT_TRUE(s.loggedOn());
+        ASSERT_EQ(w.logons, 1);
+    }
+
+}
+
+TEST(FixSequenceStore, PersistsAcrossReopen) {
+    const auto path = tempPath("fix-store");
+    std::remove(path.c_str());
+    {
+        FixSequenceStore store;
+        ASSERT_TRUE(store.open(path));
+        EXPECT_TRUE(store.persistent());
+        EXPECT_EQ(store.takeOutgoing(), 1u);
+        EXPECT_EQ(store.takeOutgoing(), 2u);
+        store.setNextIncoming(42);
+    }
+    FixSequenceStore store;
+    ASSERT_TRUE(store.open(path));
+    EXPECT_EQ(store.nextOutgoing(), 3u);
+    EXPECT_EQ(store.nextIncoming(), 42u);
+    store.close();
+    EXPECT_FALSE(store.persistent());
+    EXPECT_EQ(store.nextOutgoing(), 3u);   // carries on in memory
+    std::remove(path.c_str());
+}
+
+TEST(FixSession, ValidatesSequenceAndAnswersAdminOffTheDataPath) {
+    FixSession session;
+    Wire wire;
+    wire.attach(session);
+    const auto t0 = FixSession::Clock::now();
+    logOn(session, wire, t0);
+    EXPECT_EQ(field(wire.sent[0], "35"), "A");
+    EXPECT_EQ(field(wire.sent[0], "108"), "30");
+
+    EXPECT_EQ(session.onMessage(inbound("X", 2)), Inbound::Deliver);
+    EXPECT_EQ(session.onMessage(inbound("1", 3, "112=PING\x01")), Inbound::Consumed);
+    // Nothing is written on the receive thread; the Heartbeat goes out from poll().
+    EXPECT_EQ(wire.count("0"), 0u);
+    session.poll(t0);
+    ASSERT_EQ(wire.count("0"), 1u);
+    EXPECT_EQ(field(wire.sent.back(), "112"), "PING");
+    EXPECT_EQ(session.nextIncoming(), 4u);
+
+    // Outgoing MsgSeqNum runs on without gaps or repeats.
+    for (std::size_t i = 0; i < wire.sent.size(); ++i) EXPECT_EQ(field(wire.sent[i], "34"), std::to_string(i + 1));
+}
+
+TEST(FixSession, GapTriggersOneResendRequestAndTheReplayFillsIt) {
+    FixSession session;
+    Wire wire;
+    wire.attach(session);
+    const auto t0 = FixSession::Clock::now();
+    logOn(session, wire, t0);
+
+    EXPECT_EQ(session.onMessage(inbound("X", 2)), Inbound::Deliver);
+    EXPECT_EQ(session.onMessage(inbound("X", 5)), Inbound::Consumed);
+    EXPECT_EQ(session.onMessage(inbound("X", 6)), Inbound::Consumed);
+    session.poll(t0);
+    ASSERT_EQ(wire.count("2"), 1u);
+    EXPECT_EQ(field(wire.sent.back(), "7"), "3");
+    EXPECT_EQ(field(wire.sent.back(), "16"), "0");
+    EXPECT_EQ(session.gaps(), 1u);
+
+    // Replay: 3 as PossDup, then a gap fill over 4..5, then 6 again.
+    EXPECT_EQ(session.onMessage(inbound("X", 3, "43=Y\x01")), Inbound::Deliver);
+    EXPECT_EQ(session.onMessage(inbound("4", 4, "43=Y\x01" "123=Y\x01" "36=6\x01")), Inbound::Consumed);
+    EXPECT_EQ(session.onMessage(inbound("X", 6, "43=Y\x01")), Inbound::Deliver);
+    EXPECT_EQ(session.nextIncoming(), 7u);
+    // A duplicate that was already applied is dropped.
+    EXPECT_EQ(session.onMessage(inbound("X", 3, "43=Y\x01")), Inbound::Consumed);
+    EXPECT_EQ(session.duplicates(), 1u);
+
+    // The gap is closed: no second request when the timer runs.
+    session.poll(t0 + 60s);
+    EXPECT_EQ(wire.count("2"), 1u);
+    EXPECT_TRUE(wire.fatal.empty());
+}
+
+TEST(FixSession, LowSequenceWithoutPossDupLogsOut) {
+    FixSession session;
+    Wire wire;
+    wire.attach(session);
+    const auto t0 = FixSession::Clock::now();
+    logOn(session, wire, t0);
+
+    EXPECT_EQ(session.onMessage(inbound("X", 2)), Inbound::Deliver);
+    EXPECT_EQ(session.onMessage(inbound("X", 2)), Inbound::Disconnect);
+    session.poll(t0);
+    ASSERT_EQ(wire.count("5"), 1u);
+    EXPECT_NE(field(wire.sent.back(), "58").find("too low"), std::string::npos);
+    ASSERT_EQ(wire.fatal.size(), 1u);
+    EXPECT_FALSE(session.loggedOn());
+
+    // The counterparty's answering Logout does not end the session a second time.
+    EXPECT_EQ(session.onMessage(inbound("5", 3)), Inbound::Consumed);
+    session.poll(t0);
+    EXPECT_EQ(wire.fatal.size(), 1u);
+    EXPECT_EQ(wire.count("5"), 1u);
+}
+
+TEST(FixSession, AnswersResendRequestWithGapFillAndHonoursResets) {
+    FixSession session;
+    Wire wire;
+    wire.attach(session);
+    const auto t0 = FixSession::Clock::now();
+    logOn(session, wire, t0);
+    session.send("V", "262=req-1\x01");
+
+    EXPECT_EQ(session.onMessage(inbound("2", 2, "7=1\x01" "16=0\x01")), Inbound::Consumed);
+    session.poll(t0);
+    const auto& fill = wire.sent.back();
+    EXPECT_EQ(field(fill, "35"), "4");
+    EXPECT_EQ(field(fill, "34"), "1");
+    EXPECT_EQ(field(fill, "43"), "Y");
+    EXPECT_EQ(field(fill, "123"), "Y");
+    EXPECT_EQ(field(fill, "36"), "3");
+    EXPECT_EQ(session.nextOutgoing(), 3u);   // the gap fill reuses old numbers
+
+    // Reset mode moves ahead regardless of MsgSeqNum.
+    EXPECT_EQ(session.onMessage(inbound("4", 1, "36=100\x01")), Inbound::Consumed);
+    EXPECT_EQ(session.nextIncoming(), 100u);
+    EXPECT_EQ(session.onMessage(inbound("X", 100)), Inbound::Deliver);
+
+    // A Logon with ResetSeqNumFlag starts the counterparty over.
+    EXPECT_EQ(session.onMessage(inbound("A", 1, "108=10\x01" "141=Y\x01")), Inbound::Consumed);
+    EXPECT_EQ(session.nextIncoming(), 2u);
+    EXPECT_EQ(session.heartbeatInterval(), 10s);
+    EXPECT_TRUE(wire.fatal.empty());
+}
+
+TEST(FixSession, HeartbeatAndTestRequestTimers) {
+    FixSession session;
+    Wire wire;
+    wire.attach(session);
+    const auto t0 = FixSession::Clock::now();
+    logOn(session, wire, t0);
+
+    session.poll(t0 + 29s);
+    EXPECT_EQ(wire.count("0"), 0u);
+    session.poll(t0 + 30s);
+    EXPECT_EQ(wire.count("0"), 1u);
+    EXPECT_EQ(wire.count("1"), 0u);
+
+    // Inbound silence past the interval plus slack: TestRequest, then give up.
+    session.poll(t0 + 36s);
+    ASSERT_EQ(wire.count("1"), 1u);
+    const auto id = field(wire.sent.back(), "112");
+    EXPECT_FALSE(id.empty());
+
+    // An answer resets the watchdog.
+    EXPECT_EQ(session.onMessage(inbound("0", 2, "112=" + id + "\x01")), Inbound::Consumed);
+    session.poll(t0 + 40s);
+    session.poll(t0 + 70s);
+    EXPECT_TRUE(wire.fatal.empty());
+
+    session.poll(t0 + 77s);
+    EXPECT_EQ(wire.count("1"), 2u);
+    session.poll(t0 + 107s);
+    ASSERT_EQ(wire.fatal.size(), 1u);
+    EXPECT_EQ(wire.count("5"), 1u);
+    EXPECT_EQ(session.testRequests(), 2u);
+}
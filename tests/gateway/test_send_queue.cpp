@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../GatewayIn/include/SendQueue.hpp"
+
+using namespace std::chrono_literals;
+using gateway::SendOptions;
+using gateway::SendQueue;
+using gateway::SendRing;
+
+namespace {
+
+    std::string message(std::size_t i) {
+        return "8=FIX.4.4\x01" "34=" + std::to_string(i) + "\x01" + std::string(i % 97, 'x') + "\x01";
+    }
+
+    // Connected stream pair; writes on the first end never block.
+    struct SocketPair {
+        int fd[2]{-1, -1};
+        SocketPair() {
+            ::socketpair(AF_UNIX, SOCK_STREAM, 0, fd);
+            ::fcntl(fd[0], F_SETFL, ::fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+        }
+        ~SocketPair() { ::close(fd[0]); ::close(fd[1]); }
+
+        SendQueue::BatchWriter writer() const {
+            return [fd = fd[0]](const iovec* iov, std::size_t n) -> long {
+                msghdr msg{};
+                msg.msg_iov = const_cast<iovec*>(iov);
+                msg.msg_iovlen = n;
+                const auto r = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+                if (r >= 0) return r;
+                return errno == EAGAIN ? 0 : -1;
+            };
+        }
+
+        std::string read(std::size_t bytes) const {
+            std::string out;
+            char buf[4096];
+            const auto deadline = std::chrono::steady_clock::now() + 5s;
+            while (out.size() < bytes && std::chrono::steady_clock::now() < deadline) {
+                const auto n = ::recv(fd[1], buf, std::min(sizeof(buf), bytes - out.size()), MSG_DONTWAIT);
+                if (n > 0) out.append(buf, static_cast<std::size_t>(n));
+                else std::this_thread::sleep_for(100us);
+            }
+            return out;
+        }
+    };
+
+}
+
+TEST(SendRing, WrapsAndResumesPartialWritesInOrder) {
+    SendRing ring(4096);
+    std::mt19937 rng(7);
+    std::string expected, written;
+    std::size_t next = 0;
+
+    for (int round = 0; round < 2000; ++round) {
+        while (ring.push(message(next))) expected += message(next++);
+        iovec iov[8];
+        const auto n = ring.gather(iov, 8);
+        ASSERT_GT(n, 0u);
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < n; ++i) total += iov[i].iov_len;
+        // The transport takes an arbitrary prefix of the batch.
+        auto take = std::uniform_int_distribution<std::size_t>(0, total)(rng);
+        const auto taken = take;
+        for (std::size_t i = 0; i < n && take > 0; ++i) {
+            const auto part = std::min(take, iov[i].iov_len);
+            written.append(static_cast<const char*>(iov[i].iov_base), part);
+            take -= part;
+        }
+        ring.consume(taken);
+    }
+    ASSERT_GT(next, 1000u);
+    EXPECT_EQ(written, expected.substr(0, written.size()));
+    EXPECT_EQ(ring.queuedBytes() > 0, written.size() < expected.size());
+    EXPECT_GT(ring.latency().count(), 0u);
+}
+
+TEST(SendQueue, DrainStepCoalescesABurstIntoOneWrite) {
+    SocketPair pair;
+    SendQueue queue({.senderThread = false});
+    queue.start(pair.writer());
+
+    std::string expected;
+    for (std::size_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue.push(message(i)));
+        expected += message(i);
+    }
+    EXPECT_EQ(queue.stats().depth, 10u);
+    EXPECT_EQ(queue.drain(), expected.size());
+    EXPECT_EQ(pair.read(expected.size()), expected);
+
+    const auto s = queue.stats();
+    EXPECT_EQ(s.writes, 1u);
+    EXPECT_EQ(s.maxBatch, 10u);
+    EXPECT_EQ(s.sent, 10u);
+    EXPECT_EQ(s.depth, 0u);
+    EXPECT_EQ(s.maxDepth, 10u);
+    EXPECT_EQ(queue.latency().count(), 10u);
+}
+
+TEST(SendQueue, SenderThreadRidesOutAFullSocketWithoutBlockingTheProducer) {
+    SocketPair pair;
+    const int small = 4096;
+    ::setsockopt(pair.fd[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    SendQueue queue({.ringBytes = 1 << 22});
+    queue.start(pair.writer());
+
+    // Nobody reads yet: the socket fills up and the rest waits in the ring.
+    std::string expected;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < 20000; ++i) {
+        ASSERT_TRUE(queue.push(message(i)));
+        expected += message(i);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 1s);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_GT(queue.stats().depth, 0u);
+    EXPECT_GT(queue.stats().wouldBlock, 0u);
+
+    EXPECT_EQ(pair.read(expected.size()), expected);
+    queue.stop();
+    const auto s = queue.stats();
+    EXPECT_EQ(s.sent, 20000u);
+    EXPECT_EQ(s.dropped, 0u);
+    EXPECT_GT(s.maxBatch, 1u);
+}
+
+TEST(SendQueue, CriticalMessagesBypassOnlyAnEmptyQueue) {
+    SocketPair pair;
+    SendQueue queue({.senderThread = false});
+    queue.start(pair.writer());
+
+    ASSERT_TRUE(queue.pushCritical("cancel-1;"));
+    EXPECT_EQ(queue.stats().direct, 1u);
+    EXPECT_EQ(pair.read(9), "cancel-1;");
+
+    // With something queued the critical message takes its place behind it.
+    ASSERT_TRUE(queue.push("new-1;"));
+    ASSERT_TRUE(queue.pushCritical("cancel-2;"));
+    EXPECT_EQ(queue.stats().direct, 1u);
+    queue.drain();
+    EXPECT_EQ(pair.read(15), "new-1;cancel-2;");
+}
+
+TEST(SendQueue, FullRingRejectsAndDisconnectDropsTheBacklog) {
+    SendQueue queue({.ringBytes = 4096, .senderThread = false});
+    queue.start([](const iovec*, std::size_t) -> long { return 0; });
+    std::size_t accepted = 0;
+    while (queue.push(std::string(200, 'x'))) ++accepted;
+    EXPECT_GT(accepted, 10u);
+    EXPECT_EQ(queue.stats().rejected, 1u);
+    queue.drain();
+    EXPECT_EQ(queue.stats().wouldBlock, 1u);
+
+    queue.stop();
+    EXPECT_EQ(queue.stats().dropped, accepted);
+    EXPECT_EQ(queue.stats().depth, 0u);
+    EXPECT_EQ(queue.queuedBytes(), 0u);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../GatewayIn/include/SymbolRouter.hpp"
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderBook/include/QuoteConsumer.hpp"
+#include "websocket/MockBitVavoClient.hpp"
+#include "tcp/MockFixNetworkClient.hpp"
+
+using namespace testing;
+using namespace std::chrono_literals;
+using gateway::MockBitvavoClient;
+using gateway::MockFixNetworkClient;
+using gateway::Quote;
+using gateway::QuotesObtainer;
+using gateway::SymbolRouter;
+
+namespace {
+
+    template <typename Q>
+    std::vector<Quote> drain(Q& q) {
+        std::vector<Quote> out; Quote tmp;
+        while (q.pop(tmp)) out.push_back(tmp);
+        return out;
+    }
+
+    const std::vector<std::string> kMarkets{"BTC-EUR", "ETH-EUR", "SOL-EUR"};
+
+} // namespace
+
+TEST(SymbolRouter, AssignsDenseSlotsInSubscriptionOrder) {
+    SymbolRouter router;
+    EXPECT_EQ(router.add("ETH-EUR"), 0u);
+    EXPECT_EQ(router.add("BTC-EUR"), 1u);
+    EXPECT_EQ(router.add("ETH-EUR"), 0u);
+    EXPECT_EQ(router.size(), 2u);
+
+    auto route = router.route("BTC-EUR");
+    ASSERT_TRUE(route.has_value());
+    EXPECT_EQ(route->slot, 1u);
+    EXPECT_EQ(route->symbol, gateway::internSymbol("BTC-EUR"));
+    EXPECT_FALSE(router.route("XRP-EUR").has_value());
+    EXPECT_EQ(router.name(0), "ETH-EUR");
+}
+
+TEST(SymbolRouter, BitvavoSubscribesAllMarketsInOneFrame) {
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+    EXPECT_CALL(mock, send(R"({"action":"subscribe","channels":[{"name":"book","markets":["BTC-EUR","ETH-EUR","SOL-EUR"]}]})"))
+            .Times(1);
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", kMarkets);
+    ASSERT_TRUE(obt.connect());
+
+    onMsg(R"({"event":"book","market":"SOL-EUR","nonce":1,"bids":[["150.1","2"]]})");
+    onMsg(R"({"event":"book","market":"BTC-EUR","nonce":7,"bids":[["60000","0.5"]]})");
+    onMsg(R"({"event":"book","market":"DOGE-EUR","nonce":3,"bids":[["0.1","100"]]})");
+
+    auto bids = drain(obt.getBidQueue());
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_EQ(bids[0].getSymbolId(), gateway::internSymbol("SOL-EUR"));
+    EXPECT_EQ(bids[0].getSymbol(), "SOL-EUR");
+    EXPECT_EQ(bids[1].getSymbolId(), gateway::internSymbol("BTC-EUR"));
+    EXPECT_EQ(bids[1].getSymbol(), "BTC-EUR");
+}
+
+TEST(SymbolRouter, FixQuotesAreTaggedWithSymbolId) {
+    MockFixNetworkClient mock;
+    MockFixNetworkClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+
+    QuotesObtainer<MockFixNetworkClient> obt(std::move(mock), "127.0.0.1", "9999", kMarkets);
+
+    const char SOH = '\x01';
+    std::string msg = std::string("8=FIX.4.4") + SOH + "35=X" + SOH + "55=ETH-EUR" + SOH + "268=1" + SOH +
+                      "269=1" + SOH + "270=2500.5" + SOH + "271=1.5" + SOH;
+    onMsg(msg);
+
+    auto asks = drain(obt.getAskQueue());
+    ASSERT_EQ(asks.size(), 1u);
+    EXPECT_EQ(asks[0].getSymbolId(), gateway::internSymbol("ETH-EUR"));
+    EXPECT_EQ(asks[0].getSymbol(), "ETH-EUR");
+}
+
+TEST(SymbolRouter, ConsumerMaintainsOneBookPerMarket) {
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", kMarkets);
+    ASSERT_TRUE(obt.connect());
+
+    QuoteConsumer consumer{ std::tie(obt), kMarkets };
+    consumer.start();
+
+    onMsg(R"({"event":"book","market":"BTC-EUR","nonce":1,"bids":[["60000","0.5"]],"asks":[["60010","0.1"]]})");
+    onMsg(R"({"event":"book","market":"ETH-EUR","nonce":1,"bids":[["2500","3"]]})");
+    onMsg(R"({"event":"book","market":"SOL-EUR","nonce":1,"asks":[["151","4"]]})");
+    std::this_thread::sleep_for(3ms);
+    consumer.stop();
+
+    ASSERT_EQ(consumer.bookCount(), 3u);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook(0).bestBid(), 60000.0);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook(0).bestAsk(), 60010.0);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook(1).bestBid(), 2500.0);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook(2).bestAsk(), 151.0);
+    EXPECT_EQ(consumer.symbol(2), "SOL-EUR");
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+#include "../../GatewayIn/include/SymbolTable.hpp"
+#include "../../GatewayIn/include/Quote.hpp"
+
+using gateway::Quote;
+using gateway::QuoteSide;
+using gateway::SymbolTable;
+
+TEST(SymbolTable, InternIsIdempotent) {
+    auto& table = SymbolTable::instance();
+    const auto a = table.intern("ADA-EUR");
+    const auto b = table.intern("ADA-EUR");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(table.name(a), "ADA-EUR");
+    EXPECT_EQ(table.find("ADA-EUR"), std::optional<gateway::SymbolId>(a));
+}
+
+TEST(SymbolTable, DistinctSymbolsGetDistinctIds) {
+    auto& table = SymbolTable::instance();
+    const auto a = table.intern("LINK-EUR");
+    const auto b = table.intern("DOT-EUR");
+    EXPECT_NE(a, b);
+    EXPECT_FALSE(table.find("NOT-LISTED").has_value());
+    EXPECT_TRUE(table.name(static_cast<gateway::SymbolId>(SymbolTable::kMaxSymbols - 1)).empty());
+}
+
+TEST(SymbolTable, QuoteOutlivesTheFrameItWasParsedFrom) {
+    std::string frame = "AVAX-EUR";
+    Quote q(10.0, 2.0, std::chrono::system_clock::now(), gateway::internSymbol(frame), QuoteSide::Ask, 42);
+    frame.assign("xxxxxxxx");
+
+    EXPECT_EQ(q.getSymbol(), "AVAX-EUR");
+    EXPECT_EQ(q.getSequence(), 42u);
+    EXPECT_EQ(q.getSide(), QuoteSide::Ask);
+    EXPECT_EQ(sizeof(Quote), 32u);
+}
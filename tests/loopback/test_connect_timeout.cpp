@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <string>
+
+#include "../../GatewayIn/include/websocket/BitVavoNetworkClient.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    // Accepts TCP connections into its backlog and never answers, like a venue stuck mid-handshake.
+    struct SilentServer {
+        boost::asio::io_context io;
+        boost::asio::ip::tcp::acceptor acceptor{io, {boost::asio::ip::make_address("127.0.0.1"), 0}};
+
+        [[nodiscard]] std::string port() const { return std::to_string(acceptor.local_endpoint().port()); }
+    };
+
+}
+
+TEST(ConnectTimeout, WebSocketHandshakeIsBoundedByConnectTimeout) {
+    SilentServer server;
+    gateway::BitvavoWebSocketClient client;
+    std::string error;
+    client.setErrorHandler([&](std::string_view what) { error = what; });
+    client.setConnectTimeout(200ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(client.connect("127.0.0.1", server.port()));
+    const auto took = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(took, 200ms);
+    EXPECT_LT(took, 2s);
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../../GatewayIn/include/tcp/PixNetworkClient.hpp"
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderSender/include/OrderSender.hpp"
+#include "../../Simulator/include/SimulatorServer.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    template<class Pred>
+    bool waitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+}
+
+TEST(FixSession, SequenceNumbersSurviveReconnectToTheSimulator) {
+    sim::SimulatorServer server;
+    server.addSymbol("SIM-FIX");
+    ASSERT_TRUE(server.start(0, "127.0.0.1"));
+
+    gateway::PixNetworkClient client;
+    client.setSymbols({"SIM-FIX"});
+    client.setMessageHandler([](std::string_view) {});
+
+    ASSERT_TRUE(client.connect("127.0.0.1", std::to_string(server.port())));
+    ASSERT_TRUE(waitFor([&] { return client.session().loggedOn(); }));
+    // Logon and MarketDataRequest.
+    ASSERT_TRUE(waitFor([&] { return client.session().nextOutgoing() == 3; }));
+    client.disconnect();
+    EXPECT_FALSE(client.session().loggedOn());
+
+    // The simulator starts every connection at 1 and says so with 141=Y; ours carry on.
+    ASSERT_TRUE(client.connect("127.0.0.1", std::to_string(server.port())));
+    ASSERT_TRUE(waitFor([&] { return client.session().loggedOn(); }));
+    ASSERT_TRUE(waitFor([&] { return client.session().nextOutgoing() == 5; }));
+    EXPECT_EQ(client.session().nextIncoming(), 2u);
+    EXPECT_EQ(client.session().gaps(), 0u);
+    client.disconnect();
+    server.stop();
+}
+
+TEST(FixSession, OrdersTakeTheSessionsSequenceNumbers) {
+    sim::SimulatorServer server;
+    server.addSymbol("SIM-SEQ");
+    std::mutex mutex;
+    std::vector<std::string> orders;
+    server.tapOrders([&](std::string_view m) {
+        std::lock_guard lock(mutex);
+        orders.emplace_back(m);
+    });
+    ASSERT_TRUE(server.start(0, "127.0.0.1"));
+
+    gateway::PixNetworkClient client;
+    client.setSymbols({"SIM-SEQ"});
+    client.setMessageHandler([](std::string_view) {});
+    ASSERT_TRUE(client.connect("127.0.0.1", std::to_string(server.port())));
+    ASSERT_TRUE(waitFor([&] { return client.session().nextOutgoing() == 3; }));
+
+    OrderSender<gateway::PixNetworkClient> sender(client, {});
+    const auto symbol = gateway::internSymbol("SIM-SEQ");
+    sender.addSymbol(symbol);
+    OrderIntent intent;
+    intent.symbol = symbol;
+    intent.side = gateway::QuoteSide::Bid;
+    intent.clientOrderId = 1;
+    intent.price = 99.0;
+    intent.qty = 1.0;
+    ASSERT_TRUE(sender.send(intent));
+    intent.type = IntentType::Cancel;
+    intent.clientOrderId = 2;
+    intent.origClientOrderId = 1;
+    ASSERT_TRUE(sender.send(intent));
+    EXPECT_EQ(client.session().nextOutgoing(), 5u);
+
+    ASSERT_TRUE(waitFor([&] { std::lock_guard lock(mutex); return orders.size() == 2; }));
+    const auto field = [](std::string_view m, std::string_view tag) {
+        const std::string key = "\x01" + std::string(tag) + "=";
+        const auto start = m.find(key) + key.size();
+        return std::string(m.substr(start, m.find('\x01', start) - start));
+    };
+    // Logon and MarketDataRequest took 1 and 2; the templates zero-pad the slot.
+    EXPECT_EQ(std::stoull(field(orders[0], "34")), 3u);
+    EXPECT_EQ(std::stoull(field(orders[1], "34")), 4u);
+    EXPECT_EQ(field(orders[0], "49"), client.session().config().senderCompId);
+    EXPECT_EQ(field(orders[0], "56"), client.session().config().targetCompId);
+    client.disconnect();
+    server.stop();
+}
+
+TEST(FixSession, ObtainerParsesTheSimulatorFeedAsFix) {
+    static_assert(!gateway::QuotesObtainer<gateway::PixNetworkClient>::kBitvavo);
+    sim::SimulatorServer server;
+    server.addSymbol("SIM-OBT");
+    server.run([](auto& engine) {
+        sim::OrderRequest req;
+        req.owner = sim::kHouse;
+        req.clOrdId = 1;
+        req.symbol = gateway::internSymbol("SIM-OBT");
+        req.side = gateway::QuoteSide::Bid;
+        req.price = 99.5;
+        req.qty = 2.0;
+        engine.newOrder(req);
+    });
+    ASSERT_TRUE(server.start(0, "127.0.0.1"));
+
+    gateway::PixNetworkClient client;
+    gateway::QuotesObtainer<gateway::PixNetworkClient> obt(client, "127.0.0.1", std::to_string(server.port()), "SIM-OBT");
+    ASSERT_TRUE(obt.connect());
+    gateway::Quote q;
+    ASSERT_TRUE(waitFor([&] { return obt.getBidQueue().pop(q); }));
+    EXPECT_EQ(q.getSymbolId(), gateway::internSymbol("SIM-OBT"));
+    EXPECT_DOUBLE_EQ(q.getPrice(), 99.5);
+    EXPECT_DOUBLE_EQ(q.getSize(), 2.0);
+    obt.disconnect();
+    server.stop();
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../GatewayIn/include/tcp/PixNetworkClient.hpp"
+#include "../../OrderSender/include/OrderSender.hpp"
+#include "../../Simulator/include/MatchingEngine.hpp"
+#include "../../Simulator/include/SimulatorServer.hpp"
+
+using namespace gateway;
+using namespace std::chrono_literals;
+
+namespace {
+
+    const SymbolId kSymbol = internSymbol("SIM-EUR");
+
+    sim::OrderRequest order(char type, std::uint64_t id, QuoteSide side, double price, double qty,
+                            std::uint64_t orig = 0, sim::OwnerId owner = 1) {
+        sim::OrderRequest r;
+        r.msgType = type;
+        r.owner = owner;
+        r.clOrdId = id;
+        r.origClOrdId = orig;
+        r.symbol = kSymbol;
+        r.side = side;
+        r.price = price;
+        r.qty = qty;
+        return r;
+    }
+
+    template<class Pred>
+    bool waitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+}
+
+TEST(SimulatorServer, ServesTheFixGatewayOverLoopback) {
+    sim::SimulatorServer server;
+    server.addSymbol("SIM-EUR");
+    server.run([](auto& engine) {
+        engine.submit(order('D', 1000, QuoteSide::Bid, 99.99, 1.0, 0, sim::kHouse));
+        engine.submit(order('D', 1001, QuoteSide::Ask, 100.01, 1.0, 0, sim::kHouse));
+    });
+    ASSERT_TRUE(server.start(0, "127.0.0.1"));
+
+    std::mutex mutex;
+    std::vector<std::string> received;
+    const auto count = [&](std::string_view needle) {
+        std::lock_guard lock(mutex);
+        std::size_t n = 0;
+        for (const auto& m : received) n += m.find(needle) != std::string::npos;
+        return n;
+    };
+
+    PixNetworkClient client;
+    client.setSymbols({"SIM-EUR"});
+    client.setMessageHandler([&](std::string_view m) {
+        std::lock_guard lock(mutex);
+        received.emplace_back(m);
+    });
+    ASSERT_TRUE(client.connect("127.0.0.1", std::to_string(server.port())));
+    ASSERT_TRUE(waitFor([&] { return count("\x01" "35=X\x01") >= 2; }));
+
+    OrderSender<PixNetworkClient> sender(client, {});
+    sender.addSymbol(kSymbol);
+    OrderIntent buy;
+    buy.symbol = kSymbol;
+    buy.side = QuoteSide::Bid;
+    buy.clientOrderId = 1;
+    buy.price = 100.01;
+    buy.qty = 1.0;
+    ASSERT_TRUE(sender.send(buy));
+
+    ASSERT_TRUE(waitFor([&] { return count("\x01" "150=F\x01") >= 1; }));
+    EXPECT_EQ(count("\x01" "150=0\x01"), 1u);
+    EXPECT_EQ(count("\x01" "39=2\x01"), 1u);
+    // The emptied ask level goes out as a delete.
+    EXPECT_TRUE(waitFor([&] { return count("\x01" "279=2\x01") >= 1; }));
+    client.disconnect();
+    server.stop();
+}
@@ -4,12 +4,15 @@
 #include <string>
 #include <string_view>
 
+#include "Wire.hpp"
+
 namespace gateway {
 
 class MockFixNetworkClient {
 public:
     using MessageHandler = std::function<void(std::string_view)>;
     using ErrorHandler   = std::function<void(std::string_view)>;
+    static constexpr Wire kWire = Wire::Fix;
 
     MOCK_METHOD(bool, connect, (const std::string& host, const std::string& port), ());
     MOCK_METHOD(void, disconnect, (), ());
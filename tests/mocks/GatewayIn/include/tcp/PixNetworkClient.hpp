@@ -4,6 +4,8 @@
 #include <string>
 #include <string_view>
 
+#include "Wire.hpp"
+
 namespace gateway {
 
  class PixNetworkClient {
@@ -11,6 +13,7 @@ namespace gateway {
  	using MsgHandler   = std::function<void(std::string_view)>;
  	using MessageHandler = MsgHandler; // compatibility alias for tests
  	using ErrorHandler = std::function<void(std::string_view)>;
+ 	static constexpr Wire kWire = Wire::Fix;
 
 		PixNetworkClient() { s_instance = this; }
 
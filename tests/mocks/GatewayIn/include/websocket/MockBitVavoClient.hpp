@@ -3,12 +3,15 @@
 #include <functional>
 #include <string_view>
 
+#include "Wire.hpp"
+
 namespace gateway {
 
 	class MockBitvavoClient {
 	public:
 		using MessageHandler = std::function<void(std::string_view)>;
 		using ErrorHandler   = std::function<void(std::string_view)>;
+		static constexpr Wire kWire = Wire::Bitvavo;
 
 		MOCK_METHOD(bool, connect, (const std::string& host, const std::string& port), ());
 		MOCK_METHOD(void, disconnect, (), ());
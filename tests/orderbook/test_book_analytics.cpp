@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+namespace {
+    template<class Side>
+    double topN(const Side& side, std::size_t n) {
+        double s = 0.0;
+        for (auto it = side.begin(); it != side.end() && n > 0; ++it, --n) s += it->second.size;
+        return s;
+    }
+
+    template<class Side>
+    SweepCost sweep(const Side& side, double qty) {
+        SweepCost c;
+        for (const auto& [p, lvl] : side) {
+            const double take = std::min(qty - c.quantity, lvl.size);
+            c.quantity += take;
+            c.notional += take * p;
+            if (c.quantity >= qty) { c.complete = true; break; }
+        }
+        return c;
+    }
+}
+
+TEST(BookAnalytics, MicropriceAndImbalanceFromTopLevels) {
+    OrderBook book("BTC-EUR");
+    book.setAnalyticsDepth(2);
+    EXPECT_TRUE(std::isnan(book.microprice()));
+    EXPECT_DOUBLE_EQ(book.imbalance(), 0.0);
+
+    book.update(level(100.0, 3.0, QuoteSide::Bid));
+    book.update(level(99.0, 1.0, QuoteSide::Bid));
+    book.update(level(98.0, 50.0, QuoteSide::Bid));
+    book.update(level(101.0, 1.0, QuoteSide::Ask));
+
+    EXPECT_DOUBLE_EQ(book.microprice(), (100.0 * 1.0 + 101.0 * 3.0) / 4.0);
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 4.0) << "98 is outside the top 2";
+    EXPECT_DOUBLE_EQ(book.bidDepthNotional(), 399.0);
+    EXPECT_DOUBLE_EQ(book.imbalance(), (4.0 - 1.0) / 5.0);
+
+    book.update(level(100.0, 0.0, QuoteSide::Bid));
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 51.0) << "98 moves into the top 2";
+}
+
+TEST(BookAnalytics, SweepCostWalksLevelsAndFlagsThinBooks) {
+    OrderBook book("BTC-EUR");
+    book.setSweepQuantity(3.0);
+    book.update(level(101.0, 1.0, QuoteSide::Ask));
+    EXPECT_FALSE(book.buySweep().complete);
+    EXPECT_DOUBLE_EQ(book.buySweep().quantity, 1.0);
+
+    book.update(level(102.0, 5.0, QuoteSide::Ask));
+    ASSERT_TRUE(book.buySweep().complete);
+    EXPECT_DOUBLE_EQ(book.buySweep().notional, 101.0 + 2 * 102.0);
+    EXPECT_DOUBLE_EQ(book.buySweep().vwap(), (101.0 + 2 * 102.0) / 3.0);
+
+    book.update(level(110.0, 5.0, QuoteSide::Ask));
+    EXPECT_DOUBLE_EQ(book.buySweep().notional, 101.0 + 2 * 102.0) << "level behind the sweep";
+
+    book.update(level(100.5, 1.0, QuoteSide::Ask));
+    EXPECT_DOUBLE_EQ(book.buySweep().notional, 100.5 + 101.0 + 102.0);
+    EXPECT_TRUE(std::isnan(book.sellSweep().vwap()));
+}
+
+TEST(BookAnalytics, RebuildAndDepthChangeRecompute) {
+    OrderBook book("BTC-EUR");
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+    book.rebuild({level(90.0, 2.0, QuoteSide::Bid), level(89.0, 2.0, QuoteSide::Bid), level(91.0, 1.0, QuoteSide::Ask)});
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 4.0);
+
+    book.setAnalyticsDepth(1);
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 2.0);
+    book.setAnalyticsDepth(0);
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 0.0);
+    book.update(level(95.0, 1.0, QuoteSide::Bid));
+    EXPECT_DOUBLE_EQ(book.bidDepth(), 0.0);
+}
+
+TEST(BookAnalytics, IncrementalSignalsMatchRecomputationUnderChurn) {
+    OrderBook book("BTC-EUR");
+    constexpr std::size_t kDepth = 5;
+    book.setAnalyticsDepth(kDepth);
+    book.setSweepQuantity(7.5);
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> tick(0, 60), sz(0, 4);
+    for (int i = 0; i < 30000; ++i) {
+        const int t = tick(rng);
+        book.update(level(1000.0 + t, sz(rng), t < 30 ? QuoteSide::Bid : QuoteSide::Ask));
+
+        ASSERT_NEAR(book.bidDepth(), topN(book.bids(), kDepth), 1e-9) << i;
+        ASSERT_NEAR(book.askDepth(), topN(book.asks(), kDepth), 1e-9) << i;
+        const auto buy = sweep(book.asks(), 7.5);
+        ASSERT_EQ(book.buySweep().complete, buy.complete) << i;
+        ASSERT_NEAR(book.buySweep().notional, buy.notional, 1e-6) << i;
+        const auto sell = sweep(book.bids(), 7.5);
+        ASSERT_NEAR(book.sellSweep().notional, sell.notional, 1e-6) << i;
+    }
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderBook/include/BookCheckpoint.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "../../OrderBook/include/QuoteConsumer.hpp"
+#include "websocket/MockBitVavoClient.hpp"
+#include "TestQuotes.hpp"
+
+using namespace testing;
+using namespace gateway;
+using testutil::level;
+using namespace std::chrono_literals;
+
+namespace {
+
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::string bookUpdate(std::uint64_t nonce, const std::string& side, const std::string& px, const std::string& sz) {
+        return R"({"event":"book","market":"CK-EUR","nonce":)" + std::to_string(nonce) +
+               R"(,")" + side + R"(":[[")" + px + R"(",")" + sz + R"("]]})";
+    }
+
+}
+
+TEST(BookCheckpoint, RoundTripsBooksThroughMappedFile) {
+    OrderBook btc("CK-BTC");
+    btc.update(level("CK-BTC", 100.0, 1.0, QuoteSide::Bid));
+    btc.update(level("CK-BTC", 99.0, 2.0, QuoteSide::Bid));
+    btc.update(level("CK-BTC", 101.0, 3.0, QuoteSide::Ask));
+    OrderBook eth("CK-ETH");
+    eth.update(level("CK-ETH", 10.0, 5.0, QuoteSide::Ask));
+
+    const auto path = tempPath("hft_checkpoint_roundtrip.bin");
+    {
+        CheckpointWriter writer(path);
+        writer.submit({makeBookImage(btc, 42), makeBookImage(eth, 7)});
+        writer.flush();
+        EXPECT_EQ(writer.written(), 1u);
+        EXPECT_EQ(writer.failures(), 0u);
+    }
+
+    CheckpointFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.bookCount(), 2u);
+    const auto* rec = file.find("CK-BTC");
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->sequence, 42u);
+    ASSERT_EQ(rec->bidCount, 2u);
+    EXPECT_DOUBLE_EQ(rec->bids[0].first, 100.0);
+    EXPECT_DOUBLE_EQ(rec->bids[1].second, 2.0);
+    ASSERT_EQ(rec->askCount, 1u);
+    EXPECT_DOUBLE_EQ(rec->asks[0].first, 101.0);
+    EXPECT_EQ(file.find("CK-MISSING"), nullptr);
+
+    OrderBook restored("CK-ETH");
+    restored.rebuild(file.find("CK-ETH")->toSnapshot().levels);
+    EXPECT_DOUBLE_EQ(restored.bestAsk(), 10.0);
+    EXPECT_EQ(restored.bids().size(), 0u);
+
+    file.close();
+    std::remove(path.c_str());
+}
+
+TEST(BookCheckpoint, RejectsCorruptedFile) {
+    OrderBook book("CK-BTC");
+    book.update(level("CK-BTC", 100.0, 1.0, QuoteSide::Bid));
+    const auto path = tempPath("hft_checkpoint_corrupt.bin");
+    ASSERT_TRUE(checkpoint::write(path, {makeBookImage(book, 1)}));
+
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('\x7f');
+    }
+    CheckpointFile file;
+    EXPECT_FALSE(file.open(path));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_FALSE(file.open(tempPath("hft_checkpoint_does_not_exist.bin")));
+    std::remove(path.c_str());
+}
+
+TEST(BookCheckpoint, ConsumerRestoresAndContinuesFromLiveFeed) {
+    const auto path = tempPath("hft_checkpoint_consumer.bin");
+    {
+        OrderBook book("CK-EUR");
+        book.update(level("CK-EUR", 100.0, 1.0, QuoteSide::Bid));
+        book.update(level("CK-EUR", 102.0, 1.0, QuoteSide::Ask));
+        ASSERT_TRUE(checkpoint::write(path, {makeBookImage(book, 50)}));
+    }
+
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    int getBookRequests = 0;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+    ON_CALL(mock, send(_)).WillByDefault([&](const std::string& payload) {
+        if (payload.find("getBook") != std::string::npos) ++getBookRequests;
+    });
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "CK-EUR");
+
+    QuoteConsumer consumer{ std::tie(obt), "CK-EUR" };
+    CheckpointFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(consumer.restore(file), 1u);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook().bestBid(), 100.0);
+    EXPECT_EQ(obt.bookSync().lastNonce(), 50u);
+
+    CheckpointWriter writer(path);
+    consumer.enableCheckpoints(&writer, 1h);
+    ASSERT_TRUE(obt.connect());
+    consumer.start();
+
+    onMsg(bookUpdate(49, "bids", "100.0", "0"));      // older than the checkpoint
+    onMsg(bookUpdate(51, "bids", "100.5", "2.0"));    // continues it
+    std::this_thread::sleep_for(3ms);
+    consumer.stop();
+    writer.flush();
+
+    EXPECT_EQ(getBookRequests, 0);
+    const auto& book = consumer.getOrderBook();
+    EXPECT_DOUBLE_EQ(book.bestBid(), 100.5);
+    EXPECT_EQ(book.bids().size(), 2u);
+    EXPECT_DOUBLE_EQ(book.bestAsk(), 102.0);
+
+    // The checkpoint written on stop() carries the new nonce and level.
+    ASSERT_TRUE(file.open(path));
+    const auto* rec = file.find("CK-EUR");
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->sequence, 51u);
+    EXPECT_EQ(rec->bidCount, 2u);
+    file.close();
+    std::remove(path.c_str());
+}
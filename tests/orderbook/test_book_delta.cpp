@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+TEST(BookDelta, DisabledByDefault) {
+    OrderBook book("BTC-EUR");
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+
+    BookDelta delta;
+    EXPECT_FALSE(book.tracksChanges());
+    EXPECT_FALSE(book.takeDelta(delta));
+}
+
+TEST(BookDelta, FirstDeltaIsResetWithWholeBook) {
+    OrderBook book("BTC-EUR");
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+    book.update(level(101.0, 2.0, QuoteSide::Ask));
+    book.trackChanges(true);
+
+    BookDelta delta;
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_TRUE(delta.reset);
+    EXPECT_TRUE(delta.topOfBookChanged);
+    EXPECT_EQ(delta.changes.size(), 2u);
+
+    EXPECT_FALSE(book.takeDelta(delta)) << "nothing changed since";
+}
+
+TEST(BookDelta, CoalescesRepeatedLevelUpdates) {
+    OrderBook book("BTC-EUR");
+    book.trackChanges(true);
+    BookDelta delta;
+    book.takeDelta(delta);
+
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+    book.update(level(100.0, 3.0, QuoteSide::Bid));
+    book.update(level(99.0, 1.0, QuoteSide::Bid));
+    book.update(level(99.0, 0.0, QuoteSide::Bid));
+    book.update(level(100.0, 5.0, QuoteSide::Ask));
+
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_FALSE(delta.reset);
+    ASSERT_EQ(delta.changes.size(), 3u);
+    EXPECT_DOUBLE_EQ(delta.changes[0].size, 3.0);
+    EXPECT_EQ(delta.changes[1].price, 99.0);
+    EXPECT_EQ(delta.changes[1].size, 0.0) << "a level added and removed is reported as a delete";
+    EXPECT_EQ(delta.changes[2].side, QuoteSide::Ask);
+}
+
+TEST(BookDelta, FlagsTopOfBookOnlyWhenBestLevelMoves) {
+    OrderBook book("BTC-EUR");
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+    book.update(level(101.0, 1.0, QuoteSide::Ask));
+    book.trackChanges(true);
+    BookDelta delta;
+    book.takeDelta(delta);
+
+    book.update(level(98.0, 4.0, QuoteSide::Bid));
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_FALSE(delta.topOfBookChanged);
+
+    book.update(level(100.0, 2.0, QuoteSide::Bid));
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_TRUE(delta.topOfBookChanged) << "size at the best price changed";
+
+    book.update(level(101.0, 0.0, QuoteSide::Ask));
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_TRUE(delta.topOfBookChanged);
+    EXPECT_TRUE(std::isnan(delta.bestAsk));
+}
+
+TEST(BookDelta, RebuildProducesReset) {
+    OrderBook book("BTC-EUR");
+    book.trackChanges(true);
+    BookDelta delta;
+    book.takeDelta(delta);
+
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+    book.rebuild({level(90.0, 1.0, QuoteSide::Bid), level(91.0, 1.0, QuoteSide::Ask)});
+
+    ASSERT_TRUE(book.takeDelta(delta));
+    EXPECT_TRUE(delta.reset);
+    EXPECT_EQ(delta.changes.size(), 2u);
+}
+
+TEST(BookDelta, MirrorTracksBookUnderRandomUpdates) {
+    OrderBook book("BTC-EUR");
+    book.trackChanges(true);
+    BookMirror mirror;
+    BookDelta delta;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> tick(0, 40), sz(0, 3), batch(1, 20);
+    for (int round = 0; round < 500; ++round) {
+        for (int n = batch(rng); n > 0; --n) {
+            const int t = tick(rng);
+            const auto side = t < 20 ? QuoteSide::Bid : QuoteSide::Ask;
+            book.update(level(1000.0 + t, sz(rng), side));
+        }
+        if (round == 250) book.rebuild({level(1005.0, 1.0, QuoteSide::Bid), level(1030.0, 1.0, QuoteSide::Ask)});
+        if (book.takeDelta(delta)) mirror.apply(delta);
+
+        ASSERT_EQ(mirror.bids().size(), book.bids().size());
+        ASSERT_EQ(mirror.asks().size(), book.asks().size());
+        for (const auto& [p, lvl] : book.bids()) ASSERT_EQ(mirror.bids().at(p), lvl.size);
+        for (const auto& [p, lvl] : book.asks()) ASSERT_EQ(mirror.asks().at(p), lvl.size);
+    }
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderBook/include/BookIntegrity.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "../../OrderBook/include/QuoteConsumer.hpp"
+#include "tcp/MockFixNetworkClient.hpp"
+#include "websocket/MockBitVavoClient.hpp"
+#include "TestQuotes.hpp"
+
+using namespace testing;
+using namespace gateway;
+using testutil::level;
+using namespace std::chrono_literals;
+
+namespace {
+
+    template<class Book>
+    BookGuard::Verdict apply(BookGuard& guard, Book& book, const Quote& q) {
+        if (!guard.admit(q)) return BookGuard::Verdict::Untrusted;
+        book.update(q);
+        return guard.afterUpdate(book, q);
+    }
+
+    std::string bookUpdate(std::uint64_t nonce, const std::string& side, const std::string& px, const std::string& sz) {
+        return R"({"event":"book","market":"BTC-EUR","nonce":)" + std::to_string(nonce) +
+               R"(,")" + side + R"(":[[")" + px + R"(",")" + sz + R"("]]})";
+    }
+
+}
+
+TEST(BookGuard, PruneDropsStaleLevelsCrossedByNewQuote) {
+    OrderBook book("BTC-EUR");
+    BookGuard guard;
+    apply(guard, book, level(100.0, 1.0, QuoteSide::Bid));
+    apply(guard, book, level(101.0, 1.0, QuoteSide::Ask));
+    apply(guard, book, level(102.0, 1.0, QuoteSide::Ask));
+    apply(guard, book, level(103.0, 1.0, QuoteSide::Ask));
+
+    // A bid through two resting asks means those asks were lifted and their deletes lost.
+    EXPECT_EQ(apply(guard, book, level(102.0, 2.0, QuoteSide::Bid)), BookGuard::Verdict::Healed);
+    EXPECT_DOUBLE_EQ(book.bestBid(), 102.0);
+    EXPECT_DOUBLE_EQ(book.bestAsk(), 103.0);
+    EXPECT_EQ(book.asks().size(), 1u);
+
+    const auto s = guard.stats();
+    EXPECT_EQ(s.checks, 5u);
+    EXPECT_EQ(s.locked, 0u);
+    EXPECT_EQ(s.crossed, 1u);
+    EXPECT_EQ(s.prunedLevels, 2u);
+    EXPECT_TRUE(s.trusted);
+}
+
+TEST(BookGuard, MarkUntrustedUntilBookUncrosses) {
+    OrderBook book("BTC-EUR");
+    BookGuard guard({CrossedBookPolicy::MarkUntrusted, 0});
+    apply(guard, book, level(100.0, 1.0, QuoteSide::Bid));
+    apply(guard, book, level(101.0, 1.0, QuoteSide::Ask));
+
+    EXPECT_EQ(apply(guard, book, level(99.0, 1.0, QuoteSide::Ask)), BookGuard::Verdict::Untrusted);
+    EXPECT_FALSE(guard.trusted());
+    EXPECT_EQ(book.asks().size(), 2u);
+    EXPECT_EQ(guard.stats().crossed, 1u);
+
+    EXPECT_EQ(apply(guard, book, level(99.0, 0.0, QuoteSide::Ask)), BookGuard::Verdict::Ok);
+    EXPECT_TRUE(guard.trusted());
+}
+
+TEST(BookGuard, RejectsInvalidQuotesAndBoundsDepth) {
+    OrderBook book("BTC-EUR");
+    BookGuard guard({CrossedBookPolicy::Prune, 3});
+
+    EXPECT_FALSE(guard.admit(level(100.0, -1.0, QuoteSide::Bid)));
+    EXPECT_FALSE(guard.admit(level(std::numeric_limits<double>::quiet_NaN(), 1.0, QuoteSide::Bid)));
+    EXPECT_FALSE(guard.admit(level(0.0, 1.0, QuoteSide::Ask)));
+    EXPECT_TRUE(guard.admit(level(100.0, 0.0, QuoteSide::Ask)));
+    EXPECT_EQ(guard.stats().invalidQuotes, 3u);
+
+    for (int i = 0; i < 5; ++i) apply(guard, book, level(100.0 - i, 1.0, QuoteSide::Bid));
+    EXPECT_EQ(book.bids().size(), 3u);
+    EXPECT_DOUBLE_EQ(book.bids().rbegin()->first, 98.0);
+    EXPECT_EQ(guard.stats().trimmedLevels, 2u);
+}
+
+TEST(BookGuard, ConsumerResyncsCrossedBookAndFlagsView) {
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    std::atomic<int> getBookRequests{0};
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+    ON_CALL(mock, send(_)).WillByDefault([&](const std::string& payload) {
+        if (payload == R"({"action":"getBook","market":"BTC-EUR"})") ++getBookRequests;
+    });
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "BTC-EUR");
+    ASSERT_TRUE(obt.connect());
+
+    QuoteConsumer consumer{ std::tie(obt), "BTC-EUR" };
+    consumer.setIntegrity({CrossedBookPolicy::Resync, 0});
+    OrderBookView view(8);
+    consumer.attachView(&view);
+    consumer.start();
+
+    onMsg(bookUpdate(1, "bids", "100.0", "1.0"));
+    onMsg(bookUpdate(2, "asks", "101.0", "1.0"));
+    onMsg(bookUpdate(3, "bids", "101.5", "1.0"));
+    std::this_thread::sleep_for(3ms);
+    EXPECT_FALSE(consumer.trusted());
+    EXPECT_FALSE(view.read().trusted);
+
+    // The request goes out with the next frame, which is then held back until the snapshot lands.
+    onMsg(bookUpdate(4, "asks", "102.0", "1.0"));
+    EXPECT_EQ(getBookRequests.load(), 1);
+    onMsg(R"({"action":"getBook","response":{"market":"BTC-EUR","nonce":4,"bids":[["101.5","1.0"]],"asks":[["102.0","1.0"]]}})");
+    std::this_thread::sleep_for(3ms);
+    consumer.stop();
+
+    EXPECT_TRUE(consumer.trusted());
+    EXPECT_TRUE(view.read().trusted);
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook().bestAsk(), 102.0);
+    const auto s = consumer.integrity();
+    EXPECT_EQ(s.crossed, 1u);
+    EXPECT_EQ(s.resyncRequests, 1u);
+    EXPECT_EQ(obt.bookSync().resyncs(), 1u);
+}
+
+TEST(BookGuard, SkippedSnapshotLetsTheNextCrossingAskAgain) {
+    OrderBook book("BTC-EUR");
+    BookGuard guard({CrossedBookPolicy::Resync, 0});
+    apply(guard, book, level(100.0, 1.0, QuoteSide::Bid));
+    apply(guard, book, level(101.0, 1.0, QuoteSide::Ask));
+
+    EXPECT_EQ(apply(guard, book, level(101.5, 1.0, QuoteSide::Bid)), BookGuard::Verdict::NeedsResync);
+    EXPECT_EQ(apply(guard, book, level(102.0, 1.0, QuoteSide::Bid)), BookGuard::Verdict::Untrusted);
+
+    // The snapshot that came back was older than the book and was dropped.
+    guard.snapshotSkipped();
+    EXPECT_FALSE(guard.trusted());
+    EXPECT_EQ(apply(guard, book, level(102.5, 1.0, QuoteSide::Bid)), BookGuard::Verdict::NeedsResync);
+    EXPECT_EQ(guard.stats().resyncRequests, 2u);
+}
+
+TEST(BookGuard, ResyncPolicyPrunesOnFeedsWithoutSnapshots) {
+    MockFixNetworkClient mock;
+    MockFixNetworkClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    QuotesObtainer<MockFixNetworkClient> obt(std::move(mock), "127.0.0.1", "9999", "BTC-EUR");
+
+    QuoteConsumer consumer{ std::tie(obt), "BTC-EUR" };
+    consumer.setIntegrity({CrossedBookPolicy::Resync, 0});
+
+    const char SOH = '\x01';
+    auto level = [&](const char* side, const char* px) {
+        return std::string("8=FIX.4.4") + SOH + "35=X" + SOH + "55=BTC-EUR" + SOH + "268=1" + SOH +
+               "269=" + side + SOH + "270=" + px + SOH + "271=1.0" + SOH;
+    };
+    onMsg(level("0", "100.0"));
+    onMsg(level("1", "101.0"));
+    onMsg(level("0", "101.5"));
+    consumer.poll();
+
+    EXPECT_TRUE(consumer.trusted());
+    EXPECT_DOUBLE_EQ(consumer.getOrderBook().bestBid(), 101.5);
+    EXPECT_TRUE(consumer.getOrderBook().asks().empty());
+    EXPECT_EQ(consumer.integrity().resyncRequests, 1u);
+    EXPECT_EQ(consumer.integrity().prunedLevels, 1u);
+}
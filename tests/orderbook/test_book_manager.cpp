@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "../../OrderBook/include/BookManager.hpp"
+#include "../../OrderBook/include/FlatOrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+using namespace std::chrono_literals;
+
+namespace {
+    template<class Manager>
+    bool waitForUpdates(const Manager& m, SymbolId id, std::uint64_t n) {
+        for (int i = 0; i < 2000 && m.updateCount(id) < n; ++i) std::this_thread::sleep_for(1ms);
+        return m.updateCount(id) >= n;
+    }
+}
+
+TEST(BookManager, RoutesQuotesToTheOwningShard) {
+    BookManager<> manager({.shards = 2});
+    const auto a = manager.add("BM-A-EUR");
+    const auto b = manager.add("BM-B-EUR");
+    const auto c = manager.add("BM-C-EUR");
+    EXPECT_EQ(manager.bookCount(), 3u);
+    EXPECT_NE(manager.shardOf(a), manager.shardOf(b));
+    EXPECT_EQ(manager.symbolsOn(0) + manager.symbolsOn(1), 3u);
+
+    manager.start();
+    for (auto id : {a, b, c}) {
+        EXPECT_TRUE(manager.route(level(id, 100.0 + id, 1.0, QuoteSide::Bid)));
+        EXPECT_TRUE(manager.route(level(id, 101.0 + id, 2.0, QuoteSide::Ask)));
+    }
+    EXPECT_FALSE(manager.route(level(internSymbol("BM-UNKNOWN"), 1.0, 1.0, QuoteSide::Bid)));
+    manager.stop();
+
+    for (auto id : {a, b, c}) {
+        EXPECT_DOUBLE_EQ(manager.book(id)->bestBid(), 100.0 + id);
+        EXPECT_DOUBLE_EQ(manager.book(id)->bestAsk(), 101.0 + id);
+        EXPECT_EQ(manager.updateCount(id), 2u);
+    }
+    EXPECT_EQ(manager.unrouted(), 1u);
+}
+
+TEST(BookManager, HandoffKeepsPerSymbolOrderWhileMoving) {
+    BookManager<FlatOrderBook> manager({.shards = 3, .ringCapacity = 64});
+    const auto id = manager.add("BM-MOVE-EUR", 0);
+    manager.start();
+
+    // Every update rewrites the same level, so any reordering across a move shows up in the final size.
+    constexpr int kUpdates = 20000;
+    for (int i = 1; i <= kUpdates; ++i) {
+        manager.route(level(id, 100.0, static_cast<double>(i), QuoteSide::Bid));
+        if (i % 97 == 0) manager.moveSymbol(id, (manager.shardOf(id) + 1) % 3);
+    }
+    manager.stop();
+
+    EXPECT_GT(manager.moves(), 200u);
+    EXPECT_EQ(manager.updateCount(id), static_cast<std::uint64_t>(kUpdates));
+    EXPECT_DOUBLE_EQ(manager.book(id)->bids().size(0), static_cast<double>(kUpdates));
+}
+
+TEST(BookManager, RebalanceMovesHotSymbolOffBusyShard) {
+    BookManager<> manager({.shards = 2});
+    const auto hot1 = manager.add("BM-HOT1-EUR", 0);
+    const auto hot2 = manager.add("BM-HOT2-EUR", 0);
+    const auto cold = manager.add("BM-COLD-EUR", 1);
+    manager.start();
+
+    for (int i = 0; i < 1000; ++i) {
+        manager.route(level(hot1, 100.0 + i % 10, 1.0, QuoteSide::Bid));
+        manager.route(level(hot2, 200.0 + i % 10, 1.0, QuoteSide::Bid));
+    }
+    manager.route(level(cold, 50.0, 1.0, QuoteSide::Bid));
+    ASSERT_TRUE(waitForUpdates(manager, hot1, 1000));
+    ASSERT_TRUE(waitForUpdates(manager, hot2, 1000));
+    ASSERT_TRUE(waitForUpdates(manager, cold, 1));
+
+    EXPECT_EQ(manager.rebalance(), 1u);
+    EXPECT_NE(manager.shardOf(hot1), manager.shardOf(hot2));
+    EXPECT_EQ(manager.symbolsOn(1), 2u);
+    EXPECT_GT(manager.updateRate(hot1), manager.updateRate(cold));
+
+    // Balanced now: another pass with the same traffic leaves placement alone.
+    for (int i = 0; i < 1000; ++i) {
+        manager.route(level(hot1, 100.0, 1.0, QuoteSide::Ask));
+        manager.route(level(hot2, 200.0, 1.0, QuoteSide::Ask));
+    }
+    ASSERT_TRUE(waitForUpdates(manager, hot1, 2000));
+    ASSERT_TRUE(waitForUpdates(manager, hot2, 2000));
+    EXPECT_EQ(manager.rebalance(), 0u);
+    manager.stop();
+
+    EXPECT_DOUBLE_EQ(manager.book(hot1)->bestBid(), 109.0);
+    EXPECT_DOUBLE_EQ(manager.book(hot2)->bestBid(), 209.0);
+}
+
+TEST(BookManager, SnapshotDropsQuotesItAlreadyCovers) {
+    BookManager<> manager({.shards = 1});
+    const auto id = manager.add("BM-SNAP-EUR");
+    OrderBookView view(8);
+    manager.attachView(id, &view);
+    manager.start();
+
+    manager.route(level(id, 99.0, 1.0, QuoteSide::Bid, 10));
+    BookSnapshot snap{id, 20, {level(id, 100.0, 2.0, QuoteSide::Bid, 20), level(id, 102.0, 1.0, QuoteSide::Ask, 20)}};
+    ASSERT_TRUE(manager.routeSnapshot(std::move(snap)));
+    manager.route(level(id, 101.0, 5.0, QuoteSide::Bid, 15));
+    manager.route(level(id, 100.5, 3.0, QuoteSide::Bid, 21));
+    manager.stop();
+
+    const auto* book = manager.book(id);
+    EXPECT_DOUBLE_EQ(book->bestBid(), 100.5);
+    EXPECT_EQ(book->bids().size(), 2u);
+    EXPECT_DOUBLE_EQ(book->bestAsk(), 102.0);
+
+    OrderBookSnapshot out;
+    ASSERT_TRUE(view.read(out));
+    EXPECT_DOUBLE_EQ(out.bestBid, 100.5);
+    EXPECT_EQ(out.symbolId, id);
+}
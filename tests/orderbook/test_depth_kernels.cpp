@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+#include "../../OrderBook/include/DepthKernels.hpp"
+#include "../../OrderBook/include/FlatOrderBook.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+namespace {
+    struct ScalarGuard {
+        explicit ScalarGuard(bool on) { depth::forceScalar(on); }
+        ~ScalarGuard() { depth::forceScalar(false); }
+    };
+
+    // Same random book in all three shapes the queries run on.
+    struct Books {
+        OrderBook map{"BTC-EUR"};
+        FlatOrderBook flat{"BTC-EUR"};
+        OrderBookSnapshot snap;
+    };
+
+    void fill(Books& b, std::mt19937& rng, int depth) {
+        std::uniform_real_distribution<double> sz(0.1, 5.0);
+        for (int i = 0; i < depth; ++i) {
+            for (auto q : {level(1000.0 - i, sz(rng), QuoteSide::Bid), level(1001.0 + i, sz(rng), QuoteSide::Ask)}) {
+                b.map.update(q);
+                b.flat.update(q);
+            }
+        }
+        b.snap = b.map.snapshot();
+    }
+}
+
+TEST(DepthKernels, EmptySide) {
+    const depth::PairLevels none{};
+    EXPECT_DOUBLE_EQ(depth::cumulativeDepth(none, QuoteSide::Bid, 0.0), 0.0);
+    EXPECT_EQ(depth::crossingLevel(none, 1.0), 0u);
+    EXPECT_FALSE(depth::sweep(none, 1.0).complete);
+    EXPECT_EQ(depth::levelsWithin(none, QuoteSide::Ask, 1e9), 0u);
+}
+
+TEST(DepthKernels, HandWorkedBidSide) {
+    const std::pair<double, double> bids[] = {{100, 1}, {99, 2}, {98, 3}, {97, 4}, {96, 5}, {95, 6}};
+    const depth::PairLevels side{bids, 6};
+
+    EXPECT_DOUBLE_EQ(depth::cumulativeDepth(side, QuoteSide::Bid, 97.5), 6.0);
+    EXPECT_EQ(depth::levelsWithin(side, QuoteSide::Bid, 96.0), 5u);
+    EXPECT_DOUBLE_EQ(depth::topDepth(side, 5), 15.0);
+    EXPECT_EQ(depth::crossingLevel(side, 10.0), 3u);
+    EXPECT_EQ(depth::crossingLevel(side, 22.0), 6u);
+
+    const auto c = depth::sweep(side, 7.0);
+    EXPECT_TRUE(c.complete);
+    EXPECT_DOUBLE_EQ(c.notional, 100 + 2 * 99 + 3 * 98 + 1 * 97);
+}
+
+TEST(DepthKernels, SimdScalarAndMapAgreeOnEveryLayout) {
+    std::mt19937 rng(9);
+    for (int depthLevels : {1, 3, 4, 5, 8, 17, 50, 200}) {
+        Books b;
+        fill(b, rng, depthLevels);
+
+        for (auto side : {QuoteSide::Bid, QuoteSide::Ask}) {
+            const auto pairs = side == QuoteSide::Bid ? b.snap.bidSide() : b.snap.askSide();
+            const auto reversed = (side == QuoteSide::Bid ? b.flat.bids() : b.flat.asks()).levels();
+            const double sign = side == QuoteSide::Bid ? -1.0 : 1.0;
+            const double best = side == QuoteSide::Bid ? b.map.bestBid() : b.map.bestAsk();
+
+            for (double offset : {-1.0, 0.0, 2.5, 7.0, 1000.0}) {
+                const double limit = best + sign * offset;
+                const double expected = b.map.cumulativeDepth(side, limit);
+                for (bool scalar : {false, true}) {
+                    ScalarGuard g(scalar);
+                    EXPECT_NEAR(depth::cumulativeDepth(pairs, side, limit), expected, 1e-9);
+                    EXPECT_NEAR(depth::cumulativeDepth(reversed, side, limit), expected, 1e-9);
+                    EXPECT_EQ(depth::levelsWithin(pairs, side, limit), depth::levelsWithin(reversed, side, limit));
+                }
+            }
+
+            for (double qty : {0.5, 4.0, 20.0, 100.0, 1e6}) {
+                const auto crossing = b.map.crossingLevel(side, qty);
+                const auto cost = b.map.sweepCost(side, qty);
+                for (bool scalar : {false, true}) {
+                    ScalarGuard g(scalar);
+                    EXPECT_EQ(depth::crossingLevel(pairs, qty), crossing);
+                    EXPECT_EQ(b.flat.crossingLevel(side, qty), crossing);
+                    const auto a = depth::sweep(pairs, qty);
+                    const auto r = b.flat.sweepCost(side, qty);
+                    EXPECT_EQ(a.complete, cost.complete);
+                    EXPECT_NEAR(a.notional, cost.notional, 1e-6);
+                    EXPECT_NEAR(r.quantity, cost.quantity, 1e-9);
+                    EXPECT_NEAR(r.notional, cost.notional, 1e-6);
+                }
+            }
+            EXPECT_NEAR(depth::topDepth(pairs, 10), depth::topDepth(reversed, 10), 1e-9);
+        }
+    }
+}
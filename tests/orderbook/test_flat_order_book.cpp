@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+#include "../../OrderBook/include/FlatOrderBook.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+TEST(FlatOrderBook, KeepsBestLevelFirstOnBothSides) {
+    FlatOrderBook book("BTC-EUR");
+    book.update(level(99.0, 1.0, QuoteSide::Bid));
+    book.update(level(100.0, 2.0, QuoteSide::Bid));
+    book.update(level(98.0, 3.0, QuoteSide::Bid));
+    book.update(level(102.0, 1.0, QuoteSide::Ask));
+    book.update(level(101.0, 2.0, QuoteSide::Ask));
+    book.update(level(103.0, 3.0, QuoteSide::Ask));
+
+    EXPECT_DOUBLE_EQ(book.bestBid(), 100.0);
+    EXPECT_DOUBLE_EQ(book.bestAsk(), 101.0);
+    EXPECT_DOUBLE_EQ(book.bids().price(2), 98.0);
+    EXPECT_DOUBLE_EQ(book.asks().price(2), 103.0);
+    EXPECT_DOUBLE_EQ(book.asks().size(0), 2.0);
+
+    book.update(level(100.0, 0.0, QuoteSide::Bid));
+    book.update(level(102.0, 0.0, QuoteSide::Ask));
+    EXPECT_DOUBLE_EQ(book.bestBid(), 99.0);
+    EXPECT_EQ(book.asks().depth(), 2u);
+}
+
+TEST(FlatOrderBook, LowerBoundMatchesStd) {
+    FlatOrderBook book("BTC-EUR");
+    for (int i = 0; i < 37; ++i) book.update(level(100.0 + 2 * i, 1.0, QuoteSide::Bid));
+
+    const auto& side = book.bids();
+    for (int k = 98; k < 176; ++k) {
+        const double key = static_cast<double>(k);
+        std::size_t expected = 0;
+        while (expected < side.depth() && side.price(side.depth() - 1 - expected) < key) ++expected;
+        EXPECT_EQ(side.lowerBound(key), expected) << key;
+    }
+}
+
+TEST(FlatOrderBook, MatchesMapBookUnderRandomUpdates) {
+    FlatOrderBook flat("BTC-EUR", 4);
+    OrderBook reference("BTC-EUR");
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> tick(0, 120), sz(0, 3);
+    for (int i = 0; i < 50000; ++i) {
+        const int t = tick(rng);
+        const auto q = level(500.0 + t, sz(rng), t < 60 ? QuoteSide::Bid : QuoteSide::Ask);
+        flat.update(q);
+        reference.update(q);
+    }
+
+    const auto a = flat.snapshot();
+    const auto b = reference.snapshot();
+    EXPECT_EQ(a.bidLevels, b.bidLevels);
+    EXPECT_EQ(a.askLevels, b.askLevels);
+    EXPECT_DOUBLE_EQ(flat.bestBid(), reference.bestBid());
+    EXPECT_DOUBLE_EQ(flat.bestAsk(), reference.bestAsk());
+
+    const auto top = flat.snapshot(5);
+    ASSERT_EQ(top.bidLevels.size(), 5u);
+    EXPECT_EQ(top.bidLevels.front(), b.bidLevels.front());
+}
+
+TEST(FlatOrderBook, PublishesThroughOrderBookView) {
+    FlatOrderBook book("BTC-EUR");
+    book.rebuild({level(100.0, 1.0, QuoteSide::Bid), level(99.0, 2.0, QuoteSide::Bid),
+                  level(101.0, 3.0, QuoteSide::Ask), level(102.0, 0.0, QuoteSide::Ask)});
+
+    OrderBookView view;
+    view.publish_from(book);
+    OrderBookSnapshot snap;
+    ASSERT_TRUE(view.read(snap));
+    EXPECT_DOUBLE_EQ(snap.bestBid, 100.0);
+    EXPECT_DOUBLE_EQ(snap.bestAsk, 101.0);
+    ASSERT_EQ(snap.bidLevels.size(), 2u);
+    EXPECT_DOUBLE_EQ(snap.bidLevels[1].second, 2.0);
+    EXPECT_EQ(snap.askLevels.size(), 1u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+
+#include "../../OrderBook/include/L3OrderBook.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+
+using namespace gateway;
+
+TEST(L3OrderBook, AggregatesOrdersIntoLevels) {
+    L3OrderBook book("BTC-EUR");
+    EXPECT_TRUE(book.add(1, QuoteSide::Bid, 100.0, 1.0));
+    EXPECT_TRUE(book.add(2, QuoteSide::Bid, 100.0, 2.0));
+    EXPECT_TRUE(book.add(3, QuoteSide::Bid, 99.0, 4.0));
+    EXPECT_TRUE(book.add(4, QuoteSide::Ask, 101.0, 1.5));
+    EXPECT_FALSE(book.add(1, QuoteSide::Ask, 105.0, 1.0)) << "duplicate id";
+    EXPECT_FALSE(book.add(5, QuoteSide::Ask, 105.0, 0.0));
+
+    EXPECT_DOUBLE_EQ(book.bestBid(), 100.0);
+    EXPECT_DOUBLE_EQ(book.bestAsk(), 101.0);
+    ASSERT_EQ(book.bids().size(), 2u);
+    EXPECT_DOUBLE_EQ(book.bids().begin()->second.size, 3.0);
+    EXPECT_EQ(book.bids().begin()->second.orders, 2u);
+    EXPECT_EQ(book.orderCount(), 4u);
+}
+
+TEST(L3OrderBook, CancelRemovesOrderAndEmptyLevel) {
+    L3OrderBook book("BTC-EUR");
+    book.add(1, QuoteSide::Bid, 100.0, 1.0);
+    book.add(2, QuoteSide::Bid, 100.0, 2.0);
+
+    EXPECT_TRUE(book.cancel(1));
+    EXPECT_FALSE(book.cancel(1));
+    EXPECT_DOUBLE_EQ(book.bids().begin()->second.size, 2.0);
+    EXPECT_EQ(book.front(QuoteSide::Bid)->id, 2u);
+
+    EXPECT_TRUE(book.cancel(2));
+    EXPECT_TRUE(book.bids().empty());
+    EXPECT_EQ(book.front(QuoteSide::Bid), nullptr);
+    EXPECT_EQ(book.find(2), nullptr);
+}
+
+TEST(L3OrderBook, ModifyKeepsPriorityOnlyWhenReducing) {
+    L3OrderBook book("BTC-EUR");
+    book.add(1, QuoteSide::Ask, 101.0, 5.0);
+    book.add(2, QuoteSide::Ask, 101.0, 5.0);
+
+    EXPECT_TRUE(book.modify(1, 3.0));
+    EXPECT_EQ(book.front(QuoteSide::Ask)->id, 1u);
+    EXPECT_DOUBLE_EQ(book.asks().begin()->second.size, 8.0);
+
+    EXPECT_TRUE(book.modify(1, 6.0));
+    EXPECT_EQ(book.front(QuoteSide::Ask)->id, 2u);
+    EXPECT_DOUBLE_EQ(book.asks().begin()->second.size, 11.0);
+
+    EXPECT_TRUE(book.modify(2, 0.0));
+    EXPECT_EQ(book.orderCount(), 1u);
+}
+
+TEST(L3OrderBook, ReplaceMovesOrderToNewPrice) {
+    L3OrderBook book("BTC-EUR");
+    book.add(1, QuoteSide::Bid, 100.0, 1.0);
+    book.add(2, QuoteSide::Bid, 101.0, 1.0);
+
+    EXPECT_TRUE(book.replace(1, 101.0, 2.0));
+    ASSERT_EQ(book.bids().size(), 1u);
+    EXPECT_DOUBLE_EQ(book.bids().begin()->second.size, 3.0);
+    EXPECT_EQ(book.front(QuoteSide::Bid)->id, 2u);
+}
+
+TEST(L3OrderBook, AppliesFixUpdateActions) {
+    L3OrderBook book("EUR/USD");
+    EXPECT_TRUE(book.apply('0', 7, QuoteSide::Bid, 1.10, 100.0));
+    EXPECT_TRUE(book.apply('1', 7, QuoteSide::Bid, 1.11, 50.0));
+    EXPECT_DOUBLE_EQ(book.bestBid(), 1.11);
+    EXPECT_TRUE(book.apply('2', 7, QuoteSide::Bid, 0.0, 0.0));
+    EXPECT_FALSE(book.apply('5', 7, QuoteSide::Bid, 0.0, 0.0));
+    EXPECT_EQ(book.orderCount(), 0u);
+}
+
+TEST(L3OrderBook, ProjectsIntoOrderBookView) {
+    L3OrderBook book("BTC-EUR");
+    book.add(1, QuoteSide::Bid, 100.0, 1.0);
+    book.add(2, QuoteSide::Bid, 100.0, 2.0);
+    book.add(3, QuoteSide::Ask, 102.0, 4.0);
+
+    OrderBookView view;
+    view.publish_from(book);
+    OrderBookSnapshot snap;
+    ASSERT_TRUE(view.read(snap));
+    EXPECT_DOUBLE_EQ(snap.bestBid, 100.0);
+    EXPECT_DOUBLE_EQ(snap.bestAsk, 102.0);
+    ASSERT_EQ(snap.bidLevels.size(), 1u);
+    EXPECT_DOUBLE_EQ(snap.bidLevels[0].second, 3.0);
+}
+
+TEST(L3OrderBook, RandomFlowMatchesReferenceAggregation) {
+    L3OrderBook book("BTC-EUR", 16);
+    std::map<std::uint64_t, std::tuple<QuoteSide, double, double>> live;
+    std::mt19937_64 rng(42);
+
+    for (int i = 0; i < 20000; ++i) {
+        const auto op = rng() % 4;
+        if (op == 0 || live.empty()) {
+            const std::uint64_t id = rng() % 5000 + 1;
+            const auto side = rng() % 2 ? QuoteSide::Bid : QuoteSide::Ask;
+            const double price = 100.0 + static_cast<double>(rng() % 30);
+            const double qty = static_cast<double>(rng() % 10 + 1);
+            EXPECT_EQ(book.add(id, side, price, qty), !live.count(id));
+            live.try_emplace(id, side, price, qty);
+        } else {
+            auto it = live.begin();
+            std::advance(it, rng() % live.size());
+            const auto id = it->first;
+            if (op == 1) {
+                EXPECT_TRUE(book.cancel(id));
+                live.erase(it);
+            } else if (op == 2) {
+                const double qty = static_cast<double>(rng() % 10 + 1);
+                EXPECT_TRUE(book.modify(id, qty));
+                std::get<2>(it->second) = qty;
+            } else {
+                const double price = 100.0 + static_cast<double>(rng() % 30);
+                EXPECT_TRUE(book.replace(id, price, std::get<2>(it->second)));
+                std::get<1>(it->second) = price;
+            }
+        }
+    }
+
+    std::map<double, double> bids, asks;
+    for (auto& [id, o] : live) {
+        auto& [side, price, qty] = o;
+        (side == QuoteSide::Bid ? bids : asks)[price] += qty;
+        ASSERT_NE(book.find(id), nullptr);
+    }
+    EXPECT_EQ(book.orderCount(), live.size());
+    ASSERT_EQ(book.bids().size(), bids.size());
+    ASSERT_EQ(book.asks().size(), asks.size());
+    for (auto& [p, lvl] : book.bids()) EXPECT_NEAR(lvl.size, bids[p], 1e-9);
+    for (auto& [p, lvl] : book.asks()) EXPECT_NEAR(lvl.size, asks[p], 1e-9);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+namespace {
+    // Every level carries the same size, so a reader can tell a mix of two publishes apart.
+    void fill(OrderBook& book, double generation, int depth) {
+        std::vector<Quote> levels;
+        for (int i = 0; i < depth; ++i) {
+            levels.push_back(level(100.0 - i, generation, QuoteSide::Bid));
+            levels.push_back(level(101.0 + i, generation, QuoteSide::Ask));
+        }
+        book.rebuild(levels);
+    }
+}
+
+TEST(OrderBookView, ReadBeforePublishReturnsFalse) {
+    OrderBookView view;
+    OrderBookSnapshot snap;
+    EXPECT_FALSE(view.read(snap));
+    EXPECT_EQ(view.version(), 0u);
+    EXPECT_TRUE(std::isnan(snap.bestBid));
+}
+
+TEST(OrderBookView, PublishesTopLevelsUpToDepth) {
+    OrderBook book("BTC-EUR");
+    fill(book, 1.0, 10);
+
+    OrderBookView view(4);
+    view.publish_from(book, 3);
+
+    OrderBookSnapshot snap;
+    ASSERT_TRUE(view.read(snap));
+    EXPECT_EQ(snap.symbolId, internSymbol("BTC-EUR"));
+    EXPECT_DOUBLE_EQ(snap.bestBid, 100.0);
+    EXPECT_DOUBLE_EQ(snap.bestAsk, 101.0);
+    ASSERT_EQ(snap.bidLevels.size(), 3u);
+    ASSERT_EQ(snap.askLevels.size(), 3u);
+    EXPECT_DOUBLE_EQ(snap.bidLevels[2].first, 98.0);
+    EXPECT_DOUBLE_EQ(snap.askLevels[2].first, 103.0);
+
+    view.publish_from(book);
+    ASSERT_TRUE(view.read(snap));
+    EXPECT_EQ(snap.bidLevels.size(), 4u) << "depth is capped by the preallocated capacity";
+    EXPECT_EQ(view.version(), 2u);
+}
+
+TEST(OrderBookView, EmptySideReadsAsNaN) {
+    OrderBook book("BTC-EUR");
+    book.update(level(100.0, 1.0, QuoteSide::Bid));
+
+    OrderBookView view;
+    view.publish_from(book);
+
+    OrderBookSnapshot snap;
+    ASSERT_TRUE(view.read(snap));
+    EXPECT_DOUBLE_EQ(snap.bestBid, 100.0);
+    EXPECT_TRUE(std::isnan(snap.bestAsk));
+    EXPECT_TRUE(snap.askLevels.empty());
+}
+
+TEST(OrderBookView, ReaderNeverSeesTornPublish) {
+    constexpr int kDepth = 32;
+    OrderBook a("BTC-EUR"), b("BTC-EUR");
+    fill(a, 1.0, kDepth);
+    fill(b, 2.0, kDepth / 2);
+
+    OrderBookView view(kDepth);
+    view.publish_from(a);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < 200000; ++i) view.publish_from(i % 2 ? a : b);
+        done = true;
+    });
+
+    OrderBookSnapshot snap;
+    std::size_t reads = 0;
+    while (!done.load()) {
+        ASSERT_TRUE(view.read(snap));
+        const double generation = snap.bidLevels.front().second;
+        const std::size_t depth = generation == 1.0 ? kDepth : kDepth / 2;
+        ASSERT_EQ(snap.bidLevels.size(), depth);
+        ASSERT_EQ(snap.askLevels.size(), depth);
+        for (auto& [p, s] : snap.bidLevels) ASSERT_EQ(s, generation);
+        for (auto& [p, s] : snap.askLevels) ASSERT_EQ(s, generation);
+        ++reads;
+    }
+    writer.join();
+    EXPECT_GT(reads, 0u);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "../../OrderBook/include/PoolAllocator.hpp"
+#include "TestQuotes.hpp"
+
+using namespace gateway;
+using testutil::level;
+
+TEST(NodeArena, RecyclesFreedBlocksBeforeCarvingNewOnes) {
+    NodeArena arena(4096);
+    void* a = arena.allocate(48);
+    void* b = arena.allocate(48);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_EQ(arena.inUse(), 2u);
+    const auto used = arena.used();
+
+    arena.deallocate(a, 48);
+    EXPECT_EQ(arena.allocate(40), a) << "same size class";
+    EXPECT_EQ(arena.used(), used);
+    arena.deallocate(b, 48);
+}
+
+TEST(NodeArena, FallsBackWhenFullOrOversized) {
+    NodeArena arena(64);
+    void* big = arena.allocate(1024);
+    EXPECT_FALSE(arena.owns(big));
+    EXPECT_EQ(arena.fallbacks(), 1u);
+    arena.deallocate(big, 1024);
+
+    void* blocks[4];
+    for (auto*& p : blocks) p = arena.allocate(16);
+    void* extra = arena.allocate(16);
+    EXPECT_FALSE(arena.owns(extra));
+    EXPECT_EQ(arena.fallbacks(), 2u);
+    arena.deallocate(extra, 16);
+    for (auto* p : blocks) arena.deallocate(p, 16);
+    EXPECT_EQ(arena.inUse(), 0u);
+}
+
+TEST(PooledOrderBook, MatchesDefaultBookAndStopsGrowingUnderChurn) {
+    NodeArena arena(1 << 20);
+    PooledOrderBook pooled("BTC-EUR", PoolAllocator<PriceLevel>(arena));
+    OrderBook reference("BTC-EUR");
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> tick(0, 199), sz(0, 2);
+    auto churn = [&](int n) {
+        for (int i = 0; i < n; ++i) {
+            const int t = tick(rng);
+            const auto q = level(1000.0 + t, sz(rng), t < 100 ? QuoteSide::Bid : QuoteSide::Ask);
+            pooled.update(q);
+            reference.update(q);
+        }
+    };
+
+    // 200 distinct prices, each map node fits one 64-byte block: churn past that is served from the free list.
+    churn(200000);
+    EXPECT_LE(arena.used(), 200u * 64u);
+    EXPECT_EQ(arena.inUse(), pooled.bids().size() + pooled.asks().size());
+    EXPECT_EQ(arena.fallbacks(), 0u);
+
+    ASSERT_EQ(pooled.bids().size(), reference.bids().size());
+    ASSERT_EQ(pooled.asks().size(), reference.asks().size());
+    EXPECT_DOUBLE_EQ(pooled.bestBid(), reference.bestBid());
+    EXPECT_DOUBLE_EQ(pooled.bestAsk(), reference.bestAsk());
+
+    pooled.rebuild({level(1.0, 1.0, QuoteSide::Bid)});
+    EXPECT_EQ(pooled.bids().size(), 1u);
+    EXPECT_EQ(arena.fallbacks(), 0u);
+}
+
+TEST(NodeArena, HugePageRequestDegradesGracefully) {
+    NodeArena arena(1 << 20, true);
+    EXPECT_EQ(arena.capacity() % (2u << 20), 0u);
+    void* p = arena.allocate(64);
+    EXPECT_TRUE(arena.owns(p));
+    arena.deallocate(p, 64);
+}
@@ -201,3 +201,63 @@ TEST(QuoteConsumer_Stress, StopDuringHeavyLoadIsSafe) {
 
 
 
+
+TEST(QuoteConsumer_EndToEnd, DeltaSubscriberMirrorsBook) {
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock),
+                                          "wss.bitvavo.com", "443", "BTC-EUR");
+    ASSERT_TRUE(obt.connect());
+
+    QuoteConsumer consumer{ std::tie(obt), "BTC-EUR" };
+    BookMirror mirror;
+    std::atomic<int> deltas{0};
+    consumer.subscribeDeltas([&](const BookDelta& d) { mirror.apply(d); ++deltas; });
+    consumer.start();
+
+    onMsg(R"({"event":"book","bids":[["100.00","1.0"],["99.00","2.0"]]})");
+    onMsg(R"({"event":"book","asks":[["101.00","1.5"]]})");
+    onMsg(R"({"event":"book","bids":[["99.00","0"]]})");
+
+    std::this_thread::sleep_for(5ms);
+    consumer.stop();
+
+    EXPECT_GT(deltas.load(), 0);
+    EXPECT_DOUBLE_EQ(mirror.bestBid(), 100.0);
+    EXPECT_DOUBLE_EQ(mirror.bestAsk(), 101.0);
+    EXPECT_EQ(mirror.bids().size(), consumer.getOrderBook().bids().size());
+}
+
+TEST(QuoteConsumer_Arbitration, FirstArrivalWinsRegardlessOfFeedOrder) {
+	MockBitvavoClient mockA, mockB;
+	MockBitvavoClient::MessageHandler onMsgA, onMsgB;
+
+	EXPECT_CALL(mockA, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsgA));
+	EXPECT_CALL(mockB, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsgB));
+	EXPECT_CALL(mockA, connect(_, _)).WillOnce(Return(true));
+	EXPECT_CALL(mockB, connect(_, _)).WillOnce(Return(true));
+
+	QuotesObtainer<MockBitvavoClient> feedA(std::move(mockA), "wss.bitvavo.com", "443", "BTC-EUR");
+	QuotesObtainer<MockBitvavoClient> feedB(std::move(mockB), "wss.bitvavo.com", "443", "BTC-EUR");
+	const auto symbol = internSymbol("BTC-EUR");
+	feedA.resumeFrom(symbol, 1);
+	feedB.resumeFrom(symbol, 1);
+	ASSERT_TRUE(feedA.connect());
+	ASSERT_TRUE(feedB.connect());
+
+	QuoteConsumer consumer{ std::tie(feedA, feedB), "BTC-EUR" };
+
+	// Feed B delivers the update first, on its ask side, and then A delivers the same update.
+	onMsgB(R"({"event":"book","market":"BTC-EUR","nonce":2,"asks":[["10425.00","1.00"]]})");
+	std::this_thread::sleep_for(1ms);
+	onMsgA(R"({"event":"book","market":"BTC-EUR","nonce":2,"asks":[["10425.00","1.00"]]})");
+	consumer.poll();
+
+	EXPECT_EQ(consumer.arbiter().stats(1).wins, 1u);
+	EXPECT_EQ(consumer.arbiter().stats(0).wins, 0u);
+	EXPECT_EQ(consumer.arbiter().stats(0).duplicates, 1u);
+	EXPECT_GE(consumer.arbiter().stats(0).maxLag, 1ms);
+}
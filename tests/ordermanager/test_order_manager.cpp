@@ -0,0 +1,287 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../OrderManager/include/OrderManager.hpp"
+#include "../../Simulator/include/MatchingEngine.hpp"
+#include "../../Simulator/include/SimulatorWire.hpp"
+
+using namespace gateway;
+
+namespace {
+
+    const SymbolId kSymbol = internSymbol("OMS-EUR");
+
+    OrderIntent intent(IntentType type, std::uint64_t id, QuoteSide side, double price, double qty, std::uint64_t orig = 0) {
+        OrderIntent i;
+        i.type = type;
+        i.side = side;
+        i.symbol = kSymbol;
+        i.clientOrderId = id;
+        i.origClientOrderId = orig;
+        i.price = price;
+        i.qty = qty;
+        return i;
+    }
+
+    oms::ExecReport report(oms::ExecType type, oms::OrdStatus status, std::uint64_t id, double price, double qty,
+                           double leaves, double cum, std::uint64_t orig = 0) {
+        oms::ExecReport r;
+        r.execType = type;
+        r.ordStatus = status;
+        r.clOrdId = id;
+        r.origClOrdId = orig;
+        r.symbol = kSymbol;
+        r.price = price;
+        r.orderQty = qty;
+        r.leavesQty = leaves;
+        r.cumQty = cum;
+        return r;
+    }
+
+    std::vector<std::uint64_t> idsAt(const oms::OrderManager& m, QuoteSide side, double price) {
+        std::vector<std::uint64_t> ids;
+        if (const auto* level = m.level(kSymbol, side, price)) {
+            m.forEachOrder(*level, [&](const oms::Order& o) { ids.push_back(o.clOrdId); });
+        }
+        return ids;
+    }
+
+}
+
+TEST(OrderManager, TracksAnOrderThroughFillsAndAChainedReplace) {
+    using oms::ExecType;
+    using oms::OrdStatus;
+    oms::OrderManager m(16);
+
+    ASSERT_TRUE(m.onIntent(intent(IntentType::New, 1, QuoteSide::Bid, 99.0, 2.0)));
+    ASSERT_TRUE(m.onIntent(intent(IntentType::New, 2, QuoteSide::Bid, 99.0, 1.0)));
+    EXPECT_FALSE(m.onIntent(intent(IntentType::New, 2, QuoteSide::Bid, 98.0, 1.0)));
+    EXPECT_EQ(idsAt(m, QuoteSide::Bid, 99.0), (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_DOUBLE_EQ(m.openQty(kSymbol, QuoteSide::Bid), 3.0);
+    EXPECT_EQ(m.find(1)->pending, oms::Pending::New);
+
+    m.apply(report(ExecType::New, OrdStatus::New, 1, 99.0, 2.0, 2.0, 0.0));
+    EXPECT_EQ(m.find(1)->pending, oms::Pending::None);
+
+    auto fill = report(ExecType::Trade, OrdStatus::PartiallyFilled, 1, 99.0, 2.0, 1.5, 0.5);
+    fill.lastQty = 0.5;
+    fill.lastPx = 99.0;
+    const auto a = m.apply(fill);
+    EXPECT_TRUE(a.known);
+    EXPECT_FALSE(a.closed);
+    EXPECT_DOUBLE_EQ(m.position(kSymbol).qty, 0.5);
+    EXPECT_DOUBLE_EQ(m.position(kSymbol).cash, -49.5);
+    EXPECT_DOUBLE_EQ(m.level(kSymbol, QuoteSide::Bid, 99.0)->leavesQty, 2.5);
+
+    // Two replaces in flight; the second names the first's ClOrdID.
+    ASSERT_TRUE(m.onIntent(intent(IntentType::Replace, 10, QuoteSide::Bid, 99.5, 2.0, 1)));
+    ASSERT_TRUE(m.onIntent(intent(IntentType::Replace, 11, QuoteSide::Bid, 100.0, 2.0, 10)));
+    EXPECT_EQ(m.find(11), m.find(1));
+    EXPECT_EQ(m.find(10), nullptr);
+
+    m.apply(report(ExecType::Replaced, OrdStatus::PartiallyFilled, 10, 99.5, 2.0, 1.5, 0.5, 1));
+    EXPECT_EQ(m.find(1), nullptr);
+    EXPECT_EQ(m.find(10)->pending, oms::Pending::Replace);
+    EXPECT_EQ(idsAt(m, QuoteSide::Bid, 99.5), (std::vector<std::uint64_t>{10}));
+    m.apply(report(ExecType::Replaced, OrdStatus::PartiallyFilled, 11, 100.0, 2.0, 1.5, 0.5, 10));
+    EXPECT_EQ(m.find(11)->pending, oms::Pending::None);
+    EXPECT_EQ(m.level(kSymbol, QuoteSide::Bid, 99.5), nullptr);
+
+    fill = report(ExecType::Trade, OrdStatus::Filled, 11, 100.0, 2.0, 0.0, 2.0);
+    fill.lastQty = 1.5;
+    fill.lastPx = 100.0;
+    std::size_t levels = 0;
+    m.forEachLevel(kSymbol, QuoteSide::Bid, [&](const oms::OpenLevel&) { ++levels; });
+    EXPECT_EQ(levels, 2u);
+    EXPECT_TRUE(m.apply(fill).closed);
+    EXPECT_EQ(m.find(11), nullptr);
+    EXPECT_EQ(m.openOrders(), 1u);
+    EXPECT_DOUBLE_EQ(m.openQty(kSymbol, QuoteSide::Bid), 1.0);
+    EXPECT_DOUBLE_EQ(m.position(kSymbol).qty, 2.0);
+    EXPECT_EQ(m.position(kSymbol).fills, 2u);
+}
+
+TEST(OrderManager, CancelsRejectsAndCapacity) {
+    using oms::ExecType;
+    using oms::OrdStatus;
+    oms::OrderManager m(2);
+
+    ASSERT_TRUE(m.onIntent(intent(IntentType::New, 1, QuoteSide::Ask, 101.0, 1.0)));
+    ASSERT_TRUE(m.onIntent(intent(IntentType::New, 2, QuoteSide::Ask, 102.0, 1.0)));
+    EXPECT_FALSE(m.onIntent(intent(IntentType::New, 3, QuoteSide::Ask, 103.0, 1.0)));
+    EXPECT_FALSE(m.onIntent(intent(IntentType::Cancel, 4, QuoteSide::Ask, 0.0, 0.0, 99)));
+    EXPECT_EQ(m.refusedIntents(), 2u);
+
+    // A new order rejected by the venue frees its slot.
+    EXPECT_TRUE(m.apply(report(ExecType::Rejected, OrdStatus::Rejected, 2, 102.0, 1.0, 0.0, 0.0)).closed);
+    ASSERT_TRUE(m.onIntent(intent(IntentType::New, 3, QuoteSide::Ask, 103.0, 1.0)));
+
+    // A rejected cancel leaves the order working.
+    ASSERT_TRUE(m.onIntent(intent(IntentType::Cancel, 5, QuoteSide::Ask, 0.0, 0.0, 1)));
+    oms::ExecReport reject;
+    reject.msgType = '9';
+    reject.clOrdId = 5;
+    reject.origClOrdId = 1;
+    const auto rejected = m.apply(reject);
+    EXPECT_TRUE(rejected.known);
+    EXPECT_FALSE(rejected.closed);
+    EXPECT_EQ(m.find(1)->pending, oms::Pending::None);
+    EXPECT_EQ(m.find(5), nullptr);
+
+    ASSERT_TRUE(m.onIntent(intent(IntentType::Cancel, 6, QuoteSide::Ask, 0.0, 0.0, 1)));
+    EXPECT_TRUE(m.apply(report(ExecType::Canceled, OrdStatus::Canceled, 6, 101.0, 1.0, 0.0, 0.0, 1)).closed);
+    EXPECT_EQ(m.level(kSymbol, QuoteSide::Ask, 101.0), nullptr);
+    EXPECT_EQ(m.openOrders(), 1u);
+
+    EXPECT_FALSE(m.apply(report(ExecType::Canceled, OrdStatus::Canceled, 7, 0.0, 0.0, 0.0, 0.0, 1)).known);
+    EXPECT_EQ(m.unknownReports(), 1u);
+}
+
+TEST(OrderManager, IndexSurvivesChurn) {
+    oms::OrderManager m(512);
+    std::unordered_map<std::uint64_t, double> reference;
+    std::mt19937_64 rng(3);
+    std::uint64_t nextId = 1;
+    for (int step = 0; step < 200000; ++step) {
+        if (reference.size() < 500 && (reference.empty() || rng() % 2 == 0)) {
+            const double price = 100.0 + static_cast<double>(rng() % 32);
+            const auto id = nextId++ * 7919;   // clustered ids exercise probing and backward shifts
+            ASSERT_TRUE(m.onIntent(intent(IntentType::New, id, QuoteSide::Bid, price, 1.0)));
+            reference.emplace(id, price);
+        } else {
+            auto it = reference.begin();
+            std::advance(it, static_cast<long>(rng() % reference.size()));
+            const auto cancelId = nextId++ * 7919;
+            ASSERT_TRUE(m.onIntent(intent(IntentType::Cancel, cancelId, QuoteSide::Bid, 0.0, 0.0, it->first)));
+            ASSERT_TRUE(m.apply(report(oms::ExecType::Canceled, oms::OrdStatus::Canceled, cancelId, it->second, 1.0,
+                                       0.0, 0.0, it->first)).closed);
+            reference.erase(it);
+        }
+    }
+    EXPECT_EQ(m.openOrders(), reference.size());
+    for (const auto& [id, price] : reference) {
+        const auto* o = m.find(id);
+        ASSERT_NE(o, nullptr);
+        EXPECT_EQ(o->price, price);
+    }
+    double open = 0.0;
+    m.forEachLevel(kSymbol, QuoteSide::Bid, [&](const oms::OpenLevel& l) { open += l.leavesQty; });
+    EXPECT_NEAR(open, static_cast<double>(reference.size()), 1e-9);
+}
+
+TEST(OrderManager, AppliesExecutionReportsFromTheWire) {
+    struct Capture {
+        std::vector<sim::Execution> executions;
+        void onExecution(const sim::Execution& e) { executions.push_back(e); }
+        void onLevel(const sim::LevelUpdate&) {}
+    };
+    struct Fills {
+        double bought{0.0};
+        std::vector<std::uint64_t> done;
+        void onFill(SymbolId, QuoteSide side, double qty) { if (side == QuoteSide::Bid) bought += qty; }
+        void onOrderDone(SymbolId, std::uint64_t id) { done.push_back(id); }
+    } strategy;
+
+    sim::MatchingEngine<Capture> venue;
+    venue.addSymbol(kSymbol);
+    oms::OrderManager m;
+    sim::FixFramer framer("VENUE", "CLIENT");
+    const auto deliver = [&] {
+        for (const auto& e : venue.listener().executions) {
+            std::string body;
+            const auto type = sim::appendExecution(body, e);
+            const std::string wire(framer.frame(type, body));
+            const auto parsed = oms::parseExecReport(wire);
+            ASSERT_TRUE(parsed.has_value()) << wire;
+            EXPECT_TRUE(m.apply(*parsed, strategy).known) << wire;
+        }
+        venue.listener().executions.clear();
+    };
+    const auto send = [&](const OrderIntent& i) {
+        ASSERT_TRUE(m.onIntent(i));
+        sim::OrderRequest req;
+        req.msgType = i.type == IntentType::New ? 'D' : i.type == IntentType::Replace ? 'G' : 'F';
+        req.owner = 1;
+        req.clOrdId = i.clientOrderId;
+        req.origClOrdId = i.origClientOrderId;
+        req.symbol = i.symbol;
+        req.side = i.side;
+        req.price = i.price;
+        req.qty = i.qty;
+        venue.submit(req);
+        deliver();
+    };
+
+    sim::OrderRequest house;
+    house.owner = sim::kHouse;
+    house.clOrdId = 1000;
+    house.symbol = kSymbol;
+    house.side = QuoteSide::Ask;
+    house.price = 100.0;
+    house.qty = 0.25;
+    venue.submit(house);
+
+    send(intent(IntentType::New, 1, QuoteSide::Bid, 99.0, 1.0));
+    send(intent(IntentType::Replace, 2, QuoteSide::Bid, 100.0, 1.0, 1));
+    EXPECT_DOUBLE_EQ(strategy.bought, 0.25);
+    EXPECT_DOUBLE_EQ(m.find(2)->leavesQty, 0.75);
+    EXPECT_DOUBLE_EQ(m.find(2)->avgPx, 100.0);
+    EXPECT_EQ(idsAt(m, QuoteSide::Bid, 100.0), (std::vector<std::uint64_t>{2}));
+
+    send(intent(IntentType::Cancel, 3, QuoteSide::Bid, 0.0, 0.0, 2));
+    EXPECT_EQ(strategy.done, (std::vector<std::uint64_t>{2}));
+    EXPECT_EQ(m.openOrders(), 0u);
+    EXPECT_DOUBLE_EQ(m.position(kSymbol).qty, 0.25);
+    EXPECT_DOUBLE_EQ(m.position(kSymbol).pnl(101.0), 0.25);
+
+    // A cancel for an order that is already gone comes back as an OrderCancelReject.
+    std::string body;
+    sim::Execution e;
+    e.cancelReject = true;
+    e.requestType = 'F';
+    e.clOrdId = 4;
+    e.origClOrdId = 2;
+    const auto type = sim::appendExecution(body, e);
+    const auto parsed = oms::parseExecReport(std::string(framer.frame(type, body)));
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->msgType, '9');
+    EXPECT_EQ(parsed->cxlRejResponseTo, '1');
+    EXPECT_EQ(parsed->origClOrdId, 2u);
+}
+
+TEST(OmsGate, WithdrawsIntentsTheDownstreamSinkRefuses) {
+    oms::OrderManager m(1);
+    bool downstreamUp = false;
+    int sent = 0;
+    oms::OmsGate gate(m, [&](const OrderIntent&) {
+        if (downstreamUp) ++sent;
+        return downstreamUp;
+    });
+
+    // The refused order gives its slot back, so the next one still fits in a slab of one.
+    EXPECT_FALSE(gate(intent(IntentType::New, 1, QuoteSide::Bid, 99.0, 1.0)));
+    EXPECT_EQ(m.find(1), nullptr);
+    EXPECT_EQ(m.openOrders(), 0u);
+    EXPECT_DOUBLE_EQ(m.openQty(kSymbol, QuoteSide::Bid), 0.0);
+
+    downstreamUp = true;
+    EXPECT_TRUE(gate(intent(IntentType::New, 2, QuoteSide::Bid, 99.0, 1.0)));
+    EXPECT_EQ(m.openOrders(), 1u);
+
+    // A refused cancel leaves the order as it was and its ClOrdID free for another attempt.
+    downstreamUp = false;
+    EXPECT_FALSE(gate(intent(IntentType::Cancel, 3, QuoteSide::Bid, 0.0, 0.0, 2)));
+    ASSERT_NE(m.find(2), nullptr);
+    EXPECT_EQ(m.find(2)->pendingClOrdId, 0u);
+    EXPECT_EQ(m.find(2)->status, oms::OrdStatus::PendingNew);
+    EXPECT_EQ(m.find(3), nullptr);
+
+    // Intents the OrderManager refuses never reach the sink.
+    downstreamUp = true;
+    EXPECT_FALSE(gate(intent(IntentType::New, 4, QuoteSide::Bid, 98.0, 1.0)));
+    EXPECT_TRUE(gate(intent(IntentType::Cancel, 3, QuoteSide::Bid, 0.0, 0.0, 2)));
+    EXPECT_EQ(sent, 2);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../OrderSender/include/FixChecksum.hpp"
+#include "../../OrderSender/include/OrderSender.hpp"
+
+using namespace gateway;
+
+namespace {
+
+    struct RecordingTransport {
+        std::vector<std::string> frames;
+        bool accept{true};
+        bool send(const std::string_view& msg) {
+            if (!accept) return false;
+            frames.emplace_back(msg);
+            return true;
+        }
+    };
+
+    std::map<int, std::string> fields(const std::string& msg) {
+        std::map<int, std::string> out;
+        std::size_t pos = 0;
+        while (pos < msg.size()) {
+            const auto eq = msg.find('=', pos);
+            const auto soh = msg.find('\x01', eq);
+            out[std::stoi(msg.substr(pos, eq - pos))] = msg.substr(eq + 1, soh - eq - 1);
+            pos = soh + 1;
+        }
+        return out;
+    }
+
+    // BodyLength and CheckSum recomputed from scratch, byte by byte.
+    void expectWellFormed(const std::string& msg) {
+        ASSERT_EQ(msg.rfind("8=FIX.4.4\x01" "9=", 0), 0u);
+        const auto bodyStart = msg.find('\x01', 10) + 1;
+        const auto trailer = msg.rfind("10=");
+        ASSERT_EQ(msg.size() - trailer, 7u);
+        EXPECT_EQ(std::stoul(fields(msg)[9]), trailer - bodyStart);
+
+        unsigned sum = 0;
+        for (std::size_t i = 0; i < trailer; ++i) sum += static_cast<unsigned char>(msg[i]);
+        char expected[4]{};
+        std::snprintf(expected, sizeof expected, "%03u", sum % 256);
+        EXPECT_EQ(msg.substr(trailer + 3, 3), expected);
+    }
+
+    OrderIntent intent(IntentType type, QuoteSide side, std::uint64_t id, std::uint64_t orig, double price, double qty) {
+        OrderIntent i;
+        i.type = type;
+        i.side = side;
+        i.symbol = internSymbol("BTC-EUR");
+        i.clientOrderId = id;
+        i.origClientOrderId = orig;
+        i.price = price;
+        i.qty = qty;
+        return i;
+    }
+
+}
+
+TEST(FixChecksum, VectorSumMatchesScalarForAllLengths) {
+    std::string bytes;
+    for (int i = 0; i < 300; ++i) bytes += static_cast<char>(i * 37 + 11);
+    for (std::size_t n = 0; n <= bytes.size(); ++n) {
+        std::uint32_t ref = 0;
+        for (std::size_t i = 0; i < n; ++i) ref += static_cast<unsigned char>(bytes[i]);
+        ASSERT_EQ(fix::byteSum(bytes.data(), n), ref) << n;
+    }
+}
+
+TEST(OrderSender, EncodesNewReplaceAndCancelWithFixedLayout) {
+    RecordingTransport wire;
+    OrderSender<RecordingTransport> sender(wire, {.senderCompId = "CLIENT", .targetCompId = "VENUE", .priceDecimals = 2, .qtyDecimals = 4});
+    sender.addSymbol(internSymbol("BTC-EUR"));
+
+    ASSERT_TRUE(sender.send(intent(IntentType::New, QuoteSide::Bid, 7, 0, 10420.5, 0.75)));
+    ASSERT_TRUE(sender.send(intent(IntentType::Replace, QuoteSide::Bid, 8, 7, 10421.25, 0.5)));
+    ASSERT_TRUE(sender.send(intent(IntentType::Cancel, QuoteSide::Ask, 9, 8, 0.0, 0.5)));
+    ASSERT_EQ(wire.frames.size(), 3u);
+    for (const auto& f : wire.frames) expectWellFormed(f);
+
+    auto d = fields(wire.frames[0]);
+    EXPECT_EQ(d[35], "D");
+    EXPECT_EQ(d[49], "CLIENT");
+    EXPECT_EQ(d[56], "VENUE");
+    EXPECT_EQ(std::stoul(d[34]), 1u);
+    EXPECT_EQ(std::stoull(d[11]), 7u);
+    EXPECT_EQ(d[55], "BTC-EUR");
+    EXPECT_EQ(d[54], "1");
+    EXPECT_EQ(d[44], "0000010420.50");
+    EXPECT_EQ(d[38], "0000000000.7500");
+    EXPECT_EQ(d[52], d[60]);
+    EXPECT_EQ(d[52].size(), fix::kTimestampWidth);
+    EXPECT_EQ(d.count(41), 0u);
+
+    auto g = fields(wire.frames[1]);
+    EXPECT_EQ(g[35], "G");
+    EXPECT_EQ(std::stoul(g[34]), 2u);
+    EXPECT_EQ(std::stoull(g[41]), 7u);
+    EXPECT_DOUBLE_EQ(std::stod(g[44]), 10421.25);
+
+    auto f = fields(wire.frames[2]);
+    EXPECT_EQ(f[35], "F");
+    EXPECT_EQ(f[54], "2");
+    EXPECT_EQ(std::stoull(f[41]), 8u);
+    EXPECT_EQ(f.count(44), 0u);
+    EXPECT_EQ(sender.nextSeqNum(), 4u);
+    EXPECT_EQ(sender.sent(), 3u);
+
+    // Same template, different values: only the slots change, never the length.
+    ASSERT_TRUE(sender.send(intent(IntentType::New, QuoteSide::Ask, 123456789012345ull, 0, 1.0, 12.3456)));
+    EXPECT_EQ(wire.frames[3].size(), wire.frames[0].size());
+    expectWellFormed(wire.frames[3]);
+}
+
+TEST(OrderSender, RejectsWithoutConsumingSequenceNumbers) {
+    RecordingTransport wire;
+    OrderSender<RecordingTransport> sender(wire, {.priceDecimals = 2});
+
+    EXPECT_FALSE(sender.send(intent(IntentType::New, QuoteSide::Bid, 1, 0, 100.0, 1.0)));
+    sender.addSymbol(internSymbol("BTC-EUR"));
+    EXPECT_FALSE(sender.send(intent(IntentType::New, QuoteSide::Bid, 1, 0, -1.0, 1.0)));
+    EXPECT_FALSE(sender.send(intent(IntentType::New, QuoteSide::Bid, 1, 0, 1e12, 1.0)));
+    EXPECT_EQ(sender.rejected(), 3u);
+    EXPECT_EQ(sender.unknownSymbols(), 1u);
+    EXPECT_EQ(sender.nextSeqNum(), 1u);
+
+    wire.accept = false;
+    EXPECT_FALSE(sender.send(intent(IntentType::New, QuoteSide::Bid, 1, 0, 100.0, 1.0)));
+    EXPECT_EQ(sender.sendFailures(), 1u);
+    EXPECT_TRUE(wire.frames.empty());
+}
+
+TEST(TimestampFormatter, RendersUtcMillisecondsAcrossDayBoundaries) {
+    using namespace std::chrono;
+    fix::TimestampFormatter clock;
+    const sys_days day = 2024y / March / 9;
+    EXPECT_EQ(std::string(clock.format(day + 23h + 59min + 59s + 987ms), fix::kTimestampWidth), "20240309-23:59:59.987");
+    EXPECT_EQ(std::string(clock.format(day + 24h + 5ms), fix::kTimestampWidth), "20240310-00:00:00.005");
+}
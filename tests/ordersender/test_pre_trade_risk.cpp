@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "../../OrderSender/include/PreTradeRisk.hpp"
+#include "../../TradingLogic/include/MarketMaker.hpp"
+
+using namespace gateway;
+using namespace std::chrono_literals;
+
+namespace {
+
+    const SymbolId kSymbol = internSymbol("BTC-EUR");
+
+    OrderIntent order(double price, double qty, QuoteSide side = QuoteSide::Bid, IntentType type = IntentType::New,
+                      IntentClock::time_point at = IntentClock::time_point{} + 1h) {
+        OrderIntent i;
+        i.type = type;
+        i.side = side;
+        i.symbol = kSymbol;
+        i.price = price;
+        i.qty = qty;
+        i.decisionTs = at;
+        return i;
+    }
+
+    // Checks the intent and, when accepted, charges it as sent.
+    RiskReject send(PreTradeRisk& risk, const OrderIntent& intent) {
+        const auto result = risk.check(intent);
+        risk.commit(intent, result);
+        return result.reason;
+    }
+
+    struct Recorder {
+        std::vector<OrderIntent>* out;
+        void operator()(const OrderIntent& i) const { out->push_back(i); }
+    };
+
+}
+
+TEST(PreTradeRisk, EachLimitRejectsWithItsOwnReason) {
+    PreTradeRisk risk({.maxOrderQty = 2.0, .maxNotional = 150.0, .priceBandBps = 100.0, .maxPosition = 3.0});
+    EXPECT_EQ(risk.check(order(100.0, 1.0)).reason, RiskReject::NoReference);
+    risk.updateMid(kSymbol, 100.0);
+
+    EXPECT_EQ(risk.check(order(100.0, 1.0)).reason, RiskReject::None);
+    EXPECT_EQ(risk.check(order(100.0, 2.5)).reason, RiskReject::MaxQty);
+    EXPECT_EQ(risk.check(order(100.0, 0.0)).reason, RiskReject::MaxQty);
+    EXPECT_EQ(risk.check(order(99.0, 1.6)).reason, RiskReject::MaxNotional);
+    EXPECT_EQ(risk.check(order(101.5, 1.0)).reason, RiskReject::PriceBand);
+    EXPECT_EQ(risk.check(order(98.5, 1.0, QuoteSide::Ask)).reason, RiskReject::PriceBand);
+
+    risk.onFill(kSymbol, QuoteSide::Bid, 2.5);
+    EXPECT_EQ(risk.check(order(100.0, 1.0)).reason, RiskReject::Position);
+    EXPECT_EQ(risk.check(order(100.0, 1.0, QuoteSide::Ask)).reason, RiskReject::None);
+    // The highest-priority failure wins.
+    EXPECT_EQ(risk.check(order(150.0, 5.0)).reason, RiskReject::MaxQty);
+
+    EXPECT_EQ(risk.passed(), 2u);
+    EXPECT_EQ(risk.rejects(RiskReject::MaxQty), 3u);
+    EXPECT_EQ(risk.rejects(RiskReject::PriceBand), 2u);
+    EXPECT_EQ(risk.rejects(RiskReject::Position), 1u);
+}
+
+TEST(PreTradeRisk, ThrottleAllowsBurstThenSustainedRate) {
+    PreTradeRisk risk({.maxOrdersPerSecond = 10.0, .burst = 3.0});
+    risk.updateMid(kSymbol, 100.0);
+    const auto t0 = IntentClock::time_point{} + 1h;
+
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)), RiskReject::None);
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)), RiskReject::Throttle);
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::Cancel, t0 + 50ms)), RiskReject::Throttle);
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0 + 100ms)), RiskReject::None);
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0 + 150ms)), RiskReject::Throttle);
+    EXPECT_EQ(risk.rejects(RiskReject::Throttle), 3u);
+}
+
+TEST(PreTradeRisk, UncommittedIntentsDoNotUseTheThrottle) {
+    PreTradeRisk risk({.maxOrdersPerSecond = 10.0, .burst = 1.0});
+    risk.updateMid(kSymbol, 100.0);
+    const auto t0 = IntentClock::time_point{} + 1h;
+
+    for (int i = 0; i < 5; ++i) EXPECT_TRUE(risk.check(order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)).accepted());
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)), RiskReject::None);
+    EXPECT_EQ(send(risk, order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)), RiskReject::Throttle);
+}
+
+TEST(PreTradeRisk, KillSwitchFromAnotherThreadStillLetsCancelsOut) {
+    PreTradeRisk risk;
+    risk.updateMid(kSymbol, 100.0);
+    std::thread([&] { risk.kill(); }).join();
+
+    EXPECT_TRUE(risk.killed());
+    EXPECT_EQ(risk.check(order(100.0, 0.1)).reason, RiskReject::KillSwitch);
+    EXPECT_EQ(risk.check(order(100.0, 0.1, QuoteSide::Bid, IntentType::Replace)).reason, RiskReject::KillSwitch);
+    EXPECT_EQ(risk.check(order(0.0, 0.0, QuoteSide::Bid, IntentType::Cancel)).reason, RiskReject::None);
+
+    risk.resume();
+    EXPECT_EQ(risk.check(order(100.0, 0.1)).reason, RiskReject::None);
+}
+
+TEST(RiskGate, TracksBookMidAndFiltersStrategyIntents) {
+    PreTradeRisk risk({.maxOrderQty = 0.5});
+    std::vector<OrderIntent> sent;
+    MarketMaker<RiskGate<Recorder>> mm({.quoteSize = 1.0, .maxPosition = 5.0}, RiskGate<Recorder>(risk, Recorder{&sent}));
+
+    OrderBook book("BTC-EUR");
+    book.update(Quote(100.00, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Bid));
+    book.update(Quote(100.10, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Ask));
+    mm.onBook(book, IntentClock::now());
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(risk.rejects(RiskReject::MaxQty), 2u);
+
+    risk.setLimits(kSymbol, {.maxOrderQty = 1.0});
+    MarketMaker<RiskGate<Recorder>> sized({.quoteSize = 1.0, .maxPosition = 5.0}, RiskGate<Recorder>(risk, Recorder{&sent}));
+    sized.onBook(book, IntentClock::now());
+    EXPECT_EQ(sent.size(), 2u);
+}
+
+TEST(RiskGate, RefusedIntentsLeaveTheRestingOrdersAlone) {
+    PreTradeRisk risk({.maxOrderQty = 1.0, .maxPosition = 5.0});
+    std::vector<OrderIntent> sent;
+    MarketMaker<RiskGate<Recorder>> mm({.quoteSize = 1.0, .maxPosition = 5.0}, RiskGate<Recorder>(risk, Recorder{&sent}));
+
+    OrderBook book("BTC-EUR");
+    book.update(Quote(100.00, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Bid));
+    book.update(Quote(100.10, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Ask));
+    mm.onBook(book, IntentClock::now());
+    ASSERT_EQ(sent.size(), 2u);
+    const auto bidId = sent[0].clientOrderId;
+    const auto askId = sent[1].clientOrderId;
+
+    // The kill switch blocks the replaces; the quotes that rest keep their ClOrdIDs.
+    risk.kill();
+    book.update(Quote(101.00, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Bid));
+    book.update(Quote(101.10, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Ask));
+    mm.onBook(book, IntentClock::now());
+    EXPECT_EQ(sent.size(), 2u);
+    EXPECT_EQ(mm.refusedIntents(), 2u);
+
+    // So pulling the quotes cancels the orders that are actually on the venue.
+    mm.onBook(book, IntentClock::now(), false);
+    ASSERT_EQ(sent.size(), 4u);
+    EXPECT_EQ(sent[2].type, IntentType::Cancel);
+    EXPECT_EQ(sent[2].origClientOrderId, bidId);
+    EXPECT_EQ(sent[3].origClientOrderId, askId);
+    mm.onBook(book, IntentClock::now(), false);
+    EXPECT_EQ(sent.size(), 4u);
+}
+
+TEST(RiskGate, RefusedDeliveriesDoNotUseTheThrottle) {
+    PreTradeRisk risk({.maxOrdersPerSecond = 10.0, .burst = 1.0});
+    risk.updateMid(kSymbol, 100.0);
+    bool accept = false;
+    RiskGate gate(risk, [&](const OrderIntent&) { return accept; });
+    const auto t0 = IntentClock::time_point{} + 1h;
+
+    for (int i = 0; i < 3; ++i) EXPECT_FALSE(gate(order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)));
+    accept = true;
+    EXPECT_TRUE(gate(order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)));
+    EXPECT_FALSE(gate(order(100.0, 0.1, QuoteSide::Bid, IntentType::New, t0)));
+    EXPECT_EQ(risk.rejects(RiskReject::Throttle), 1u);
+}
+
+TEST(RiskGate, SendFailureKeepsTheSideLive) {
+    PreTradeRisk risk({.maxOrderQty = 1.0, .maxPosition = 5.0});
+    std::vector<OrderIntent> tried;
+    bool accept = true;
+    const auto wire = [&](const OrderIntent& i) {
+        tried.push_back(i);
+        return accept;
+    };
+    MarketMaker<RiskGate<decltype(wire)>> mm({.quoteSize = 1.0, .maxPosition = 5.0}, RiskGate<decltype(wire)>(risk, wire));
+
+    OrderBook book("BTC-EUR");
+    book.update(Quote(100.00, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Bid));
+    book.update(Quote(100.10, 1.0, std::chrono::system_clock::now(), kSymbol, QuoteSide::Ask));
+    mm.onBook(book, IntentClock::now());
+    ASSERT_EQ(tried.size(), 2u);
+
+    // A cancel the wire did not take leaves the side live, so it is tried again.
+    accept = false;
+    mm.onBook(book, IntentClock::now(), false);
+    ASSERT_EQ(tried.size(), 4u);
+    accept = true;
+    mm.onBook(book, IntentClock::now(), false);
+    ASSERT_EQ(tried.size(), 6u);
+    EXPECT_EQ(tried[4].type, IntentType::Cancel);
+    EXPECT_EQ(tried[4].origClientOrderId, tried[0].clientOrderId);
+    mm.onBook(book, IntentClock::now(), false);
+    EXPECT_EQ(tried.size(), 6u);
+}
@@ -11,6 +11,8 @@ using bitvavo::parseAndStoreQuote;
 
 namespace {
 
+	// The parser only tags subscribed markets, i.e. those already in the symbol table.
+	[[maybe_unused]] const bool kSubscribed = (gateway::internSymbol("BTC-EUR"), gateway::internSymbol("ETH-EUR"), true);
 
 	template <typename Clock = std::chrono::system_clock>
 	struct TimeBounds {
@@ -150,6 +152,12 @@ TEST(ParseAndStoreQuote, ReturnsAskWhenNoBids) {
 	EXPECT_TRUE(IsWithin(q->getTimestamp(), TimeBounds<>{t0, t1}));
 }
 
+TEST(ParseAndStoreQuote, DropsUnknownMarkets) {
+	std::string frame = R"({"event":"book","bids":[["101.0","2.0"]]})";
+	EXPECT_FALSE(parseAndStoreQuote(frame, "NOT-SUBSCRIBED").has_value());
+	EXPECT_FALSE(gateway::SymbolTable::instance().find("NOT-SUBSCRIBED").has_value());
+}
+
 TEST(ParseAndStoreQuote, ReturnsNulloptWhenNoLevels) {
 	std::string frame = R"({"event":"book","bids":[],"asks":[]})";
 	auto q = parseAndStoreQuote(frame, "BTC-EUR");
@@ -193,3 +201,29 @@ TEST(ParseFirstLevel, RejectsMalformedQtyWithLeadingChars) {
 	EXPECT_FALSE(parseFirstLevel(f, "asks", px, qty));
 }
 
+
+TEST(ExtractNonce, KeepsQuoteSequenceWidth) {
+	const auto wide = (std::uint64_t{1} << gateway::Quote::kSequenceBits) + 5;
+	EXPECT_EQ(extractNonce(R"({"nonce":)" + std::to_string(wide) + "}"), 5u);
+}
+
+TEST(IsBookSnapshot, RequiresResponseWithNonce) {
+	EXPECT_TRUE(bitvavo::isBookSnapshot(R"({"action":"getBook","response":{"market":"BTC-EUR","nonce":7,"bids":[],"asks":[]}})"));
+	EXPECT_FALSE(bitvavo::isBookSnapshot(R"({"action":"getBook","errorCode":205,"error":"market parameter is invalid."})"));
+	EXPECT_FALSE(bitvavo::isBookSnapshot(R"({"action":"getBook","response":{"market":"BTC-EUR"}})"));
+}
+
+TEST(ParseBookLevels, EmitsNothingWhenEitherSideIsMalformed) {
+	const auto symbol = gateway::internSymbol("BTC-EUR");
+	int emitted = 0;
+	const auto count = [&](const gateway::Quote&) { ++emitted; };
+
+	EXPECT_FALSE(bitvavo::parseBookLevels(
+		R"({"event":"book","bids":[["100.0","1.0"]],"asks":[["101.0","1.0"],["102.0","x"]]})", symbol, count));
+	EXPECT_FALSE(bitvavo::parseBookLevels(R"({"event":"book","bids":[["100.0","1.0"],["99.0"]]})", symbol, count));
+	EXPECT_FALSE(bitvavo::parseBookLevels(R"({"event":"book","nonce":3})", symbol, count));
+	EXPECT_EQ(emitted, 0);
+
+	EXPECT_TRUE(bitvavo::parseBookLevels(R"({"event":"book","bids":[["100.0","1.0"],["99.0","2.0"]]})", symbol, count));
+	EXPECT_EQ(emitted, 2);
+}
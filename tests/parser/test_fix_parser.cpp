@@ -2,6 +2,7 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
 
 #include "../../GatewayIn/include/Quote.hpp"
 
@@ -13,6 +14,10 @@ namespace {
 
 	constexpr char SOH = '\x01';
 
+	// The parser only tags subscribed instruments, i.e. those already in the symbol table.
+	[[maybe_unused]] const bool kSubscribed =
+			(gateway::internSymbol("BTC-EUR"), gateway::internSymbol("ETH-EUR"), gateway::internSymbol("XRP-EUR"), true);
+
 	std::string fix_msg(std::initializer_list<std::pair<std::string, std::string>> fields) {
 		std::string m;
 		m.reserve(256);
@@ -81,6 +86,14 @@ TEST(FIX_LenientParser, NonBookType_YieldsNullopt) {
 	EXPECT_FALSE(q.has_value());
 }
 
+TEST(FIX_LenientParser, UnknownSymbol_YieldsNullopt) {
+	const auto msg = fix_msg({ {"8","FIX.4.4"}, {"35","X"}, {"55","NOT-SUBSCRIBED"}, {"268","1"} })
+					 + "269=0" + std::string(1,SOH) + "270=1" + std::string(1,SOH) + "271=1" + std::string(1,SOH);
+
+	EXPECT_FALSE(parseAndStoreQuote(msg).has_value());
+	EXPECT_FALSE(gateway::SymbolTable::instance().find("NOT-SUBSCRIBED").has_value());
+}
+
 // ========================= Lenient gedrag expliciet vastgelegd =========================
 
 TEST(FIX_LenientParser, SideOtherThanZeroMapsToAsk_ByContract) {
@@ -156,3 +169,42 @@ TEST(FIX_LenientParser, TimestampIsNowInterval) {
 	ASSERT_TRUE(q.has_value());
 	EXPECT_TRUE(IsWithin(q->getTimestamp(), TimeBounds<>{t0,t1}));
 }
+
+TEST(FIX_OrderEntries, IncrementalEntriesCarryActionAndOrderId) {
+	const auto msg = fix_msg({
+		{"8","FIX.4.4"},{"35","X"},{"268","3"},
+		{"279","0"},{"269","0"},{"278","11"},{"55","EUR/USD"},{"270","1.1000"},{"271","500"},
+		{"279","1"},{"269","1"},{"278","12"},{"55","EUR/USD"},{"270","1.1002"},{"271","250"},
+		{"279","2"},{"269","0"},{"278","9"},
+		{"10","000"}
+	});
+
+	std::vector<fix::OrderEntry> entries;
+	EXPECT_EQ(fix::forEachOrderEntry(msg, [&](const fix::OrderEntry& e) { entries.push_back(e); }), 3u);
+	ASSERT_EQ(entries.size(), 3u);
+	EXPECT_EQ(entries[0].updateAction, '0');
+	EXPECT_EQ(entries[0].orderId, 11u);
+	EXPECT_EQ(entries[0].side, gateway::QuoteSide::Bid);
+	EXPECT_DOUBLE_EQ(entries[0].price, 1.1000);
+	EXPECT_EQ(entries[1].updateAction, '1');
+	EXPECT_EQ(entries[1].side, gateway::QuoteSide::Ask);
+	EXPECT_DOUBLE_EQ(entries[1].size, 250.0);
+	EXPECT_EQ(entries[2].updateAction, '2');
+	EXPECT_EQ(entries[2].orderId, 9u);
+}
+
+TEST(FIX_OrderEntries, SnapshotEntriesWithoutIdsOrTradesAreSkipped) {
+	const auto msg = fix_msg({
+		{"35","W"},{"55","EUR/USD"},{"268","3"},
+		{"269","0"},{"278","1"},{"270","1.1"},{"271","10"},
+		{"269","2"},{"278","2"},{"270","1.1"},{"271","5"},
+		{"269","1"},{"270","1.2"},{"271","10"},
+		{"10","000"}
+	});
+
+	std::vector<fix::OrderEntry> entries;
+	fix::forEachOrderEntry(msg, [&](const fix::OrderEntry& e) { entries.push_back(e); });
+	ASSERT_EQ(entries.size(), 1u);
+	EXPECT_EQ(entries[0].updateAction, '0');
+	EXPECT_EQ(entries[0].orderId, 1u);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../../OrderSender/include/OrderSender.hpp"
+#include "../../Parser/include/BitvavoBookParser.hpp"
+#include "../../Parser/include/FixBookParser.hpp"
+#include "../../Simulator/include/MatchingEngine.hpp"
+#include "../../Simulator/include/SimulatorWire.hpp"
+
+using namespace gateway;
+
+namespace {
+
+    struct Recorder {
+        std::vector<sim::Execution> executions;
+        std::vector<sim::LevelUpdate> levels;
+        void onExecution(const sim::Execution& e) { executions.push_back(e); }
+        void onLevel(const sim::LevelUpdate& u) { levels.push_back(u); }
+    };
+
+    const SymbolId kSymbol = internSymbol("SIM-EUR");
+
+    sim::OrderRequest order(char type, std::uint64_t id, QuoteSide side, double price, double qty,
+                            std::uint64_t orig = 0, sim::OwnerId owner = 1) {
+        sim::OrderRequest r;
+        r.msgType = type;
+        r.owner = owner;
+        r.clOrdId = id;
+        r.origClOrdId = orig;
+        r.symbol = kSymbol;
+        r.side = side;
+        r.price = price;
+        r.qty = qty;
+        return r;
+    }
+
+}
+
+TEST(MatchingEngine, FillsByPriceThenTimeAndRestsTheRemainder) {
+    sim::MatchingEngine<Recorder> engine;
+    engine.addSymbol(kSymbol);
+    engine.submit(order('D', 1, QuoteSide::Ask, 101.0, 1.0));
+    engine.submit(order('D', 2, QuoteSide::Ask, 101.0, 1.0));
+    engine.submit(order('D', 3, QuoteSide::Ask, 100.5, 0.5));
+    auto& rec = engine.listener();
+    rec.executions.clear();
+    rec.levels.clear();
+
+    engine.submit(order('D', 10, QuoteSide::Bid, 101.0, 3.0, 0, 2));
+    // New, then per fill one report for the maker and one for the taker.
+    ASSERT_EQ(rec.executions.size(), 7u);
+    EXPECT_EQ(rec.executions[0].execType, sim::ExecType::New);
+    EXPECT_EQ(rec.executions[1].clOrdId, 3u);
+    EXPECT_EQ(rec.executions[1].ordStatus, sim::OrdStatus::Filled);
+    EXPECT_DOUBLE_EQ(rec.executions[1].lastPx, 100.5);
+    EXPECT_EQ(rec.executions[3].clOrdId, 1u);
+    EXPECT_EQ(rec.executions[5].clOrdId, 2u);
+
+    const auto& last = rec.executions.back();
+    EXPECT_EQ(last.clOrdId, 10u);
+    EXPECT_EQ(last.ordStatus, sim::OrdStatus::PartiallyFilled);
+    EXPECT_DOUBLE_EQ(last.cumQty, 2.5);
+    EXPECT_DOUBLE_EQ(last.leavesQty, 0.5);
+    EXPECT_NEAR(last.avgPx, (0.5 * 100.5 + 2.0 * 101.0) / 2.5, 1e-12);
+
+    // Both ask levels emptied, then the remainder rests as a bid.
+    ASSERT_EQ(rec.levels.size(), 3u);
+    EXPECT_DOUBLE_EQ(rec.levels[0].price, 100.5);
+    EXPECT_DOUBLE_EQ(rec.levels[0].size, 0.0);
+    EXPECT_DOUBLE_EQ(rec.levels[1].price, 101.0);
+    EXPECT_DOUBLE_EQ(rec.levels[1].size, 0.0);
+    EXPECT_EQ(rec.levels[2].side, QuoteSide::Bid);
+    EXPECT_DOUBLE_EQ(rec.levels[2].size, 0.5);
+    EXPECT_EQ(engine.trades(), 3u);
+    EXPECT_EQ(engine.liveOrders(), 1u);
+}
+
+TEST(MatchingEngine, CancelReplaceAndRejects) {
+    sim::MatchingEngine<Recorder> engine;
+    engine.addSymbol(kSymbol);
+    auto& rec = engine.listener();
+
+    engine.submit(order('D', 1, QuoteSide::Bid, 99.0, 2.0));
+    engine.submit(order('D', 1, QuoteSide::Bid, 99.0, 2.0));
+    EXPECT_EQ(rec.executions.back().execType, sim::ExecType::Rejected);
+    EXPECT_FALSE(rec.executions.back().cancelReject);
+
+    engine.submit(order('F', 5, QuoteSide::Bid, 0.0, 0.0, 42));
+    EXPECT_TRUE(rec.executions.back().cancelReject);
+
+    engine.submit(order('D', 7, QuoteSide::Ask, 100.0, 1.0, 0, sim::kHouse));
+    engine.submit(order('G', 2, QuoteSide::Bid, 100.0, 2.0, 1));
+    const auto& fill = rec.executions.back();
+    EXPECT_EQ(fill.execType, sim::ExecType::Trade);
+    EXPECT_EQ(fill.clOrdId, 2u);
+    EXPECT_DOUBLE_EQ(fill.leavesQty, 1.0);
+    EXPECT_EQ(engine.book(kSymbol)->bids().begin()->first, 100.0);
+    EXPECT_EQ(engine.book(kSymbol)->bids().count(99.0), 0u);
+
+    engine.submit(order('F', 3, QuoteSide::Bid, 0.0, 0.0, 2));
+    EXPECT_EQ(rec.executions.back().execType, sim::ExecType::Canceled);
+    EXPECT_EQ(rec.executions.back().origClOrdId, 2u);
+    EXPECT_DOUBLE_EQ(rec.executions.back().cumQty, 1.0);
+    EXPECT_EQ(engine.liveOrders(), 0u);
+    EXPECT_EQ(engine.rejected(), 2u);
+}
+
+TEST(MatchingEngine, ClOrdIdsAreScopedToTheirOwner) {
+    sim::MatchingEngine<Recorder> engine;
+    engine.addSymbol(kSymbol);
+    auto& rec = engine.listener();
+
+    // Two sessions both start at ClOrdID 1.
+    engine.submit(order('D', 1, QuoteSide::Bid, 99.0, 1.0, 0, 1));
+    engine.submit(order('D', 1, QuoteSide::Bid, 98.0, 1.0, 0, 2));
+    EXPECT_EQ(rec.executions.back().execType, sim::ExecType::New);
+    EXPECT_EQ(engine.liveOrders(), 2u);
+    EXPECT_EQ(engine.rejected(), 0u);
+
+    // Neither can cancel or replace the other's order.
+    engine.submit(order('F', 2, QuoteSide::Bid, 0.0, 0.0, 1, 3));
+    EXPECT_TRUE(rec.executions.back().cancelReject);
+    engine.submit(order('G', 2, QuoteSide::Bid, 97.0, 1.0, 1, 3));
+    EXPECT_TRUE(rec.executions.back().cancelReject);
+    EXPECT_EQ(engine.liveOrders(), 2u);
+
+    engine.submit(order('F', 2, QuoteSide::Bid, 0.0, 0.0, 1, 2));
+    EXPECT_EQ(rec.executions.back().execType, sim::ExecType::Canceled);
+    EXPECT_EQ(rec.executions.back().owner, 2u);
+    EXPECT_DOUBLE_EQ(rec.executions.back().price, 98.0);
+    EXPECT_EQ(engine.book(kSymbol)->bids().count(99.0), 1u);
+
+    // A fill reports the maker's own ClOrdID back to its owner.
+    engine.submit(order('D', 1, QuoteSide::Ask, 99.0, 1.0, 0, 2));
+    ASSERT_GE(rec.executions.size(), 2u);
+    const auto& maker = rec.executions[rec.executions.size() - 2];
+    EXPECT_EQ(maker.owner, 1u);
+    EXPECT_EQ(maker.clOrdId, 1u);
+    EXPECT_EQ(maker.ordStatus, sim::OrdStatus::Filled);
+    EXPECT_EQ(engine.liveOrders(), 0u);
+}
+
+TEST(SimulatorWire, OutputParsesWithOurOwnParsers) {
+    const sim::LevelUpdate u{kSymbol, QuoteSide::Ask, 100.25, 1.5};
+
+    std::string body;
+    sim::appendIncrementalRefresh(body, u, '1');
+    sim::FixFramer framer("VENUE", "CLIENT");
+    const std::string x(framer.frame("X", body));
+    const auto quote = fix::parseAndStoreQuote(x);
+    ASSERT_TRUE(quote.has_value());
+    EXPECT_DOUBLE_EQ(quote->getPrice(), 100.25);
+    EXPECT_DOUBLE_EQ(quote->getSize(), 1.5);
+    EXPECT_EQ(quote->getSide(), QuoteSide::Ask);
+    EXPECT_EQ(fix::checksum(std::string_view(x).substr(0, x.size() - 7)),
+              std::stoi(std::string(sim::fixField(x, "10"))));
+
+    const auto json = sim::bitvavoBookUpdate(u, 17);
+    std::vector<Quote> quotes;
+    ASSERT_TRUE(bitvavo::parseBookLevels(json, kSymbol, [&](const Quote& q) { quotes.push_back(q); }));
+    ASSERT_EQ(quotes.size(), 1u);
+    EXPECT_DOUBLE_EQ(quotes[0].getPrice(), 100.25);
+    EXPECT_EQ(bitvavo::extractNonce(json), 17u);
+
+    struct Capture {
+        std::string last;
+        bool send(const std::string_view& m) { last = m; return true; }
+    } wire;
+    OrderSender<Capture> sender(wire, {});
+    sender.addSymbol(kSymbol);
+    OrderIntent intent;
+    intent.type = IntentType::Replace;
+    intent.side = QuoteSide::Ask;
+    intent.symbol = kSymbol;
+    intent.clientOrderId = 9;
+    intent.origClientOrderId = 8;
+    intent.price = 101.5;
+    intent.qty = 0.25;
+    ASSERT_TRUE(sender.send(intent));
+    const auto req = sim::decodeOrder(wire.last, 3);
+    ASSERT_TRUE(req.has_value());
+    EXPECT_EQ(req->msgType, 'G');
+    EXPECT_EQ(req->clOrdId, 9u);
+    EXPECT_EQ(req->origClOrdId, 8u);
+    EXPECT_EQ(req->side, QuoteSide::Ask);
+    EXPECT_DOUBLE_EQ(req->price, 101.5);
+    EXPECT_DOUBLE_EQ(req->qty, 0.25);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../../GatewayIn/include/QuotesObtainer.hpp"
+#include "../../OrderBook/include/OrderBook.hpp"
+#include "../../OrderBook/include/QuoteConsumer.hpp"
+#include "../../GatewayIn/include/LatencyHistogram.hpp"
+#include "../../TradingLogic/include/MarketMaker.hpp"
+#include "websocket/MockBitVavoClient.hpp"
+#include "TestQuotes.hpp"
+
+using namespace testing;
+using namespace gateway;
+using testutil::level;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct Recorder {
+        std::vector<OrderIntent>* out;
+        void operator()(const OrderIntent& i) const { out->push_back(i); }
+    };
+
+    OrderBook makeBook(double bid, double ask, double size = 1.0) {
+        OrderBook book("BTC-EUR");
+        book.update(level(bid, size, QuoteSide::Bid));
+        book.update(level(ask, size, QuoteSide::Ask));
+        return book;
+    }
+
+}
+
+TEST(LatencyHistogram, PercentilesStayWithinBucketError) {
+    LatencyHistogram h;
+    for (std::uint64_t ns = 1; ns <= 10000; ++ns) h.recordNs(ns);
+    EXPECT_EQ(h.count(), 10000u);
+    EXPECT_EQ(h.min(), 1u);
+    EXPECT_EQ(h.max(), 10000u);
+    EXPECT_NEAR(h.mean(), 5000.5, 1e-9);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50)), 5000.0, 5000.0 * 0.07);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99)), 9900.0, 9900.0 * 0.07);
+    EXPECT_EQ(h.percentile(100), 10000u);
+    EXPECT_EQ(LatencyHistogram::upperEdge(LatencyHistogram::bucketOf(7)), 7u);
+
+    LatencyHistogram other;
+    other.recordNs(1'000'000);
+    h.merge(other);
+    EXPECT_EQ(h.max(), 1'000'000u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+}
+
+TEST(MarketMaker, QuotesAroundMicropriceAndRequotesOnlyOnMoves) {
+    std::vector<OrderIntent> sent;
+    MarketMaker<Recorder> mm({.halfSpreadBps = 10.0, .quoteSize = 0.5, .maxPosition = 5.0, .requoteBps = 2.0}, Recorder{&sent});
+
+    auto book = makeBook(100.00, 100.10);
+    mm.onBook(book, IntentClock::now());
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[0].type, IntentType::New);
+    EXPECT_EQ(sent[0].side, QuoteSide::Bid);
+    EXPECT_NEAR(sent[0].price, 99.94, 1e-9);
+    EXPECT_NEAR(sent[1].price, 100.16, 1e-9);
+    EXPECT_DOUBLE_EQ(sent[1].qty, 0.5);
+    EXPECT_NE(sent[0].clientOrderId, sent[1].clientOrderId);
+    EXPECT_EQ(mm.tickToIntent().count(), 1u);
+
+    // A one-tick wiggle stays inside the requote band.
+    book.update(level(100.01, 1.0, QuoteSide::Bid));
+    mm.onBook(book, IntentClock::now());
+    EXPECT_EQ(sent.size(), 2u);
+
+    book = makeBook(101.00, 101.10);
+    mm.onBook(book, IntentClock::now());
+    ASSERT_EQ(sent.size(), 4u);
+    EXPECT_EQ(sent[2].type, IntentType::Replace);
+    EXPECT_EQ(sent[2].origClientOrderId, sent[0].clientOrderId);
+    EXPECT_GT(sent[2].price, sent[0].price);
+}
+
+TEST(MarketMaker, StopsBuyingAtPositionLimitAndPullsOnUntrustedBook) {
+    std::vector<OrderIntent> sent;
+    MarketMaker<Recorder> mm({.quoteSize = 1.0, .maxPosition = 1.0}, Recorder{&sent});
+    const auto id = internSymbol("BTC-EUR");
+    auto book = makeBook(100.00, 100.10);
+
+    mm.onFill(id, QuoteSide::Bid, 1.0);
+    EXPECT_DOUBLE_EQ(mm.position(id), 1.0);
+    mm.onBook(book, IntentClock::now());
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].side, QuoteSide::Ask);
+
+    mm.onBook(book, IntentClock::now(), false);
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[1].type, IntentType::Cancel);
+    EXPECT_EQ(sent[1].origClientOrderId, sent[0].clientOrderId);
+}
+
+TEST(MarketMaker, ConsumerDrivesStrategyOnBookThread) {
+    MockBitvavoClient mock;
+    MockBitvavoClient::MessageHandler onMsg;
+    EXPECT_CALL(mock, setMessageHandler(_)).WillOnce(SaveArg<0>(&onMsg));
+    EXPECT_CALL(mock, connect(_, _)).WillOnce(Return(true));
+    QuotesObtainer<MockBitvavoClient> obt(std::move(mock), "wss.bitvavo.com", "443", "BTC-EUR");
+    ASSERT_TRUE(obt.connect());
+
+    std::vector<OrderIntent> sent;
+    MarketMaker<Recorder> mm({}, Recorder{&sent});
+    QuoteConsumer consumer{ std::tie(obt), "BTC-EUR" };
+    consumer.start(mm);
+
+    onMsg(R"({"event":"book","bids":[["10420.00","0.75"]]})");
+    onMsg(R"({"event":"book","asks":[["10425.00","1.00"]]})");
+    std::this_thread::sleep_for(3ms);
+    consumer.stop();
+
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_LT(sent[0].price, 10425.00);
+    EXPECT_GT(sent[1].price, 10420.00);
+    EXPECT_LE(sent[0].tickTs, sent[0].decisionTs);
+    EXPECT_GE(mm.decisions(), 1u);
+    EXPECT_EQ(mm.tickToIntent().count(), 1u);
+}